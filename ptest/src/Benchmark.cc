@@ -0,0 +1,1482 @@
+#include "Benchmark.h"
+#include "Config.h"
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/utils/Runnable.h>
+#include <alibabacloud/oss/utils/FileRegionStream.h>
+#include <alibabacloud/oss/utils/ObjectLister.h>
+#include <alibabacloud/oss/utils/BatchDeleter.h>
+#include <alibabacloud/oss/utils/ObjectWriter.h>
+#include <alibabacloud/oss/utils/ObjectReader.h>
+#include <alibabacloud/oss/utils/BufferPool.h>
+#include <src/utils/Executor.h>
+#include <src/utils/Crc64.h>
+#include <src/utils/PositionalFile.h>
+#include <src/utils/FileSystemUtils.h>
+#include <src/utils/SignUtils.h>
+#include <src/utils/Codec.h>
+#include <src/http/HeaderList.h>
+#include <src/auth/HmacSha1Signer.h>
+#include <src/model/ListObjectsResultParser.h>
+#include <src/external/tinyxml2/tinyxml2.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <alibabacloud/oss/client/RateLimiter.h>
+#include <LocalOssServer.h>
+#include <alibabacloud/oss/http/HttpType.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace AlibabaCloud::OSS;
+using namespace AlibabaCloud::OSS::PTest;
+
+typedef std::chrono::steady_clock BenchClock;
+
+/*heap allocations of the whole process while counting is on, for bench_body_pool*/
+static std::atomic<bool> g_countAllocs(false);
+static std::atomic<int64_t> g_allocs(0);
+
+void *operator new(std::size_t size)
+{
+    if (g_countAllocs.load(std::memory_order_relaxed)) {
+        g_allocs.fetch_add(1, std::memory_order_relaxed);
+    }
+    void *p = std::malloc(size > 0 ? size : 1);
+    if (p == nullptr) {
+        std::abort();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+static int64_t elapsed_us(BenchClock::time_point start, BenchClock::time_point stop)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count();
+}
+
+static int64_t percentile(std::vector<int64_t> values, double pct)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t idx = static_cast<size_t>(pct * (values.size() - 1));
+    return values[idx];
+}
+
+static int process_thread_count()
+{
+#ifdef __linux__
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            return std::atoi(line.c_str() + 8);
+        }
+    }
+#endif
+    return -1;
+}
+
+/*samples the process thread count until stopped*/
+class PeakThreadSampler
+{
+public:
+    PeakThreadSampler() : stop_(false), peak_(process_thread_count())
+    {
+        thread_ = std::thread([this]() {
+            while (!stop_) {
+                int cnt = process_thread_count();
+                if (cnt > peak_) peak_ = cnt;
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        });
+    }
+    int stop()
+    {
+        stop_ = true;
+        thread_.join();
+        //exclude the sampler thread itself
+        return peak_ - 1;
+    }
+private:
+    std::atomic<bool> stop_;
+    std::atomic<int> peak_;
+    std::thread thread_;
+};
+
+/*executor benchmark*/
+struct DispatchResult
+{
+    int64_t submitUs;
+    int64_t totalUs;
+    std::vector<int64_t> latencyUs;
+    int peakRunning;
+    int peakThreads;
+};
+
+template <typename Submit>
+static DispatchResult run_dispatch(int taskNum, int workMs, Submit submit)
+{
+    DispatchResult result;
+    result.latencyUs.resize(taskNum);
+    std::atomic<int> finished(0);
+    std::atomic<int> running(0);
+    std::atomic<int> peakRunning(0);
+
+    PeakThreadSampler sampler;
+    auto start = BenchClock::now();
+    for (int i = 0; i < taskNum; i++) {
+        auto submitted = BenchClock::now();
+        submit([&, i, submitted]() {
+            result.latencyUs[i] = elapsed_us(submitted, BenchClock::now());
+            int cur = ++running;
+            int peak = peakRunning;
+            while (cur > peak && !peakRunning.compare_exchange_weak(peak, cur)) {}
+            if (workMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(workMs));
+            }
+            running--;
+            finished++;
+        });
+    }
+    result.submitUs = elapsed_us(start, BenchClock::now());
+    while (finished < taskNum) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    result.totalUs = elapsed_us(start, BenchClock::now());
+    result.peakThreads = sampler.stop();
+    result.peakRunning = peakRunning;
+    return result;
+}
+
+static void report_dispatch(const std::string &name, const DispatchResult &r)
+{
+    int64_t sum = 0;
+    for (auto v : r.latencyUs) sum += v;
+    std::cout << std::left << std::setw(22) << name
+        << " submit(ms)=" << std::setw(8) << r.submitUs / 1000
+        << " total(ms)=" << std::setw(8) << r.totalUs / 1000
+        << " latency(us) avg=" << std::setw(8) << (r.latencyUs.empty() ? 0 : sum / static_cast<int64_t>(r.latencyUs.size()))
+        << " p50=" << std::setw(8) << percentile(r.latencyUs, 0.50)
+        << " p99=" << std::setw(8) << percentile(r.latencyUs, 0.99)
+        << " peakRunning=" << std::setw(6) << r.peakRunning
+        << " peakThreads=" << r.peakThreads << std::endl;
+}
+
+static int bench_executor()
+{
+    const int threadNum = 16;
+    const int queueDepth = 4096;
+    struct Scenario { int taskNum; int workMs; } scenarios[] = { { 10000, 0 }, { 2000, 5 } };
+
+    for (auto const &s : scenarios) {
+        std::cout << "#### tasks=" << s.taskNum << ", work=" << s.workMs << "ms" << std::endl;
+
+        //the former executor, one thread per task
+        auto perTask = run_dispatch(s.taskNum, s.workMs, [](const std::function<void()> &fn) {
+            std::thread(fn).detach();
+        });
+        report_dispatch("thread-per-task", perTask);
+
+        std::unique_ptr<Executor> executor(new Executor(threadNum, queueDepth));
+        auto pooled = run_dispatch(s.taskNum, s.workMs, [&executor](const std::function<void()> &fn) {
+            executor->execute(new Runnable(fn));
+        });
+        executor->shutdown();
+        report_dispatch("work-stealing pool", pooled);
+    }
+    return 0;
+}
+
+/*upload body benchmark, reads a file part by part the way the http layer does*/
+static uint64_t drain_body(std::istream &content, int64_t length, std::vector<char> &buffer, bool crc64)
+{
+    uint64_t crc = 0;
+    int64_t transferred = 0;
+    while (transferred < length) {
+        size_t wanted = static_cast<size_t>(std::min<int64_t>(buffer.size(), length - transferred));
+        content.read(buffer.data(), wanted);
+        size_t got = static_cast<size_t>(content.gcount());
+        if (got == 0) {
+            break;
+        }
+        if (crc64) {
+            crc = CRC64::CalcCRC(crc, buffer.data(), got);
+        }
+        transferred += got;
+    }
+    return crc64 ? crc : static_cast<uint64_t>(transferred);
+}
+
+static int bench_upload_body()
+{
+    const int64_t fileSize = 256LL * 1024 * 1024;
+    const int64_t partSize = 8LL * 1024 * 1024;
+    const std::string path = "bench_upload_body.dat";
+    {
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        std::vector<char> block(1024 * 1024);
+        for (size_t i = 0; i < block.size(); i++) {
+            block[i] = static_cast<char>(i * 131 + 7);
+        }
+        for (int64_t i = 0; i < fileSize / static_cast<int64_t>(block.size()); i++) {
+            out.write(block.data(), block.size());
+        }
+    }
+
+    //curl asks for up to 16KB (CURL_MAX_WRITE_SIZE) per read callback by default
+    std::vector<char> buffer(16384);
+    std::cout << "#### file=" << fileSize / (1024 * 1024) << "MB, part=" << partSize / (1024 * 1024)
+        << "MB, read size=" << buffer.size() << std::endl;
+
+    for (int crc64 = 0; crc64 < 2; crc64++) {
+        uint64_t sumA = 0, sumB = 0;
+        auto start = BenchClock::now();
+        for (int64_t offset = 0; offset < fileSize; offset += partSize) {
+            std::fstream content(path, std::ios::in | std::ios::binary);
+            content.seekg(offset, content.beg);
+            sumA ^= drain_body(content, partSize, buffer, crc64 != 0);
+        }
+        auto fstreamUs = elapsed_us(start, BenchClock::now());
+
+        start = BenchClock::now();
+        for (int64_t offset = 0; offset < fileSize; offset += partSize) {
+            FileRegionStream content(path, offset, partSize);
+            sumB ^= drain_body(content, partSize, buffer, crc64 != 0);
+        }
+        auto regionUs = elapsed_us(start, BenchClock::now());
+
+        std::string suffix = crc64 ? " +crc64" : "";
+        std::cout << std::left << std::setw(24) << ("std::fstream" + suffix)
+            << " MB/s=" << std::setw(8) << (fileSize / (1024 * 1024)) * 1000000 / (fstreamUs > 0 ? fstreamUs : 1) << std::endl;
+        std::cout << std::left << std::setw(24) << ("FileRegionStream" + suffix)
+            << " MB/s=" << std::setw(8) << (fileSize / (1024 * 1024)) * 1000000 / (regionUs > 0 ? regionUs : 1)
+            << " data " << (sumA == sumB ? "match" : "MISMATCH") << std::endl;
+    }
+    std::remove(path.c_str());
+    return 0;
+}
+
+/*crc64 benchmark, google benchmark like: iterations grow until the run takes long enough*/
+template <typename Fn>
+static void run_throughput(const std::string &name, size_t size, Fn fn)
+{
+    int64_t iterations = 1;
+    int64_t us = 0;
+    while (true) {
+        auto start = BenchClock::now();
+        for (int64_t i = 0; i < iterations; i++) {
+            fn();
+        }
+        us = elapsed_us(start, BenchClock::now());
+        if (us >= 200000 || iterations >= (INT64_C(1) << 40)) {
+            break;
+        }
+        iterations *= (us < 1000) ? 10 : 2;
+    }
+    double ns = us * 1000.0 / iterations;
+    double mbps = (static_cast<double>(size) * iterations / (1024 * 1024)) / (us / 1000000.0);
+    std::cout << std::left << std::setw(28) << name
+        << std::right << std::setw(14) << std::fixed << std::setprecision(1) << ns << " ns"
+        << std::setw(12) << iterations;
+    if (size > 0) {
+        std::cout << "  bytes_per_second=" << std::setprecision(0) << mbps << "MB/s";
+    }
+    std::cout << std::endl;
+}
+
+static int bench_crc64()
+{
+    std::vector<char> data(16 * 1024 * 1024);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(i * 131 + 7);
+    }
+    std::cout << "#### hardware accelerated=" << CRC64::HardwareAccelerated() << std::endl;
+    std::cout << std::left << std::setw(28) << "Benchmark" << std::right << std::setw(17) << "Time"
+        << std::setw(12) << "Iterations" << std::endl;
+
+    volatile uint64_t sink = 0;
+    for (size_t size : { 64, 256, 1024, 4096, 16384, 65536, 1024 * 1024, 16 * 1024 * 1024 }) {
+        std::string suffix = "/" + std::to_string(size);
+        run_throughput("BM_CRC64Table" + suffix, size, [&]() {
+            sink = sink + CRC64::CalcCRCTable(0, data.data(), size);
+        });
+        run_throughput("BM_CRC64" + suffix, size, [&]() {
+            sink = sink + CRC64::CalcCRC(0, data.data(), size);
+        });
+    }
+    return 0;
+}
+
+static int bench_crc64_combine()
+{
+    volatile uint64_t sink = 0;
+    uint64_t crc = UINT64_C(0x0123456789abcdef);
+    //the part size of a resumable transfer, and lengths that never repeat
+    run_throughput("BM_CombineCRC/8MB", 0, [&]() {
+        sink = sink + CRC64::CombineCRC(crc, sink, 8 * 1024 * 1024);
+    });
+    uint64_t len = 1;
+    run_throughput("BM_CombineCRC/varying", 0, [&]() {
+        len = len * 6364136223846793005ULL + 1442695040888963407ULL;
+        sink = sink + CRC64::CombineCRC(crc, sink, len >> 24);
+    });
+    return 0;
+}
+
+static int bench_file_crc64()
+{
+    const int64_t fileSize = 512LL * 1024 * 1024;
+    const std::string path = "bench_file_crc64.dat";
+    {
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        std::vector<char> block(1024 * 1024);
+        for (size_t i = 0; i < block.size(); i++) {
+            block[i] = static_cast<char>(i * 131 + 7);
+        }
+        for (int64_t i = 0; i < fileSize / static_cast<int64_t>(block.size()); i++) {
+            out.write(block.data(), block.size());
+        }
+    }
+    std::cout << "#### file=" << fileSize / (1024 * 1024) << "MB (page cache), cores="
+        << std::thread::hardware_concurrency() << std::endl;
+
+    uint64_t first = 0;
+    for (uint32_t threadNum : { 1, 2, 4, 8 }) {
+        uint64_t crc = 0;
+        auto start = BenchClock::now();
+        bool ok = ComputeFileCRC64(path, threadNum, crc);
+        auto us = elapsed_us(start, BenchClock::now());
+        if (threadNum == 1) {
+            first = crc;
+        }
+        std::cout << "threads=" << std::setw(3) << threadNum
+            << " MB/s=" << std::setw(8) << (fileSize / (1024 * 1024)) * 1000000 / (us > 0 ? us : 1)
+            << " crc " << (ok && crc == first ? "match" : "MISMATCH") << std::endl;
+    }
+    std::remove(path.c_str());
+    return 0;
+}
+
+/*Content-MD5 benchmark, many small bodies one by one vs the multi-buffer batch*/
+/*a full ListObjects page, as the service returns it*/
+static std::string list_page_xml(int keyNum)
+{
+    std::stringstream ss;
+    ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+       << "<ListBucketResult>\n"
+       << "  <Name>bench-bucket</Name>\n  <Prefix>data/</Prefix>\n  <Marker></Marker>\n"
+       << "  <MaxKeys>" << keyNum << "</MaxKeys>\n  <Delimiter></Delimiter>\n"
+       << "  <IsTruncated>true</IsTruncated>\n  <NextMarker>data/2019/04/26/object-"
+       << keyNum - 1 << ".dat</NextMarker>\n";
+    for (int i = 0; i < keyNum; i++) {
+        ss << "  <Contents>\n"
+           << "    <Key>data/2019/04/26/object-" << i << ".dat</Key>\n"
+           << "    <LastModified>2019-04-26T05:39:32.000Z</LastModified>\n"
+           << "    <ETag>&quot;5B3C1A2E053D763E1B002CC607C5" << std::hex << std::uppercase
+           << std::setw(4) << std::setfill('0') << (i & 0xFFFF) << std::dec << "&quot;</ETag>\n"
+           << "    <Type>Normal</Type>\n"
+           << "    <Size>" << 344606 + i << "</Size>\n"
+           << "    <StorageClass>Standard</StorageClass>\n"
+           << "    <Owner>\n      <ID>1305433xxx</ID>\n      <DisplayName>1305433xxx</DisplayName>\n    </Owner>\n"
+           << "  </Contents>\n";
+    }
+    ss << "</ListBucketResult>\n";
+    return ss.str();
+}
+
+/*the former result path: the body copied to a string, a document tree, then the fields copied out*/
+static size_t parse_list_page_dom(std::iostream &content)
+{
+    std::istreambuf_iterator<char> isb(content), end;
+    std::string str(isb, end);
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(str.c_str(), str.size()) != tinyxml2::XML_SUCCESS) {
+        return 0;
+    }
+    std::vector<std::vector<std::string>> summaries;
+    auto root = doc.RootElement();
+    for (auto node = root->FirstChildElement("Contents"); node; node = node->NextSiblingElement("Contents")) {
+        std::vector<std::string> fields;
+        for (const char *name : { "Key", "LastModified", "ETag", "Size", "StorageClass", "Type" }) {
+            auto field = node->FirstChildElement(name);
+            fields.push_back(field && field->GetText() ? field->GetText() : "");
+        }
+        auto owner = node->FirstChildElement("Owner");
+        if (owner) {
+            for (const char *name : { "ID", "DisplayName" }) {
+                auto field = owner->FirstChildElement(name);
+                fields.push_back(field && field->GetText() ? field->GetText() : "");
+            }
+        }
+        summaries.push_back(std::move(fields));
+    }
+    return summaries.size();
+}
+
+static int bench_list_parse()
+{
+    for (int keyNum : { 100, 1000 }) {
+        const std::string xml = list_page_xml(keyNum);
+        const size_t chunk = 16 * 1024;
+        std::cout << "#### keys/page=" << keyNum << " page bytes=" << xml.size() << std::endl;
+        size_t count = 0;
+        run_throughput("BM_ListPageDom", xml.size(), [&]() {
+            std::stringstream content(xml);
+            count = parse_list_page_dom(content);
+        });
+        std::cout << "  summaries=" << count << std::endl;
+        run_throughput("BM_ListPageStream", xml.size(), [&]() {
+            ListObjectsResult result(std::make_shared<std::stringstream>(xml));
+            count = result.ObjectSummarys().size();
+        });
+        std::cout << "  summaries=" << count << std::endl;
+        //as the body arrives from the transport, no copy of the page is kept
+        run_throughput("BM_ListPageOnReceive", xml.size(), [&]() {
+            ListObjectsResultParser parser;
+            for (size_t pos = 0; pos < xml.size(); pos += chunk) {
+                parser.feed(xml.data() + pos, std::min(chunk, xml.size() - pos));
+            }
+            ListObjectsResult result;
+            parser.finish(result);
+            count = result.ObjectSummarys().size();
+        });
+        std::cout << "  summaries=" << count << std::endl;
+    }
+    return 0;
+}
+
+static int bench_content_md5()
+{
+    const int objectNum = 20000;
+    for (size_t size : { 256, 1024, 4096, 16384 }) {
+        std::vector<std::shared_ptr<std::iostream>> contents;
+        for (int i = 0; i < objectNum; i++) {
+            std::string data(size, '\0');
+            for (size_t j = 0; j < size; j++) {
+                data[j] = static_cast<char>(i * 7 + j * 131);
+            }
+            contents.push_back(std::make_shared<std::stringstream>(data));
+        }
+
+        auto start = BenchClock::now();
+        std::vector<std::string> single;
+        for (auto &content : contents) {
+            single.push_back(ComputeContentMD5(*content));
+        }
+        auto singleUs = elapsed_us(start, BenchClock::now());
+
+        start = BenchClock::now();
+        auto batch = ComputeContentMD5(contents);
+        auto batchUs = elapsed_us(start, BenchClock::now());
+
+        std::cout << "size=" << std::setw(6) << size << " objects=" << objectNum
+            << " one by one(objects/s)=" << std::setw(8) << objectNum * INT64_C(1000000) / (singleUs > 0 ? singleUs : 1)
+            << " batch(objects/s)=" << std::setw(8) << objectNum * INT64_C(1000000) / (batchUs > 0 ? batchUs : 1)
+            << " md5 " << (single == batch ? "match" : "MISMATCH") << std::endl;
+    }
+    return 0;
+}
+
+/*request signing benchmark, the canonical string and the hmac of a typical put*/
+static int bench_sign()
+{
+    HeaderCollection headers;
+    headers[Http::CONTENT_TYPE] = "application/octet-stream";
+    headers[Http::CONTENT_LENGTH] = "1024";
+    headers[Http::DATE] = "Sat, 17 Oct 2026 12:00:00 GMT";
+    headers[Http::USER_AGENT] = "aliyun-sdk-cpp/1.9.2";
+    headers["x-oss-meta-owner"] = " bench ";
+    headers["X-OSS-Storage-Class"] = "Standard";
+    headers["x-oss-security-token"] = std::string(400, 't');
+    ParameterCollection parameters;
+    parameters["partNumber"] = "12";
+    parameters["uploadId"] = "0004B9895DBBB6EC98E36";
+    parameters["max-keys"] = "100";
+
+    HmacSha1Signer signer;
+    const std::string secret = "kHh2zx9SX6zmHLuExqBcAJ1Ii4hA0e";
+    std::string signature;
+    const int64_t signNum = 200000;
+    for (int round = 0; round < 2; round++) {
+        auto start = BenchClock::now();
+        for (int64_t i = 0; i < signNum; i++) {
+            SignUtils signUtils(signer.version());
+            signUtils.build("PUT", "/bucket/dir/object-key.dat", headers.at(Http::DATE), headers, parameters);
+            signature = signer.generate(signUtils.CanonicalString(), secret);
+        }
+        auto us = elapsed_us(start, BenchClock::now());
+        std::cout << "signs/s=" << std::setw(8) << signNum * 1000000 / (us > 0 ? us : 1)
+            << " ns/sign=" << std::setw(6) << us * 1000 / signNum
+            << " signature=" << signature << std::endl;
+    }
+    return 0;
+}
+
+/*presigned urls of many keys, one call per key vs the batch on one core and on all of them*/
+static int bench_presign()
+{
+    ClientConfiguration conf;
+    OssClient client("oss-cn-hangzhou.aliyuncs.com", "LTAI4Fw2NbDUiJ9xnQ3Pk8mZ", "kHh2zx9SX6zmHLuExqBcAJ1Ii4hA0e", conf);
+    const size_t keyNum = 100000;
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < keyNum; i++) {
+        keys.push_back("video/2026/10/18/segment-" + std::to_string(i) + ".ts");
+    }
+    const int64_t expires = 1792300000;
+
+    auto report = [&](const char *name, int64_t us, int64_t allocs) {
+        std::cout << std::left << std::setw(14) << name << std::right
+            << " urls/s=" << std::setw(9) << static_cast<int64_t>(keyNum) * 1000000 / (us > 0 ? us : 1)
+            << " ns/url=" << std::setw(6) << us * 1000 / static_cast<int64_t>(keyNum)
+            << " allocs/url=" << std::fixed << std::setprecision(1) << static_cast<double>(allocs) / keyNum << std::endl;
+    };
+
+    std::vector<std::string> urls;
+    std::vector<std::string> batchUrls;
+    for (int round = 0; round < 2; round++) {
+        g_allocs = 0;
+        g_countAllocs = true;
+        auto start = BenchClock::now();
+        for (size_t i = 0; i < keyNum; i++) {
+            auto outcome = client.GeneratePresignedUrl("bucket", keys[i], expires, Http::Get);
+        }
+        auto us = elapsed_us(start, BenchClock::now());
+        g_countAllocs = false;
+        report("single", us, g_allocs);
+
+        //under the threading threshold, one core
+        const size_t batchSize = 256;
+        std::vector<std::string> batch(batchSize);
+        g_allocs = 0;
+        g_countAllocs = true;
+        start = BenchClock::now();
+        for (size_t i = 0; i < keyNum; i += batchSize) {
+            batch.assign(keys.begin() + i, keys.begin() + std::min(i + batchSize, keyNum));
+            client.GeneratePresignedUrls("bucket", batch, expires, Http::Get, batchUrls);
+        }
+        us = elapsed_us(start, BenchClock::now());
+        g_countAllocs = false;
+        report("batch-1core", us, g_allocs);
+
+        g_allocs = 0;
+        g_countAllocs = true;
+        start = BenchClock::now();
+        client.GeneratePresignedUrls("bucket", keys, expires, Http::Get, urls);
+        us = elapsed_us(start, BenchClock::now());
+        g_countAllocs = false;
+        report("batch-cores", us, g_allocs);
+    }
+    std::cout << "cores=" << std::thread::hardware_concurrency() << " url=" << urls.back() << std::endl;
+    return 0;
+}
+
+/*the stream per call url encoding the codec replaced, as the baseline*/
+static std::string stream_url_encode(const std::string &src)
+{
+    std::stringstream dest;
+    static const char *hex = "0123456789ABCDEF";
+    for (unsigned char c : src) {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            dest << c;
+        }
+        else {
+            dest << '%' << hex[c >> 4] << hex[c & 15];
+        }
+    }
+    return dest.str();
+}
+
+/*url coding throughput by kernel on plain and on utf-8 keys, and the digest encodings*/
+static int bench_codec()
+{
+    std::string plain;
+    std::string utf8;
+    while (plain.size() < 4096) {
+        plain.append("logs/2026-10-18/app_server-").append(std::to_string(plain.size())).append(".log.gz");
+        utf8.append("\xE8\xA7\x86\xE9\xA2\x91/\xE7\xAC\xAC").append(std::to_string(utf8.size())).append("\xE9\x9B\x86 clip.mp4");
+    }
+    const int64_t bytesPerRound = 64 * 1024 * 1024;
+    auto report = [](const std::string &name, int64_t bytes, int64_t us) {
+        std::cout << std::left << std::setw(24) << name << std::right
+            << " MB/s=" << std::setw(8) << bytes / (us > 0 ? us : 1) << std::endl;
+    };
+
+    auto active = Codec::ActiveKernel();
+    const char *kernelNames[] = { "scalar", "sse2", "avx2" };
+    for (const auto *input : { &plain, &utf8 }) {
+        const char *inputName = input == &plain ? "plain" : "utf8";
+        int64_t calls = bytesPerRound / static_cast<int64_t>(input->size());
+        std::string encoded;
+        auto start = BenchClock::now();
+        for (int64_t i = 0; i < calls / 8; i++) {
+            encoded = stream_url_encode(*input);
+        }
+        report(std::string("encode-stream-") + inputName, bytesPerRound / 8, elapsed_us(start, BenchClock::now()));
+
+        for (auto kernel : { Codec::Scalar, Codec::Sse2, Codec::Avx2 }) {
+            if (!Codec::setKernel(kernel)) {
+                continue;
+            }
+            start = BenchClock::now();
+            for (int64_t i = 0; i < calls; i++) {
+                encoded.clear();
+                Codec::UrlEncode(input->data(), input->size(), encoded);
+            }
+            report(std::string("encode-") + kernelNames[kernel] + "-" + inputName, bytesPerRound, elapsed_us(start, BenchClock::now()));
+
+            std::string decoded;
+            start = BenchClock::now();
+            for (int64_t i = 0; i < calls; i++) {
+                decoded.clear();
+                Codec::UrlDecode(encoded.data(), encoded.size(), decoded);
+            }
+            report(std::string("decode-") + kernelNames[kernel] + "-" + inputName,
+                calls * static_cast<int64_t>(encoded.size()), elapsed_us(start, BenchClock::now()));
+        }
+    }
+    Codec::setKernel(active);
+
+    //digest sized inputs, etag hex and content-md5 base64
+    const unsigned char digest[16] = { 0x9e, 0x10, 0x7d, 0x9d, 0x37, 0x2b, 0xb6, 0x82, 0x6b, 0xd8, 0x1d, 0x35, 0x42, 0xa4, 0x19, 0xd6 };
+    const int64_t digestNum = 2000000;
+    std::string out;
+    auto start = BenchClock::now();
+    for (int64_t i = 0; i < digestNum; i++) {
+        out.clear();
+        Codec::HexEncode(digest, sizeof(digest), out);
+    }
+    auto us = elapsed_us(start, BenchClock::now());
+    std::cout << "hex-16B                  ns/op=" << std::setw(6) << us * 1000 / digestNum << std::endl;
+    start = BenchClock::now();
+    for (int64_t i = 0; i < digestNum; i++) {
+        out.clear();
+        Codec::Base64Encode(reinterpret_cast<const char *>(digest), sizeof(digest), out);
+    }
+    us = elapsed_us(start, BenchClock::now());
+    std::cout << "base64-16B               ns/op=" << std::setw(6) << us * 1000 / digestNum << std::endl;
+    return 0;
+}
+
+/*the header work of one request, as the client does it: build, check, sign and hand to curl,
+  then parse the response lines, look up the crc64 and request id, and copy out for the result*/
+template <typename Headers, typename SetLine, typename Has, typename Find>
+static void run_headers(int64_t requestNum, const HeaderCollection &requestHeaders, const std::vector<std::string> &lines,
+    SetLine setLine, Has has, Find find, int64_t &allocs, int64_t &us)
+{
+    SignUtils signUtils("1.0");
+    ParameterCollection parameters;
+    std::string date = "Sat, 18 Oct 2026 12:00:00 GMT";
+    std::string slistLine;
+    size_t sink = 0;
+    g_allocs = 0;
+    g_countAllocs = true;
+    auto start = BenchClock::now();
+    for (int64_t i = 0; i < requestNum; i++) {
+        Headers request;
+        for (const auto &header : requestHeaders) {
+            request.set(header.first, header.second);
+        }
+        request.set(Http::USER_AGENT, "aliyun-sdk-cpp/1.9.2 (Linux/6.1; x86_64)");
+        if (!has(request, "x-oss-date") && !has(request, Http::DATE)) {
+            request.set(Http::DATE, date);
+        }
+        if (!has(request, Http::CONTENT_LENGTH)) {
+            request.set(Http::CONTENT_LENGTH, "1048576");
+        }
+        if (!has(request, Http::CONTENT_MD5)) {
+            request.set(Http::CONTENT_MD5, "nhB9nTcrtoJr2B01QqQZ1g==");
+        }
+        signUtils.build("PUT", "/bucket/dir/object", date, request, parameters);
+        request.set(Http::AUTHORIZATION, "OSS LTAI4Fw2NbDUiJ9xnQ3Pk8mZ:dcraOrvCrWLMAA7adAlCGt+DfQE=");
+        for (const auto &header : request) {
+            slistLine.assign(find.name(header)).append(": ").append(find.value(header));
+            sink += slistLine.size();
+        }
+
+        Headers response;
+        for (const auto &line : lines) {
+            setLine(response, line);
+        }
+        sink += has(response, Http::CONTENT_LENGTH) ? 1 : 0;
+        sink += find(response, "x-oss-hash-crc64ecma").size();
+        sink += find(response, "x-oss-request-id").size();
+        HeaderCollection result = find.collection(response);
+        sink += result.size();
+    }
+    us = elapsed_us(start, BenchClock::now());
+    g_countAllocs = false;
+    allocs = g_allocs;
+    if (sink == 0) {
+        std::cout << "";
+    }
+}
+
+/*the map the messages held before, with its line parsing*/
+struct MapHeaders : public HeaderCollection
+{
+    void set(const std::string &name, const std::string &value) { (*this)[name] = value; }
+};
+
+struct MapAccess
+{
+    std::string operator()(const MapHeaders &headers, const char *name) const
+    {
+        auto it = headers.find(name);
+        return it != headers.end() ? it->second : std::string();
+    }
+    const std::string &name(const HeaderCollection::value_type &header) const { return header.first; }
+    const std::string &value(const HeaderCollection::value_type &header) const { return header.second; }
+    HeaderCollection collection(const MapHeaders &headers) const { return headers; }
+};
+
+struct ListAccess
+{
+    std::string operator()(const HeaderList &headers, const char *name) const
+    {
+        auto value = headers.find(name);
+        return value != nullptr ? *value : std::string();
+    }
+    const std::string &name(const HeaderList::Entry &header) const { return header.name(); }
+    const std::string &value(const HeaderList::Entry &header) const { return header.value(); }
+    HeaderCollection collection(const HeaderList &headers) const { return headers.toHeaderCollection(); }
+};
+
+static int bench_headers()
+{
+    HeaderCollection requestHeaders;
+    requestHeaders[Http::CONTENT_TYPE] = "application/octet-stream";
+    requestHeaders["x-oss-meta-owner"] = "bench";
+    requestHeaders["x-oss-storage-class"] = "Standard";
+    requestHeaders["x-oss-security-token"] = std::string(400, 't');
+    std::vector<std::string> lines = {
+        "HTTP/1.1 200 OK\r\n",
+        "Server: AliyunOSS\r\n",
+        "Date: Sat, 18 Oct 2026 12:00:00 GMT\r\n",
+        "Content-Length: 0\r\n",
+        "Connection: keep-alive\r\n",
+        "x-oss-request-id: 5C06A3B67B8B5A3DA422299D\r\n",
+        "ETag: \"9E107D9D372BB6826BD81D3542A419D6\"\r\n",
+        "x-oss-hash-crc64ecma: 13781591981226417361\r\n",
+        "Content-MD5: nhB9nTcrtoJr2B01QqQZ1g==\r\n",
+        "x-oss-server-time: 21\r\n",
+        "x-oss-object-type: Normal\r\n",
+        "x-oss-storage-class: Standard\r\n",
+        "\r\n",
+    };
+    const int64_t requestNum = 100000;
+    for (int round = 0; round < 2; round++) {
+        int64_t allocs = 0;
+        int64_t us = 0;
+        //as recvHeaders did: the line, the name and the value as strings
+        run_headers<MapHeaders>(requestNum, requestHeaders, lines,
+            [](MapHeaders &headers, const std::string &buffer) {
+                std::string line(buffer);
+                auto pos = line.find(':');
+                if (pos != line.npos) {
+                    size_t posEnd = line.rfind('\r');
+                    if (posEnd != line.npos) {
+                        posEnd = posEnd - pos - 2;
+                    }
+                    std::string name = line.substr(0, pos);
+                    std::string value = line.substr(pos + 2, posEnd);
+                    headers.set(name, value);
+                }
+            },
+            [](const MapHeaders &headers, const char *name) { return headers.find(name) != headers.end(); },
+            MapAccess(), allocs, us);
+        std::cout << "map    ns/request=" << std::setw(6) << us * 1000 / requestNum
+            << " allocs/request=" << std::setw(4) << allocs / requestNum << std::endl;
+
+        run_headers<HeaderList>(requestNum, requestHeaders, lines,
+            [](HeaderList &headers, const std::string &line) {
+                const char *colon = static_cast<const char *>(memchr(line.data(), ':', line.size()));
+                if (colon != nullptr) {
+                    const char *value = colon + 1;
+                    const char *end = line.data() + line.size();
+                    while (value < end && *value == ' ') {
+                        value++;
+                    }
+                    while (end > value && (end[-1] == '\r' || end[-1] == '\n')) {
+                        end--;
+                    }
+                    headers.set(line.data(), static_cast<size_t>(colon - line.data()), value, static_cast<size_t>(end - value));
+                }
+            },
+            [](const HeaderList &headers, const char *name) { return headers.find(name) != nullptr; },
+            ListAccess(), allocs, us);
+        std::cout << "flat   ns/request=" << std::setw(6) << us * 1000 / requestNum
+            << " allocs/request=" << std::setw(4) << allocs / requestNum << std::endl;
+    }
+    return 0;
+}
+
+/*body stream benchmark, a response body written in curl sized chunks then read back*/
+template <typename Factory>
+static void run_body_pool(size_t bodySize, int64_t opNum, Factory factory, int64_t &allocs, int64_t &us)
+{
+    std::vector<char> chunk(16384, 'b');
+    std::vector<char> out(16384);
+    g_allocs = 0;
+    g_countAllocs = true;
+    auto start = BenchClock::now();
+    for (int64_t i = 0; i < opNum; i++) {
+        std::shared_ptr<std::iostream> body = factory();
+        for (size_t pos = 0; pos < bodySize; pos += chunk.size()) {
+            body->write(chunk.data(), static_cast<std::streamsize>(std::min(chunk.size(), bodySize - pos)));
+        }
+        while (body->read(out.data(), static_cast<std::streamsize>(out.size()))) {
+        }
+    }
+    us = elapsed_us(start, BenchClock::now());
+    g_countAllocs = false;
+    allocs = g_allocs;
+}
+
+static int bench_body_pool()
+{
+    const int64_t opNum = 100000;
+    auto pool = std::make_shared<BufferPool>();
+    for (size_t bodySize : { 1024, 4096, 16384, 65536 }) {
+        int64_t allocsA = 0, usA = 0, allocsB = 0, usB = 0;
+        run_body_pool(bodySize, opNum, [] { return std::make_shared<std::stringstream>(); }, allocsA, usA);
+        run_body_pool(bodySize, opNum, [&pool] { return std::make_shared<PooledBufferStream>(pool); }, allocsB, usB);
+        std::cout << "body=" << std::setw(6) << bodySize
+            << " std::stringstream allocs/op=" << std::setw(6) << std::fixed << std::setprecision(2) << static_cast<double>(allocsA) / opNum
+            << " ns/op=" << std::setw(6) << usA * 1000 / opNum
+            << " PooledBufferStream allocs/op=" << std::setw(6) << static_cast<double>(allocsB) / opNum
+            << " ns/op=" << std::setw(6) << usB * 1000 / opNum << std::endl;
+    }
+    auto stats = pool->Statistics();
+    std::cout << "pool acquires=" << stats.acquires << " hit rate=" << std::setprecision(4) << stats.HitRate()
+        << " pooled bytes=" << stats.pooledBytes << std::endl;
+    return 0;
+}
+
+/*bandwidth shaper benchmark, parallel downloads of two priorities under one client-wide limit*/
+static int bench_shaper()
+{
+    LocalOssServer server;
+    if (!server.start()) {
+        std::cout << "loopback server is not available." << std::endl;
+        return 1;
+    }
+    const int rateKBps = 8 * 1024;
+    const int threadNum = 32;
+    const int64_t durationMs = 3000;
+    const std::string data(64 * 1024, 'd');
+    std::cout << "#### limit=" << rateKBps << "KB/s, threads=" << threadNum << " (half High, half Low), "
+        << "object=64KB, duration=" << durationMs << "ms" << std::endl;
+
+    for (unsigned eventLoopThreadNum : { 0U, 2U }) {
+        auto limiter = std::make_shared<TokenBucketRateLimiter>(rateKBps);
+        ClientConfiguration conf;
+        conf.maxConnections = threadNum;
+        conf.recvRateLimiter = limiter;
+        conf.eventLoopThreadNum = eventLoopThreadNum;
+        OssClient client(server.endpoint(), "ak", "sk", conf);
+        client.PutObject("bucket", "object", std::make_shared<std::stringstream>(data));
+
+        std::atomic<int64_t> bytes[2];
+        bytes[0] = 0;
+        bytes[1] = 0;
+        auto start = BenchClock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadNum; i++) {
+            threads.emplace_back([&, i]() {
+                int index = i % 2;
+                while (elapsed_us(start, BenchClock::now()) < durationMs * 1000) {
+                    GetObjectRequest request("bucket", "object");
+                    request.setTransferPriority(index == 0 ? TransferPriority::High : TransferPriority::Low);
+                    auto outcome = client.GetObject(request);
+                    //the transfers still running at the end have the whole limit to themselves
+                    if (outcome.isSuccess() && elapsed_us(start, BenchClock::now()) < durationMs * 1000) {
+                        bytes[index] += outcome.result().Metadata().ContentLength();
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        auto us = durationMs * 1000;
+        int64_t total = bytes[0] + bytes[1];
+        std::cout << (eventLoopThreadNum > 0 ? "event loop" : "blocking  ")
+            << " KB/s=" << std::setw(8) << total * 1000000 / 1024 / (us > 0 ? us : 1)
+            << " of limit=" << std::fixed << std::setprecision(1) << std::setw(6) << 100.0 * total * 1000000 / 1024 / us / rateKBps << "%"
+            << " High:Low=" << std::setprecision(2) << (bytes[1] > 0 ? static_cast<double>(bytes[0]) / bytes[1] : 0.0)
+            << " (weights 4:1)" << std::endl;
+    }
+    server.stop();
+    return 0;
+}
+
+/*download sink benchmark, parallel parts written into one file the way ResumableDownloader does*/
+template <typename OpenPart>
+static int64_t run_download_sink(int threadNum, int64_t fileSize, int64_t partSize, const std::vector<char> &chunk, OpenPart openPart)
+{
+    std::atomic<int64_t> nextPart(0);
+    const int64_t partNum = fileSize / partSize;
+    std::vector<std::thread> workers;
+    auto start = BenchClock::now();
+    for (int i = 0; i < threadNum; i++) {
+        workers.emplace_back([&]() {
+            int64_t part;
+            while ((part = nextPart++) < partNum) {
+                std::shared_ptr<std::iostream> content = openPart(part * partSize);
+                for (int64_t written = 0; written < partSize; written += chunk.size()) {
+                    content->write(chunk.data(), chunk.size());
+                }
+                content->flush();
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    return elapsed_us(start, BenchClock::now());
+}
+
+static uint64_t file_crc64(const std::string &path, int64_t length, std::vector<char> &buffer)
+{
+    FileRegionStream content(path);
+    return drain_body(content, length, buffer, true);
+}
+
+static int bench_download_sink()
+{
+    const int64_t fileSize = 256LL * 1024 * 1024;
+    const int64_t partSize = 8LL * 1024 * 1024;
+    //tmpfs, so the numbers are about the write path rather than the disk
+    std::string dir = IsDirectoryExist("/dev/shm") ? "/dev/shm" : ".";
+    const std::string path = dir + "/bench_download_sink.dat";
+
+    //curl hands over up to 16KB (CURL_MAX_WRITE_SIZE) per write callback
+    std::vector<char> chunk(16384);
+    for (size_t i = 0; i < chunk.size(); i++) {
+        chunk[i] = static_cast<char>(i * 131 + 7);
+    }
+    std::cout << "#### file=" << path << ", size=" << fileSize / (1024 * 1024) << "MB, part="
+        << partSize / (1024 * 1024) << "MB, write size=" << chunk.size() << std::endl;
+
+    std::vector<char> buffer(1024 * 1024);
+    for (int threadNum : { 8, 16, 32 }) {
+        std::remove(path.c_str());
+        std::ofstream(path, std::ios::out | std::ios::app);
+        auto fstreamUs = run_download_sink(threadNum, fileSize, partSize, chunk, [&](int64_t pos) {
+            std::shared_ptr<std::iostream> content = std::make_shared<std::fstream>(path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+            content->seekp(pos, content->beg);
+            return content;
+        });
+        uint64_t crcA = file_crc64(path, fileSize, buffer);
+
+        std::remove(path.c_str());
+        std::ofstream(path, std::ios::out | std::ios::app);
+        auto file = std::make_shared<PositionalFile>(path);
+        file->preallocate(fileSize);
+        auto positionalUs = run_download_sink(threadNum, fileSize, partSize, chunk, [&](int64_t pos) {
+            return std::make_shared<PositionalWriteStream>(file, pos);
+        });
+        file = nullptr;
+        uint64_t crcB = file_crc64(path, fileSize, buffer);
+
+        std::cout << "threads=" << std::setw(3) << threadNum
+            << " std::fstream MB/s=" << std::setw(8) << (fileSize / (1024 * 1024)) * 1000000 / (fstreamUs > 0 ? fstreamUs : 1)
+            << " PositionalFile MB/s=" << std::setw(8) << (fileSize / (1024 * 1024)) * 1000000 / (positionalUs > 0 ? positionalUs : 1)
+            << " data " << (crcA == crcB ? "match" : "MISMATCH") << std::endl;
+    }
+    std::remove(path.c_str());
+    return 0;
+}
+
+/*hermetic end to end benchmark, the sdk against the loopback stand-in server*/
+class SharedBufferStream : public std::iostream
+{
+public:
+    //read only view of data, request bodies are not copied per op
+    explicit SharedBufferStream(const std::string &data) : std::iostream(&buf_), buf_(data) {}
+private:
+    struct Buf : public std::streambuf
+    {
+        explicit Buf(const std::string &data)
+        {
+            char *p = const_cast<char *>(data.data());
+            setg(p, p, p + data.size());
+        }
+        pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode) override
+        {
+            off_type base = way == std::ios_base::beg ? 0 : (way == std::ios_base::cur ? gptr() - eback() : egptr() - eback());
+            off_type pos = base + off;
+            if (pos < 0 || pos > egptr() - eback()) {
+                return pos_type(off_type(-1));
+            }
+            setg(eback(), eback() + pos, egptr());
+            return pos_type(pos);
+        }
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+    Buf buf_;
+};
+
+static int64_t process_cpu_us()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * INT64_C(1000000) +
+        usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#else
+    return 0;
+#endif
+}
+
+/*opNum ops spread over threadNum threads, op(index) returns false on failure*/
+template <typename Op>
+static void run_local(const std::string &name, int threadNum, int opNum, int64_t bytesPerOp, Op op)
+{
+    std::vector<int64_t> latencyUs(opNum);
+    std::atomic<int> nextOp(0);
+    std::atomic<int> failed(0);
+    std::vector<std::thread> workers;
+    int64_t cpuStart = process_cpu_us();
+    auto start = BenchClock::now();
+    for (int i = 0; i < threadNum; i++) {
+        workers.emplace_back([&]() {
+            int index;
+            while ((index = nextOp++) < opNum) {
+                auto begin = BenchClock::now();
+                if (!op(index)) {
+                    failed++;
+                }
+                latencyUs[index] = elapsed_us(begin, BenchClock::now());
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    int64_t us = elapsed_us(start, BenchClock::now());
+    int64_t cpuUs = process_cpu_us() - cpuStart;
+    us = us > 0 ? us : 1;
+
+    std::cout << std::left << std::setw(24) << name
+        << " ops/s=" << std::setw(9) << static_cast<int64_t>(opNum) * 1000000 / us;
+    if (bytesPerOp > 0) {
+        int64_t mb = bytesPerOp * opNum / (1024 * 1024);
+        std::cout << " MB/s=" << std::setw(7) << mb * 1000000 / us;
+    }
+    std::cout << " p50(us)=" << std::setw(9) << percentile(latencyUs, 0.50)
+        << " p99(us)=" << std::setw(9) << percentile(latencyUs, 0.99);
+    if (bytesPerOp >= 1024 * 1024) {
+        double gb = static_cast<double>(bytesPerOp) * opNum / (1024.0 * 1024 * 1024);
+        std::cout << " cpu(ms)/GB=" << std::setw(7) << static_cast<int64_t>(cpuUs / 1000 / gb);
+    }
+    else {
+        std::cout << " cpu(us)/op=" << std::setw(7) << cpuUs / (opNum > 0 ? opNum : 1);
+    }
+    std::cout << " failed=" << failed << std::endl;
+}
+
+static int bench_local()
+{
+    LocalOssServer::Options options;
+    options.latencyMs = Config::InjectLatencyMs;
+    options.bandwidthKBps = Config::InjectBandwidthKBPerSec;
+    options.errorRate = Config::InjectErrorRate;
+    options.slowEvery = Config::InjectSlowEvery;
+    options.slowLatencyMs = Config::InjectSlowLatencyMs;
+    LocalOssServer server(options);
+
+#ifndef _WIN32
+    //the server runs in a child process, so its cpu time is not in the client's getrusage
+    if (!server.listen()) {
+        std::cout << "loopback server is not available." << std::endl;
+        return 1;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        server.serve();
+        _exit(0);
+    }
+    if (child < 0) {
+        std::cout << "fork failed." << std::endl;
+        return 1;
+    }
+#else
+    if (!server.start()) {
+        std::cout << "loopback server is not available." << std::endl;
+        return 1;
+    }
+#endif
+
+    const int threadNum = std::max(Config::Multithread, 1);
+    const int loops = std::max(Config::LoopTimes, 1);
+    const std::string bucket = "bench-bucket";
+    ClientConfiguration conf;
+    conf.maxConnections = threadNum * 2 + 8;
+    //room for the auto-tuned transfers
+    conf.transferThreadNum = AutoTuneMaxThreadNum;
+    if (options.errorRate > 0) {
+        conf.retryStrategy = std::make_shared<JitterRetryStrategy>(10, 10, 200);
+    }
+    OssClient client(server.endpoint(), "ak", "sk", conf);
+
+    std::cout << "#### endpoint=" << server.endpoint() << ", threads=" << threadNum
+        << ", latency=" << options.latencyMs << "ms, bandwidth=" << options.bandwidthKBps
+        << "KB/s, errorRate=" << options.errorRate << ", slowEvery=" << options.slowEvery
+        << ", slowLatency=" << options.slowLatencyMs << "ms" << std::endl;
+
+    const std::string small(4 * 1024, 's');
+    std::string large(16 * 1024 * 1024, '\0');
+    for (size_t i = 0; i < large.size(); i++) {
+        large[i] = static_cast<char>(i * 131 + 7);
+    }
+    const int smallNum = 2000 * loops;
+    const int largeNum = 16 * loops;
+
+    run_local("put_object_4KB", threadNum, smallNum, small.size(), [&](int i) {
+        auto content = std::make_shared<SharedBufferStream>(small);
+        return client.PutObject(bucket, "small/" + std::to_string(i), content).isSuccess();
+    });
+    run_local("get_object_4KB", threadNum, smallNum, small.size(), [&](int i) {
+        return client.GetObject(bucket, "small/" + std::to_string(i)).isSuccess();
+    });
+    run_local("head_object", threadNum, smallNum, 0, [&](int i) {
+        return client.HeadObject(bucket, "small/" + std::to_string(i)).isSuccess();
+    });
+    run_local("put_object_16MB", threadNum, largeNum, large.size(), [&](int i) {
+        auto content = std::make_shared<SharedBufferStream>(large);
+        return client.PutObject(bucket, "large/" + std::to_string(i), content).isSuccess();
+    });
+    run_local("get_object_16MB", threadNum, largeNum, large.size(), [&](int i) {
+        return client.GetObject(bucket, "large/" + std::to_string(i)).isSuccess();
+    });
+    const int64_t rangeSize = 64 * 1024;
+    run_local("range_get_64KB", threadNum, smallNum / 2, rangeSize, [&](int i) {
+        GetObjectRequest request(bucket, "large/0");
+        int64_t start = (static_cast<int64_t>(i) * 7919 * rangeSize) % (static_cast<int64_t>(large.size()) - rangeSize);
+        request.setRange(start, start + rangeSize - 1);
+        return client.GetObject(request).isSuccess();
+    });
+    //the 16MB objects read in 64KB chunks, 1MB ranges fetched ahead of the reader
+    for (int parallel : { 1, 4 }) {
+        run_local("object_reader_16MB_p" + std::to_string(parallel), threadNum, largeNum, large.size(), [&](int i) {
+            ObjectReader reader(client, bucket, "large/" + std::to_string(i), 1024 * 1024, parallel);
+            std::vector<char> buffer(static_cast<size_t>(rangeSize));
+            int64_t total = 0, n = 0;
+            while ((n = reader.read(buffer.data(), buffer.size())) > 0) {
+                total += n;
+            }
+            return n == 0 && total == static_cast<int64_t>(large.size());
+        });
+    }
+
+    //multipart upload of 64MB in 8MB parts, the parts of one upload are sent in order
+    const int64_t partSize = 8 * 1024 * 1024;
+    const std::string part = large.substr(0, static_cast<size_t>(partSize));
+    run_local("multipart_64MB", threadNum, 2 * loops, partSize * 8, [&](int i) {
+        std::string key = "multipart/" + std::to_string(i);
+        auto initOutcome = client.InitiateMultipartUpload(InitiateMultipartUploadRequest(bucket, key));
+        if (!initOutcome.isSuccess()) {
+            return false;
+        }
+        PartList partList;
+        for (int num = 1; num <= 8; num++) {
+            auto content = std::make_shared<SharedBufferStream>(part);
+            auto outcome = client.UploadPart(UploadPartRequest(bucket, key, num, initOutcome.result().UploadId(), content));
+            if (!outcome.isSuccess()) {
+                return false;
+            }
+            partList.push_back(Part(num, outcome.result().ETag()));
+        }
+        return client.CompleteMultipartUpload(CompleteMultipartUploadRequest(bucket, key, partList, initOutcome.result().UploadId())).isSuccess();
+    });
+    //the same 64MB written in 64KB chunks of unknown total length, parts sent while writing
+    for (int parallel : { 1, 4 }) {
+        run_local("object_writer_64MB_p" + std::to_string(parallel), threadNum, 2 * loops, partSize * 8, [&](int i) {
+            ObjectWriter writer(client, bucket, "writer/" + std::to_string(i), ObjectMetaData(), partSize, parallel);
+            for (int64_t pos = 0; pos < partSize * 8; pos += rangeSize) {
+                if (!writer.write(part.data() + pos % partSize, static_cast<size_t>(rangeSize))) {
+                    return false;
+                }
+            }
+            return writer.close();
+        });
+    }
+    //a 64MB file in 1MB parts, the caller's 3 threads vs auto-tuned from 3
+    const std::string resumablePath = "bench_local_resumable.dat";
+    {
+        std::ofstream out(resumablePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        for (int i = 0; i < 4; i++) {
+            out.write(large.data(), large.size());
+        }
+    }
+    for (int autoTune = 0; autoTune < 2; autoTune++) {
+        std::string suffix = autoTune ? "auto" : "t3";
+        run_local("resume_up_64MB_" + suffix, threadNum, loops, large.size() * 4, [&](int i) {
+            UploadObjectRequest request(bucket, "resumable/" + std::to_string(i), resumablePath, "", 1024 * 1024, 3);
+            request.setAutoTune(autoTune != 0);
+            return client.ResumableUploadObject(request).isSuccess();
+        });
+        run_local("resume_down_64MB_" + suffix, threadNum, loops, large.size() * 4, [&](int i) {
+            std::string path = resumablePath + ".download" + std::to_string(i);
+            DownloadObjectRequest request(bucket, "resumable/" + std::to_string(i), path, "", 1024 * 1024, 3);
+            request.setAutoTune(autoTune != 0);
+            bool done = client.ResumableDownloadObject(request).isSuccess();
+            std::remove(path.c_str());
+            return done;
+        });
+    }
+    //16 uploads of 4MB at once, 16 threads each, on the 32 transfer threads of the client
+    const std::string smallFilePath = resumablePath + ".4MB";
+    {
+        std::ofstream out(smallFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(large.data(), 4 * 1024 * 1024);
+    }
+    run_local("resume_up_16x4MB", threadNum, loops, 16 * 4 * 1024 * 1024, [&](int i) {
+        std::vector<std::thread> uploads;
+        std::atomic<int> done(0);
+        for (int n = 0; n < 16; n++) {
+            uploads.emplace_back([&, n]() {
+                UploadObjectRequest request(bucket, "shared/" + std::to_string(i) + "/" + std::to_string(n), smallFilePath, "", 256 * 1024, 16);
+                done += client.ResumableUploadObject(request).isSuccess() ? 1 : 0;
+            });
+        }
+        for (auto &upload : uploads) {
+            upload.join();
+        }
+        return done == 16;
+    });
+    std::remove(smallFilePath.c_str());
+    std::remove(resumablePath.c_str());
+
+    //1000 keys are in small/ from put_object_4KB
+    run_local("list_objects_1000", threadNum, 100 * loops, 0, [&](int) {
+        ListObjectsRequest request(bucket);
+        request.setPrefix("small/");
+        request.setMaxKeys(1000);
+        auto outcome = client.ListObjects(request);
+        return outcome.isSuccess() && outcome.result().ObjectSummarys().size() == 1000;
+    });
+    //the whole listing in 100 key pages, one lister at a time. The keys have hashed
+    //names, the layout recommended for large buckets, so the sampled ranges are even
+    const int listNum = 4000;
+    const std::string empty;
+    run_local("put_object_0B", threadNum, listNum, 0, [&](int i) {
+        char name[32];
+        snprintf(name, sizeof(name), "lister/%08x", static_cast<unsigned>(i) * 2654435761U);
+        auto content = std::make_shared<SharedBufferStream>(empty);
+        return client.PutObject(bucket, name, content).isSuccess();
+    });
+    for (int parallel : { 1, 8 }) {
+        run_local("object_lister_p" + std::to_string(parallel), 1, 5 * loops, 0, [&](int) {
+            ListObjectsRequest request(bucket);
+            request.setPrefix("lister/");
+            request.setMaxKeys(100);
+            ObjectLister lister(client, request, parallel, false);
+            int count = 0;
+            ObjectSummaryList page;
+            while (lister.nextPage(page)) {
+                count += static_cast<int>(page.size());
+            }
+            return !lister.hasError() && count == listNum;
+        });
+    }
+    if (options.slowEvery > 0) {
+        ClientConfiguration hedgedConf = conf;
+        hedgedConf.enableHedgedGet = true;
+        OssClient hedged(server.endpoint(), "ak", "sk", hedgedConf);
+        //only the objects of a known size are hedged
+        for (int i = 0; i < smallNum / 4; i++) {
+            hedged.HeadObject(bucket, "small/" + std::to_string(i));
+        }
+        run_local("get_object_4KB_hedged", threadNum, smallNum / 4, small.size(), [&](int i) {
+            return hedged.GetObject(bucket, "small/" + std::to_string(i)).isSuccess();
+        });
+    }
+
+    run_local("delete_objects_1000", threadNum, 2 * loops, 0, [&](int i) {
+        DeleteObjectsRequest request(bucket);
+        DeletedKeyList keys;
+        for (int k = 0; k < 1000; k++) {
+            keys.push_back("small/" + std::to_string(i * 1000 + k));
+        }
+        request.setKeyList(keys);
+        request.setQuiet(true);
+        return client.DeleteObjects(request).isSuccess();
+    });
+    //keys/s of the batch deleter by requests in flight, the keys need not exist
+    const int deleteNum = 20000 * loops;
+    for (int parallel : { 1, 4, 8 }) {
+        BatchDeleter deleter(client, bucket, parallel);
+        int64_t cpuStart = process_cpu_us();
+        for (int i = 0; i < deleteNum; i++) {
+            deleter.add("batch/" + std::to_string(i));
+        }
+        bool done = deleter.flush();
+        std::cout << std::left << std::setw(24) << ("batch_deleter_p" + std::to_string(parallel))
+            << " keys/s=" << std::setw(9) << static_cast<int64_t>(deleter.KeysPerSecond())
+            << " requests=" << deleter.RequestCount()
+            << " cpu(us)/key=" << std::setprecision(2) << std::fixed
+            << static_cast<double>(process_cpu_us() - cpuStart) / deleteNum
+            << " failed=" << (done ? 0 : 1) << std::endl;
+    }
+    {
+        BatchDeleter deleter(client, bucket, 8);
+        bool done = deleter.deletePrefix("lister/", 4);
+        std::cout << std::left << std::setw(24) << "batch_deleter_prefix"
+            << " keys/s=" << std::setw(9) << static_cast<int64_t>(deleter.KeysPerSecond())
+            << " deleted=" << deleter.DeletedCount()
+            << " failed=" << ((done && deleter.DeletedCount() == listNum) ? 0 : 1) << std::endl;
+    }
+
+#ifndef _WIN32
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+#else
+    server.stop();
+#endif
+    return 0;
+}
+
+/*a retry of a 10000 part CompleteMultipartUpload against a server that always fails*/
+static int bench_retry()
+{
+    LocalOssServer::Options options;
+    options.errorRate = 1.0;
+    LocalOssServer server(options);
+#ifndef _WIN32
+    if (!server.listen()) {
+        std::cout << "loopback server is not available." << std::endl;
+        return 1;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        server.serve();
+        _exit(0);
+    }
+    if (child < 0) {
+        std::cout << "fork failed." << std::endl;
+        return 1;
+    }
+#else
+    if (!server.start()) {
+        std::cout << "loopback server is not available." << std::endl;
+        return 1;
+    }
+#endif
+
+    PartList parts;
+    for (int32_t i = 1; i <= 10000; i++) {
+        parts.push_back(Part(i, "\"5B3C1A2E053D763E1B002CC607C5A0FE" + std::to_string(i) + "\""));
+    }
+    CompleteMultipartUploadRequest request("bench-bucket", "object", parts, "0004B9895DBBB6EC98E36");
+    const int requestNum = 20;
+    const long retries = 20;
+    int64_t cpuUs[2] = { 0, 0 };
+    int64_t allocs[2] = { 0, 0 };
+    for (int round = 0; round < 2; round++) {
+        ClientConfiguration conf;
+        conf.retryStrategy = std::make_shared<JitterRetryStrategy>(round == 0 ? 0 : retries, 0, 0);
+        OssClient client(server.endpoint(), "ak", "sk", conf);
+        client.CompleteMultipartUpload(request);
+        g_allocs = 0;
+        g_countAllocs = true;
+        int64_t cpuStart = process_cpu_us();
+        for (int i = 0; i < requestNum; i++) {
+            client.CompleteMultipartUpload(request);
+        }
+        cpuUs[round] = process_cpu_us() - cpuStart;
+        g_countAllocs = false;
+        allocs[round] = g_allocs;
+    }
+
+    std::cout << std::left << std::setw(24) << "complete_10000_parts"
+        << " first_attempt_cpu_us=" << std::setw(9) << cpuUs[0] / requestNum
+        << " first_attempt_allocs=" << std::setw(9) << allocs[0] / requestNum
+        << " retry_cpu_us=" << std::setw(9) << (cpuUs[1] - cpuUs[0]) / (requestNum * retries)
+        << " retry_allocs=" << (allocs[1] - allocs[0]) / (requestNum * retries) << std::endl;
+
+#ifndef _WIN32
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+#else
+    server.stop();
+#endif
+    return 0;
+}
+
+struct BenchmarkEntry
+{
+    const char *command;
+    const char *desc;
+    int(*fn)();
+};
+
+static const BenchmarkEntry Benchmarks[] =
+{
+    { "bench_executor", "async executor dispatch latency and peak thread count", bench_executor },
+    { "bench_upload_body", "file part read throughput of the upload body, fstream vs FileRegionStream", bench_upload_body },
+    { "bench_crc64", "crc64 throughput from 64B to 16MB, table vs the dispatched kernel", bench_crc64 },
+    { "bench_crc64_combine", "CombineCRC cost for a repeating part size and for varying lengths", bench_crc64_combine },
+    { "bench_file_crc64", "ComputeFileCRC64 throughput by thread count", bench_file_crc64 },
+    { "bench_content_md5", "Content-MD5 of many small bodies, one by one vs multi-buffer batch", bench_content_md5 },
+    { "bench_sign", "signs per second of the canonical string build plus hmac-sha1", bench_sign },
+    { "bench_presign", "presigned urls per second, one call per key vs the batch api", bench_presign },
+    { "bench_codec", "url encode/decode MB/s by kernel vs the stream version, hex and base64 of a digest", bench_codec },
+    { "bench_headers", "header handling cost per request and response, map vs the flat HeaderList", bench_headers },
+    { "bench_download_sink", "parallel part write throughput of the download sink, fstream vs PositionalFile", bench_download_sink },
+    { "bench_shaper", "aggregate download rate and priority split under one client-wide recv limit", bench_shaper },
+    { "bench_body_pool", "heap allocations and time per 1KB to 64KB body, stringstream vs PooledBufferStream", bench_body_pool },
+    { "bench_list_parse", "ListObjects page parse, document tree vs streaming, time per page and MB/s", bench_list_parse },
+    { "bench_retry", "client cpu and allocations of the first attempt and of a retry of a 10000 part CompleteMultipartUpload", bench_retry },
+    { "bench_local", "put/get/range/multipart/list/delete against a loopback server, see --inject*", bench_local },
+};
+
+bool AlibabaCloud::OSS::PTest::IsBenchmarkCommand(const std::string &command)
+{
+    return command.compare(0, 6, "bench_") == 0;
+}
+
+int AlibabaCloud::OSS::PTest::RunBenchmark(const std::string &command)
+{
+    for (auto const &entry : Benchmarks) {
+        if (command == entry.command) {
+            return entry.fn();
+        }
+    }
+    std::cout << "Unknown benchmark command:" << command << std::endl;
+    PrintBenchmarkHelp();
+    return 1;
+}
+
+void AlibabaCloud::OSS::PTest::PrintBenchmarkHelp()
+{
+    std::cout << "\nOffline benchmarks (no oss.ini needed) :  \n";
+    for (auto const &entry : Benchmarks) {
+        std::cout << "    cpp-sdk-ptest -c " << std::left << std::setw(24) << entry.command << entry.desc << "\n";
+    }
+}
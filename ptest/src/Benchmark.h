@@ -0,0 +1,15 @@
+#include <string>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+namespace PTest
+{
+    /*offline micro benchmarks, they do not need oss.ini*/
+    bool IsBenchmarkCommand(const std::string &command);
+    int RunBenchmark(const std::string &command);
+    void PrintBenchmarkHelp();
+}
+}
+}
@@ -1,6 +1,7 @@
 #include <string.h>
 #include <string>
 #include "Config.h"
+#include "Benchmark.h"
 #include <sstream>
 #include <iostream>
 #include <fstream>
@@ -30,6 +31,12 @@ bool Config::DifferentSource = false;
 bool Config::CrcCheck = true;
 int Config::SpeedKBPerSec = 0;   //
 
+int Config::InjectLatencyMs = 0;
+int Config::InjectBandwidthKBPerSec = 0;
+double Config::InjectErrorRate = 0.0;
+int Config::InjectSlowEvery = 0;
+int Config::InjectSlowLatencyMs = 1000;
+
 bool Config::Debug = false;
 bool Config::DumpDetail = false;
 bool Config::PrintPercentile = false;
@@ -97,6 +104,11 @@ void Config::PrintHelp()
     std::cout << "  --limit SPEED       Whether to limit the upload or download speed, in kB/s.  \n";
     std::cout << "  --detail            print detail inforamtion for each testcase. \n";
     std::cout << "  --percentile        print the 90th and 95th percentile value. \n";
+    std::cout << "  --injectLatency MS  bench_local: latency added to every response.  \n";
+    std::cout << "  --injectBandwidth KB  bench_local: per connection bandwidth, in kB/s.  \n";
+    std::cout << "  --injectErrorRate R bench_local: share of requests answered with 503.  \n";
+    std::cout << "  --injectSlowEvery N bench_local: every Nth request is slow, see --injectSlowLatency.  \n";
+    std::cout << "  --injectSlowLatency MS  bench_local: latency of the slow requests, default 1000.  \n";
 
 
     std::cout << "\nExamples :  \n";
@@ -115,6 +127,7 @@ void Config::PrintHelp()
     std::cout << "    cpp-sdk-ptest -c download_async -f mylocalfilename -k myobjectkeyname \n";
     std::cout << "    cpp-sdk-ptest -c dna -f mylocalfilename -k myobjectkeyname -m 5 \n";
     std::cout << "    cpp-sdk-ptest -c dn -f mylocalfilename -k myobjectkeyname -m 5 \n";
+    PrintBenchmarkHelp();
 }
 
 void Config::PrintCfgInfo()
@@ -244,6 +257,26 @@ int Config::ParseArg(int argc, char **argv)
             else if (!strcmp("--percentile", argv[i])) {
                 Config::PrintPercentile = true;
             }
+            else if (!strcmp("--injectLatency", argv[i])) {
+                Config::InjectLatencyMs = std::atoi(argv[i + 1]);
+                i++;
+            }
+            else if (!strcmp("--injectBandwidth", argv[i])) {
+                Config::InjectBandwidthKBPerSec = std::atoi(argv[i + 1]);
+                i++;
+            }
+            else if (!strcmp("--injectErrorRate", argv[i])) {
+                Config::InjectErrorRate = std::atof(argv[i + 1]);
+                i++;
+            }
+            else if (!strcmp("--injectSlowEvery", argv[i])) {
+                Config::InjectSlowEvery = std::atoi(argv[i + 1]);
+                i++;
+            }
+            else if (!strcmp("--injectSlowLatency", argv[i])) {
+                Config::InjectSlowLatencyMs = std::atoi(argv[i + 1]);
+                i++;
+            }
         }
         i++;
     };
@@ -290,4 +323,4 @@ int Config::LoadCfgFile()
     }
 
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -39,6 +39,13 @@ namespace PTest
 
         static int SpeedKBPerSec;
 
+        /*fault injection of the bench_local stand-in server*/
+        static int InjectLatencyMs;
+        static int InjectBandwidthKBPerSec;
+        static double InjectErrorRate;
+        static int InjectSlowEvery;
+        static int InjectSlowLatencyMs;
+
         static bool Debug;
         static bool DumpDetail;
         static bool PrintPercentile;
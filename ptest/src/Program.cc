@@ -3,6 +3,7 @@
 #include <iostream>
 #include <memory>
 #include "Config.h"
+#include "Benchmark.h"
 #include <fstream>
 #include <future>
 #include <thread>
@@ -616,6 +617,10 @@ int main(int argc, char **argv)
         return 0;
     }
 
+    if (IsBenchmarkCommand(Config::Command)) {
+        return RunBenchmark(Config::Command);
+    }
+
     if (Config::LoadCfgFile() != 0) {
         return 0;
     }
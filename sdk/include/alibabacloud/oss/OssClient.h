@@ -40,6 +40,8 @@ namespace OSS
     /*Utils*/
     std::string ALIBABACLOUD_OSS_EXPORT ComputeContentMD5(const char *data, size_t size);
     std::string ALIBABACLOUD_OSS_EXPORT ComputeContentMD5(std::istream& stream);
+    /*Content-MD5 of many bodies at once, small bodies are hashed in parallel lanes*/
+    std::vector<std::string> ALIBABACLOUD_OSS_EXPORT ComputeContentMD5(const std::vector<std::shared_ptr<std::iostream>>& contents);
     std::string ALIBABACLOUD_OSS_EXPORT ComputeContentETag(const char* data, size_t size);
     std::string ALIBABACLOUD_OSS_EXPORT ComputeContentETag(std::istream& stream);
     std::string ALIBABACLOUD_OSS_EXPORT UrlEncode(const std::string& src);
@@ -53,6 +55,7 @@ namespace OSS
     std::time_t ALIBABACLOUD_OSS_EXPORT UtcToUnixTime(const std::string& t);
     uint64_t    ALIBABACLOUD_OSS_EXPORT ComputeCRC64(uint64_t crc, void* buf, size_t len);
     uint64_t    ALIBABACLOUD_OSS_EXPORT CombineCRC64(uint64_t crc1, uint64_t crc2, uintmax_t len2);
+    bool        ALIBABACLOUD_OSS_EXPORT ComputeFileCRC64(const std::string& filePath, uint32_t threadNum, uint64_t& crc64);
 
     /*Aysnc APIs*/
     class OssClient;
@@ -61,12 +64,14 @@ namespace OSS
     using PutObjectAsyncHandler = std::function<void(const AlibabaCloud::OSS::OssClient*, const PutObjectRequest&, const PutObjectOutcome&, const std::shared_ptr<const AsyncCallerContext>&)>;
     using UploadPartAsyncHandler = std::function<void(const AlibabaCloud::OSS::OssClient*, const UploadPartRequest&, const PutObjectOutcome&, const std::shared_ptr<const AsyncCallerContext>&)>;
     using UploadPartCopyAsyncHandler = std::function<void(const AlibabaCloud::OSS::OssClient*, const UploadPartCopyRequest&, const UploadPartCopyOutcome&, const std::shared_ptr<const AsyncCallerContext>&)>;
+    using DeleteObjectsAsyncHandler = std::function<void(const AlibabaCloud::OSS::OssClient*, const DeleteObjectsRequest&, const DeleteObjecstOutcome&, const std::shared_ptr<const AsyncCallerContext>&)>;
 
     /*Callable*/
     using ListObjectOutcomeCallable = std::future<ListObjectOutcome>;
     using GetObjectOutcomeCallable  = std::future<GetObjectOutcome>;
     using PutObjectOutcomeCallable  = std::future<PutObjectOutcome>;
     using UploadPartCopyOutcomeCallable = std::future<UploadPartCopyOutcome>;
+    using DeleteObjectsOutcomeCallable = std::future<DeleteObjecstOutcome>;
 
     class OssClientImpl;
     class ALIBABACLOUD_OSS_EXPORT OssClient
@@ -194,6 +199,8 @@ namespace OSS
         StringOutcome GeneratePresignedUrl(const std::string& bucket, const std::string& key) const;
         StringOutcome GeneratePresignedUrl(const std::string& bucket, const std::string& key, int64_t expires) const;
         StringOutcome GeneratePresignedUrl(const std::string& bucket, const std::string& key, int64_t expires, Http::Method method) const;
+        /*urls[i] is the url of keys[i], the strings of urls are reused*/
+        VoidOutcome GeneratePresignedUrls(const std::string& bucket, const std::vector<std::string>& keys, int64_t expires, Http::Method method, std::vector<std::string>& urls) const;
         GetObjectOutcome GetObjectByUrl(const GetObjectByUrlRequest& request) const;
         GetObjectOutcome GetObjectByUrl(const std::string& url) const;
         GetObjectOutcome GetObjectByUrl(const std::string& url, const std::string& file) const;
@@ -228,6 +235,7 @@ namespace OSS
         void PutObjectAsync(const PutObjectRequest& request, const PutObjectAsyncHandler& handler, const std::shared_ptr<const AsyncCallerContext>& context = nullptr) const;
         void UploadPartAsync(const UploadPartRequest& request, const UploadPartAsyncHandler& handler, const std::shared_ptr<const AsyncCallerContext>& context = nullptr) const;
         void UploadPartCopyAsync(const UploadPartCopyRequest& request, const UploadPartCopyAsyncHandler& handler, const std::shared_ptr<const AsyncCallerContext>& context = nullptr) const;
+        void DeleteObjectsAsync(const DeleteObjectsRequest& request, const DeleteObjectsAsyncHandler& handler, const std::shared_ptr<const AsyncCallerContext>& context = nullptr) const;
 
         /*Callable APIs*/
         ListObjectOutcomeCallable ListObjectsCallable(const ListObjectsRequest& request) const;
@@ -235,6 +243,7 @@ namespace OSS
         PutObjectOutcomeCallable PutObjectCallable(const PutObjectRequest& request) const;
         PutObjectOutcomeCallable UploadPartCallable(const UploadPartRequest& request) const;
         UploadPartCopyOutcomeCallable UploadPartCopyCallable(const UploadPartCopyRequest& request) const;
+        DeleteObjectsOutcomeCallable DeleteObjectsCallable(const DeleteObjectsRequest& request) const;
 
         /*Extended APIs*/
         bool DoesBucketExist(const std::string& bucket) const;
@@ -23,6 +23,7 @@
 #include <alibabacloud/oss/OssError.h>
 #include <alibabacloud/oss/ServiceResult.h>
 #include <alibabacloud/oss/utils/Outcome.h>
+#include <alibabacloud/oss/utils/FileRegionStream.h>
 #include <alibabacloud/oss/model/VoidResult.h>
 #include <alibabacloud/oss/model/ListBucketsRequest.h>
 #include <alibabacloud/oss/model/ListBucketsResult.h>
@@ -91,7 +91,9 @@ namespace OSS
             partSize_(partSize),
             checkpointDir_(checkpointDir),
             requestPayer_(AlibabaCloud::OSS::RequestPayer::NotSet),
-            trafficLimit_(0)
+            trafficLimit_(0),
+            autoTune_(false),
+            checkpointSyncInterval_(0)
         {
             threadNum_ = threadNum == 0 ? 1 : threadNum;
         }
@@ -123,6 +125,15 @@ namespace OSS
         void setTrafficLimit(uint64_t value);
         uint64_t TrafficLimit() const;
 
+        /*ThreadNum parts in flight to begin with, then ramped up to AutoTuneMaxThreadNum
+          and larger parts by the measured throughput*/
+        void setAutoTune(bool enable);
+        bool AutoTune() const;
+
+        /*fsync the checkpoint journal every interval parts, 0 leaves the flushing to the system*/
+        void setCheckpointSyncInterval(uint32_t interval);
+        uint32_t CheckpointSyncInterval() const;
+
     protected:
         friend class OssClientImpl;
         virtual int validate() const;
@@ -136,6 +147,8 @@ namespace OSS
         std::string mtime_;
         AlibabaCloud::OSS::RequestPayer requestPayer_;
         uint64_t trafficLimit_;
+        bool autoTune_;
+        uint32_t checkpointSyncInterval_;
     };
 
     class ALIBABACLOUD_OSS_EXPORT LiveChannelRequest : public OssRequest
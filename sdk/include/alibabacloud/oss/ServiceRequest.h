@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <iostream>
 #include <alibabacloud/oss/Export.h>
@@ -48,6 +49,17 @@ namespace OSS
         
         const AlibabaCloud::OSS::TransferProgress& TransferProgress() const;
         void setTransferProgress(const AlibabaCloud::OSS::TransferProgress& arg);
+
+        /*the share of the client bandwidth limits, and for the resumable transfers
+          the order of their parts on the transfer threads of the client*/
+        void setTransferPriority(AlibabaCloud::OSS::TransferPriority priority);
+        AlibabaCloud::OSS::TransferPriority TransferPriority() const;
+
+        /*once the flag is set the transfer of the request is aborted and not retried,
+          e.g. a read-ahead nobody reads any more*/
+        void setCancelFlag(const std::shared_ptr<std::atomic<bool>> &flag);
+        const std::shared_ptr<std::atomic<bool>> &CancelFlag() const;
+        bool isCancelled() const;
     protected:
         ServiceRequest();
         void setPath(const std::string &path);
@@ -56,6 +68,8 @@ namespace OSS
         std::string path_;
         IOStreamFactory responseStreamFactory_;
         AlibabaCloud::OSS::TransferProgress transferProgress_;
+        AlibabaCloud::OSS::TransferPriority transferPriority_;
+        std::shared_ptr<std::atomic<bool>> cancelFlag_;
     };
 }
 }
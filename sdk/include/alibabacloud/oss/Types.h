@@ -98,6 +98,13 @@ namespace OSS
         Requester
     };
 
+    enum class TransferPriority
+    {
+        High = 0,
+        Normal,
+        Low
+    };
+
     typedef void(*LogCallback)(LogLevel level, const std::string& stream);
 
     struct  ALIBABACLOUD_OSS_EXPORT caseSensitiveLess
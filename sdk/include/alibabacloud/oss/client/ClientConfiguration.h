@@ -15,6 +15,7 @@
  */
 
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <alibabacloud/oss/auth/CredentialsProvider.h>
@@ -97,21 +98,71 @@ namespace OSS
         */
         bool enableCrc64;
         /**
+        * Send the Content-MD5 of the object data of PutObject and UploadPart, so the
+        * server rejects a corrupted body. It takes a pass over the body before the send,
+        * the crc64 is computed in the same pass. Default false.
+        */
+        bool enableContentMd5;
+        /**
         * enable or disable auto correct http request date.
         */
         bool enableDateSkewAdjustment;
         /**
-        * Rate limit data upload speed.
+        * Rate limit of the data upload of all the transfers of the client together,
+        * and of the other clients with the same limiter. See RateLimiter.
         */
         std::shared_ptr<RateLimiter> sendRateLimiter;
         /**
-        * Rate limit data download speed.
+        * Rate limit of the data download, shared the same way.
         */
         std::shared_ptr<RateLimiter> recvRateLimiter;
         /**
         * The interface for outgoing traffic. E.g. eth0 in linux
         */
         std::string networkInterface;
+        /**
+        * Worker threads for async requests. Default 0, the same as maxConnections.
+        */
+        unsigned executorThreadNum;
+        /**
+        * Max queued async requests, submitting blocks when it is reached. 0 means no limit.
+        */
+        unsigned executorQueueDepth;
+        /**
+        * Event loop threads of the event driven http engine (curl multi), which serves
+        * the async apis without a thread per request. Default 0, use the blocking engine.
+        */
+        unsigned eventLoopThreadNum;
+        /**
+        * Keep-alive connections opened to the endpoint when the client is created,
+        * so the first requests skip the dns lookup and the tcp/tls handshake. Default 0.
+        */
+        unsigned prewarmConnections;
+        /**
+        * Send a second GET when the first one takes longer than hedgeDelayMs and use the
+        * response that comes first, the other one is cancelled. Cuts the tail latency of
+        * small reads, the bodies are buffered in memory and the GETs of a blocking client
+        * take two threads of the executor. Default false.
+        */
+        bool enableHedgedGet;
+        /**
+        * Delay of the hedged GET. Default 0, the p95 latency of the recent GETs.
+        */
+        long hedgeDelayMs;
+        /**
+        * Largest object a GET is hedged for, the size is the one the last GET or HEAD of the
+        * object returned. Ranged GETs and objects of unknown size are never hedged. Default 1 MB.
+        */
+        int64_t hedgeMaxSize;
+        /**
+        * Threads shared by the parts of all the resumable transfers of the client.
+        * Default 0, the same as maxConnections.
+        */
+        unsigned transferThreadNum;
+        /**
+        * Max bytes of the resumable parts in flight over all the transfers. Default 0, no limit.
+        */
+        uint64_t transferMaxInflightBytes;
     };
 }
 }
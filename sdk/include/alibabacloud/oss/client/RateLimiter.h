@@ -16,19 +16,50 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <alibabacloud/oss/Export.h>
+#include <alibabacloud/oss/Types.h>
 
 namespace AlibabaCloud
 {
 namespace OSS
 {
-    /*the unit of rate is kB/S*/
+    /*
+    * The unit of rate is kB/S. The rate is the limit of all the transfers of the clients
+    * the limiter is set on together: they take their bytes from one token bucket per
+    * limiter, so a limiter set on several clients caps them all. Transfers of different
+    * priorities share the rate by PriorityWeight while they compete for it.
+    */
     class  ALIBABACLOUD_OSS_EXPORT RateLimiter
     {
     public:
         virtual ~RateLimiter() {}
         virtual void setRate(int rate) = 0;
         virtual int Rate() const = 0;
+        /*the bytes an idle bucket may save up, 0 means 100ms of the rate*/
+        virtual int64_t Burst() const { return 0; }
+        virtual int PriorityWeight(TransferPriority priority) const
+        {
+            return priority == TransferPriority::High ? 4 : priority == TransferPriority::Normal ? 2 : 1;
+        }
+    };
+
+    class  ALIBABACLOUD_OSS_EXPORT TokenBucketRateLimiter : public RateLimiter
+    {
+    public:
+        TokenBucketRateLimiter(int rate = 0, int64_t burst = 0);
+        void setRate(int rate) override;
+        int Rate() const override;
+        void setBurst(int64_t burst);
+        int64_t Burst() const override;
+        /*a weight below 1 counts as 1*/
+        void setPriorityWeight(TransferPriority priority, int weight);
+        int PriorityWeight(TransferPriority priority) const override;
+    private:
+        std::atomic<int> rate_;
+        std::atomic<int64_t> burst_;
+        std::atomic<int> weights_[3];
     };
 } 
 }
@@ -17,6 +17,9 @@
 #pragma once
 
 #include <alibabacloud/oss/client/Error.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
 
 namespace AlibabaCloud
 {
@@ -28,6 +31,48 @@ namespace OSS
         virtual ~RetryStrategy() {}
         virtual bool shouldRetry(const Error& error, long attemptedRetries) const = 0;
         virtual long calcDelayTimeMs(const Error& error, long attemptedRetries) const = 0;
+
+        /*server errors, skewed time and the transient network errors*/
+        static bool isRetryableError(const Error& error);
+    };
+
+    /**
+    * Exponential backoff with decorrelated jitter, delay = min(maxDelay, random(baseDelay, 3 * previous delay)).
+    * Clients failing at the same time spread their retries out instead of retrying in lockstep.
+    */
+    class  ALIBABACLOUD_OSS_EXPORT JitterRetryStrategy : public RetryStrategy
+    {
+    public:
+        JitterRetryStrategy(long maxRetries = 3, long baseDelayMs = 300, long maxDelayMs = 20000);
+        bool shouldRetry(const Error& error, long attemptedRetries) const override;
+        long calcDelayTimeMs(const Error& error, long attemptedRetries) const override;
+    private:
+        long maxRetries_;
+        long baseDelayMs_;
+        long maxDelayMs_;
+    };
+
+    /**
+    * Limits the retries of all the requests sharing it with a token bucket. Each retry takes
+    * a token and the bucket refills at tokensPerSecond, so a degraded service sees at most
+    * that many retries per second on top of the requests instead of a retry storm.
+    * The decision whether and when to retry is left to the wrapped strategy.
+    */
+    class  ALIBABACLOUD_OSS_EXPORT RetryBudgetStrategy : public RetryStrategy
+    {
+    public:
+        RetryBudgetStrategy(const std::shared_ptr<RetryStrategy>& strategy, double maxTokens = 100, double tokensPerSecond = 10);
+        bool shouldRetry(const Error& error, long attemptedRetries) const override;
+        long calcDelayTimeMs(const Error& error, long attemptedRetries) const override;
+        double AvailableTokens() const;
+    private:
+        void refill() const;
+        std::shared_ptr<RetryStrategy> strategy_;
+        double maxTokens_;
+        double tokensPerSecond_;
+        mutable std::mutex lock_;
+        mutable double tokens_;
+        mutable std::chrono::steady_clock::time_point lastRefill_;
     };
 } 
 }
@@ -46,6 +46,7 @@ namespace OSS
         const std::vector<std::string>& MatchingETagsConstraint() const { return matchingETags_; }
         const std::vector<std::string>& NonmatchingETagsConstraint() const { return nonmatchingETags_;}
         const std::map<std::string, std::string>& ResponseHeaderParameters() const { return responseHeaderParameters_; }
+        bool DirectIO() const { return directIO_; }
 
         void setRange(int64_t start, int64_t end);
         void setModifiedSinceConstraint(const std::string& gmt);
@@ -53,6 +54,8 @@ namespace OSS
         void setMatchingETagConstraints(const std::vector<std::string>& match);
         void setNonmatchingETagConstraints(const std::vector<std::string>& match);
         void addResponseHeaders(RequestResponseHeader header, const std::string& value);
+        /*write the parts with O_DIRECT where the file system supports it, bypassing the page cache*/
+        void setDirectIO(bool directIO);
 
     protected:
         virtual int validate() const;
@@ -70,6 +73,7 @@ namespace OSS
         std::shared_ptr<std::iostream> content_;
 
         std::map<std::string, std::string> responseHeaderParameters_;
+        bool directIO_;
     };
 }
 }
\ No newline at end of file
@@ -55,6 +55,7 @@ namespace OSS
         const CommonPrefixeList& CommonPrefixes() const { return commonPrefixes_; }
         const AlibabaCloud::OSS::MultipartUploadList& MultipartUploadList() const { return multipartUploadList_; }
     private:
+        friend class ListMultipartUploadsResultParser;
         std::string bucket_;
         std::string keyMarker_;
         std::string uploadIdMarker_;
@@ -42,6 +42,11 @@ namespace OSS
         void setPrefix(const std::string& prefix) { prefix_ = prefix; prefixIsSet_ = true; }
         void setEncodingType(const std::string& type) { encodingType_ = type; encodingTypeIsSet_ = true; }
         void setRequestPayer(RequestPayer value) { requestPayer_ = value; }
+        const std::string& Delimiter() const { return delimiter_; }
+        const std::string& Marker() const { return marker_; }
+        int MaxKeys() const { return maxKeysIsSet_ ? maxKeys_ : -1; }
+        const std::string& Prefix() const { return prefix_; }
+        const std::string& EncodingType() const { return encodingType_; }
 
     protected:
         virtual ParameterCollection specialParameters() const;
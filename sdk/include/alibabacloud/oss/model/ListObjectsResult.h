@@ -40,6 +40,7 @@ namespace OSS
         const AlibabaCloud::OSS::Owner& Owner() const { return owner_; }
     private:
         friend class ListObjectsResult;
+        friend class ListObjectsResultParser;
         std::string key_;
         std::string eTag_;
         int64_t size_;
@@ -69,6 +70,7 @@ namespace OSS
         const CommonPrefixeList& CommonPrefixes() const { return commonPrefixes_; }
         const ObjectSummaryList& ObjectSummarys() const { return objectSummarys_; }
     private:
+        friend class ListObjectsResultParser;
         std::string name_;
         std::string prefix_;
         std::string marker_;
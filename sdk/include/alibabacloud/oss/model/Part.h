@@ -36,6 +36,7 @@ namespace OSS
         const std::string& ETag() const { return eTag_; }
     private:
         friend class ListPartsResult;
+        friend class ListPartsResultParser;
         friend class ResumableUploader;
         friend class ResumableCopier;
         int32_t partNumber_;
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <alibabacloud/oss/Export.h>
+#include <alibabacloud/oss/OssError.h>
+#include <alibabacloud/oss/model/DeleteObjectsRequest.h>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class OssClient;
+    class BatchDeleterState;
+
+    /*
+    * Deletes any number of keys of a bucket with DeleteObjects. The keys are grouped in
+    * batches of up to 1000 keys, sent through DeleteObjectsAsync with at most parallel
+    * requests in flight; add blocks while they are all busy. A key missing from the
+    * Deleted list of its result is sent again, up to maxAttempts times in all. The keys
+    * are url encoded in the request body, so any key can be deleted.
+    * The client must outlive the deleter.
+    */
+    class ALIBABACLOUD_OSS_EXPORT BatchDeleter
+    {
+    public:
+        BatchDeleter(const OssClient& client, const std::string& bucket, int parallel = 4);
+        /*flushes the pending keys*/
+        ~BatchDeleter();
+
+        /*set before the first add*/
+        void setBatchSize(size_t size);
+        void setMaxAttempts(int attempts);
+        void setRequestPayer(RequestPayer value);
+
+        /*false once a request failed, the key is not queued then*/
+        bool add(const std::string& key);
+        /*deletes every key listed under prefix, the listing runs ahead of the deletes*/
+        bool deletePrefix(const std::string& prefix, int listParallel = 1);
+        /*sends the partial batch and waits for all the requests, false if any key was not deleted*/
+        bool flush();
+
+        int64_t DeletedCount() const;
+        int64_t RequestCount() const;
+        /*keys of the failed requests and keys still there after the last attempt*/
+        DeletedKeyList FailedKeys() const;
+        /*deleted keys per second from the first add to the last result*/
+        double KeysPerSecond() const;
+
+        bool hasError() const;
+        OssError error() const;
+
+    private:
+        BatchDeleter(const BatchDeleter&) = delete;
+        BatchDeleter& operator=(const BatchDeleter&) = delete;
+        std::shared_ptr<BatchDeleterState> state_;
+    };
+}
+}
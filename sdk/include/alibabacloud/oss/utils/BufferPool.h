@@ -0,0 +1,151 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <alibabacloud/oss/Export.h>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /*
+    * Free lists of byte blocks in the size classes 4KB, 16KB, 64KB, 256KB and 1MB, so the
+    * bodies of small requests and responses reuse memory instead of going to the allocator
+    * each time. Each class keeps at most its share of maxPooledBytes, a block given back
+    * to a full class and a block bigger than 1MB are freed. Thread safe.
+    */
+    class ALIBABACLOUD_OSS_EXPORT BufferPool
+    {
+    public:
+        struct Stats
+        {
+            uint64_t acquires;
+            //acquires served from a free list
+            uint64_t hits;
+            uint64_t releases;
+            //releases freed instead of kept
+            uint64_t drops;
+            //bytes kept in the free lists
+            uint64_t pooledBytes;
+            double HitRate() const { return acquires == 0 ? 0.0 : static_cast<double>(hits) / acquires; }
+        };
+        static const size_t SizeClassNum = 5;
+        static const size_t MinBlockSize = 4 * 1024;
+        static const size_t MaxBlockSize = 1024 * 1024;
+
+        explicit BufferPool(size_t maxPooledBytes = 16 * 1024 * 1024);
+        ~BufferPool();
+
+        /*the pool of the default response and payload streams*/
+        static const std::shared_ptr<BufferPool>& Default();
+
+        /*a block of at least size bytes, capacity is set to its real size*/
+        char* acquire(size_t size, size_t& capacity);
+        void release(char* block, size_t capacity);
+        /*frees the blocks in the free lists*/
+        void clear();
+        Stats Statistics() const;
+
+    private:
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+        struct SizeClass
+        {
+            std::mutex lock;
+            std::vector<char*> blocks;
+            size_t maxBlocks;
+        };
+        SizeClass classes_[SizeClassNum];
+        std::atomic<uint64_t> acquires_;
+        std::atomic<uint64_t> hits_;
+        std::atomic<uint64_t> releases_;
+        std::atomic<uint64_t> drops_;
+        std::atomic<uint64_t> pooledBytes_;
+    };
+
+    /*
+    * Growable byte buffer on blocks of a BufferPool, with the stream buffer interface of
+    * std::stringbuf: independent read and write positions, seeks within the written bytes.
+    * data() and size() give the bytes without going through a stream. Growing moves the
+    * bytes to a block of the next fitting class, the old block goes back to the pool.
+    */
+    class ALIBABACLOUD_OSS_EXPORT PooledBuffer : public std::streambuf
+    {
+    public:
+        explicit PooledBuffer(const std::shared_ptr<BufferPool>& pool = BufferPool::Default(), size_t reserve = 0);
+        ~PooledBuffer();
+
+        char* data() { return data_; }
+        const char* data() const { return data_; }
+        /*the bytes written, up to the furthest write position*/
+        size_t size() const;
+        size_t capacity() const { return capacity_; }
+        void reserve(size_t size);
+        /*keeps the first size bytes, the positions are moved into them*/
+        void resize(size_t size);
+        /*writes at the end, the write position follows*/
+        void append(const char* data, size_t size);
+        void clear();
+        std::string str() const;
+
+    protected:
+        int_type underflow() override;
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+        std::streamsize showmanyc() override;
+        pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which) override;
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+    private:
+        PooledBuffer(const PooledBuffer&) = delete;
+        PooledBuffer& operator=(const PooledBuffer&) = delete;
+        void syncSize();
+        void grow(size_t size);
+        void setPositions(size_t readPos, size_t writePos);
+
+        std::shared_ptr<BufferPool> pool_;
+        char* data_;
+        size_t capacity_;
+        //the end of the bytes written, pptr() may be past it
+        size_t size_;
+    };
+
+    /*iostream over a PooledBuffer, the default response stream of the requests*/
+    class ALIBABACLOUD_OSS_EXPORT PooledBufferStream : public std::iostream
+    {
+    public:
+        explicit PooledBufferStream(const std::shared_ptr<BufferPool>& pool = BufferPool::Default(), size_t reserve = 0) :
+            std::iostream(nullptr), buf_(pool, reserve) { rdbuf(&buf_); }
+
+        PooledBuffer& buffer() { return buf_; }
+        const PooledBuffer& buffer() const { return buf_; }
+
+    private:
+        PooledBufferStream(const PooledBufferStream&) = delete;
+        PooledBufferStream& operator=(const PooledBufferStream&) = delete;
+        PooledBuffer buf_;
+    };
+}
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <alibabacloud/oss/Export.h>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class FileRegionBuf;
+
+    /*
+    * Read only stream over the bytes [offset, offset + length) of a file, length -1 means
+    * up to the end of the file. Reads go straight from the file into the caller's buffer
+    * (pread), without the intermediate buffer of std::fstream, so an upload body is copied
+    * once, into the http layer. Positions are relative to the region. When the file can
+    * not be opened, the stream is in fail state.
+    */
+    class ALIBABACLOUD_OSS_EXPORT FileRegionStream : public std::iostream
+    {
+    public:
+        FileRegionStream(const std::string &path, int64_t offset = 0, int64_t length = -1);
+        ~FileRegionStream();
+
+        bool isOpen() const;
+        int64_t length() const;
+
+    private:
+        FileRegionStream(const FileRegionStream &) = delete;
+        FileRegionStream &operator = (const FileRegionStream &) = delete;
+        FileRegionBuf *buf_;
+    };
+}
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include <alibabacloud/oss/Export.h>
+#include <alibabacloud/oss/OssError.h>
+#include <alibabacloud/oss/model/ListObjectsRequest.h>
+#include <alibabacloud/oss/model/ListObjectsResult.h>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class OssClient;
+    class ObjectListerState;
+
+    /*
+    * Lazy listing of all the objects of a ListObjectsRequest, page by page. The next page
+    * is requested while the caller consumes the current one.
+    *
+    * With parallel > 1 the key space is split into disjoint marker ranges that are listed
+    * concurrently through ListObjectsAsync. The split keys come from setSplitKeys, else from
+    * the common prefixes of a "/" delimited listing, else from sampled first keys. ordered
+    * keeps the key order of a serial listing, otherwise pages are returned as they arrive.
+    * A request with a delimiter is listed serially. MaxKeys is the page size, 1000 when not
+    * set. The client must outlive the lister.
+    */
+    class ALIBABACLOUD_OSS_EXPORT ObjectLister
+    {
+    public:
+        class iterator
+        {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef ObjectSummary value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const ObjectSummary* pointer;
+            typedef const ObjectSummary& reference;
+
+            iterator() : lister_(nullptr) {}
+            reference operator*() const { return current_; }
+            pointer operator->() const { return &current_; }
+            iterator& operator++() { advance(); return *this; }
+            bool operator==(const iterator& other) const { return lister_ == other.lister_; }
+            bool operator!=(const iterator& other) const { return lister_ != other.lister_; }
+        private:
+            friend class ObjectLister;
+            explicit iterator(ObjectLister* lister) : lister_(lister) { advance(); }
+            void advance();
+            ObjectLister* lister_;
+            ObjectSummary current_;
+        };
+
+        ObjectLister(const OssClient& client, const ListObjectsRequest& request, int parallel = 1, bool ordered = true);
+        ~ObjectLister();
+
+        /*keys that split the parallel listing, (k[i-1], k[i]] is one range. Set before the first read.*/
+        void setSplitKeys(const std::vector<std::string>& keys);
+
+        /*false at the end of the listing or on error*/
+        bool nextPage(ObjectSummaryList& summaries, CommonPrefixeList& prefixes);
+        bool nextPage(ObjectSummaryList& summaries);
+        bool next(ObjectSummary& summary);
+
+        bool hasError() const;
+        const OssError& error() const;
+
+        /*for (const auto& summary : lister), check hasError() after the loop*/
+        iterator begin() { return iterator(this); }
+        iterator end() { return iterator(); }
+
+    private:
+        ObjectLister(const ObjectLister&) = delete;
+        ObjectLister& operator=(const ObjectLister&) = delete;
+        std::shared_ptr<ObjectListerState> state_;
+        ObjectSummaryList page_;
+        size_t pos_;
+        bool started_;
+    };
+}
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <alibabacloud/oss/Export.h>
+#include <alibabacloud/oss/OssError.h>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class OssClient;
+    class ObjectReaderState;
+
+    /*
+    * Reads an object like a file. The object is fetched in blocks of blockSize by range
+    * GETs through GetObjectAsync, ahead of the read cursor, into at most parallel buffers.
+    * The read-ahead window starts at two blocks, doubles while read waits for data and
+    * shrinks by one block once the blocks of a whole window were ready before they were
+    * needed. A seek within the fetched blocks keeps them, any other seek cancels the
+    * outstanding ranges and restarts the window: their buffers are reused at once and the
+    * rest of their data is dropped as it arrives. The object is opened by a HeadObject on
+    * first use and the ranges are bound to its ETag, so an object overwritten while it is
+    * read fails with PreconditionFailed instead of mixing versions.
+    * The client must outlive the reader.
+    */
+    class ALIBABACLOUD_OSS_EXPORT ObjectReader
+    {
+    public:
+        ObjectReader(const OssClient& client, const std::string& bucket, const std::string& key,
+            int64_t blockSize = 1024 * 1024, int parallel = 4);
+        ~ObjectReader();
+
+        /*the bytes read, 0 at the end of the object, -1 on error*/
+        int64_t read(char* buffer, size_t size);
+        /*false if the offset is past the end or the object can not be opened*/
+        bool seek(int64_t offset);
+        int64_t tell() const;
+
+        /*-1 if the object can not be opened*/
+        int64_t Size() const;
+        const std::string& ETag() const;
+        /*the current read-ahead window in blocks*/
+        int Window() const;
+
+        bool hasError() const;
+        OssError error() const;
+
+    private:
+        ObjectReader(const ObjectReader&) = delete;
+        ObjectReader& operator=(const ObjectReader&) = delete;
+        std::shared_ptr<ObjectReaderState> state_;
+    };
+}
+}
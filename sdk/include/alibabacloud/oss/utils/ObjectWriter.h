@@ -0,0 +1,74 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <alibabacloud/oss/Export.h>
+#include <alibabacloud/oss/Const.h>
+#include <alibabacloud/oss/OssError.h>
+#include <alibabacloud/oss/model/ObjectMetaData.h>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class OssClient;
+    class ObjectWriterState;
+
+    /*
+    * Uploads data of unknown length, e.g. from a pipe or a compressor, as it is written.
+    * The data is copied into part sized buffers; every full buffer is sent as a part of
+    * a multipart upload through UploadPartAsync while the caller keeps writing. At most
+    * parallel buffers exist, write blocks while they are all in flight, so the memory is
+    * bounded by parallel * partSize. close sends the last part and completes the upload,
+    * data smaller than one part is sent with a single PutObject instead.
+    * A writer destroyed without close aborts the upload. The client must outlive the writer.
+    */
+    class ALIBABACLOUD_OSS_EXPORT ObjectWriter
+    {
+    public:
+        ObjectWriter(const OssClient& client, const std::string& bucket, const std::string& key,
+            const ObjectMetaData& metaData = ObjectMetaData(), int64_t partSize = DefaultPartSize, int parallel = 4);
+        ~ObjectWriter();
+
+        /*false once the upload failed*/
+        bool write(const char* data, size_t size);
+        bool write(const std::string& data) { return write(data.data(), data.size()); }
+        /*completes the object, false if any request failed*/
+        bool close();
+        /*drops the upload and the parts sent so far*/
+        void abort();
+
+        int64_t Size() const;
+        int PartCount() const;
+        /*of the completed object*/
+        const std::string& ETag() const;
+        uint64_t CRC64() const;
+
+        bool hasError() const;
+        OssError error() const;
+
+    private:
+        ObjectWriter(const ObjectWriter&) = delete;
+        ObjectWriter& operator=(const ObjectWriter&) = delete;
+        std::shared_ptr<ObjectWriterState> state_;
+    };
+}
+}
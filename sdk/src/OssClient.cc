@@ -71,6 +71,11 @@ uint64_t AlibabaCloud::OSS::CombineCRC64(uint64_t crc1, uint64_t crc2, uintmax_t
 {
     return CRC64::CombineCRC(crc1, crc2, len2);
 }
+
+bool AlibabaCloud::OSS::ComputeFileCRC64(const std::string& filePath, uint32_t threadNum, uint64_t& crc64)
+{
+    return CRC64::CalcFileCRC(filePath, threadNum, crc64);
+}
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 
 OssClient::OssClient(const std::string &endpoint, const std::string & accessKeyId, const std::string & accessKeySecret, const ClientConfiguration & configuration) :
@@ -421,7 +426,7 @@ PutObjectOutcome OssClient::PutObject(const std::string &bucket, const std::stri
 
 PutObjectOutcome OssClient::PutObject(const std::string &bucket, const std::string &key, const std::string &fileToUpload) const
 {
-    std::shared_ptr<std::iostream> content = std::make_shared<std::fstream>(fileToUpload, std::ios::in|std::ios::binary);
+    std::shared_ptr<std::iostream> content = std::make_shared<FileRegionStream>(fileToUpload);
     return client_->PutObject(PutObjectRequest(bucket, key, content));
 }
 
@@ -432,7 +437,7 @@ PutObjectOutcome OssClient::PutObject(const std::string &bucket, const std::stri
 
 PutObjectOutcome OssClient::PutObject(const std::string &bucket, const std::string &key, const std::string &fileToUpload, const ObjectMetaData &meta) const
 {
-    std::shared_ptr<std::iostream> content = std::make_shared<std::fstream>(fileToUpload, std::ios::in | std::ios::binary);
+    std::shared_ptr<std::iostream> content = std::make_shared<FileRegionStream>(fileToUpload);
     return client_->PutObject(PutObjectRequest(bucket, key, content, meta));
 }
 
@@ -578,6 +583,11 @@ StringOutcome OssClient::GeneratePresignedUrl(const std::string &bucket, const s
     return GeneratePresignedUrl(request);
 }
 
+VoidOutcome OssClient::GeneratePresignedUrls(const std::string &bucket, const std::vector<std::string> &keys, int64_t expires, Http::Method method, std::vector<std::string> &urls) const
+{
+    return client_->GeneratePresignedUrls(bucket, keys, expires, method, urls);
+}
+
 GetObjectOutcome OssClient::GetObjectByUrl(const GetObjectByUrlRequest &request) const
 {
     return client_->GetObjectByUrl(request);
@@ -602,13 +612,13 @@ PutObjectOutcome OssClient::PutObjectByUrl(const PutObjectByUrlRequest &request)
 
 PutObjectOutcome OssClient::PutObjectByUrl(const std::string &url, const std::string &file) const
 {
-    std::shared_ptr<std::iostream> content = std::make_shared<std::fstream>(file, std::ios::in|std::ios::binary);
+    std::shared_ptr<std::iostream> content = std::make_shared<FileRegionStream>(file);
     return client_->PutObjectByUrl(PutObjectByUrlRequest(url, content));
 }
 
 PutObjectOutcome OssClient::PutObjectByUrl(const std::string &url, const std::string &file, const ObjectMetaData &metaData) const
 {
-    std::shared_ptr<std::iostream> content = std::make_shared<std::fstream>(file, std::ios::in | std::ios::binary);
+    std::shared_ptr<std::iostream> content = std::make_shared<FileRegionStream>(file);
     return client_->PutObjectByUrl(PutObjectByUrlRequest(url, content, metaData));
 }
 
@@ -660,6 +670,15 @@ ListPartsOutcome OssClient::ListParts(const ListPartsRequest &request) const
 /*Aysnc APIs*/
 void OssClient::ListObjectsAsync(const ListObjectsRequest &request, const ListObjectAsyncHandler &handler, const std::shared_ptr<const AsyncCallerContext>& context) const
 {
+    if (client_->isEventDriven()) {
+        auto req = std::make_shared<ListObjectsRequest>(request);
+        client_->ListObjectsAsync(req, [this, req, handler, context](const ListObjectOutcome &outcome)
+        {
+            handler(this, *req, outcome, context);
+        });
+        return;
+    }
+
     auto fn = [this, request, handler, context]()
     {
         handler(this, request, client_->ListObjects(request), context);
@@ -670,6 +689,15 @@ void OssClient::ListObjectsAsync(const ListObjectsRequest &request, const ListOb
 
 void OssClient::GetObjectAsync(const GetObjectRequest &request, const GetObjectAsyncHandler &handler, const std::shared_ptr<const AsyncCallerContext>& context) const
 {
+    if (client_->isEventDriven()) {
+        auto req = std::make_shared<GetObjectRequest>(request);
+        client_->GetObjectAsync(req, [this, req, handler, context](const GetObjectOutcome &outcome)
+        {
+            handler(this, *req, outcome, context);
+        });
+        return;
+    }
+
     auto fn = [this, request, handler, context]()
     {
         handler(this, request, client_->GetObject(request), context);
@@ -680,6 +708,15 @@ void OssClient::GetObjectAsync(const GetObjectRequest &request, const GetObjectA
 
 void OssClient::PutObjectAsync(const PutObjectRequest &request, const PutObjectAsyncHandler &handler, const std::shared_ptr<const AsyncCallerContext>& context) const
 {
+    if (client_->isEventDriven()) {
+        auto req = std::make_shared<PutObjectRequest>(request);
+        client_->PutObjectAsync(req, [this, req, handler, context](const PutObjectOutcome &outcome)
+        {
+            handler(this, *req, outcome, context);
+        });
+        return;
+    }
+
     auto fn = [this, request, handler, context]()
     {
         handler(this, request, client_->PutObject(request), context);
@@ -690,6 +727,15 @@ void OssClient::PutObjectAsync(const PutObjectRequest &request, const PutObjectA
 
 void OssClient::UploadPartAsync(const UploadPartRequest &request, const UploadPartAsyncHandler &handler, const std::shared_ptr<const AsyncCallerContext>& context) const
 {
+    if (client_->isEventDriven()) {
+        auto req = std::make_shared<UploadPartRequest>(request);
+        client_->UploadPartAsync(req, [this, req, handler, context](const PutObjectOutcome &outcome)
+        {
+            handler(this, *req, outcome, context);
+        });
+        return;
+    }
+
     auto fn = [this, request, handler, context]()
     {
         handler(this, request, client_->UploadPart(request), context);
@@ -700,6 +746,15 @@ void OssClient::UploadPartAsync(const UploadPartRequest &request, const UploadPa
 
 void OssClient::UploadPartCopyAsync(const UploadPartCopyRequest &request, const UploadPartCopyAsyncHandler &handler, const std::shared_ptr<const AsyncCallerContext>& context) const
 {
+    if (client_->isEventDriven()) {
+        auto req = std::make_shared<UploadPartCopyRequest>(request);
+        client_->UploadPartCopyAsync(req, [this, req, handler, context](const UploadPartCopyOutcome &outcome)
+        {
+            handler(this, *req, outcome, context);
+        });
+        return;
+    }
+
     auto fn = [this, request, handler, context]()
     {
         handler(this, request, client_->UploadPartCopy(request), context);
@@ -708,10 +763,38 @@ void OssClient::UploadPartCopyAsync(const UploadPartCopyRequest &request, const
     client_->asyncExecute(new Runnable(fn));
 }
 
+void OssClient::DeleteObjectsAsync(const DeleteObjectsRequest &request, const DeleteObjectsAsyncHandler &handler, const std::shared_ptr<const AsyncCallerContext>& context) const
+{
+    if (client_->isEventDriven()) {
+        auto req = std::make_shared<DeleteObjectsRequest>(request);
+        client_->DeleteObjectsAsync(req, [this, req, handler, context](const DeleteObjecstOutcome &outcome)
+        {
+            handler(this, *req, outcome, context);
+        });
+        return;
+    }
+
+    auto fn = [this, request, handler, context]()
+    {
+        handler(this, request, client_->DeleteObjects(request), context);
+    };
+
+    client_->asyncExecute(new Runnable(fn));
+}
+
 
 /*Callable APIs*/
 ListObjectOutcomeCallable OssClient::ListObjectsCallable(const ListObjectsRequest &request) const
 {
+    if (client_->isEventDriven()) {
+        auto promise = std::make_shared<std::promise<ListObjectOutcome>>();
+        client_->ListObjectsAsync(std::make_shared<ListObjectsRequest>(request), [promise](const ListObjectOutcome &outcome)
+        {
+            promise->set_value(outcome);
+        });
+        return promise->get_future();
+    }
+
     auto task = std::make_shared<std::packaged_task<ListObjectOutcome()>>(
         [this, request]()
     {
@@ -723,6 +806,15 @@ ListObjectOutcomeCallable OssClient::ListObjectsCallable(const ListObjectsReques
 
 GetObjectOutcomeCallable OssClient::GetObjectCallable(const GetObjectRequest &request) const
 {
+    if (client_->isEventDriven()) {
+        auto promise = std::make_shared<std::promise<GetObjectOutcome>>();
+        client_->GetObjectAsync(std::make_shared<GetObjectRequest>(request), [promise](const GetObjectOutcome &outcome)
+        {
+            promise->set_value(outcome);
+        });
+        return promise->get_future();
+    }
+
     auto task = std::make_shared<std::packaged_task<GetObjectOutcome()>>(
         [this, request]()
     {
@@ -735,6 +827,15 @@ GetObjectOutcomeCallable OssClient::GetObjectCallable(const GetObjectRequest &re
 
 PutObjectOutcomeCallable OssClient::PutObjectCallable(const PutObjectRequest &request) const
 {
+    if (client_->isEventDriven()) {
+        auto promise = std::make_shared<std::promise<PutObjectOutcome>>();
+        client_->PutObjectAsync(std::make_shared<PutObjectRequest>(request), [promise](const PutObjectOutcome &outcome)
+        {
+            promise->set_value(outcome);
+        });
+        return promise->get_future();
+    }
+
     auto task = std::make_shared<std::packaged_task<PutObjectOutcome()>>(
         [this, request]()
     {
@@ -746,6 +847,15 @@ PutObjectOutcomeCallable OssClient::PutObjectCallable(const PutObjectRequest &re
 
 PutObjectOutcomeCallable OssClient::UploadPartCallable(const UploadPartRequest &request) const
 {
+    if (client_->isEventDriven()) {
+        auto promise = std::make_shared<std::promise<PutObjectOutcome>>();
+        client_->UploadPartAsync(std::make_shared<UploadPartRequest>(request), [promise](const PutObjectOutcome &outcome)
+        {
+            promise->set_value(outcome);
+        });
+        return promise->get_future();
+    }
+
     auto task = std::make_shared<std::packaged_task<PutObjectOutcome()>>(
         [this, request]()
     {
@@ -757,6 +867,15 @@ PutObjectOutcomeCallable OssClient::UploadPartCallable(const UploadPartRequest &
 
 UploadPartCopyOutcomeCallable OssClient::UploadPartCopyCallable(const UploadPartCopyRequest &request) const
 {
+    if (client_->isEventDriven()) {
+        auto promise = std::make_shared<std::promise<UploadPartCopyOutcome>>();
+        client_->UploadPartCopyAsync(std::make_shared<UploadPartCopyRequest>(request), [promise](const UploadPartCopyOutcome &outcome)
+        {
+            promise->set_value(outcome);
+        });
+        return promise->get_future();
+    }
+
     auto task = std::make_shared<std::packaged_task<UploadPartCopyOutcome()>>(
         [this, request]()
     {
@@ -766,6 +885,26 @@ UploadPartCopyOutcomeCallable OssClient::UploadPartCopyCallable(const UploadPart
     return task->get_future();
 }
 
+DeleteObjectsOutcomeCallable OssClient::DeleteObjectsCallable(const DeleteObjectsRequest &request) const
+{
+    if (client_->isEventDriven()) {
+        auto promise = std::make_shared<std::promise<DeleteObjecstOutcome>>();
+        client_->DeleteObjectsAsync(std::make_shared<DeleteObjectsRequest>(request), [promise](const DeleteObjecstOutcome &outcome)
+        {
+            promise->set_value(outcome);
+        });
+        return promise->get_future();
+    }
+
+    auto task = std::make_shared<std::packaged_task<DeleteObjecstOutcome()>>(
+        [this, request]()
+    {
+        return this->DeleteObjects(request);
+    });
+    client_->asyncExecute(new Runnable([task]() { (*task)(); }));
+    return task->get_future();
+}
+
 /*Extended APIs*/
 bool OssClient::DoesBucketExist(const std::string &bucket) const
 {
@@ -858,4 +997,4 @@ CopyObjectOutcome OssClient::ResumableCopyObject(const MultiCopyObjectRequest &r
 GetObjectOutcome OssClient::ResumableDownloadObject(const DownloadObjectRequest &request) const 
 {
     return client_->ResumableDownloadObject(request);
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -18,12 +18,14 @@
 #include <algorithm>
 #include <sstream>
 #include <set>
+#include <thread>
 #include <tinyxml2/tinyxml2.h>
 #include <alibabacloud/oss/http/HttpType.h>
 #include <alibabacloud/oss/Const.h>
 #include <fstream>
 #include "utils/Utils.h"
 #include "utils/SignUtils.h"
+#include "utils/Codec.h"
 #include "auth/HmacSha1Signer.h"
 #include "OssClientImpl.h"
 #include "utils/LogUtils.h"
@@ -31,6 +33,7 @@
 #include "ResumableUploader.h"
 #include "ResumableDownloader.h"
 #include "ResumableCopier.h"
+#include "model/ListObjectsResultParser.h"
 
 using namespace AlibabaCloud::OSS;
 using namespace tinyxml2;
@@ -46,12 +49,29 @@ OssClientImpl::OssClientImpl(const std::string &endpoint, const std::shared_ptr<
     endpoint_(endpoint),
     credentialsProvider_(credentialsProvider),
     signer_(std::make_shared<HmacSha1Signer>()),
-    executor_(std::make_shared<Executor>())
+    executor_(std::make_shared<Executor>(
+        static_cast<int>(configuration.executorThreadNum > 0 ? configuration.executorThreadNum : configuration.maxConnections),
+        static_cast<int>(configuration.executorQueueDepth))),
+    transferManager_(std::make_shared<TransferManager>(
+        static_cast<int>(configuration.transferThreadNum > 0 ? configuration.transferThreadNum : configuration.maxConnections),
+        configuration.transferMaxInflightBytes))
 {
+    if (configuration.prewarmConnections > 0) {
+        BASE::prewarmRequest(CombineHostString(endpoint_, "", configuration.isCname) + "/", configuration.prewarmConnections);
+    }
 }
 
 OssClientImpl::~OssClientImpl()
 {
+    //finish the queued async requests before the client goes away
+    executor_->shutdown();
+    transferManager_->shutdown();
+    BASE::drainRequest();
+}
+
+Executor *OssClientImpl::executor() const
+{
+    return executor_.get();
 }
 
 int OssClientImpl::asyncExecute(Runnable * r) const
@@ -63,25 +83,44 @@ int OssClientImpl::asyncExecute(Runnable * r) const
     return 0;
 }
 
-std::shared_ptr<HttpRequest> OssClientImpl::buildHttpRequest(const std::string & endpoint, const ServiceRequest & msg, Http::Method method) const
+std::shared_ptr<HttpRequest> OssClientImpl::prepareHttpRequest(const std::string & endpoint, const ServiceRequest & msg, Http::Method method) const
 {
     auto httpRequest = std::make_shared<HttpRequest>(method);
-    auto calcContentMD5 = !!(msg.Flags()&REQUEST_FLAG_CONTENTMD5);
     auto paramInPath = !!(msg.Flags()&REQUEST_FLAG_PARAM_IN_PATH);
+    auto checkCRC64 = configuration().enableCrc64 && !!(msg.Flags()&REQUEST_FLAG_CHECK_CRC64);
+    //the object data uploads are the ones with a crc64 checked body, a presigned url can not take the header
+    auto isDataUpload = !!(msg.Flags()&REQUEST_FLAG_CHECK_CRC64) && !paramInPath &&
+        (method == Http::Method::Put || method == Http::Method::Post);
+    auto calcContentMD5 = !!(msg.Flags()&REQUEST_FLAG_CONTENTMD5) ||
+        (configuration().enableContentMd5 && isDataUpload);
     httpRequest->setResponseStreamFactory(msg.ResponseStreamFactory());
     addHeaders(httpRequest, msg.Headers());
-    addBody(httpRequest, msg.Body(), calcContentMD5);
+    addBody(httpRequest, msg.Body(), calcContentMD5, checkCRC64);
     if (paramInPath) {
         httpRequest->setUrl(Url(msg.Path()));
     }
     else {
-        addSignInfo(httpRequest, msg);
         addUrl(httpRequest, endpoint, msg);
     }
     addOther(httpRequest, msg);
     return httpRequest;
 }
 
+std::shared_ptr<HttpRequest> OssClientImpl::signHttpRequest(const HttpRequest &prepared, const ServiceRequest &msg) const
+{
+    auto httpRequest = std::make_shared<HttpRequest>(prepared);
+    //a Date of the caller is kept, otherwise each attempt has its own
+    if (!httpRequest->hasHeader(Http::DATE)) {
+        std::time_t t = std::time(nullptr);
+        t += getRequestDateOffset();
+        httpRequest->addHeader(Http::DATE, ToGmtTime(t));
+    }
+    if (!(msg.Flags()&REQUEST_FLAG_PARAM_IN_PATH)) {
+        addSignInfo(httpRequest, msg);
+    }
+    return httpRequest;
+}
+
 bool OssClientImpl::hasResponseError(const std::shared_ptr<HttpResponse>&response) const
 {
     if (BASE::hasResponseError(response)) {
@@ -125,18 +164,13 @@ void OssClientImpl::addHeaders(const std::shared_ptr<HttpRequest> &httpRequest,
     //common headers
     httpRequest->addHeader(Http::USER_AGENT, configuration().userAgent);
 
-    //Date
+    //Date of the caller, a generated one is added to each attempt
     if (httpRequest->hasHeader("x-oss-date")) {
         httpRequest->addHeader(Http::DATE, httpRequest->Header("x-oss-date"));
     }
-    if (!httpRequest->hasHeader(Http::DATE)) {
-        std::time_t t = std::time(nullptr);
-        t += getRequestDateOffset();
-        httpRequest->addHeader(Http::DATE, ToGmtTime(t));
-    }
 }
 
-void OssClientImpl::addBody(const std::shared_ptr<HttpRequest> &httpRequest, const std::shared_ptr<std::iostream>& body, bool contentMd5) const
+void OssClientImpl::addBody(const std::shared_ptr<HttpRequest> &httpRequest, const std::shared_ptr<std::iostream>& body, bool contentMd5, bool crc64) const
 {
     if (body == nullptr) {
         Http::Method methold = httpRequest->method();
@@ -153,8 +187,19 @@ void OssClientImpl::addBody(const std::shared_ptr<HttpRequest> &httpRequest, con
     }
 
     if (contentMd5 && body && !httpRequest->hasHeader(Http::CONTENT_MD5)) {
-        auto md5 = ComputeContentMD5(*body);
-        httpRequest->setHeader(Http::CONTENT_MD5, md5);
+        //of the bytes sent, an upload part may start in the middle of its stream
+        auto size = std::atoll(httpRequest->Header(Http::CONTENT_LENGTH).c_str());
+        if (crc64) {
+            //one pass over the body for both, the transfer then skips the crc64
+            uint64_t bodyCrc64 = 0;
+            auto md5 = ComputeContentMD5(*body, size, &bodyCrc64);
+            httpRequest->setHeader(Http::CONTENT_MD5, md5);
+            httpRequest->setBodyCrc64(bodyCrc64);
+        }
+        else {
+            auto md5 = ComputeContentMD5(*body, size, nullptr);
+            httpRequest->setHeader(Http::CONTENT_MD5, md5);
+        }
     }
 
     httpRequest->addBody(body);
@@ -167,11 +212,8 @@ void OssClientImpl::addSignInfo(const std::shared_ptr<HttpRequest> &httpRequest,
         httpRequest->addHeader("x-oss-security-token", credentials.SessionToken());
     }
 
-    //Sort the parameters
-    ParameterCollection parameters;
-    for (auto const&param : request.Parameters()) {
-        parameters[param.first] = param.second;
-    }
+    //ParameterCollection is an ordered map, the parameters come sorted
+    const ParameterCollection parameters = request.Parameters();
 
     std::string method = Http::MethodToString(httpRequest->method());
 
@@ -192,17 +234,14 @@ void OssClientImpl::addSignInfo(const std::shared_ptr<HttpRequest> &httpRequest,
     signUtils.build(method, resource, date, httpRequest->Headers(), parameters);
     auto signature = signer_->generate(signUtils.CanonicalString(), credentials.AccessKeySecret());
 
-    std::stringstream authValue;
-    authValue
-        << "OSS "
-        << credentials.AccessKeyId()
-        << ":"
-        << signature;
+    std::string authValue;
+    authValue.reserve(5 + credentials.AccessKeyId().size() + signature.size());
+    authValue.append("OSS ").append(credentials.AccessKeyId()).append(":").append(signature);
 
-    httpRequest->addHeader(Http::AUTHORIZATION, authValue.str());
+    httpRequest->addHeader(Http::AUTHORIZATION, authValue);
 
     OSS_LOG(LogLevel::LogDebug, TAG, "client(%p) request(%p) CanonicalString:%s", this, httpRequest.get(), signUtils.CanonicalString().c_str());
-    OSS_LOG(LogLevel::LogDebug, TAG, "client(%p) request(%p) Authorization:%s", this, httpRequest.get(), authValue.str().c_str());
+    OSS_LOG(LogLevel::LogDebug, TAG, "client(%p) request(%p) Authorization:%s", this, httpRequest.get(), authValue.c_str());
 }
 
 void OssClientImpl::addUrl(const std::shared_ptr<HttpRequest> &httpRequest, const std::string &endpoint, const ServiceRequest &request) const
@@ -219,15 +258,7 @@ void OssClientImpl::addUrl(const std::shared_ptr<HttpRequest> &httpRequest, cons
     
     auto parameters = request.Parameters();
     if (!parameters.empty()) {
-        std::stringstream queryString;
-        for (const auto &p : parameters)
-        {
-            if (p.second.empty())
-                queryString << "&" << UrlEncode(p.first);
-            else
-                queryString << "&" << UrlEncode(p.first) << "=" << UrlEncode(p.second);
-        }
-        url.setQuery(queryString.str().substr(1));
+        url.setQuery(CombineQueryString(parameters));
     }
     httpRequest->setUrl(url);
 }
@@ -236,6 +267,8 @@ void OssClientImpl::addOther(const std::shared_ptr<HttpRequest> &httpRequest, co
 {
     //progress
     httpRequest->setTransferProgress(request.TransferProgress());
+    httpRequest->setTransferPriority(request.TransferPriority());
+    httpRequest->setCancelFlag(request.CancelFlag());
 
     //crc64 check
     auto checkCRC64 = !!(request.Flags()&REQUEST_FLAG_CHECK_CRC64);
@@ -306,7 +339,7 @@ ServiceResult OssClientImpl::buildResult(const OssRequest &request, const std::s
     result.setRequestId(httpResponse->Header("x-oss-request-id"));
     result.setPlayload(httpResponse->Body());
     result.setResponseCode(httpResponse->statusCode());
-    result.setHeaderCollection(httpResponse->Headers());
+    result.setHeaderCollection(httpResponse->Headers().toHeaderCollection());
     return result;
 }
 
@@ -325,6 +358,25 @@ OssOutcome OssClientImpl::MakeRequest(const OssRequest &request, Http::Method me
     }
 }
 
+void OssClientImpl::MakeRequestAsync(const std::shared_ptr<const OssRequest> &request, Http::Method method,
+    const std::function<void(const OssOutcome &)> &handler) const
+{
+    int ret = request->validate();
+    if (ret != 0) {
+        handler(OssOutcome(OssError("ValidateError", request->validateMessage(ret))));
+        return;
+    }
+
+    BASE::AttemptRequestAsync(endpoint_, request, method, [this, request, handler](const ClientOutcome &outcome)
+    {
+        if (outcome.isSuccess()) {
+            handler(OssOutcome(buildResult(*request, outcome.result())));
+        } else {
+            handler(OssOutcome(buildError(outcome.error())));
+        }
+    });
+}
+
 ListBucketsOutcome OssClientImpl::ListBuckets(const ListBucketsRequest &request) const
 {
     auto outcome = MakeRequest(request, Http::Method::Get);
@@ -541,11 +593,38 @@ VoidOutcome OssClientImpl::DeleteBucketPolicy(const DeleteBucketPolicyRequest& r
     }
 }
 
+/*the page is parsed while it is received, every attempt starts a new parse*/
+static std::shared_ptr<ListObjectsRequest> ParseOnReceive(const ListObjectsRequest &request, const std::shared_ptr<ListObjectsResultParser> &parser)
+{
+    auto req = std::make_shared<ListObjectsRequest>(request);
+    IOStreamFactory factory = request.ResponseStreamFactory();
+    req->setResponseStreamFactory([parser, factory]() { return parser->attach(factory()); });
+    return req;
+}
+
 ListObjectOutcome OssClientImpl::ListObjects(const ListObjectsRequest &request) const
 {
-    auto outcome = MakeRequest(request, Http::Method::Get);
+    auto parser = std::make_shared<ListObjectsResultParser>();
+    auto req = ParseOnReceive(request, parser);
+    return buildListObjectsOutcome(MakeRequest(*req, Http::Method::Get), parser);
+}
+
+void OssClientImpl::ListObjectsAsync(const std::shared_ptr<const ListObjectsRequest> &request, const std::function<void(const ListObjectOutcome &)> &handler) const
+{
+    auto parser = std::make_shared<ListObjectsResultParser>();
+    MakeRequestAsync(ParseOnReceive(*request, parser), Http::Method::Get, [this, handler, parser](const OssOutcome &outcome)
+    {
+        handler(buildListObjectsOutcome(outcome, parser));
+    });
+}
+
+ListObjectOutcome OssClientImpl::buildListObjectsOutcome(const OssOutcome &outcome, const std::shared_ptr<ListObjectsResultParser> &parser) const
+{
     if (outcome.isSuccess()) {
-        ListObjectsResult result(outcome.result().payload());
+        ListObjectsResult result;
+        if (parser->Content() != outcome.result().payload() || !parser->finish(result)) {
+            result = ListObjectsResult(outcome.result().payload());
+        }
         result.requestId_ = outcome.result().RequestId();
         return result.ParseDone() ? ListObjectOutcome(std::move(result)) :
             ListObjectOutcome(OssError("ParseXMLError", "Parsing ListObject result fail."));
@@ -725,7 +804,19 @@ GetBucketPaymentOutcome OssClientImpl::GetBucketRequestPayment(const GetBucketRe
 #undef GetObject
 GetObjectOutcome OssClientImpl::GetObject(const GetObjectRequest &request) const
 {
-    auto outcome = MakeRequest(request, Http::Method::Get);
+    return buildGetObjectOutcome(request, MakeRequest(request, Http::Method::Get));
+}
+
+void OssClientImpl::GetObjectAsync(const std::shared_ptr<const GetObjectRequest> &request, const std::function<void(const GetObjectOutcome &)> &handler) const
+{
+    MakeRequestAsync(request, Http::Method::Get, [this, request, handler](const OssOutcome &outcome)
+    {
+        handler(buildGetObjectOutcome(*request, outcome));
+    });
+}
+
+GetObjectOutcome OssClientImpl::buildGetObjectOutcome(const GetObjectRequest &request, const OssOutcome &outcome) const
+{
     if (outcome.isSuccess()) {
         return GetObjectOutcome(GetObjectResult(request.Bucket(), request.Key(),
             outcome.result().payload(),outcome.result().headerCollection()));
@@ -737,7 +828,19 @@ GetObjectOutcome OssClientImpl::GetObject(const GetObjectRequest &request) const
 
 PutObjectOutcome OssClientImpl::PutObject(const PutObjectRequest &request) const
 {
-    auto outcome = MakeRequest(request, Http::Method::Put);
+    return buildPutObjectOutcome(MakeRequest(request, Http::Method::Put));
+}
+
+void OssClientImpl::PutObjectAsync(const std::shared_ptr<const PutObjectRequest> &request, const std::function<void(const PutObjectOutcome &)> &handler) const
+{
+    MakeRequestAsync(request, Http::Method::Put, [this, handler](const OssOutcome &outcome)
+    {
+        handler(buildPutObjectOutcome(outcome));
+    });
+}
+
+PutObjectOutcome OssClientImpl::buildPutObjectOutcome(const OssOutcome &outcome) const
+{
     if (outcome.isSuccess()) {
         return PutObjectOutcome(PutObjectResult(outcome.result().headerCollection(), 
             outcome.result().payload()));
@@ -762,7 +865,19 @@ VoidOutcome OssClientImpl::DeleteObject(const DeleteObjectRequest &request) cons
 
 DeleteObjecstOutcome OssClientImpl::DeleteObjects(const DeleteObjectsRequest &request) const
 {
-    auto outcome = MakeRequest(request, Http::Method::Post);
+    return buildDeleteObjectsOutcome(MakeRequest(request, Http::Method::Post));
+}
+
+void OssClientImpl::DeleteObjectsAsync(const std::shared_ptr<const DeleteObjectsRequest> &request, const std::function<void(const DeleteObjecstOutcome &)> &handler) const
+{
+    MakeRequestAsync(request, Http::Method::Post, [this, handler](const OssOutcome &outcome)
+    {
+        handler(buildDeleteObjectsOutcome(outcome));
+    });
+}
+
+DeleteObjecstOutcome OssClientImpl::buildDeleteObjectsOutcome(const OssOutcome &outcome) const
+{
     if (outcome.isSuccess()) {
         DeleteObjectsResult result(outcome.result().payload());
         result.requestId_ = outcome.result().RequestId();
@@ -1015,13 +1130,87 @@ StringOutcome OssClientImpl::GeneratePresignedUrl(const GeneratePresignedUrlRequ
     return StringOutcome(ss.str());
 }
 
+VoidOutcome OssClientImpl::GeneratePresignedUrls(const std::string &bucket, const std::vector<std::string> &keys,
+    int64_t expires, Http::Method method, std::vector<std::string> &urls) const
+{
+    if (!IsValidBucketName(bucket)) {
+        return VoidOutcome(OssError("ValidateError", "The Bucket is invalid."));
+    }
+    for (const auto &key : keys) {
+        if (!IsValidObjectKey(key)) {
+            return VoidOutcome(OssError("ValidateError", "The Key is invalid."));
+        }
+    }
+
+    //the same as GeneratePresignedUrl gives, with all but the key and the signature built once
+    const Credentials credentials = credentialsProvider_->getCredentials();
+    auto signingKey = signer_->prepare(credentials.AccessKeySecret());
+    std::string date = std::to_string(expires);
+
+    std::string canonicalPrefix;
+    canonicalPrefix.append(Http::MethodToString(method)).append("\n\n\n");
+    canonicalPrefix.append(date).append("\n/").append(bucket).append("/");
+    std::string canonicalSuffix;
+    if (!credentials.SessionToken().empty()) {
+        canonicalSuffix.append("?security-token=").append(credentials.SessionToken());
+    }
+
+    std::string urlPrefix = CombineHostString(endpoint_, bucket, configuration().isCname);
+    urlPrefix.append(CombinePathString(endpoint_, bucket, ""));
+    std::string queryPrefix;
+    queryPrefix.append("?Expires=").append(date);
+    queryPrefix.append("&OSSAccessKeyId=").append(UrlEncode(credentials.AccessKeyId()));
+    queryPrefix.append("&Signature=");
+    std::string querySuffix;
+    if (!credentials.SessionToken().empty()) {
+        querySuffix.append("&security-token=").append(UrlEncode(credentials.SessionToken()));
+    }
+
+    urls.resize(keys.size());
+    auto generate = [&](size_t first, size_t last) {
+        std::string canonical(canonicalPrefix);
+        std::string signature;
+        for (size_t i = first; i < last; i++) {
+            canonical.resize(canonicalPrefix.size());
+            canonical.append(keys[i]).append(canonicalSuffix);
+            signingKey->sign(canonical, signature);
+
+            std::string &url = urls[i];
+            url.assign(urlPrefix);
+            Codec::UrlEncode(keys[i].data(), keys[i].size(), url);
+            url.append(queryPrefix);
+            Codec::UrlEncode(signature.data(), signature.size(), url);
+            url.append(querySuffix);
+        }
+    };
+
+    //large batches are split across the cores, each thread fills its own range of urls
+    const size_t MinKeysPerThread = 512;
+    size_t threadNum = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    threadNum = std::min(threadNum, keys.size() / MinKeysPerThread);
+    if (threadNum <= 1) {
+        generate(0, keys.size());
+        return VoidOutcome(VoidResult());
+    }
+    std::vector<std::thread> threads;
+    size_t step = (keys.size() + threadNum - 1) / threadNum;
+    for (size_t first = step; first < keys.size(); first += step) {
+        threads.emplace_back(generate, first, std::min(first + step, keys.size()));
+    }
+    generate(0, step);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return VoidOutcome(VoidResult());
+}
+
 GetObjectOutcome OssClientImpl::GetObjectByUrl(const GetObjectByUrlRequest &request) const
 {
     auto outcome = BASE::AttemptRequest(endpoint_, request, Http::Method::Get);
     if (outcome.isSuccess()) {
         return GetObjectOutcome(GetObjectResult("", "", 
             outcome.result()->Body(),
-            outcome.result()->Headers()));
+            outcome.result()->Headers().toHeaderCollection()));
     }
     else {
         return GetObjectOutcome(buildError(outcome.error()));
@@ -1032,7 +1221,7 @@ PutObjectOutcome OssClientImpl::PutObjectByUrl(const PutObjectByUrlRequest &requ
 {
     auto outcome = BASE::AttemptRequest(endpoint_, request, Http::Method::Put);
     if (outcome.isSuccess()) {
-        return PutObjectOutcome(PutObjectResult(outcome.result()->Headers(), 
+        return PutObjectOutcome(PutObjectResult(outcome.result()->Headers().toHeaderCollection(), 
             outcome.result()->Body()));
     }
     else {
@@ -1058,7 +1247,19 @@ InitiateMultipartUploadOutcome OssClientImpl::InitiateMultipartUpload(const Init
 
 PutObjectOutcome OssClientImpl::UploadPart(const UploadPartRequest &request)const
 {
-    auto outcome = MakeRequest(request, Http::Put);
+    return buildUploadPartOutcome(MakeRequest(request, Http::Put));
+}
+
+void OssClientImpl::UploadPartAsync(const std::shared_ptr<const UploadPartRequest> &request, const std::function<void(const PutObjectOutcome &)> &handler) const
+{
+    MakeRequestAsync(request, Http::Put, [this, handler](const OssOutcome &outcome)
+    {
+        handler(buildUploadPartOutcome(outcome));
+    });
+}
+
+PutObjectOutcome OssClientImpl::buildUploadPartOutcome(const OssOutcome &outcome) const
+{
     if(outcome.isSuccess()){
         const HeaderCollection& header = outcome.result().headerCollection();
         return PutObjectOutcome(PutObjectResult(header));
@@ -1069,7 +1270,19 @@ PutObjectOutcome OssClientImpl::UploadPart(const UploadPartRequest &request)cons
 
 UploadPartCopyOutcome OssClientImpl::UploadPartCopy(const UploadPartCopyRequest &request) const
 {
-    auto outcome = MakeRequest(request, Http::Put);
+    return buildUploadPartCopyOutcome(MakeRequest(request, Http::Put));
+}
+
+void OssClientImpl::UploadPartCopyAsync(const std::shared_ptr<const UploadPartCopyRequest> &request, const std::function<void(const UploadPartCopyOutcome &)> &handler) const
+{
+    MakeRequestAsync(request, Http::Put, [this, handler](const OssOutcome &outcome)
+    {
+        handler(buildUploadPartCopyOutcome(outcome));
+    });
+}
+
+UploadPartCopyOutcome OssClientImpl::buildUploadPartCopyOutcome(const OssOutcome &outcome) const
+{
     if(outcome.isSuccess()){
         const HeaderCollection& header = outcome.result().headerCollection();
         return UploadPartCopyOutcome(
@@ -1151,7 +1364,7 @@ PutObjectOutcome OssClientImpl::ResumableUploadObject(const UploadObjectRequest&
 
     if (request.ObjectSize() <= request.PartSize())
     {
-        std::shared_ptr<std::iostream> content = std::make_shared<std::fstream>(request.FilePath(), std::ios::in | std::ios::binary);
+        std::shared_ptr<std::iostream> content = std::make_shared<FileRegionStream>(request.FilePath());
         PutObjectRequest putObjectReq(request.Bucket(), request.Key(), content, request.MetaData());
         if (request.TransferProgress().Handler) {
             putObjectReq.setTransferProgress(request.TransferProgress());
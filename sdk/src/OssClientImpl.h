@@ -25,6 +25,7 @@
 #include <alibabacloud/oss/OssFwd.h>
 #include "auth/Signer.h"
 #include "utils/Executor.h"
+#include "utils/TransferManager.h"
 #include "client/Client.h"
 #ifdef GetObject
 #undef GetObject
@@ -34,6 +35,8 @@ namespace AlibabaCloud
 {
 namespace OSS
 {
+    class ListObjectsResultParser;
+
     class OssClientImpl : public Client
     {
     public:
@@ -42,6 +45,8 @@ namespace OSS
         OssClientImpl(const std::string &endpoint, const std::shared_ptr<CredentialsProvider>& credentialsProvider, const ClientConfiguration & configuration);
         virtual ~OssClientImpl();
         int asyncExecute(Runnable * r) const;
+        /*runs the parts of the resumable transfers*/
+        TransferManager& transferManager() const { return *transferManager_; }
 
         ListBucketsOutcome ListBuckets(const ListBucketsRequest &request) const;
         CreateBucketOutcome CreateBucket(const CreateBucketRequest &request) const;
@@ -112,6 +117,7 @@ namespace OSS
         
         /*Generate URL*/
         StringOutcome GeneratePresignedUrl(const GeneratePresignedUrlRequest &request) const;
+        VoidOutcome GeneratePresignedUrls(const std::string &bucket, const std::vector<std::string> &keys, int64_t expires, Http::Method method, std::vector<std::string> &urls) const;
         GetObjectOutcome GetObjectByUrl(const GetObjectByUrlRequest &request) const;
         PutObjectOutcome PutObjectByUrl(const PutObjectByUrlRequest &request) const;
 
@@ -135,18 +141,30 @@ namespace OSS
         VoidOutcome DeleteLiveChannel(const DeleteLiveChannelRequest &request) const;
         StringOutcome GenerateRTMPSignedUrl(const GenerateRTMPSignedUrlRequest &request) const;
 
+        /*Event driven async, the handler is called in the event loop*/
+        void ListObjectsAsync(const std::shared_ptr<const ListObjectsRequest> &request, const std::function<void(const ListObjectOutcome &)> &handler) const;
+        void GetObjectAsync(const std::shared_ptr<const GetObjectRequest> &request, const std::function<void(const GetObjectOutcome &)> &handler) const;
+        void PutObjectAsync(const std::shared_ptr<const PutObjectRequest> &request, const std::function<void(const PutObjectOutcome &)> &handler) const;
+        void UploadPartAsync(const std::shared_ptr<const UploadPartRequest> &request, const std::function<void(const PutObjectOutcome &)> &handler) const;
+        void UploadPartCopyAsync(const std::shared_ptr<const UploadPartCopyRequest> &request, const std::function<void(const UploadPartCopyOutcome &)> &handler) const;
+        void DeleteObjectsAsync(const std::shared_ptr<const DeleteObjectsRequest> &request, const std::function<void(const DeleteObjecstOutcome &)> &handler) const;
+
         /*Requests control*/
         void DisableRequest();
         void EnableRequest();
 
     protected:
-        virtual std::shared_ptr<HttpRequest> buildHttpRequest(const std::string & endpoint, const ServiceRequest &msg, Http::Method method) const;
+        virtual std::shared_ptr<HttpRequest> prepareHttpRequest(const std::string & endpoint, const ServiceRequest &msg, Http::Method method) const;
+        virtual std::shared_ptr<HttpRequest> signHttpRequest(const HttpRequest &prepared, const ServiceRequest &msg) const;
         virtual bool hasResponseError(const std::shared_ptr<HttpResponse>&response)  const;
+        virtual Executor *executor() const;
         OssOutcome MakeRequest(const OssRequest &request, Http::Method method) const;
+        void MakeRequestAsync(const std::shared_ptr<const OssRequest> &request, Http::Method method,
+            const std::function<void(const OssOutcome &)> &handler) const;
 
     private:
         void addHeaders(const std::shared_ptr<HttpRequest> &httpRequest, const HeaderCollection &headers) const;
-        void addBody(const std::shared_ptr<HttpRequest> &httpRequest, const std::shared_ptr<std::iostream>& body, bool contentMd5 = false) const;
+        void addBody(const std::shared_ptr<HttpRequest> &httpRequest, const std::shared_ptr<std::iostream>& body, bool contentMd5 = false, bool crc64 = false) const;
         void addSignInfo(const std::shared_ptr<HttpRequest> &httpRequest, const ServiceRequest &request) const;
         void addUrl(const std::shared_ptr<HttpRequest> &httpRequest, const std::string &endpoint, const ServiceRequest &request) const;
         void addOther(const std::shared_ptr<HttpRequest> &httpRequest, const ServiceRequest &request) const;
@@ -154,11 +172,19 @@ namespace OSS
         OssError buildError(const Error &error) const;
         ServiceResult buildResult(const OssRequest &request, const std::shared_ptr<HttpResponse> &httpResponse) const;
 
+        ListObjectOutcome buildListObjectsOutcome(const OssOutcome &outcome, const std::shared_ptr<ListObjectsResultParser> &parser) const;
+        GetObjectOutcome buildGetObjectOutcome(const GetObjectRequest &request, const OssOutcome &outcome) const;
+        PutObjectOutcome buildPutObjectOutcome(const OssOutcome &outcome) const;
+        PutObjectOutcome buildUploadPartOutcome(const OssOutcome &outcome) const;
+        UploadPartCopyOutcome buildUploadPartCopyOutcome(const OssOutcome &outcome) const;
+        DeleteObjecstOutcome buildDeleteObjectsOutcome(const OssOutcome &outcome) const;
+
     private:
         std::string endpoint_;
         std::shared_ptr<CredentialsProvider> credentialsProvider_;
         std::shared_ptr<Signer> signer_;
         std::shared_ptr< Executor> executor_;
+        std::shared_ptr<TransferManager> transferManager_;
     };
 }
 }
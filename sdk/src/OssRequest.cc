@@ -15,6 +15,7 @@
 */
 
 #include <alibabacloud/oss/OssRequest.h>
+#include <alibabacloud/oss/utils/BufferPool.h>
 #include <sstream>
 #include "http/HttpType.h"
 #include "utils/Utils.h"
@@ -60,8 +61,9 @@ std::shared_ptr<std::iostream> OssRequest::Body() const
     std::shared_ptr<std::iostream> payloadBody;
     if (!p.empty())
     {
-      payloadBody = std::make_shared<std::stringstream>();
-      *payloadBody << p;
+      auto stream = std::make_shared<PooledBufferStream>(BufferPool::Default(), p.size());
+      stream->buffer().append(p.data(), p.size());
+      payloadBody = stream;
     }
     return payloadBody;
 }
@@ -275,6 +277,26 @@ uint64_t OssResumableBaseRequest::TrafficLimit() const
     return trafficLimit_;
 }
 
+void OssResumableBaseRequest::setAutoTune(bool enable)
+{
+    autoTune_ = enable;
+}
+
+bool OssResumableBaseRequest::AutoTune() const
+{
+    return autoTune_;
+}
+
+void OssResumableBaseRequest::setCheckpointSyncInterval(uint32_t interval)
+{
+    checkpointSyncInterval_ = interval;
+}
+
+uint32_t OssResumableBaseRequest::CheckpointSyncInterval() const
+{
+    return checkpointSyncInterval_;
+}
+
 void LiveChannelRequest::setBucket(const std::string &bucket)
 {
     bucket_ = bucket;
@@ -15,11 +15,17 @@
  */
 
 #include <alibabacloud/oss/Const.h>
+#include <algorithm>
 #include "ResumableBaseWorker.h"
 #include "utils/FileSystemUtils.h"
 
 using namespace AlibabaCloud::OSS;
 
+namespace
+{
+    /*an auto-tuned part is made of at most this many parts of the layout*/
+    const uint64_t MaxPartChunks = 16;
+}
 
 ResumableBaseWorker::ResumableBaseWorker(uint64_t objectSize, uint64_t partSize) :
     hasRecord_(false),
@@ -50,13 +56,15 @@ int ResumableBaseWorker::validate(OssError& err)
 
     if (hasRecord_) {
         if (0 != validateRecord()) {
-            RemoveFile(recordPath_);
+            removeRecord();
             if (0 != prepare(err)) {
                 return -1;
             }
         }
     }
     else {
+        //a journal left without its record belongs to no transfer
+        removeRecord();
         if (0 != prepare(err)) {
             return -1;
         }
@@ -76,3 +84,60 @@ void ResumableBaseWorker::determinePartSize()
 
     partSize_ = partSize;
 }
+
+void ResumableBaseWorker::initTuner(uint32_t threadNum, bool autoTune, size_t partCount)
+{
+    int threads = static_cast<int>(threadNum);
+    if (!autoTune) {
+        tuner_.reset(new TransferTuner(threads));
+        return;
+    }
+    //no more threads than parts, no part over the 5GB limit
+    int maxThreads = static_cast<int>(std::min<size_t>(std::max(threads, AutoTuneMaxThreadNum), std::max<size_t>(partCount, 1)));
+    int maxChunks = static_cast<int>(std::max<uint64_t>(1, std::min<uint64_t>(MaxPartChunks, MaxFileSize / partSize_)));
+    tuner_.reset(new TransferTuner(threads, maxThreads, maxChunks));
+}
+
+bool ResumableBaseWorker::replayJournal(std::vector<CheckpointJournal::Entry>& entries)
+{
+    if (recordPath_.empty()) {
+        return false;
+    }
+    CheckpointJournal journal(recordPath_ + ".journal");
+    return journal.replay(entries);
+}
+
+void ResumableBaseWorker::openJournal(uint32_t syncInterval)
+{
+    if (!recordPath_.empty()) {
+        journal_.reset(new CheckpointJournal(recordPath_ + ".journal", syncInterval));
+        journal_->open();
+    }
+}
+
+void ResumableBaseWorker::appendJournal(const CheckpointJournal::Entry& entry)
+{
+    if (journal_ != nullptr) {
+        journal_->append(entry);
+    }
+}
+
+void ResumableBaseWorker::rewriteJournal(const std::vector<CheckpointJournal::Entry>& entries)
+{
+    if (!recordPath_.empty()) {
+        CheckpointJournal journal(recordPath_ + ".journal");
+        journal.compact(entries);
+    }
+}
+
+void ResumableBaseWorker::removeRecord()
+{
+    if (recordPath_.empty()) {
+        return;
+    }
+    if (journal_ != nullptr) {
+        journal_->close();
+    }
+    RemoveFile(recordPath_);
+    RemoveFile(recordPath_ + ".journal");
+}
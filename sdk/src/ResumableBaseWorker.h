@@ -16,10 +16,13 @@
 
 #pragma once
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <alibabacloud/oss/OssError.h>
 #include <alibabacloud/oss/OssRequest.h>
 #include "utils/Utils.h"
+#include "utils/TransferTuner.h"
+#include "utils/CheckpointJournal.h"
 
 namespace AlibabaCloud
 {
@@ -34,6 +37,16 @@ namespace OSS
     protected:
         int validate(OssError& err);
         void determinePartSize();
+        /*the parts in flight, fixed at threadNum unless autoTune*/
+        void initTuner(uint32_t threadNum, bool autoTune, size_t partCount);
+        /*the parts completed by the last run, false if the record has no journal*/
+        bool replayJournal(std::vector<CheckpointJournal::Entry>& entries);
+        /*the parts are logged to the journal next to the record from now on*/
+        void openJournal(uint32_t syncInterval);
+        void appendJournal(const CheckpointJournal::Entry& entry);
+        void rewriteJournal(const std::vector<CheckpointJournal::Entry>& entries);
+        /*the record and its journal*/
+        void removeRecord();
         virtual const std::string getRecordPath() = 0;
         virtual int loadRecord() = 0;
         virtual int prepare(OssError& err) = 0;
@@ -45,6 +58,8 @@ namespace OSS
         uint64_t objectSize_;
         uint64_t consumedSize_;
         uint64_t partSize_;
+        std::unique_ptr<TransferTuner> tuner_;
+        std::unique_ptr<CheckpointJournal> journal_;
     };
 }
 }
\ No newline at end of file
@@ -44,75 +44,89 @@ CopyObjectOutcome ResumableCopier::Copy()
     if (getPartsToUploadCopy(err, partsCopied, partsToUploadCopy) != 0) {
         return CopyObjectOutcome(err);
     }
+    openJournal(request_.CheckpointSyncInterval());
 
     std::vector<UploadPartCopyOutcome> outcomes;
-    std::vector<std::thread> threadPool;
 
-    for (uint32_t i = 0; i < request_.ThreadNum(); i++) {
-        threadPool.emplace_back(std::thread([&]() {
-            Part part;
-            while (true) {
-                {
-                std::lock_guard<std::mutex> lck(lock_);
-                if (partsToUploadCopy.empty())
-                    break;
-                part = partsToUploadCopy.front();
-                partsToUploadCopy.erase(partsToUploadCopy.begin());
-                }
-
-                if (!client_->isEnableRequest())
-                    break;
-
-                uint64_t offset = partSize_ * (part.PartNumber() - 1);
-                uint64_t length = part.Size();
+    initTuner(request_.ThreadNum(), request_.AutoTune(), partsToUploadCopy.size());
+    //the parts run on the transfer threads of the client, shared with the other transfers
+    auto state = client_->transferManager().run(request_.TransferPriority(), [&](TransferManager::Task& task) -> TransferManager::State {
+        int64_t partStart;
+        Part part;
+        {
+        std::lock_guard<std::mutex> lck(lock_);
+        if (partsToUploadCopy.empty() || !client_->isEnableRequest()) {
+            return TransferManager::Done;
+        }
+        if (!tuner_->acquire(partStart)) {
+            return TransferManager::Busy;
+        }
+        part = partsToUploadCopy.front();
+        partsToUploadCopy.erase(partsToUploadCopy.begin());
+        //an auto-tuned part also takes the next parts of the layout, under the number of the first
+        int chunks = tuner_->chunks(partsToUploadCopy.size() + 1);
+        for (int n = 1; n < chunks && !partsToUploadCopy.empty() &&
+            partsToUploadCopy.front().PartNumber() == part.PartNumber() + n; n++) {
+            part.size_ += partsToUploadCopy.front().Size();
+            partsToUploadCopy.erase(partsToUploadCopy.begin());
+        }
+        }
 
-                auto uploadPartCopyReq = UploadPartCopyRequest(request_.Bucket(), request_.Key(), request_.SrcBucket(), request_.SrcKey(),
-                    uploadID_, part.PartNumber(), 
-                    request_.SourceIfMatchEtag(), request_.SourceIfNotMatchEtag(),
-                    request_.SourceIfModifiedSince(), request_.SourceIfUnModifiedSince());
-                uploadPartCopyReq.setCopySourceRange(offset, offset + length - 1);
-                if (request_.RequestPayer() == RequestPayer::Requester) {
-                    uploadPartCopyReq.setRequestPayer(request_.RequestPayer());
-                }
-                if (request_.TrafficLimit() != 0) {
-                    uploadPartCopyReq.setTrafficLimit(request_.TrafficLimit());
-                }
-                auto outcome = client_->UploadPartCopy(uploadPartCopyReq);
+        //the data of a copied part does not pass through the client
+        task.bytes = 0;
+        task.run = [&, part, partStart]() mutable {
+            uint64_t offset = partSize_ * (part.PartNumber() - 1);
+            uint64_t length = part.Size();
+
+            auto uploadPartCopyReq = UploadPartCopyRequest(request_.Bucket(), request_.Key(), request_.SrcBucket(), request_.SrcKey(),
+                uploadID_, part.PartNumber(), 
+                request_.SourceIfMatchEtag(), request_.SourceIfNotMatchEtag(),
+                request_.SourceIfModifiedSince(), request_.SourceIfUnModifiedSince());
+            uploadPartCopyReq.setCopySourceRange(offset, offset + length - 1);
+            if (request_.RequestPayer() == RequestPayer::Requester) {
+                uploadPartCopyReq.setRequestPayer(request_.RequestPayer());
+            }
+            if (request_.TrafficLimit() != 0) {
+                uploadPartCopyReq.setTrafficLimit(request_.TrafficLimit());
+            }
+            uploadPartCopyReq.setTransferPriority(request_.TransferPriority());
+            auto outcome = client_->UploadPartCopy(uploadPartCopyReq);
 #ifdef ENABLE_OSS_TEST
-                if (!!(request_.Flags() & 0x40000000) && (part.PartNumber() == 2 || part.PartNumber() == 4)) {
-                    const char* TAG = "ResumableCopyObjectClient";
-                    OSS_LOG(LogLevel::LogDebug, TAG, "NO.%d part data copy failed!", part.PartNumber());
-                    outcome = UploadPartCopyOutcome();
-                }
+            if (!!(request_.Flags() & 0x40000000) && (part.PartNumber() == 2 || part.PartNumber() == 4)) {
+                const char* TAG = "ResumableCopyObjectClient";
+                OSS_LOG(LogLevel::LogDebug, TAG, "NO.%d part data copy failed!", part.PartNumber());
+                outcome = UploadPartCopyOutcome();
+            }
 #endif // ENABLE_OSS_TEST
 
-                //lock
-                {
-                    std::lock_guard<std::mutex> lck(lock_);
-                    if (outcome.isSuccess()) {
-                        part.eTag_ = outcome.result().ETag();
-                        partsCopied.push_back(part);
-                    }
-                    outcomes.push_back(outcome);
-                    if (outcome.isSuccess()) {
-                        auto process = request_.TransferProgress();
-
-                        if (process.Handler) {
-                            consumedSize_ += length;
-                            process.Handler((size_t)length, consumedSize_, objectSize_, process.UserData);
-                        }
-                    }
+            //lock
+            {
+                std::lock_guard<std::mutex> lck(lock_);
+                if (outcome.isSuccess()) {
+                    part.eTag_ = outcome.result().ETag();
+                    partsCopied.push_back(part);
                 }
+                outcomes.push_back(outcome);
+                if (outcome.isSuccess()) {
+                    auto process = request_.TransferProgress();
 
+                    if (process.Handler) {
+                        consumedSize_ += length;
+                        process.Handler((size_t)length, consumedSize_, objectSize_, process.UserData);
+                    }
+                }
             }
-        }));
-    }
-
-    for (auto& worker : threadPool) {
-        if (worker.joinable()) {
-            worker.join();
-        }
-    }
+            if (outcome.isSuccess()) {
+                CheckpointJournal::Entry entry;
+                entry.partNumber = part.PartNumber();
+                entry.size = part.Size();
+                entry.eTag = part.ETag();
+                appendJournal(entry);
+            }
+            tuner_->release(partStart, outcome.isSuccess() ? length : 0, outcome.isSuccess());
+        };
+        return TransferManager::Ready;
+    });
 
     for (const auto& outcome : outcomes) {
         if (!outcome.isSuccess()) {
@@ -123,6 +137,9 @@ CopyObjectOutcome ResumableCopier::Copy()
     if (!client_->isEnableRequest()) {
         return CopyObjectOutcome(OssError("ClientError:100002", "Disable all requests by upper."));
     }
+    if (state != TransferManager::Done) {
+        return CopyObjectOutcome(OssError("TransferError", "ResumableCopy stopped with parts left, no part could start."));
+    }
 
     // sort partsCopied
     std::sort(partsCopied.begin(), partsCopied.end(), [](const Part& a, const Part& b) 
@@ -148,9 +165,7 @@ CopyObjectOutcome ResumableCopier::Copy()
         return CopyObjectOutcome(compOutcome.error());
     }
 
-    if (!recordPath_.empty()) {
-        RemoveFile(recordPath_);
-    }
+    removeRecord();
     CopyObjectResult result;
     HeadObjectRequest hRequest(request_.Bucket(), request_.Key());
     if (request_.RequestPayer() == RequestPayer::Requester) {
@@ -309,8 +324,28 @@ const std::string ResumableCopier::getRecordPath()
 int ResumableCopier::getPartsToUploadCopy(OssError &err, PartList &partsCopied, PartList &partsToUploadCopy) 
 {
     std::set<uint64_t> partNumbersUploaded;
-
-    if (hasRecord_) {
+    auto addCopied = [&](const Part &part) {
+        //an auto-tuned part covers the layout parts of its size
+        int64_t layoutSize = static_cast<int64_t>(partSize_);
+        int64_t covered = std::max<int64_t>((part.Size() + layoutSize - 1) / layoutSize, 1);
+        for (int64_t n = 0; n < covered; n++) {
+            partNumbersUploaded.insert(part.PartNumber() + n);
+        }
+        partsCopied.push_back(part);
+        consumedSize_ += part.Size();
+    };
+
+    std::vector<CheckpointJournal::Entry> entries;
+    if (hasRecord_ && replayJournal(entries)) {
+        for (const auto &entry : entries) {
+            Part part(entry.partNumber, entry.eTag);
+            part.size_ = entry.size;
+            part.cRC64_ = entry.crc64;
+            addCopied(part);
+        }
+    }
+    else if (hasRecord_) {
+        //a record of an older version, the journal starts from the listed parts
         uint32_t marker = 0;
         auto listPartsRequest = ListPartsRequest(request_.Bucket(), request_.Key(), uploadID_);
         if (!request_.EncodingType().empty()) {
@@ -329,9 +364,13 @@ int ResumableCopier::getPartsToUploadCopy(OssError &err, PartList &partsCopied,
 
             auto parts = outcome.result().PartList();
             for (auto iter = parts.begin(); iter != parts.end(); iter++) {
-                partNumbersUploaded.insert(iter->PartNumber());
-                partsCopied.emplace_back(*iter);
-                consumedSize_ += iter->Size();
+                addCopied(*iter);
+                CheckpointJournal::Entry entry;
+                entry.partNumber = iter->PartNumber();
+                entry.size = iter->Size();
+                entry.crc64 = iter->CRC64();
+                entry.eTag = iter->ETag();
+                entries.push_back(entry);
             }
 
             if (outcome.result().IsTruncated()) {
@@ -341,6 +380,7 @@ int ResumableCopier::getPartsToUploadCopy(OssError &err, PartList &partsCopied,
                 break;
             }
         }
+        rewriteJournal(entries);
     }
 
     int32_t partCount = (int32_t)((objectSize_ - 1) / partSize_ + 1);
@@ -22,6 +22,7 @@
 #include "utils/Crc64.h"
 #include "utils/LogUtils.h"
 #include "utils/FileSystemUtils.h"
+#include "utils/PositionalFile.h"
 #include "external/json/json.h"
 #include "OssClientImpl.h"
 #include "ResumableDownloader.h"
@@ -41,6 +42,7 @@ GetObjectOutcome ResumableDownloader::Download()
     if (getPartsToDownload(err, partsToDownload) != 0) {
         return GetObjectOutcome(err);
     }
+    openJournal(request_.CheckpointSyncInterval());
 
     //task queue
     PartRecordList downloadedParts;
@@ -48,111 +50,94 @@ GetObjectOutcome ResumableDownloader::Download()
         downloadedParts = record_.parts;
     }
     std::vector<GetObjectOutcome> outcomes;
-    std::vector<std::thread> threadPool;
 
-    for (uint32_t i = 0; i < request_.ThreadNum(); i++) {
-        threadPool.emplace_back(std::thread([&]() {
-            PartRecord part;
-            while (true) {
-                {
-                std::lock_guard<std::mutex> lck(lock_);
-                if (partsToDownload.empty())
-                    break;
-                part = partsToDownload.front();
-                partsToDownload.erase(partsToDownload.begin());
-                }
+    //all the parts write to one descriptor at their own offsets
+    auto tmpFile = std::make_shared<PositionalFile>(request_.TempFilePath(), request_.DirectIO());
+    if (!tmpFile->isOpen()) {
+        return GetObjectOutcome(OssError("ValidateError", GetModelErrorMsg(ARG_ERROR_OPEN_DOWNLOAD_TEMP_FILE)));
+    }
+    tmpFile->preallocate(static_cast<int64_t>(contentLength_));
 
-                if (!client_->isEnableRequest())
-                    break;
-
-                uint64_t pos = partSize_ * (part.partNumber - 1);
-                uint64_t start = part.offset;
-                uint64_t end = start + part.size - 1;
-                auto getObjectReq = GetObjectRequest(request_.Bucket(), request_.Key(), request_.ModifiedSinceConstraint(), request_.UnmodifiedSinceConstraint(),
-                    request_.MatchingETagsConstraint(), request_.NonmatchingETagsConstraint(), request_.ResponseHeaderParameters());
-                getObjectReq.setResponseStreamFactory([=]() {std::shared_ptr<std::iostream> tmpFstream = std::make_shared<std::fstream>(request_.TempFilePath(), std::ios_base::in | std::ios_base::out | std::ios_base::binary);
-                tmpFstream->seekp(pos, tmpFstream->beg);
-                return tmpFstream;
-                });
-                getObjectReq.setRange(start, end);
-                getObjectReq.setFlags(getObjectReq.Flags() | REQUEST_FLAG_CHECK_CRC64 | REQUEST_FLAG_SAVE_CLIENT_CRC64);
-
-                auto process = request_.TransferProgress();
-                if (process.Handler) {
-                    TransferProgress uploadPartProcess = { DownloadPartProcessCallback, (void *)this };
-                    getObjectReq.setTransferProgress(uploadPartProcess);
-                }
-                if (request_.RequestPayer() == RequestPayer::Requester) {
-                    getObjectReq.setRequestPayer(request_.RequestPayer());
-                }
-                if (request_.TrafficLimit() != 0) {
-                    getObjectReq.setTrafficLimit(request_.TrafficLimit());
-                }
-                auto outcome = client_->GetObject(getObjectReq);
+    initTuner(request_.ThreadNum(), request_.AutoTune(), partsToDownload.size());
+    //the parts run on the transfer threads of the client, shared with the other transfers
+    auto state = client_->transferManager().run(request_.TransferPriority(), [&](TransferManager::Task& task) -> TransferManager::State {
+        int64_t partStart;
+        PartRecord part;
+        {
+        std::lock_guard<std::mutex> lck(lock_);
+        if (partsToDownload.empty() || !client_->isEnableRequest()) {
+            return TransferManager::Done;
+        }
+        if (!tuner_->acquire(partStart)) {
+            return TransferManager::Busy;
+        }
+        part = partsToDownload.front();
+        partsToDownload.erase(partsToDownload.begin());
+        //an auto-tuned part also takes the next parts of the layout, under the number of the first
+        int chunks = tuner_->chunks(partsToDownload.size() + 1);
+        for (int n = 1; n < chunks && !partsToDownload.empty() &&
+            partsToDownload.front().partNumber == part.partNumber + n; n++) {
+            part.size += partsToDownload.front().size;
+            partsToDownload.erase(partsToDownload.begin());
+        }
+        }
+
+        task.bytes = static_cast<uint64_t>(part.size);
+        task.run = [&, part, partStart]() mutable {
+            uint64_t pos = partSize_ * (part.partNumber - 1);
+            uint64_t start = part.offset;
+            uint64_t end = start + part.size - 1;
+            auto getObjectReq = GetObjectRequest(request_.Bucket(), request_.Key(), request_.ModifiedSinceConstraint(), request_.UnmodifiedSinceConstraint(),
+                request_.MatchingETagsConstraint(), request_.NonmatchingETagsConstraint(), request_.ResponseHeaderParameters());
+            getObjectReq.setResponseStreamFactory([=]() {
+                return std::make_shared<PositionalWriteStream>(tmpFile, static_cast<int64_t>(pos));
+            });
+            getObjectReq.setRange(start, end);
+            getObjectReq.setFlags(getObjectReq.Flags() | REQUEST_FLAG_CHECK_CRC64 | REQUEST_FLAG_SAVE_CLIENT_CRC64);
+
+            auto process = request_.TransferProgress();
+            if (process.Handler) {
+                TransferProgress uploadPartProcess = { DownloadPartProcessCallback, (void *)this };
+                getObjectReq.setTransferProgress(uploadPartProcess);
+            }
+            if (request_.RequestPayer() == RequestPayer::Requester) {
+                getObjectReq.setRequestPayer(request_.RequestPayer());
+            }
+            if (request_.TrafficLimit() != 0) {
+                getObjectReq.setTrafficLimit(request_.TrafficLimit());
+            }
+            getObjectReq.setTransferPriority(request_.TransferPriority());
+            auto outcome = client_->GetObject(getObjectReq);
 #ifdef ENABLE_OSS_TEST
-                if (!!(request_.Flags() & 0x40000000) && part.partNumber == 2) {
-                    const char* TAG = "ResumableDownloadObjectClient";
-                    OSS_LOG(LogLevel::LogDebug, TAG, "NO.2 part data download failed.");
-                    outcome = GetObjectOutcome();
-                }
+            if (!!(request_.Flags() & 0x40000000) && part.partNumber == 2) {
+                const char* TAG = "ResumableDownloadObjectClient";
+                OSS_LOG(LogLevel::LogDebug, TAG, "NO.2 part data download failed.");
+                outcome = GetObjectOutcome();
+            }
 #endif // ENABLE_OSS_TEST
 
-                // lock
-                {
-                    std::lock_guard<std::mutex> lck(lock_);
-                    if (outcome.isSuccess()) {
-                        part.crc64 = std::strtoull(outcome.result().Metadata().HttpMetaData().at("x-oss-hash-crc64ecma-by-client").c_str(), nullptr, 10);
-                        downloadedParts.push_back(part);
-                    }
-                    outcomes.push_back(outcome);
-
-                    //update record
-                    if (!recordPath_.empty() && outcome.isSuccess()) {
-                        auto &record = record_;
-                        record.parts = downloadedParts;
-
-                        Json::Value root;
-                        root["opType"] = record.opType;
-                        root["bucket"] = record.bucket;
-                        root["key"] = record.key;
-                        root["filePath"] = record.filePath;
-                        root["mtime"] = record.mtime;
-                        root["size"] = record.size;
-                        root["partSize"] = record.partSize;
-
-                        int index = 0;
-                        for (PartRecord& part : record.parts) {
-                            root["parts"][index]["partNumber"] = part.partNumber;
-                            root["parts"][index]["size"] = part.size;
-                            root["parts"][index]["crc64"] = part.crc64;
-                            index++;
-                        }
-
-                        std::stringstream ss;
-                        ss << root;
-                        std::string md5Sum = ComputeContentETag(ss);
-                        root["md5Sum"] = md5Sum;
-
-                        if (request_.RangeIsSet()) {
-                            root["rangeStart"] = record.rangeStart;
-                            root["rangeEnd"] = record.rangeEnd;
-                        }
-
-                        std::ofstream recordStream(recordPath_, std::ios::out);
-                        if (recordStream.is_open()) {
-                            recordStream << root;
-                        }
-                    }
+            // lock
+            {
+                std::lock_guard<std::mutex> lck(lock_);
+                if (outcome.isSuccess()) {
+                    part.crc64 = std::strtoull(outcome.result().Metadata().HttpMetaData().at("x-oss-hash-crc64ecma-by-client").c_str(), nullptr, 10);
+                    downloadedParts.push_back(part);
                 }
-            }
-        }));
-    }
+                outcomes.push_back(outcome);
 
-    for (auto& worker : threadPool) {
-        if (worker.joinable()) {
-            worker.join();
-        }
-    }
+            }
+            if (outcome.isSuccess()) {
+                CheckpointJournal::Entry entry;
+                entry.partNumber = part.partNumber;
+                entry.offset = part.offset;
+                entry.size = part.size;
+                entry.crc64 = part.crc64;
+                appendJournal(entry);
+            }
+            tuner_->release(partStart, outcome.isSuccess() ? static_cast<uint64_t>(part.size) : 0, outcome.isSuccess());
+        };
+        return TransferManager::Ready;
+    });
 
     std::shared_ptr<std::iostream> content = nullptr;
     for (auto& outcome : outcomes) {
@@ -161,10 +146,15 @@ GetObjectOutcome ResumableDownloader::Download()
         }
         outcome.result().setContent(content);
     }
+    //closed before the rename
+    tmpFile = nullptr;
 
     if (!client_->isEnableRequest()) {
         return GetObjectOutcome(OssError("ClientError:100002", "Disable all requests by upper."));
     }
+    if (state != TransferManager::Done) {
+        return GetObjectOutcome(OssError("TransferError", "ResumableDownload stopped with parts left, no part could start."));
+    }
 
     // sort
     std::sort(downloadedParts.begin(), downloadedParts.end(), [&](const PartRecord& a, const PartRecord& b)
@@ -222,9 +212,7 @@ GetObjectOutcome ResumableDownloader::Download()
         ss << "rename temp file "<< request_.TempFilePath() << " to " << request_.FilePath() << " failed";
         return GetObjectOutcome(OssError("RenameError", ss.str()));
     }
-    if (!recordPath_.empty()) {
-        RemoveFile(recordPath_);
-    }
+    removeRecord();
 
     GetObjectResult result(request_.Bucket(), request_.Key(), meta);
     return GetObjectOutcome(result);
@@ -381,8 +369,24 @@ int ResumableDownloader::getPartsToDownload(OssError &err, PartRecordList &parts
 
     std::set<uint64_t> partNumbersDownloaded;
     if (hasRecord_) {
+        //the parts in the record itself are from older versions, the journal has the rest
+        std::vector<CheckpointJournal::Entry> entries;
+        replayJournal(entries);
+        for (const auto &entry : entries) {
+            PartRecord part;
+            part.partNumber = entry.partNumber;
+            part.offset = entry.offset;
+            part.size = entry.size;
+            part.crc64 = entry.crc64;
+            record_.parts.push_back(part);
+        }
         for (PartRecord &part : record_.parts) {
-            partNumbersDownloaded.insert(part.partNumber);
+            //an auto-tuned part covers the layout parts of its size
+            int64_t layoutSize = static_cast<int64_t>(partSize_);
+            int64_t covered = std::max<int64_t>((part.size + layoutSize - 1) / layoutSize, 1);
+            for (int64_t n = 0; n < covered; n++) {
+                partNumbersDownloaded.insert(part.partNumber + n);
+            }
             consumedSize_ += part.size;
         }
     }
@@ -48,77 +48,92 @@ PutObjectOutcome ResumableUploader::Upload()
     if (getPartsToUpload(err, uploadedParts, partsToUpload) != 0){
         return PutObjectOutcome(err);
     }
+    openJournal(request_.CheckpointSyncInterval());
 
     std::vector<PutObjectOutcome> outcomes;
-    std::vector<std::thread> threadPool;
-
-    for (uint32_t i = 0; i < request_.ThreadNum(); i++) {
-        threadPool.emplace_back(std::thread([&]() {
-            Part part;
-            while (true) {
-                {
-                std::lock_guard<std::mutex> lck(lock_);
-                if (partsToUpload.empty())
-                    break;
-                part = partsToUpload.front();
-                partsToUpload.erase(partsToUpload.begin());
-                }
-
-                if (!client_->isEnableRequest())
-                    break;
-
-                uint64_t offset = partSize_ * (part.PartNumber() - 1);
-                uint64_t length = part.Size();
-                auto content = std::make_shared<std::fstream>(request_.FilePath(), std::ios::in | std::ios::binary);
-                content->seekg(offset, content->beg);
-
-                UploadPartRequest uploadPartRequest(request_.Bucket(), request_.Key(), part.PartNumber(), uploadID_, content);
-                uploadPartRequest.setContentLength(length);
-
-                auto process = request_.TransferProgress();
-                if (process.Handler) {
-                    TransferProgress uploadPartProcess = { UploadPartProcessCallback, (void *)this };
-                    uploadPartRequest.setTransferProgress(uploadPartProcess);
-                }
-                if (request_.RequestPayer() == RequestPayer::Requester) {
-                    uploadPartRequest.setRequestPayer(request_.RequestPayer());
-                }
-                if (request_.TrafficLimit() != 0) {
-                    uploadPartRequest.setTrafficLimit(request_.TrafficLimit());
-                }
-                auto outcome = client_->UploadPart(uploadPartRequest);
+
+    initTuner(request_.ThreadNum(), request_.AutoTune(), partsToUpload.size());
+    //the parts run on the transfer threads of the client, shared with the other transfers
+    auto state = client_->transferManager().run(request_.TransferPriority(), [&](TransferManager::Task& task) -> TransferManager::State {
+        int64_t partStart;
+        Part part;
+        {
+        std::lock_guard<std::mutex> lck(lock_);
+        if (partsToUpload.empty() || !client_->isEnableRequest()) {
+            return TransferManager::Done;
+        }
+        if (!tuner_->acquire(partStart)) {
+            return TransferManager::Busy;
+        }
+        part = partsToUpload.front();
+        partsToUpload.erase(partsToUpload.begin());
+        //an auto-tuned part also takes the next parts of the layout, under the number of the first
+        int chunks = tuner_->chunks(partsToUpload.size() + 1);
+        for (int n = 1; n < chunks && !partsToUpload.empty() &&
+            partsToUpload.front().PartNumber() == part.PartNumber() + n; n++) {
+            part.size_ += partsToUpload.front().Size();
+            partsToUpload.erase(partsToUpload.begin());
+        }
+        }
+
+        task.bytes = part.Size();
+        task.run = [&, part, partStart]() mutable {
+            uint64_t offset = partSize_ * (part.PartNumber() - 1);
+            uint64_t length = part.Size();
+            auto content = std::make_shared<FileRegionStream>(request_.FilePath(), offset, length);
+
+            UploadPartRequest uploadPartRequest(request_.Bucket(), request_.Key(), part.PartNumber(), uploadID_, content);
+            uploadPartRequest.setContentLength(length);
+
+            auto process = request_.TransferProgress();
+            if (process.Handler) {
+                TransferProgress uploadPartProcess = { UploadPartProcessCallback, (void *)this };
+                uploadPartRequest.setTransferProgress(uploadPartProcess);
+            }
+            if (request_.RequestPayer() == RequestPayer::Requester) {
+                uploadPartRequest.setRequestPayer(request_.RequestPayer());
+            }
+            if (request_.TrafficLimit() != 0) {
+                uploadPartRequest.setTrafficLimit(request_.TrafficLimit());
+            }
+            uploadPartRequest.setTransferPriority(request_.TransferPriority());
+            auto outcome = client_->UploadPart(uploadPartRequest);
 #ifdef ENABLE_OSS_TEST
-                if (!!(request_.Flags() & 0x40000000) && part.PartNumber() == 2) {
-                    const char* TAG = "ResumableUploadObjectClient";
-                    OSS_LOG(LogLevel::LogDebug, TAG, "NO.2 part data upload failed.");
-                    outcome = PutObjectOutcome();
-                }
+            if (!!(request_.Flags() & 0x40000000) && part.PartNumber() == 2) {
+                const char* TAG = "ResumableUploadObjectClient";
+                OSS_LOG(LogLevel::LogDebug, TAG, "NO.2 part data upload failed.");
+                outcome = PutObjectOutcome();
+            }
 #endif // ENABLE_OSS_TEST
 
-                if (outcome.isSuccess()) {
-                    part.eTag_  = outcome.result().ETag();
-                    part.cRC64_ = outcome.result().CRC64();
-                }
-
-                //lock
-                {
-                std::lock_guard<std::mutex> lck(lock_);
-                uploadedParts.push_back(part);
-                outcomes.push_back(outcome);
-                }
+            if (outcome.isSuccess()) {
+                part.eTag_  = outcome.result().ETag();
+                part.cRC64_ = outcome.result().CRC64();
+                CheckpointJournal::Entry entry;
+                entry.partNumber = part.PartNumber();
+                entry.size = part.Size();
+                entry.crc64 = part.CRC64();
+                entry.eTag = part.ETag();
+                appendJournal(entry);
             }
-        }));
-    }
 
-    for (auto& worker:threadPool) {
-        if(worker.joinable()){
-            worker.join();
-        }
-    }
+            //lock
+            {
+            std::lock_guard<std::mutex> lck(lock_);
+            uploadedParts.push_back(part);
+            outcomes.push_back(outcome);
+            }
+            tuner_->release(partStart, outcome.isSuccess() ? length : 0, outcome.isSuccess());
+        };
+        return TransferManager::Ready;
+    });
 
     if (!client_->isEnableRequest()) {
         return PutObjectOutcome(OssError("ClientError:100002", "Disable all requests by upper."));
     }
+    if (state != TransferManager::Done) {
+        return PutObjectOutcome(OssError("TransferError", "ResumableUpload stopped with parts left, no part could start."));
+    }
 
     for (const auto& outcome : outcomes) {
         if (!outcome.isSuccess()) {
@@ -171,9 +186,7 @@ PutObjectOutcome ResumableUploader::Upload()
         return PutObjectOutcome(OssError("CrcCheckError", "ResumableUpload Object CRC Checksum fail."));
     }
 
-    if (!recordPath_.empty()) {
-        RemoveFile(recordPath_);
-    }
+    removeRecord();
 
     HeaderCollection headers;
     headers[Http::ETAG] = outcome.result().ETag();
@@ -300,8 +313,28 @@ const std::string ResumableUploader::getRecordPath()
 int ResumableUploader::getPartsToUpload(OssError &err, PartList &partsUploaded, PartList &partsToUpload)
 {
     std::set<uint64_t> partNumbersUploaded;
-    
-    if(hasRecord_){ 
+    auto addUploaded = [&](const Part &part) {
+        //an auto-tuned part covers the layout parts of its size
+        int64_t layoutSize = static_cast<int64_t>(partSize_);
+        int64_t covered = std::max<int64_t>((part.Size() + layoutSize - 1) / layoutSize, 1);
+        for (int64_t n = 0; n < covered; n++) {
+            partNumbersUploaded.insert(part.PartNumber() + n);
+        }
+        partsUploaded.push_back(part);
+        consumedSize_ += part.Size();
+    };
+
+    std::vector<CheckpointJournal::Entry> entries;
+    if (hasRecord_ && replayJournal(entries)) {
+        for (const auto &entry : entries) {
+            Part part(entry.partNumber, entry.eTag);
+            part.size_ = entry.size;
+            part.cRC64_ = entry.crc64;
+            addUploaded(part);
+        }
+    }
+    else if(hasRecord_){ 
+        //a record of an older version, the journal starts from the listed parts
         uint32_t marker = 0;
         auto listPartsRequest = ListPartsRequest(request_.Bucket(), request_.Key(), uploadID_);
         if (!request_.EncodingType().empty()) {
@@ -320,9 +353,13 @@ int ResumableUploader::getPartsToUpload(OssError &err, PartList &partsUploaded,
 
             auto parts = outcome.result().PartList();
             for(auto iter = parts.begin(); iter != parts.end(); iter++){
-                partNumbersUploaded.insert(iter->PartNumber());
-                partsUploaded.emplace_back(*iter);
-                consumedSize_ += iter->Size();
+                addUploaded(*iter);
+                CheckpointJournal::Entry entry;
+                entry.partNumber = iter->PartNumber();
+                entry.size = iter->Size();
+                entry.crc64 = iter->CRC64();
+                entry.eTag = iter->ETag();
+                entries.push_back(entry);
             }
 
             if(outcome.result().IsTruncated()){
@@ -331,6 +368,7 @@ int ResumableUploader::getPartsToUpload(OssError &err, PartList &partsUploaded,
                 break;
             }
         }
+        rewriteJournal(entries);
     }
 
     int32_t partCount = (int32_t)((objectSize_ - 1)/ partSize_ + 1);
@@ -15,14 +15,15 @@
  */
 
 #include <alibabacloud/oss/ServiceRequest.h>
-#include <sstream>
+#include <alibabacloud/oss/utils/BufferPool.h>
 
 using namespace AlibabaCloud::OSS;
 
 ServiceRequest::ServiceRequest() :
     flags_(0),
     path_("/"),
-    responseStreamFactory_([] { return std::make_shared<std::stringstream>(); })
+    responseStreamFactory_([] { return std::make_shared<PooledBufferStream>(); }),
+    transferPriority_(AlibabaCloud::OSS::TransferPriority::Normal)
 {
     transferProgress_.Handler = nullptr;
     transferProgress_.UserData = nullptr;
@@ -67,3 +68,28 @@ void ServiceRequest::setFlags(int flags)
 {
     flags_ = flags;
 }
+
+void ServiceRequest::setTransferPriority(AlibabaCloud::OSS::TransferPriority priority)
+{
+    transferPriority_ = priority;
+}
+
+AlibabaCloud::OSS::TransferPriority ServiceRequest::TransferPriority() const
+{
+    return transferPriority_;
+}
+
+void ServiceRequest::setCancelFlag(const std::shared_ptr<std::atomic<bool>> &flag)
+{
+    cancelFlag_ = flag;
+}
+
+const std::shared_ptr<std::atomic<bool>> &ServiceRequest::CancelFlag() const
+{
+    return cancelFlag_;
+}
+
+bool ServiceRequest::isCancelled() const
+{
+    return cancelFlag_ != nullptr && cancelFlag_->load();
+}
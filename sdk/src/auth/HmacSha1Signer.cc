@@ -15,11 +15,13 @@
  */
 
 #include "HmacSha1Signer.h"
+#include <cstring>
 #if 0//def _WIN32
 #include <windows.h>
 #include <wincrypt.h>
 #else
 #include <openssl/hmac.h>
+#include <openssl/evp.h>
 #ifdef OPENSSL_IS_BORINGSSL 
 #include <openssl/base64.h>
 #endif
@@ -27,6 +29,80 @@
 
 using namespace AlibabaCloud::OSS;
 
+namespace
+{
+    const size_t Sha1BlockSize = 64;
+
+    struct DigestContext
+    {
+        DigestContext() : ctx(EVP_MD_CTX_create()) {}
+        ~DigestContext() { EVP_MD_CTX_destroy(ctx); }
+        EVP_MD_CTX *ctx;
+    };
+}
+
+/*HMAC(K, m) = H((K ^ opad) || H((K ^ ipad) || m)), the two keyed prefixes are hashed once*/
+struct HmacSha1Signer::KeyState : public Signer::Key
+{
+    explicit KeyState(const std::string &key) :
+        secret(key),
+        inner(EVP_MD_CTX_create()),
+        outer(EVP_MD_CTX_create())
+    {
+        unsigned char block[Sha1BlockSize];
+        std::memset(block, 0, sizeof(block));
+        if (key.size() > Sha1BlockSize) {
+            unsigned int len = 0;
+            EVP_Digest(key.data(), key.size(), block, &len, EVP_sha1(), nullptr);
+        }
+        else {
+            std::memcpy(block, key.data(), key.size());
+        }
+
+        unsigned char pad[Sha1BlockSize];
+        for (size_t i = 0; i < Sha1BlockSize; i++) {
+            pad[i] = block[i] ^ 0x36;
+        }
+        EVP_DigestInit_ex(inner, EVP_sha1(), nullptr);
+        EVP_DigestUpdate(inner, pad, sizeof(pad));
+        for (size_t i = 0; i < Sha1BlockSize; i++) {
+            pad[i] = block[i] ^ 0x5c;
+        }
+        EVP_DigestInit_ex(outer, EVP_sha1(), nullptr);
+        EVP_DigestUpdate(outer, pad, sizeof(pad));
+    }
+
+    ~KeyState()
+    {
+        EVP_MD_CTX_destroy(inner);
+        EVP_MD_CTX_destroy(outer);
+    }
+
+    //the keyed states are shared, each call hashes in a copy
+    void sign(const std::string &src, std::string &signature) const override
+    {
+        unsigned char md[EVP_MAX_MD_SIZE];
+        unsigned int mdLen = 0;
+        static thread_local DigestContext work;
+        signature.clear();
+        if (EVP_MD_CTX_copy_ex(work.ctx, inner) != 1 ||
+            EVP_DigestUpdate(work.ctx, src.c_str(), src.size()) != 1 ||
+            EVP_DigestFinal_ex(work.ctx, md, &mdLen) != 1 ||
+            EVP_MD_CTX_copy_ex(work.ctx, outer) != 1 ||
+            EVP_DigestUpdate(work.ctx, md, mdLen) != 1 ||
+            EVP_DigestFinal_ex(work.ctx, md, &mdLen) != 1)
+            return;
+
+        char encodedData[100];
+        int len = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(encodedData), md, mdLen);
+        signature.append(encodedData, len);
+    }
+
+    std::string secret;
+    EVP_MD_CTX *inner;
+    EVP_MD_CTX *outer;
+};
+
 HmacSha1Signer::HmacSha1Signer() :
     Signer(HmacSha1, "HMAC-SHA1", "1.0")
 {
@@ -36,6 +112,21 @@ HmacSha1Signer::~HmacSha1Signer()
 {
 }
 
+std::shared_ptr<const HmacSha1Signer::KeyState> HmacSha1Signer::keyState(const std::string &secret)
+{
+    //the state depends on the secret only, so no signer or thread shares it and nothing is locked
+    static thread_local std::shared_ptr<const KeyState> state;
+    if (state == nullptr || state->secret != secret) {
+        state = std::make_shared<const KeyState>(secret);
+    }
+    return state;
+}
+
+std::shared_ptr<const Signer::Key> HmacSha1Signer::prepare(const std::string &secret) const
+{
+    return keyState(secret);
+}
+
 std::string HmacSha1Signer::generate(const std::string & src, const std::string & secret) const
 {
     if (src.empty())
@@ -87,16 +178,8 @@ std::string HmacSha1Signer::generate(const std::string & src, const std::string
     delete dest;
     return ret;
 #else
-    unsigned char md[32];
-    unsigned int mdLen = 32;
-
-    if (HMAC(EVP_sha1(), secret.c_str(), static_cast<int>(secret.size()),
-        reinterpret_cast<const unsigned char*>(src.c_str()), src.size(),
-        md, &mdLen) == nullptr)
-        return std::string();
-
-    char encodedData[100];
-    EVP_EncodeBlock(reinterpret_cast<unsigned char*>(encodedData), md, mdLen);
-    return encodedData;
+    std::string signature;
+    keyState(secret)->sign(src, signature);
+    return signature;
 #endif
 }
\ No newline at end of file
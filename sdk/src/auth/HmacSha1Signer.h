@@ -17,6 +17,7 @@
 #pragma once
 
 #include "Signer.h"
+#include <memory>
 
 
 namespace AlibabaCloud
@@ -31,6 +32,12 @@ namespace OSS
         ~HmacSha1Signer();
         
         virtual std::string generate(const std::string &src, const std::string &secret)const override;
+        virtual std::shared_ptr<const Key> prepare(const std::string &secret) const override;
+
+    private:
+        struct KeyState;
+        //the sha1 states after the padded key, a snapshot per thread rebuilt when the secret changes
+        static std::shared_ptr<const KeyState> keyState(const std::string &secret);
     };
 }
 }
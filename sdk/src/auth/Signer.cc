@@ -29,6 +29,31 @@ Signer::~Signer()
 {
 }
 
+namespace
+{
+    class GenericKey : public Signer::Key
+    {
+    public:
+        GenericKey(const Signer &signer, const std::string &secret) :
+            signer_(signer),
+            secret_(secret)
+        {
+        }
+        void sign(const std::string &src, std::string &signature) const override
+        {
+            signature = signer_.generate(src, secret_);
+        }
+    private:
+        const Signer &signer_;
+        std::string secret_;
+    };
+}
+
+std::shared_ptr<const Signer::Key> Signer::prepare(const std::string &secret) const
+{
+    return std::make_shared<GenericKey>(*this, secret);
+}
+
 std::string Signer::name() const
 {
     return name_;
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 namespace AlibabaCloud
@@ -30,9 +31,17 @@ namespace OSS
         {
             HmacSha1,
         };
+        /*a secret prepared once for signing many strings*/
+        class Key
+        {
+        public:
+            virtual ~Key() {}
+            virtual void sign(const std::string &src, std::string &signature) const = 0;
+        };
         virtual ~Signer();
 
         virtual std::string generate(const std::string &src, const std::string &secret)const = 0;
+        virtual std::shared_ptr<const Key> prepare(const std::string &secret) const;
         std::string name()const;
         Type type() const;
         std::string version()const;
@@ -15,24 +15,37 @@
  */
 
 #include <alibabacloud/oss/client/RetryStrategy.h>
+#include <alibabacloud/oss/utils/BufferPool.h>
+#include <alibabacloud/oss/utils/Runnable.h>
 #include <tinyxml2/tinyxml2.h>
 #include "Client.h"
 #include "../http/CurlHttpClient.h"
+#include "../http/CurlMultiHttpClient.h"
 #include "../utils/Executor.h"
 #include "../utils/Utils.h"
+#include "../utils/LogUtils.h"
 #include "../auth/Signer.h"
 #include <sstream>
+#include <atomic>
+#include <cstdlib>
 #include <ctime>
+#include <chrono>
+#include <condition_variable>
+#include <vector>
 
 
 using namespace AlibabaCloud::OSS;
 using namespace tinyxml2;
 
+static const char *TAG = "Client";
+
 Client::Client(const std::string & servicename, const ClientConfiguration &configuration) :
     requestDateOffset_(0),
     serviceName_(servicename),
     configuration_(configuration),
-    httpClient_(std::make_shared<CurlHttpClient>(configuration))
+    httpClient_(configuration.eventLoopThreadNum > 0 ?
+        std::make_shared<CurlMultiHttpClient>(configuration) :
+        std::make_shared<CurlHttpClient>(configuration))
 {
 }
 
@@ -52,44 +65,275 @@ std::string Client::serviceName()const
 
 Client::ClientOutcome Client::AttemptRequest(const std::string & endpoint, const ServiceRequest & request, Http::Method method) const
 {
+    if (!httpClient_->isEnable()) {
+        return ClientOutcome(Error("ClientError:100002", "Disable all requests by upper."));
+    }
+
+    //the body is serialized and hashed once, a retry only signs again
+    std::shared_ptr<const HttpRequest> prepared = prepareHttpRequest(endpoint, request, method);
     for (int retry =0; ;retry++) {
-        auto outcome = AttemptOnceRequest(endpoint, request, method);
-        if (outcome.isSuccess()) {
-            return outcome;
-        } 
-        else if (!httpClient_->isEnable()) {
+        auto outcome = AttemptOnceRequest(request, prepared);
+        long sleepTmeMs = 0;
+        if (!shouldRetry(request, outcome, retry, sleepTmeMs)) {
             return outcome;
         }
-        else {
-            if (configuration_.enableDateSkewAdjustment &&
-                outcome.error().Status() == 403 &&
-                outcome.error().Message().find("RequestTimeTooSkewed")) {
-                auto serverTimeStr = analyzeServerTime(outcome.error().Message());
-                auto serverTime = UtcToUnixTime(serverTimeStr);
-                if (serverTime != -1) {
-                    std::time_t localTime = std::time(nullptr);
-                    setRequestDateOffset(serverTime - localTime);
-                }
-            }
-            RetryStrategy *retryStrategy = configuration().retryStrategy.get();
-            if (retryStrategy == nullptr || !retryStrategy->shouldRetry(outcome.error(), retry)) {
-                return outcome;
-            }
-            long sleepTmeMs = retryStrategy->calcDelayTimeMs(outcome.error(), retry);
-            httpClient_->waitForRetry(sleepTmeMs);
+        httpClient_->waitForRetry(sleepTmeMs);
+    }
+}
+
+void Client::AttemptRequestAsync(const std::string & endpoint, const std::shared_ptr<const ServiceRequest> &request, Http::Method method,
+    const ClientOutcomeHandler &handler) const
+{
+    if (!httpClient_->isEnable()) {
+        handler(ClientOutcome(Error("ClientError:100002", "Disable all requests by upper.")));
+        return;
+    }
+    attemptRequestAsync(request, prepareHttpRequest(endpoint, *request, method), handler, 0);
+}
+
+void Client::attemptRequestAsync(const std::shared_ptr<const ServiceRequest> &request, const std::shared_ptr<const HttpRequest> &prepared,
+    const ClientOutcomeHandler &handler, int retry) const
+{
+    if (!httpClient_->isEnable()) {
+        handler(ClientOutcome(Error("ClientError:100002", "Disable all requests by upper.")));
+        return;
+    }
+
+    auto r = signHttpRequest(*prepared, *request);
+    httpClient_->makeRequestAsync(r, [this, request, prepared, handler, retry](const std::shared_ptr<HttpResponse> &response)
+    {
+        auto outcome = buildOutcome(response);
+        long sleepTmeMs = 0;
+        if (!shouldRetry(*request, outcome, retry, sleepTmeMs)) {
+            handler(outcome);
+            return;
+        }
+        httpClient_->schedule([this, request, prepared, handler, retry]()
+        {
+            attemptRequestAsync(request, prepared, handler, retry + 1);
+        }, sleepTmeMs);
+    });
+}
+
+bool Client::shouldRetry(const ServiceRequest &request, const ClientOutcome &outcome, int retry, long &delayMs) const
+{
+    if (outcome.isSuccess() || !httpClient_->isEnable() || request.isCancelled()) {
+        return false;
+    }
+
+    if (configuration_.enableDateSkewAdjustment &&
+        outcome.error().Status() == 403 &&
+        outcome.error().Message().find("RequestTimeTooSkewed")) {
+        auto serverTimeStr = analyzeServerTime(outcome.error().Message());
+        auto serverTime = UtcToUnixTime(serverTimeStr);
+        if (serverTime != -1) {
+            std::time_t localTime = std::time(nullptr);
+            setRequestDateOffset(serverTime - localTime);
         }
     }
+    RetryStrategy *retryStrategy = configuration().retryStrategy.get();
+    if (retryStrategy == nullptr || !retryStrategy->shouldRetry(outcome.error(), retry)) {
+        return false;
+    }
+    delayMs = retryStrategy->calcDelayTimeMs(outcome.error(), retry);
+    return true;
+}
+
+static bool IsSuccessResponse(const std::shared_ptr<HttpResponse> &response)
+{
+    return response != nullptr && response->statusCode() / 100 == 2;
+}
+
+static long ElapsedMs(const std::chrono::steady_clock::time_point &start)
+{
+    return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count());
 }
 
-Client::ClientOutcome Client::AttemptOnceRequest(const std::string & endpoint, const ServiceRequest & request, Http::Method method) const
+Client::ClientOutcome Client::AttemptOnceRequest(const ServiceRequest & request, const std::shared_ptr<const HttpRequest> &prepared) const
 {
     if (!httpClient_->isEnable()) {
         return ClientOutcome(Error("ClientError:100002", "Disable all requests by upper."));
     }
 
-    auto r = buildHttpRequest(endpoint, request, method);
-    auto response = httpClient_->makeRequest(r); 
-    
+    auto r = signHttpRequest(*prepared, request);
+    if (!configuration_.enableHedgedGet) {
+        auto response = httpClient_->makeRequest(r); 
+        return buildOutcome(response);
+    }
+
+    //a hedged GET buffers its body, so only an object already seen to be small is hedged.
+    //A loop thread or a worker of the pool the attempts run on can not wait for them
+    auto sizeKey = r->url().authority() + r->url().path();
+    bool wholeObject = r->url().query().empty() && !r->hasHeader(Http::RANGE);
+    std::shared_ptr<HttpResponse> response;
+    if (r->method() == Http::Method::Get && wholeObject && !httpClient_->inEventLoop() &&
+        (httpClient_->isEventDriven() || (executor() != nullptr && !executor()->inWorker()))) {
+        auto size = objectSizes_.get(sizeKey);
+        if (size >= 0 && size <= configuration_.hedgeMaxSize) {
+            response = makeHedgedRequest(request, prepared, r);
+        }
+    }
+    if (response == nullptr) {
+        response = httpClient_->makeRequest(r);
+    }
+
+    if ((r->method() == Http::Method::Get || r->method() == Http::Method::Head) && wholeObject) {
+        if (IsSuccessResponse(response) && response->hasHeader(Http::CONTENT_LENGTH)) {
+            objectSizes_.put(sizeKey, std::atoll(response->Header(Http::CONTENT_LENGTH).c_str()));
+        }
+        else {
+            objectSizes_.remove(sizeKey);
+        }
+    }
+    else if (r->method() != Http::Method::Get && r->method() != Http::Method::Head) {
+        //the object may change
+        objectSizes_.remove(sizeKey);
+    }
+    return buildOutcome(response);
+}
+
+Executor *Client::executor() const
+{
+    return nullptr;
+}
+
+namespace
+{
+    //a successful response wins at once, a failed one only when nothing else is in flight
+    struct HedgeState
+    {
+        HedgeState() : done(false), pending(0), progressOwner(nullptr) {}
+
+        void complete(const std::shared_ptr<HttpResponse> &response, const std::shared_ptr<HttpRequest> &from)
+        {
+            std::lock_guard<std::mutex> lck(lock);
+            pending--;
+            if (done || (!IsSuccessResponse(response) && pending > 0)) {
+                return;
+            }
+            done = true;
+            winner = response;
+            winnerRequest = from;
+            for (auto const &r : requests) {
+                if (r != from) {
+                    r->cancel();
+                }
+            }
+            cv.notify_all();
+        }
+
+        std::mutex lock;
+        std::condition_variable cv;
+        bool done;
+        int pending;
+        std::vector<std::shared_ptr<HttpRequest>> requests;
+        std::shared_ptr<HttpResponse> winner;
+        std::shared_ptr<HttpRequest> winnerRequest;
+        //the attempt the caller sees the progress of
+        std::atomic<const HttpRequest *> progressOwner;
+    };
+}
+
+std::shared_ptr<HttpResponse> Client::makeHedgedRequest(const ServiceRequest &request, const std::shared_ptr<const HttpRequest> &prepared,
+    const std::shared_ptr<HttpRequest> &primary) const
+{
+    long delayMs = configuration_.hedgeDelayMs > 0 ? configuration_.hedgeDelayMs : getLatencies_.percentile(95);
+    auto start = std::chrono::steady_clock::now();
+    if (delayMs < 0) {
+        //not enough latencies yet
+        auto response = httpClient_->makeRequest(primary);
+        if (IsSuccessResponse(response)) {
+            getLatencies_.add(ElapsedMs(start));
+        }
+        return response;
+    }
+
+    //a cancelled transfer only stops at the next progress callback, up to a second later,
+    //so the caller waits for the winner and the loser finishes on its own. Both read into
+    //memory, the loser must not write to the caller's stream meanwhile
+    auto toMemory = [] { return std::make_shared<PooledBufferStream>(); };
+    primary->setResponseStreamFactory(toMemory);
+    auto state = std::make_shared<HedgeState>();
+    auto httpClient = httpClient_;
+    auto pool = executor();
+    auto launch = [state, httpClient, pool](const std::shared_ptr<HttpRequest> &r) {
+        {
+            std::lock_guard<std::mutex> lck(state->lock);
+            state->pending++;
+            state->requests.push_back(r);
+        }
+        if (httpClient->isEventDriven()) {
+            httpClient->makeRequestAsync(r, [state, r](const std::shared_ptr<HttpResponse> &response) {
+                state->complete(response, r);
+            });
+        }
+        else {
+            pool->execute(new Runnable([state, httpClient, r]() {
+                state->complete(httpClient->makeRequest(r), r);
+            }));
+        }
+    };
+
+    //the caller sees the progress of one attempt, the first one that transfers
+    auto track = [state](const std::shared_ptr<HttpRequest> &r) {
+        auto progress = r->TransferProgress();
+        if (!progress.Handler) {
+            return;
+        }
+        const HttpRequest *self = r.get();
+        r->setTransferProgress({ [state, progress, self](size_t increment, int64_t transferred, int64_t total, void *userData) {
+            const HttpRequest *owner = nullptr;
+            if (state->progressOwner.compare_exchange_strong(owner, self) || owner == self) {
+                progress.Handler(increment, transferred, total, userData);
+            }
+        }, progress.UserData });
+    };
+
+    track(primary);
+    launch(primary);
+    std::shared_ptr<HttpRequest> hedge;
+    {
+        std::unique_lock<std::mutex> lck(state->lock);
+        if (!state->cv.wait_for(lck, std::chrono::milliseconds(delayMs), [&] { return state->done; })) {
+            hedge = signHttpRequest(*prepared, request);
+            hedge->setResponseStreamFactory(toMemory);
+            track(hedge);
+        }
+    }
+    auto hedgeStart = std::chrono::steady_clock::now();
+    if (hedge != nullptr) {
+        launch(hedge);
+    }
+
+    std::shared_ptr<HttpResponse> winner;
+    bool hedgeWon = false;
+    {
+        std::unique_lock<std::mutex> lck(state->lock);
+        state->cv.wait(lck, [&] { return state->done; });
+        winner = state->winner;
+        hedgeWon = state->winnerRequest == hedge && hedge != nullptr;
+    }
+    if (IsSuccessResponse(winner)) {
+        getLatencies_.add(ElapsedMs(hedgeWon ? hedgeStart : start));
+    }
+
+    if (hedgeWon) {
+        OSS_LOG(LogLevel::LogDebug, TAG, "request(%p) hedged request(%p) came first", primary.get(), hedge.get());
+    }
+    //an error body stays in memory, it is parsed into the error
+    if (IsSuccessResponse(winner) && winner->Body() != nullptr && request.ResponseStreamFactory()) {
+        auto body = request.ResponseStreamFactory()();
+        std::istreambuf_iterator<char> isb(*winner->Body()), end;
+        std::copy(isb, end, std::ostreambuf_iterator<char>(*body));
+        body->seekg(0);
+        winner->addBody(body);
+    }
+    return winner;
+}
+
+Client::ClientOutcome Client::buildOutcome(const std::shared_ptr<HttpResponse> &response) const
+{
     if(hasResponseError(response)) {
         return ClientOutcome(buildError(response));
     } else {
@@ -136,7 +380,7 @@ Error Client::buildError(const std::shared_ptr<HttpResponse> &response) const
         error.setCode(ss.str());
         error.setMessage(response->statusMsg());
     }
-    error.setHeaders(response->Headers());
+    error.setHeaders(response->Headers().toHeaderCollection());
     return error;
 }
 
@@ -158,10 +402,25 @@ void Client::enableRequest()
     httpClient_->enable();
 }
 
+void Client::drainRequest()
+{
+    httpClient_->drain();
+}
+
+void Client::prewarmRequest(const std::string &url, unsigned count)
+{
+    httpClient_->prewarm(url, count);
+}
+
 bool Client::isEnableRequest() const
 {
     return httpClient_->isEnable();
 }
+
+bool Client::isEventDriven() const
+{
+    return httpClient_->isEventDriven();
+}
    
 void Client::setRequestDateOffset(uint64_t offset) const
 {
@@ -24,16 +24,21 @@
 #include <alibabacloud/oss/client/Error.h>
 #include <alibabacloud/oss/utils/Outcome.h>
 #include "../http/HttpClient.h"
+#include "LatencyWindow.h"
+#include "ObjectSizeCache.h"
 
 namespace AlibabaCloud
 {
 namespace OSS
 {
 
+    class Executor;
+
     class  Client
     {
     public:
         using ClientOutcome =  Outcome<Error, std::shared_ptr<HttpResponse>> ;
+        using ClientOutcomeHandler = std::function<void(const ClientOutcome &outcome)>;
 
         Client(const std::string & servicename, const ClientConfiguration &configuration);
         virtual ~Client();
@@ -42,19 +47,35 @@ namespace OSS
         const ClientConfiguration &configuration()const;
 
         bool isEnableRequest() const;
+        bool isEventDriven() const;
 
     protected:
         ClientOutcome AttemptRequest(const std::string & endpoint, const ServiceRequest &request, Http::Method method) const;
-        ClientOutcome AttemptOnceRequest(const std::string & endpoint, const ServiceRequest &request, Http::Method method) const;
-        virtual std::shared_ptr<HttpRequest> buildHttpRequest(const std::string & endpoint, const ServiceRequest &msg, Http::Method method) const = 0;
+        ClientOutcome AttemptOnceRequest(const ServiceRequest &request, const std::shared_ptr<const HttpRequest> &prepared) const;
+        void AttemptRequestAsync(const std::string & endpoint, const std::shared_ptr<const ServiceRequest> &request, Http::Method method,
+            const ClientOutcomeHandler &handler) const;
+        /*the parts of the request that hold across the retries: headers, body, Content-MD5 and url*/
+        virtual std::shared_ptr<HttpRequest> prepareHttpRequest(const std::string & endpoint, const ServiceRequest &msg, Http::Method method) const = 0;
+        /*a copy of the prepared request, dated and signed for one attempt*/
+        virtual std::shared_ptr<HttpRequest> signHttpRequest(const HttpRequest &prepared, const ServiceRequest &msg) const = 0;
         virtual bool hasResponseError(const std::shared_ptr<HttpResponse>&response) const;
+        /*the pool the hedged GETs run on, none by default*/
+        virtual Executor *executor() const;
         
         void setRequestDateOffset(uint64_t offset) const;
         uint64_t getRequestDateOffset() const;
 
         void disableRequest();
         void enableRequest();
+        void drainRequest();
+        void prewarmRequest(const std::string &url, unsigned count);
     private:
+        bool shouldRetry(const ServiceRequest &request, const ClientOutcome &outcome, int retry, long &delayMs) const;
+        void attemptRequestAsync(const std::shared_ptr<const ServiceRequest> &request, const std::shared_ptr<const HttpRequest> &prepared,
+            const ClientOutcomeHandler &handler, int retry) const;
+        std::shared_ptr<HttpResponse> makeHedgedRequest(const ServiceRequest &request, const std::shared_ptr<const HttpRequest> &prepared,
+            const std::shared_ptr<HttpRequest> &primary) const;
+        ClientOutcome buildOutcome(const std::shared_ptr<HttpResponse> &response) const;
         Error buildError(const std::shared_ptr<HttpResponse> &response) const ;
         std::string analyzeServerTime(const std::string &message) const;
 
@@ -62,6 +83,10 @@ namespace OSS
         std::string serviceName_;
         ClientConfiguration configuration_;
         std::shared_ptr<HttpClient> httpClient_;
+        //the recent GET latencies the hedged GETs wait for
+        mutable LatencyWindow getLatencies_;
+        //only the objects known to be no larger than hedgeMaxSize are hedged
+        mutable ObjectSizeCache objectSizes_;
     };
 }
 }
@@ -63,31 +63,7 @@ bool DefaultRetryStrategy::shouldRetry(const Error & error, long attemptedRetrie
     if (attemptedRetries >= m_maxRetries)
         return false;
 
-    long responseCode = error.Status();
-
-    //http code
-    if ((responseCode == 403 && error.Message().find("RequestTimeTooSkewed")) ||
-        (responseCode > 499 && responseCode < 599)) {
-        return true;
-    }
-    else {
-        switch (responseCode)
-        {
-        //curl error code
-        case (ERROR_CURL_BASE + 7):  //CURLE_COULDNT_CONNECT
-        case (ERROR_CURL_BASE + 18): //CURLE_PARTIAL_FILE
-        case (ERROR_CURL_BASE + 23): //CURLE_WRITE_ERROR
-        case (ERROR_CURL_BASE + 28): //CURLE_OPERATION_TIMEDOUT
-        case (ERROR_CURL_BASE + 52): //CURLE_GOT_NOTHING
-        case (ERROR_CURL_BASE + 55): //CURLE_SEND_ERROR
-        case (ERROR_CURL_BASE + 56): //CURLE_RECV_ERROR
-            return true;
-        default:
-            break;
-        };
-    }
-
-    return false;
+    return isRetryableError(error);
 }
 
 long DefaultRetryStrategy::calcDelayTimeMs(const Error & error, long attemptedRetries) const
@@ -110,9 +86,19 @@ ClientConfiguration::ClientConfiguration() :
     verifySSL(false),
     isCname(false),
     enableCrc64(true),
+    enableContentMd5(false),
     enableDateSkewAdjustment(true),
     sendRateLimiter(nullptr),
-    recvRateLimiter(nullptr)
+    recvRateLimiter(nullptr),
+    executorThreadNum(0),
+    executorQueueDepth(4096),
+    eventLoopThreadNum(0),
+    prewarmConnections(0),
+    enableHedgedGet(false),
+    hedgeDelayMs(0),
+    hedgeMaxSize(1024 * 1024),
+    transferThreadNum(0),
+    transferMaxInflightBytes(0)
 {
 
 }
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LatencyWindow.h"
+#include <algorithm>
+
+using namespace AlibabaCloud::OSS;
+
+LatencyWindow::LatencyWindow() :
+    next_(0)
+{
+    samples_.reserve(Capacity);
+}
+
+void LatencyWindow::add(long latencyMs)
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    if (samples_.size() < Capacity) {
+        samples_.push_back(latencyMs);
+    }
+    else {
+        samples_[next_] = latencyMs;
+        next_ = (next_ + 1) % Capacity;
+    }
+}
+
+long LatencyWindow::percentile(int percent) const
+{
+    std::vector<long> samples;
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        if (samples_.size() < MinSamples) {
+            return -1;
+        }
+        samples = samples_;
+    }
+    size_t rank = (samples.size() * static_cast<size_t>(percent) + 99) / 100;
+    rank = std::min(std::max(rank, static_cast<size_t>(1)), samples.size()) - 1;
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
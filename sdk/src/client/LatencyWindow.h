@@ -0,0 +1,44 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /*latencies of the last requests, in ms*/
+    class LatencyWindow
+    {
+    public:
+        static const size_t Capacity = 256;
+        static const size_t MinSamples = 20;
+
+        LatencyWindow();
+        void add(long latencyMs);
+        /*percent in (0, 100], -1 until MinSamples latencies are collected*/
+        long percentile(int percent) const;
+
+    private:
+        mutable std::mutex lock_;
+        std::vector<long> samples_;
+        size_t next_;
+    };
+}
+}
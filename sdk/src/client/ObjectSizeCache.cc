@@ -0,0 +1,41 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ObjectSizeCache.h"
+
+using namespace AlibabaCloud::OSS;
+
+void ObjectSizeCache::put(const std::string &key, int64_t size)
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    if (sizes_.size() >= Capacity && sizes_.find(key) == sizes_.end()) {
+        sizes_.erase(sizes_.begin());
+    }
+    sizes_[key] = size;
+}
+
+void ObjectSizeCache::remove(const std::string &key)
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    sizes_.erase(key);
+}
+
+int64_t ObjectSizeCache::get(const std::string &key) const
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    auto it = sizes_.find(key);
+    return it == sizes_.end() ? -1 : it->second;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /*the sizes of the objects seen by the recent GETs and HEADs, by host and path*/
+    class ObjectSizeCache
+    {
+    public:
+        static const size_t Capacity = 1024;
+
+        void put(const std::string &key, int64_t size);
+        void remove(const std::string &key);
+        /*-1 when the size is not known*/
+        int64_t get(const std::string &key) const;
+
+    private:
+        mutable std::mutex lock_;
+        std::unordered_map<std::string, int64_t> sizes_;
+    };
+}
+}
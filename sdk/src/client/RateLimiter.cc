@@ -0,0 +1,67 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <alibabacloud/oss/client/RateLimiter.h>
+
+using namespace AlibabaCloud::OSS;
+
+namespace
+{
+    size_t WeightIndex(TransferPriority priority)
+    {
+        size_t index = static_cast<size_t>(priority);
+        return index < 3 ? index : 2;
+    }
+}
+
+TokenBucketRateLimiter::TokenBucketRateLimiter(int rate, int64_t burst) :
+    rate_(rate),
+    burst_(burst)
+{
+    weights_[0] = RateLimiter::PriorityWeight(TransferPriority::High);
+    weights_[1] = RateLimiter::PriorityWeight(TransferPriority::Normal);
+    weights_[2] = RateLimiter::PriorityWeight(TransferPriority::Low);
+}
+
+void TokenBucketRateLimiter::setRate(int rate)
+{
+    rate_ = rate;
+}
+
+int TokenBucketRateLimiter::Rate() const
+{
+    return rate_;
+}
+
+void TokenBucketRateLimiter::setBurst(int64_t burst)
+{
+    burst_ = burst;
+}
+
+int64_t TokenBucketRateLimiter::Burst() const
+{
+    return burst_;
+}
+
+void TokenBucketRateLimiter::setPriorityWeight(TransferPriority priority, int weight)
+{
+    weights_[WeightIndex(priority)] = weight < 1 ? 1 : weight;
+}
+
+int TokenBucketRateLimiter::PriorityWeight(TransferPriority priority) const
+{
+    return weights_[WeightIndex(priority)];
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <thread>
+#include "../utils/Utils.h"
+
+using namespace AlibabaCloud::OSS;
+
+bool RetryStrategy::isRetryableError(const Error& error)
+{
+    long responseCode = error.Status();
+
+    //http code
+    if ((responseCode == 403 && error.Message().find("RequestTimeTooSkewed")) ||
+        (responseCode > 499 && responseCode < 599)) {
+        return true;
+    }
+    else {
+        switch (responseCode)
+        {
+        //curl error code
+        case (ERROR_CURL_BASE + 7):  //CURLE_COULDNT_CONNECT
+        case (ERROR_CURL_BASE + 18): //CURLE_PARTIAL_FILE
+        case (ERROR_CURL_BASE + 23): //CURLE_WRITE_ERROR
+        case (ERROR_CURL_BASE + 28): //CURLE_OPERATION_TIMEDOUT
+        case (ERROR_CURL_BASE + 52): //CURLE_GOT_NOTHING
+        case (ERROR_CURL_BASE + 55): //CURLE_SEND_ERROR
+        case (ERROR_CURL_BASE + 56): //CURLE_RECV_ERROR
+            return true;
+        default:
+            break;
+        };
+    }
+
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static std::mt19937_64 &RandomEngine()
+{
+    static thread_local std::mt19937_64 engine(std::random_device{}() ^
+        std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return engine;
+}
+
+JitterRetryStrategy::JitterRetryStrategy(long maxRetries, long baseDelayMs, long maxDelayMs) :
+    maxRetries_(maxRetries),
+    baseDelayMs_(std::max(baseDelayMs, 1L)),
+    maxDelayMs_(std::max(maxDelayMs, baseDelayMs_))
+{
+}
+
+bool JitterRetryStrategy::shouldRetry(const Error& error, long attemptedRetries) const
+{
+    if (attemptedRetries >= maxRetries_)
+        return false;
+
+    return isRetryableError(error);
+}
+
+long JitterRetryStrategy::calcDelayTimeMs(const Error& error, long attemptedRetries) const
+{
+    UNUSED_PARAM(error);
+    //the strategy keeps no state per request, so the chain of delays up to this
+    //retry is drawn again, which gives the same distribution as the stored one
+    auto &engine = RandomEngine();
+    long delay = baseDelayMs_;
+    for (long i = 0; i <= attemptedRetries; i++) {
+        std::uniform_int_distribution<long> dist(baseDelayMs_, std::max(baseDelayMs_, std::min(maxDelayMs_, delay * 3)));
+        delay = dist(engine);
+    }
+    return delay;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+RetryBudgetStrategy::RetryBudgetStrategy(const std::shared_ptr<RetryStrategy>& strategy, double maxTokens, double tokensPerSecond) :
+    strategy_(strategy),
+    maxTokens_(maxTokens),
+    tokensPerSecond_(tokensPerSecond),
+    tokens_(maxTokens),
+    lastRefill_(std::chrono::steady_clock::now())
+{
+}
+
+void RetryBudgetStrategy::refill() const
+{
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - lastRefill_;
+    tokens_ = std::min(maxTokens_, tokens_ + elapsed.count() * tokensPerSecond_);
+    lastRefill_ = now;
+}
+
+bool RetryBudgetStrategy::shouldRetry(const Error& error, long attemptedRetries) const
+{
+    if (strategy_ == nullptr || !strategy_->shouldRetry(error, attemptedRetries)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lck(lock_);
+    refill();
+    if (tokens_ < 1.0) {
+        return false;
+    }
+    tokens_ -= 1.0;
+    return true;
+}
+
+long RetryBudgetStrategy::calcDelayTimeMs(const Error& error, long attemptedRetries) const
+{
+    return strategy_->calcDelayTimeMs(error, attemptedRetries);
+}
+
+double RetryBudgetStrategy::AvailableTokens() const
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    refill();
+    return tokens_;
+}
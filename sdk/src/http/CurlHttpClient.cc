@@ -17,15 +17,22 @@
 #include "CurlHttpClient.h"
 #include <curl/curl.h>
 #include <cassert>
+#include <chrono>
+#include <cstring>
 #include <sstream>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
 #include <algorithm>
+#include <memory>
+#include <thread>
+#include <functional>
 #include <../utils/Crc64.h>
 #include <alibabacloud/oss/client/Error.h>
 #include <alibabacloud/oss/client/RateLimiter.h>
+#include <alibabacloud/oss/utils/BufferPool.h>
+#include "../utils/BandwidthShaper.h"
 #include "../utils/LogUtils.h"
 #include "../utils/Utils.h"
 
@@ -37,101 +44,114 @@ namespace OSS
 {
     const char * TAG = "CurlHttpClient";
     ////////////////////////////////////////////////////////////////////////////////////////////
-    template< typename RESOURCE_TYPE>
-    class ResourceManager_
+    const unsigned MaxShardNum = 16;
+    //how many idle handles are checked for the host affinity
+    const size_t AffinityScanNum = 8;
+
+    static unsigned nextShardSlot()
     {
-    public:
-        ResourceManager_() : m_shutdown(false) {}
-        RESOURCE_TYPE Acquire()
-        {
-            std::unique_lock<std::mutex> locker(m_queueLock);
-            while(!m_shutdown.load() && m_resources.size() == 0)
-            {
-                m_semaphore.wait(locker, [&](){ return m_shutdown.load() || m_resources.size() > 0; });                    
-            }
-    
-            assert(!m_shutdown.load());
-    
-            RESOURCE_TYPE resource = m_resources.back();
-            m_resources.pop_back();
-    
-            return resource;
-        }
-    
-        bool HasResourcesAvailable()
-        {
-            std::lock_guard<std::mutex> locker(m_queueLock);
-            return m_resources.size() > 0 && !m_shutdown.load();
-        }
-    
-        void Release(RESOURCE_TYPE resource)
-        {
-            std::unique_lock<std::mutex> locker(m_queueLock);
-            m_resources.push_back(resource);
-            locker.unlock();
-            m_semaphore.notify_one();
-        }
-    
-        void PutResource(RESOURCE_TYPE resource)
-        {
-            m_resources.push_back(resource);
-        }
-    
-        std::vector<RESOURCE_TYPE> ShutdownAndWait(size_t resourceCount)
-        {
-            std::vector<RESOURCE_TYPE> resources;
-            std::unique_lock<std::mutex> locker(m_queueLock);
-            m_shutdown = true;
-            while (m_resources.size() < resourceCount)
-            {
-                m_semaphore.wait(locker, [&]() { return m_resources.size() == resourceCount; });
-            }
-            resources = m_resources;
-            m_resources.clear();
-            return resources;
-        }
-    
-    private:
-        std::vector<RESOURCE_TYPE> m_resources;
-        std::mutex m_queueLock;
-        std::condition_variable m_semaphore;
-        std::atomic<bool> m_shutdown;
-    };
-    
-    
+        static std::atomic<unsigned> slot(0);
+        return slot++;
+    }
+
+    /*
+    * The idle handles are spread over a few shards, each thread prefers its own
+    * one, so concurrent acquire/release rarely touch the same lock. A handle keeps
+    * the host it served last, an acquire for that host picks it first to reuse
+    * its keep-alive connection.
+    */
     class CurlContainer
     {
     public:
         CurlContainer(unsigned maxSize = 16, long requestTimeout = 10000, long connectTimeout = 5000):
+              shardNum_(1),
               maxPoolSize_(maxSize), 
               requestTimeout_(requestTimeout), 
               connectTimeout_(connectTimeout),
-              poolSize_(0)
+              poolSize_(0),
+              idleCount_(0),
+              waiters_(0),
+              shutdown_(false),
+              share_(curl_share_init())
         {
+            unsigned num = (std::max)(1U, (std::min)(std::thread::hardware_concurrency(), MaxShardNum));
+            shardNum_ = (std::max)(1U, (std::min)(num, maxPoolSize_));
+            shards_.reset(new Shard[shardNum_]);
+
+            //dns cache and tls sessions are shared by all the handles
+            if (share_ != nullptr) {
+                curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, lockShare);
+                curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, unlockShare);
+                curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+                curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+                curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            }
         }
     
         ~CurlContainer()
         {
-            for (CURL* handle : handleContainer_.ShutdownAndWait(poolSize_)) {
-                curl_easy_cleanup(handle);
+            {
+                std::unique_lock<std::mutex> locker(waitLock_);
+                shutdown_ = true;
+                waiters_++;
+                waitCv_.wait(locker, [&]() { return idleCount_.load() == static_cast<int>(poolSize_.load()); });
+                waiters_--;
+            }
+            for (unsigned i = 0; i < shardNum_; i++) {
+                for (auto &idle : shards_[i].handles) {
+                    curl_easy_cleanup(idle.handle);
+                }
+            }
+            if (share_ != nullptr) {
+                curl_share_cleanup(share_);
             }
         }
     
-        CURL* Acquire()
+        CURL* Acquire(const std::string &host)
         {
-            if(!handleContainer_.HasResourcesAvailable()) {
-                growPool();
+            size_t hostKey = std::hash<std::string>()(host);
+            for (;;) {
+                CURL* handle = TryAcquire(hostKey);
+                if (handle != nullptr) {
+                    return handle;
+                }
+                std::unique_lock<std::mutex> locker(waitLock_);
+                waiters_++;
+                waitCv_.wait(locker, [&]() { return shutdown_ || idleCount_.load() > 0 || poolSize_.load() < maxPoolSize_; });
+                waiters_--;
+                assert(!shutdown_);
             }
-            CURL* handle = handleContainer_.Acquire();
-            return handle;
         }    
+
+        CURL* TryAcquire(const std::string &host)
+        {
+            return TryAcquire(std::hash<std::string>()(host));
+        }
+
+        /*a handle outside of the pool, for a caller that must not wait for one*/
+        CURL* CreateUnpooled()
+        {
+            CURL* handle = curl_easy_init();
+            if (handle != nullptr) {
+                setDefaultOptions(handle);
+            }
+            return handle;
+        }
     
-        void Release(CURL* handle)
+        void Release(CURL* handle, const std::string &host)
         {
             if (handle) {
-                curl_easy_reset(handle);
-                setDefaultOptions(handle);
-                handleContainer_.Release(handle);
+                resetRequestOptions(handle);
+                Shard &shard = localShard();
+                {
+                    std::lock_guard<std::mutex> locker(shard.lock);
+                    shard.handles.push_back(IdleHandle{ handle, std::hash<std::string>()(host) });
+                    idleCount_++;
+                }
+                if (waiters_.load() > 0) {
+                    std::lock_guard<std::mutex> locker(waitLock_);
+                    waitCv_.notify_one();
+                }
             }
         }
     
@@ -140,29 +160,74 @@ namespace OSS
         const CurlContainer& operator = (const CurlContainer&) = delete;
         CurlContainer(const CurlContainer&&) = delete;
         const CurlContainer& operator = (const CurlContainer&&) = delete;
-    
-        bool growPool()
+
+        struct IdleHandle
         {
-            std::lock_guard<std::mutex> locker(containerLock_);
-            if (poolSize_ < maxPoolSize_) {
-                unsigned multiplier = poolSize_ > 0 ? poolSize_ : 1;
-                unsigned amountToAdd = (std::min)(multiplier * 2, maxPoolSize_ - poolSize_);
-        
-                unsigned actuallyAdded = 0;
-                for (unsigned i = 0; i < amountToAdd; ++i) {
-                    CURL* curlHandle = curl_easy_init();
-                    if (curlHandle) {
-                        setDefaultOptions(curlHandle);
-                        handleContainer_.Release(curlHandle);
-                        ++actuallyAdded;
-                    } else {
-                        break;
+            CURL *handle;
+            size_t hostKey;
+        };
+
+        struct Shard
+        {
+            std::mutex lock;
+            std::vector<IdleHandle> handles;
+        };
+
+        Shard &localShard()
+        {
+            static thread_local unsigned slot = nextShardSlot();
+            return shards_[slot % shardNum_];
+        }
+
+        CURL* TryAcquire(size_t hostKey)
+        {
+            if (idleCount_.load() > 0) {
+                size_t start = &localShard() - &shards_[0];
+                for (size_t i = 0; i < shardNum_; i++) {
+                    CURL *handle = takeFrom(shards_[(start + i) % shardNum_], hostKey);
+                    if (handle != nullptr) {
+                        return handle;
                     }
                 }
-                poolSize_ += actuallyAdded;
-                return actuallyAdded > 0;
             }
-            return false;
+            return createHandle();
+        }
+
+        CURL* takeFrom(Shard &shard, size_t hostKey)
+        {
+            std::lock_guard<std::mutex> locker(shard.lock);
+            auto &handles = shard.handles;
+            if (handles.empty()) {
+                return nullptr;
+            }
+            size_t scan = (std::min)(handles.size(), AffinityScanNum);
+            for (size_t i = 1; i <= scan; i++) {
+                if (handles[handles.size() - i].hostKey == hostKey) {
+                    std::swap(handles[handles.size() - i], handles.back());
+                    break;
+                }
+            }
+            CURL *handle = handles.back().handle;
+            handles.pop_back();
+            idleCount_--;
+            return handle;
+        }
+
+        CURL* createHandle()
+        {
+            unsigned size = poolSize_.load();
+            while (size < maxPoolSize_) {
+                if (poolSize_.compare_exchange_weak(size, size + 1)) {
+                    CURL* handle = curl_easy_init();
+                    if (handle == nullptr) {
+                        poolSize_--;
+                        return nullptr;
+                    }
+                    setDefaultOptions(handle);
+                    return handle;
+                }
+            }
+            return nullptr;
         }
     
         void setDefaultOptions(CURL* handle)
@@ -178,15 +243,56 @@ namespace OSS
 
             curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
             curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
+
+            if (share_ != nullptr) {
+                curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+            }
+        }
+
+        /*the options a request sets, the defaults stay from the creation of the handle*/
+        static void resetRequestOptions(CURL* handle)
+        {
+            //back to GET, clears NOBODY, UPLOAD and POST
+            curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+            curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, nullptr);
+            curl_easy_setopt(handle, CURLOPT_URL, nullptr);
+            curl_easy_setopt(handle, CURLOPT_HTTPHEADER, nullptr);
+            curl_easy_setopt(handle, CURLOPT_HEADERDATA, nullptr);
+            curl_easy_setopt(handle, CURLOPT_WRITEDATA, nullptr);
+            curl_easy_setopt(handle, CURLOPT_READDATA, nullptr);
+            curl_easy_setopt(handle, CURLOPT_PROGRESSDATA, nullptr);
+            curl_easy_setopt(handle, CURLOPT_PRIVATE, nullptr);
+            curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 1L);
+            curl_easy_setopt(handle, CURLOPT_VERBOSE, 0L);
+        }
+
+        static void lockShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+        {
+            UNUSED_PARAM(handle);
+            UNUSED_PARAM(access);
+            static_cast<CurlContainer *>(userptr)->shareLocks_[data].lock();
+        }
+
+        static void unlockShare(CURL *handle, curl_lock_data data, void *userptr)
+        {
+            UNUSED_PARAM(handle);
+            static_cast<CurlContainer *>(userptr)->shareLocks_[data].unlock();
         }
     
     private:
-        ResourceManager_<CURL*> handleContainer_;
+        std::unique_ptr<Shard[]> shards_;
+        unsigned shardNum_;
         unsigned maxPoolSize_;
         unsigned long requestTimeout_;
         unsigned long connectTimeout_;
-        unsigned poolSize_;
-        std::mutex containerLock_;
+        std::atomic<unsigned> poolSize_;
+        std::atomic<int> idleCount_;
+        std::atomic<int> waiters_;
+        bool shutdown_;
+        std::mutex waitLock_;
+        std::condition_variable waitCv_;
+        CURLSH *share_;
+        std::mutex shareLocks_[CURL_LOCK_DATA_LAST];
     };
     
     /////////////////////////////////////////////////////////////////////////////////////////////
@@ -204,10 +310,38 @@ namespace OSS
         bool enableCrc64;
         uint64_t sendCrc64Value;
         uint64_t recvCrc64Value;
-        int sendSpeed;
-        int recvSpeed;
+        curl_slist *headerList;
+        std::shared_ptr<HttpResponse> responseHolder;
+        std::iostream::pos_type requestBodyPos;
+        bool sendCrc64Precomputed;
     };
 
+    //the most a shaped send takes at once, the bucket is overdrawn by at most this
+    const size_t ShapedSendSize = 16 * 1024;
+
+    enum ShapeResult
+    {
+        ShapeGo,
+        ShapePause,
+        ShapeAbort
+    };
+
+    /*takes bytes from the bandwidth of the client, paused or blocked until they are there*/
+    static ShapeResult shapeTransfer(TransferState *state, BandwidthShaper *shaper, int64_t bytes)
+    {
+        int64_t waitUs = 0;
+        while (!shaper->take(state->request->TransferPriority(), bytes, waitUs)) {
+            if (!state->owner->isEnable() || state->request->isCancelled()) {
+                return ShapeAbort;
+            }
+            if (state->owner->pauseTransfer(state->curl, waitUs)) {
+                return ShapePause;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(waitUs));
+        }
+        return ShapeGo;
+    }
+
     static size_t sendBody(char *ptr, size_t size, size_t nmemb, void *userdata)
     {
         TransferState *state = static_cast<TransferState*>(userdata);
@@ -228,6 +362,18 @@ namespace OSS
                     read = static_cast<size_t>(remains);
                 }
             }
+            BandwidthShaper *shaper = state->owner->sendShaper_.get();
+            if (shaper != nullptr && read > 0) {
+                read = (std::min)(read, ShapedSendSize);
+                switch (shapeTransfer(state, shaper, static_cast<int64_t>(read))) {
+                case ShapePause:
+                    return CURL_READFUNC_PAUSE;
+                case ShapeAbort:
+                    return CURL_READFUNC_ABORT;
+                default:
+                    break;
+                }
+            }
             content->read(ptr, read);
             got = static_cast<size_t>(content->gcount());
         }
@@ -237,7 +383,7 @@ namespace OSS
             state->progress(got, state->transferred, state->total, state->userData);
         }
 
-        if (state->enableCrc64) {
+        if (state->enableCrc64 && !state->sendCrc64Precomputed) {
             state->sendCrc64Value = CRC64::CalcCRC(state->sendCrc64Value, (void *)ptr, got);
         }
 
@@ -255,6 +401,19 @@ namespace OSS
             return -1;
         }
 
+        //curl hands the same data again after a pause
+        BandwidthShaper *shaper = state->owner->recvShaper_.get();
+        if (shaper != nullptr) {
+            switch (shapeTransfer(state, shaper, static_cast<int64_t>(wanted))) {
+            case ShapePause:
+                return CURL_WRITEFUNC_PAUSE;
+            case ShapeAbort:
+                return 0;
+            default:
+                break;
+            }
+        }
+
         if (state->firstRecvData) {
             long response_code = 0;
             curl_easy_getinfo(state->curl, CURLINFO_RESPONSE_CODE, &response_code);
@@ -267,7 +426,7 @@ namespace OSS
                     state->request, state->recvBodyPos);
             }
             else {
-                state->response->addBody(std::make_shared<std::stringstream>());
+                state->response->addBody(std::make_shared<PooledBufferStream>());
             }
             state->firstRecvData = false;
         }
@@ -299,17 +458,19 @@ namespace OSS
         TransferState *state = static_cast<TransferState*>(userdata);
         const size_t length = nitems * size;
 
-        std::string line(buffer);
-        auto pos = line.find(':');
-        if (pos != line.npos)
-        {
-            size_t posEnd = line.rfind('\r');
-            if (posEnd != line.npos) {
-                posEnd = posEnd - pos - 2;
+        //the line is not nul terminated, the name and value are set from it in place
+        const char *colon = static_cast<const char *>(memchr(buffer, ':', length));
+        if (colon != nullptr) {
+            const char *value = colon + 1;
+            const char *end = buffer + length;
+            while (value < end && (*value == ' ' || *value == '\t')) {
+                value++;
+            }
+            while (end > value && (end[-1] == '\r' || end[-1] == '\n' || end[-1] == ' ' || end[-1] == '\t')) {
+                end--;
             }
-            std::string name  = line.substr(0, pos);
-            std::string value = line.substr(pos + 2, posEnd);
-            state->response->setHeader(name, value);
+            state->response->setHeader(buffer, static_cast<size_t>(colon - buffer),
+                value, static_cast<size_t>(end - value));
         }
 
         if (length == 2 && (buffer[0] == 0x0D) && (buffer[1] == 0x0A)) {
@@ -355,31 +516,10 @@ namespace OSS
         CurlHttpClient *thiz = static_cast<CurlHttpClient *>(state->owner);
 
         //stop by upper caller
-        if (!thiz->isEnable()) {
+        if (!thiz->isEnable() || state->request->isCancelled()) {
             return 1;
         }
 
-        //for speed update
-        if (thiz->sendRateLimiter_ != nullptr) {
-            auto rate = thiz->sendRateLimiter_->Rate();
-            if (rate != state->sendSpeed) {
-                state->sendSpeed = rate;
-                auto speed = static_cast<curl_off_t>(rate);
-                speed = speed * 1024;
-                curl_easy_setopt(state->curl, CURLOPT_MAX_SEND_SPEED_LARGE, speed);
-            }
-        }
-
-        if (thiz->recvRateLimiter_ != nullptr) {
-            auto rate = thiz->recvRateLimiter_->Rate();
-            if (rate != state->recvSpeed) {
-                state->recvSpeed = rate;
-                auto speed = static_cast<curl_off_t>(rate);
-                speed = speed * 1024;
-                curl_easy_setopt(state->curl, CURLOPT_MAX_RECV_SPEED_LARGE, speed);
-            }
-        }
-
         return 0;
     }
 }
@@ -410,11 +550,19 @@ CurlHttpClient::CurlHttpClient(const ClientConfiguration &configuration) :
     caPath_(configuration.caPath),
     caFile_(configuration.caFile),
     networkInterface_(configuration.networkInterface),
-    sendRateLimiter_(configuration.sendRateLimiter),
-    recvRateLimiter_(configuration.recvRateLimiter)
+    sendShaper_(BandwidthShaper::Get(configuration.sendRateLimiter)),
+    recvShaper_(BandwidthShaper::Get(configuration.recvRateLimiter))
 {
 }
 
+bool CurlHttpClient::pauseTransfer(CURL *curl, int64_t waitUs)
+{
+    UNUSED_PARAM(curl);
+    UNUSED_PARAM(waitUs);
+    //a blocking transfer has the thread to itself
+    return false;
+}
+
 CurlHttpClient::~CurlHttpClient()
 {
     if (curlContainer_) {
@@ -422,16 +570,106 @@ CurlHttpClient::~CurlHttpClient()
     }
 }
 
+CURL *CurlHttpClient::acquireHandle(const std::string &host)
+{
+    return curlContainer_->Acquire(host);
+}
+
+CURL *CurlHttpClient::tryAcquireHandle(const std::string &host)
+{
+    return curlContainer_->TryAcquire(host);
+}
+
+void CurlHttpClient::releaseHandle(CURL *handle, const std::string &host)
+{
+    curlContainer_->Release(handle, host);
+}
+
 std::shared_ptr<HttpResponse> CurlHttpClient::makeRequest(const std::shared_ptr<HttpRequest> &request)
 {
     OSS_LOG(LogLevel::LogDebug, TAG, "request(%p) enter makeRequest", request.get());
+
+    const std::string &host = request->url().host();
+    CURL * curl = acquireHandle(host);
+    OSS_LOG(LogLevel::LogDebug, TAG, "request(%p) acquire curl handle:%p", request.get(), curl);
+
+    TransferState *state = beginTransfer(request, curl);
+    CURLcode res = curl_easy_perform(curl);
+    auto response = endTransfer(state, res);
+
+    releaseHandle(curl, host);
+    return response;
+}
+
+std::shared_ptr<HttpResponse> CurlHttpClient::makeRequestNoWait(const std::shared_ptr<HttpRequest> &request)
+{
+    const std::string &host = request->url().host();
+    CURL * curl = tryAcquireHandle(host);
+    bool pooled = curl != nullptr;
+    if (!pooled) {
+        //the handles of the pool may be held by the transfers of the calling thread
+        curl = curlContainer_->CreateUnpooled();
+    }
+    if (curl == nullptr) {
+        auto response = std::make_shared<HttpResponse>(request);
+        response->setStatusCode(CURLE_FAILED_INIT + ERROR_CURL_BASE);
+        response->setStatusMsg(curl_easy_strerror(CURLE_FAILED_INIT));
+        return response;
+    }
+    OSS_LOG(LogLevel::LogDebug, TAG, "request(%p) acquire curl handle:%p, pooled:%d", request.get(), curl, pooled);
+
+    TransferState *state = beginTransfer(request, curl);
+    CURLcode res = curl_easy_perform(curl);
+    auto response = endTransfer(state, res);
+
+    if (pooled) {
+        releaseHandle(curl, host);
+    }
+    else {
+        curl_easy_cleanup(curl);
+    }
+    return response;
+}
+
+void CurlHttpClient::prewarm(const std::string &url, unsigned count)
+{
+    Url target(url);
+    const std::string &host = target.host();
+
+    //hold the handles together, so each one opens its own connection
+    std::vector<CURL *> handles;
+    for (unsigned i = 0; i < count; i++) {
+        CURL *curl = tryAcquireHandle(host);
+        if (curl == nullptr) {
+            break;
+        }
+        handles.push_back(curl);
+    }
+
+    for (auto curl : handles) {
+        auto request = std::make_shared<HttpRequest>(Http::Method::Head);
+        request->setUrl(target);
+        TransferState *state = beginTransfer(request, curl);
+        CURLcode res = curl_easy_perform(curl);
+        auto response = endTransfer(state, res);
+        OSS_LOG(LogLevel::LogDebug, TAG, "prewarm connection to %s, handle:%p, ResponseCode:%d",
+            host.c_str(), curl, response->statusCode());
+    }
+
+    for (auto curl : handles) {
+        releaseHandle(curl, host);
+    }
+}
+
+TransferState *CurlHttpClient::beginTransfer(const std::shared_ptr<HttpRequest> &request, CURL *curl)
+{
     curl_slist *list = nullptr;
     auto& headers = request->Headers();
-    for (const auto &p : headers) {
-        if (p.second.empty())
+    std::string str;
+    for (const auto &header : headers) {
+        if (header.value().empty())
             continue;
-        std::string str = p.first;
-        str.append(": ").append(p.second);
+        str.assign(header.name()).append(": ").append(header.value());
         list = curl_slist_append(list, str.c_str());
     }
 
@@ -442,17 +680,18 @@ std::shared_ptr<HttpResponse> CurlHttpClient::makeRequest(const std::shared_ptr<
         requestBodyPos = request->Body()->tellg();
     }
 
-    CURL * curl = curlContainer_->Acquire();
-
-    OSS_LOG(LogLevel::LogDebug, TAG, "request(%p) acquire curl handle:%p", request.get(), curl);
-
     uint64_t initCRC64 = 0;
 #ifdef ENABLE_OSS_TEST
-    if (headers.find("oss-test-crc64") != headers.end()) {
-        initCRC64 = std::strtoull(headers.at("oss-test-crc64").c_str(), nullptr, 10);
+    if (headers.find("oss-test-crc64") != nullptr) {
+        initCRC64 = std::strtoull(headers.find("oss-test-crc64")->c_str(), nullptr, 10);
     }
 #endif
-    TransferState transferState = {
+    //the Content-MD5 pass covered the bytes sent, so its crc64 holds
+    bool crc64Precomputed = request->hasCheckCrc64() && request->hasBodyCrc64() && initCRC64 == 0;
+    if (crc64Precomputed) {
+        initCRC64 = request->BodyCrc64();
+    }
+    TransferState *state = new TransferState {
         this,
         curl,
         request.get(),
@@ -462,8 +701,10 @@ std::shared_ptr<HttpResponse> CurlHttpClient::makeRequest(const std::shared_ptr<
         request->TransferProgress().Handler,
         request->TransferProgress().UserData,
         request->hasCheckCrc64(), initCRC64, initCRC64, 
-        0, 0
+        list, response, requestBodyPos,
+        crc64Precomputed
     };
+    TransferState &transferState = *state;
 
     if (request->hasHeader(Http::CONTENT_LENGTH)) {
         transferState.total = std::atoll(request->Header(Http::CONTENT_LENGTH).c_str());
@@ -493,15 +734,17 @@ std::shared_ptr<HttpResponse> CurlHttpClient::makeRequest(const std::shared_ptr<
     curl_easy_setopt(curl, CURLOPT_USERAGENT,userAgent_.c_str());
 
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, list);
-    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transferState);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, state);
     curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, recvHeaders);
 
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transferState);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, state);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, recvBody);
 
-    curl_easy_setopt(curl, CURLOPT_READDATA, &transferState);
+    curl_easy_setopt(curl, CURLOPT_READDATA, state);
     curl_easy_setopt(curl, CURLOPT_READFUNCTION, sendBody);
 
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, state);
+
     if (verifySSL_) {
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
@@ -534,26 +777,19 @@ std::shared_ptr<HttpResponse> CurlHttpClient::makeRequest(const std::shared_ptr<
 
     //progress Callback
     curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, progressCallback);
-    curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, &transferState);
+    curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, state);
     curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
 
-    //Send bytes/sec 
-    if (sendRateLimiter_ != nullptr) {
-        transferState.sendSpeed = sendRateLimiter_->Rate();
-        auto speed = static_cast<curl_off_t>(transferState.sendSpeed);
-        speed = speed * 1024;
-        curl_easy_setopt(curl, CURLOPT_MAX_SEND_SPEED_LARGE, speed);
-    }
+    return state;
+}
 
-    //Recv bytes/sec 
-    if (recvRateLimiter_ != nullptr) {
-        transferState.recvSpeed = recvRateLimiter_->Rate();
-        auto speed = static_cast<curl_off_t>(transferState.recvSpeed);
-        speed = speed * 1024;
-        curl_easy_setopt(curl, CURLOPT_MAX_RECV_SPEED_LARGE, speed);
-    }
+std::shared_ptr<HttpResponse> CurlHttpClient::endTransfer(TransferState *state, CURLcode res)
+{
+    std::unique_ptr<TransferState> transferState(state);
+    CURL *curl = state->curl;
+    HttpRequest *request = state->request;
+    auto response = state->responseHolder;
 
-    CURLcode res = curl_easy_perform(curl);
     long response_code= 0;
     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
 
@@ -587,39 +823,37 @@ std::shared_ptr<HttpResponse> CurlHttpClient::makeRequest(const std::shared_ptr<
     {
     case Http::Method::Put:
     case Http::Method::Post:
-        request->setCrc64Result(transferState.sendCrc64Value);
+        request->setCrc64Result(state->sendCrc64Value);
         break;
     default:
-        request->setCrc64Result(transferState.recvCrc64Value);
+        request->setCrc64Result(state->recvCrc64Value);
         break;
     }
-    request->setTransferedBytes(transferState.transferred);
-
-    curlContainer_->Release(curl);
+    request->setTransferedBytes(state->transferred);
 
-    curl_slist_free_all(list);
+    curl_slist_free_all(state->headerList);
 
     auto & body = response->Body();
     if (body != nullptr) {
         body->flush();
-        if (res != CURLE_OK && transferState.recvBodyPos != static_cast<std::streampos>(-1)) {
+        if (res != CURLE_OK && state->recvBodyPos != static_cast<std::streampos>(-1)) {
             OSS_LOG(LogLevel::LogDebug, TAG, "request(%p) setResponseBody, tellp:%lld, recvBodyPos:%lld",
-                request.get(), body->tellp(), transferState.recvBodyPos);
+                request, body->tellp(), state->recvBodyPos);
             body->clear();
-            body->seekp(transferState.recvBodyPos);
+            body->seekp(state->recvBodyPos);
         }
     }
     else {
-        response->addBody(std::make_shared<std::stringstream>());
+        response->addBody(std::make_shared<PooledBufferStream>());
     }
 
-    if (requestBodyPos != static_cast<std::streampos>(-1)) {
+    if (state->requestBodyPos != static_cast<std::streampos>(-1)) {
         request->Body()->clear();
-        request->Body()->seekg(requestBodyPos);
+        request->Body()->seekg(state->requestBodyPos);
     }
 
     OSS_LOG(LogLevel::LogDebug, TAG, "request(%p) leave makeRequest, CURLcode:%d, ResponseCode:%d", 
-        request.get(), res, response_code);
+        request, res, response_code);
 
     return response;
 }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <alibabacloud/oss/client/ClientConfiguration.h>
+#include <curl/curl.h>
 #include "HttpClient.h"
 
 namespace AlibabaCloud
@@ -25,7 +26,8 @@ namespace OSS
 {
 
     class CurlContainer;
-    class RateLimiter;
+    class BandwidthShaper;
+    struct TransferState;
 
     class CurlHttpClient : public HttpClient
     {
@@ -37,6 +39,15 @@ namespace OSS
         static void cleanupGlobalState();
 
         virtual std::shared_ptr<HttpResponse> makeRequest(const std::shared_ptr<HttpRequest> &request) override;
+        virtual void prewarm(const std::string &url, unsigned count) override;
+    protected:
+        CURL *acquireHandle(const std::string &host);
+        CURL *tryAcquireHandle(const std::string &host);
+        void releaseHandle(CURL *handle, const std::string &host);
+        /*never waits for a free handle, one outside of the pool is used when there is none*/
+        std::shared_ptr<HttpResponse> makeRequestNoWait(const std::shared_ptr<HttpRequest> &request);
+        TransferState *beginTransfer(const std::shared_ptr<HttpRequest> &request, CURL *curl);
+        std::shared_ptr<HttpResponse> endTransfer(TransferState *state, CURLcode res);
     private:
         CurlContainer *curlContainer_;
         std::string userAgent_;
@@ -50,8 +61,10 @@ namespace OSS
         std::string caFile_;
         std::string networkInterface_;
     public:
-        std::shared_ptr<RateLimiter> sendRateLimiter_;
-        std::shared_ptr<RateLimiter> recvRateLimiter_;
+        /*holds a transfer out of the bandwidth for waitUs, false to block the calling thread instead*/
+        virtual bool pauseTransfer(CURL *curl, int64_t waitUs);
+        std::shared_ptr<BandwidthShaper> sendShaper_;
+        std::shared_ptr<BandwidthShaper> recvShaper_;
     };
 }
 }
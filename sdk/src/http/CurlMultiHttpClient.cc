@@ -0,0 +1,587 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CurlMultiHttpClient.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+#include "../utils/LogUtils.h"
+#include "../utils/Utils.h"
+
+using namespace AlibabaCloud::OSS;
+
+namespace
+{
+    const char *TAG = "CurlMultiHttpClient";
+    typedef std::chrono::steady_clock LoopClock;
+#ifndef __linux__
+    //without a wakeup fd the loop polls for new work at this interval
+    const long MaxPollIntervalMs = 10;
+#endif
+}
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    static thread_local CurlEventLoop *tlsEventLoop = nullptr;
+
+    class CurlEventLoop
+    {
+    public:
+        CurlEventLoop(CurlMultiHttpClient *owner);
+        ~CurlEventLoop();
+
+        void addTransfer(const std::shared_ptr<HttpRequest> &request, const HttpResponseHandler &handler);
+        void post(const std::function<void()> &task, long delayMs);
+        bool resumeLater(CURL *curl, int64_t waitUs);
+        void drain();
+        void stop();
+        void wakeup();
+        bool idle();
+        bool hasWaiting() const { return waitingCount_ > 0; }
+        bool isCurrent() const { return tlsEventLoop == this; }
+
+    private:
+        struct Transfer
+        {
+            std::shared_ptr<HttpRequest> request;
+            HttpResponseHandler handler;
+            TransferState *state;
+        };
+        struct Timer
+        {
+            LoopClock::time_point deadline;
+            uint64_t seq;
+            std::function<void()> task;
+            bool operator > (const Timer &other) const
+            {
+                return deadline != other.deadline ? deadline > other.deadline : seq > other.seq;
+            }
+        };
+
+        void run();
+        void processIncoming();
+        void startTransfer(Transfer &transfer);
+        void runDueTimers();
+        void checkDone();
+        void finishWork();
+        int computeWaitMs() const;
+
+        static int socketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp);
+        static int timerCallback(CURLM *multi, long timeoutMs, void *userp);
+
+        CurlMultiHttpClient *owner_;
+        CURLM *multi_;
+
+        std::mutex lock_;
+        std::condition_variable idleCv_;
+        std::vector<Transfer> incoming_;
+        std::vector<Timer> incomingTimers_;
+        int outstanding_;
+        bool stop_;
+        uint64_t timerSeq_;
+
+        //accessed in the loop thread only
+        std::deque<Transfer> waiting_;
+        std::atomic<int> waitingCount_;
+        std::unordered_map<CURL *, Transfer> active_;
+        std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+        bool curlTimerSet_;
+        LoopClock::time_point curlDeadline_;
+#ifdef __linux__
+        int epollFd_;
+        int eventFd_;
+#endif
+        std::thread thread_;
+    };
+}
+}
+
+CurlEventLoop::CurlEventLoop(CurlMultiHttpClient *owner) :
+    owner_(owner),
+    multi_(curl_multi_init()),
+    outstanding_(0),
+    stop_(false),
+    timerSeq_(0),
+    waitingCount_(0),
+    curlTimerSet_(false)
+{
+#ifdef __linux__
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    eventFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = eventFd_;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, eventFd_, &ev);
+
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, socketCallback);
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, timerCallback);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+#endif
+    thread_ = std::thread(&CurlEventLoop::run, this);
+}
+
+CurlEventLoop::~CurlEventLoop()
+{
+    stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    curl_multi_cleanup(multi_);
+#ifdef __linux__
+    close(eventFd_);
+    close(epollFd_);
+#endif
+}
+
+void CurlEventLoop::addTransfer(const std::shared_ptr<HttpRequest> &request, const HttpResponseHandler &handler)
+{
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        incoming_.push_back(Transfer{ request, handler, nullptr });
+        outstanding_++;
+    }
+    wakeup();
+}
+
+void CurlEventLoop::post(const std::function<void()> &task, long delayMs)
+{
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        auto deadline = LoopClock::now() + std::chrono::milliseconds(delayMs > 0 ? delayMs : 0);
+        incomingTimers_.push_back(Timer{ deadline, timerSeq_++, task });
+        outstanding_++;
+    }
+    wakeup();
+}
+
+/*called in the loop thread from a callback of a transfer about to pause, false if it is not one of the loop*/
+bool CurlEventLoop::resumeLater(CURL *curl, int64_t waitUs)
+{
+    if (active_.find(curl) == active_.end()) {
+        return false;
+    }
+    long delayMs = static_cast<long>((waitUs + 999) / 1000);
+    post([this, curl]() {
+        //the transfer may have ended meanwhile, its handle is no longer ours then
+        if (active_.find(curl) != active_.end()) {
+            curl_easy_pause(curl, CURLPAUSE_CONT);
+        }
+    }, delayMs);
+    return true;
+}
+
+void CurlEventLoop::drain()
+{
+    std::unique_lock<std::mutex> lck(lock_);
+    idleCv_.wait(lck, [this] { return outstanding_ == 0; });
+}
+
+bool CurlEventLoop::idle()
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    return outstanding_ == 0;
+}
+
+void CurlEventLoop::stop()
+{
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        stop_ = true;
+    }
+    wakeup();
+}
+
+void CurlEventLoop::wakeup()
+{
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t ret = write(eventFd_, &one, sizeof(one));
+    (void)ret;
+#endif
+}
+
+void CurlEventLoop::finishWork()
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    if (--outstanding_ == 0) {
+        idleCv_.notify_all();
+    }
+}
+
+void CurlEventLoop::processIncoming()
+{
+    std::vector<Transfer> transfers;
+    std::vector<Timer> timers;
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        transfers.swap(incoming_);
+        timers.swap(incomingTimers_);
+    }
+
+    for (auto &timer : timers) {
+        timers_.push(std::move(timer));
+    }
+
+    //the earlier requests go first when handles become free
+    while (!waiting_.empty()) {
+        CURL *curl = owner_->tryAcquireHandle(waiting_.front().request->url().host());
+        if (curl == nullptr) {
+            break;
+        }
+        Transfer transfer = std::move(waiting_.front());
+        waiting_.pop_front();
+        waitingCount_--;
+        transfer.state = owner_->beginTransfer(transfer.request, curl);
+        curl_multi_add_handle(multi_, curl);
+        active_.emplace(curl, std::move(transfer));
+    }
+
+    for (auto &transfer : transfers) {
+        startTransfer(transfer);
+    }
+}
+
+void CurlEventLoop::startTransfer(Transfer &transfer)
+{
+    CURL *curl = waiting_.empty() ? owner_->tryAcquireHandle(transfer.request->url().host()) : nullptr;
+    if (curl == nullptr) {
+        waiting_.push_back(std::move(transfer));
+        waitingCount_++;
+        return;
+    }
+    OSS_LOG(LogLevel::LogDebug, TAG, "request(%p) start transfer, curl handle:%p", transfer.request.get(), curl);
+    transfer.state = owner_->beginTransfer(transfer.request, curl);
+    curl_multi_add_handle(multi_, curl);
+    active_.emplace(curl, std::move(transfer));
+}
+
+void CurlEventLoop::runDueTimers()
+{
+    auto now = LoopClock::now();
+    while (!timers_.empty() && timers_.top().deadline <= now) {
+        auto task = timers_.top().task;
+        timers_.pop();
+        task();
+        finishWork();
+    }
+}
+
+void CurlEventLoop::checkDone()
+{
+    CURLMsg *msg;
+    int left;
+    while ((msg = curl_multi_info_read(multi_, &left)) != nullptr) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+        CURL *curl = msg->easy_handle;
+        CURLcode res = msg->data.result;
+        curl_multi_remove_handle(multi_, curl);
+
+        auto it = active_.find(curl);
+        if (it == active_.end()) {
+            continue;
+        }
+        Transfer transfer = std::move(it->second);
+        active_.erase(it);
+
+        auto response = owner_->endTransfer(transfer.state, res);
+        owner_->releaseHandle(curl, transfer.request->url().host());
+        owner_->onHandleReleased(this);
+
+        transfer.handler(response);
+        finishWork();
+    }
+}
+
+int CurlEventLoop::computeWaitMs() const
+{
+    LoopClock::time_point deadline = LoopClock::time_point::max();
+    if (curlTimerSet_) {
+        deadline = curlDeadline_;
+    }
+    if (!timers_.empty() && timers_.top().deadline < deadline) {
+        deadline = timers_.top().deadline;
+    }
+    if (deadline == LoopClock::time_point::max()) {
+        return -1;
+    }
+    auto now = LoopClock::now();
+    if (deadline <= now) {
+        return 0;
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+    return static_cast<int>(ms);
+}
+
+int CurlEventLoop::socketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp)
+{
+    UNUSED_PARAM(easy);
+#ifdef __linux__
+    CurlEventLoop *loop = static_cast<CurlEventLoop *>(userp);
+    if (what == CURL_POLL_REMOVE) {
+        epoll_ctl(loop->epollFd_, EPOLL_CTL_DEL, s, nullptr);
+        return 0;
+    }
+
+    epoll_event ev;
+    ev.events = 0;
+    ev.data.fd = s;
+    if (what & CURL_POLL_IN) {
+        ev.events |= EPOLLIN;
+    }
+    if (what & CURL_POLL_OUT) {
+        ev.events |= EPOLLOUT;
+    }
+
+    if (socketp == nullptr) {
+        if (epoll_ctl(loop->epollFd_, EPOLL_CTL_ADD, s, &ev) != 0 && errno == EEXIST) {
+            epoll_ctl(loop->epollFd_, EPOLL_CTL_MOD, s, &ev);
+        }
+        curl_multi_assign(loop->multi_, s, loop);
+    }
+    else {
+        epoll_ctl(loop->epollFd_, EPOLL_CTL_MOD, s, &ev);
+    }
+#else
+    UNUSED_PARAM(s);
+    UNUSED_PARAM(what);
+    UNUSED_PARAM(userp);
+    UNUSED_PARAM(socketp);
+#endif
+    return 0;
+}
+
+int CurlEventLoop::timerCallback(CURLM *multi, long timeoutMs, void *userp)
+{
+    UNUSED_PARAM(multi);
+    CurlEventLoop *loop = static_cast<CurlEventLoop *>(userp);
+    if (timeoutMs < 0) {
+        loop->curlTimerSet_ = false;
+    }
+    else {
+        loop->curlTimerSet_ = true;
+        loop->curlDeadline_ = LoopClock::now() + std::chrono::milliseconds(timeoutMs);
+    }
+    return 0;
+}
+
+void CurlEventLoop::run()
+{
+    tlsEventLoop = this;
+    OSS_LOG(LogLevel::LogDebug, TAG, "event loop(%p) enter", this);
+
+#ifdef __linux__
+    const int MaxEvents = 256;
+    epoll_event events[MaxEvents];
+#endif
+    int running = 0;
+
+    for (;;) {
+        processIncoming();
+        runDueTimers();
+
+        {
+            std::lock_guard<std::mutex> lck(lock_);
+            if (stop_ && outstanding_ == 0) {
+                break;
+            }
+        }
+
+#ifdef __linux__
+        if (curlTimerSet_ && curlDeadline_ <= LoopClock::now()) {
+            curlTimerSet_ = false;
+            curl_multi_socket_action(multi_, CURL_SOCKET_TIMEOUT, 0, &running);
+            checkDone();
+            continue;
+        }
+
+        int n = epoll_wait(epollFd_, events, MaxEvents, computeWaitMs());
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == eventFd_) {
+                uint64_t value;
+                while (read(eventFd_, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+            int flags = 0;
+            if (events[i].events & EPOLLIN) {
+                flags |= CURL_CSELECT_IN;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flags |= CURL_CSELECT_OUT;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                flags |= CURL_CSELECT_ERR;
+            }
+            curl_multi_socket_action(multi_, fd, flags, &running);
+        }
+        checkDone();
+#else
+        curl_multi_perform(multi_, &running);
+        checkDone();
+        int waitMs = computeWaitMs();
+        if (waitMs < 0 || waitMs > MaxPollIntervalMs) {
+            waitMs = static_cast<int>(MaxPollIntervalMs);
+        }
+        curl_multi_wait(multi_, nullptr, 0, waitMs, nullptr);
+#endif
+    }
+
+    tlsEventLoop = nullptr;
+    OSS_LOG(LogLevel::LogDebug, TAG, "event loop(%p) leave", this);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+CurlMultiHttpClient::CurlMultiHttpClient(const ClientConfiguration &configuration) :
+    CurlHttpClient(configuration),
+    nextLoop_(0)
+{
+    unsigned num = configuration.eventLoopThreadNum > 0 ? configuration.eventLoopThreadNum : 1;
+    for (unsigned i = 0; i < num; i++) {
+        loops_.push_back(new CurlEventLoop(this));
+    }
+}
+
+CurlMultiHttpClient::~CurlMultiHttpClient()
+{
+    //finish the pending transfers before the handles go away
+    for (auto loop : loops_) {
+        loop->stop();
+    }
+    for (auto loop : loops_) {
+        delete loop;
+    }
+    loops_.clear();
+}
+
+CurlEventLoop *CurlMultiHttpClient::nextLoop()
+{
+    return loops_[nextLoop_++ % loops_.size()];
+}
+
+bool CurlMultiHttpClient::inEventLoop() const
+{
+    return tlsEventLoop != nullptr;
+}
+
+void CurlMultiHttpClient::onHandleReleased(CurlEventLoop *loop)
+{
+    for (auto other : loops_) {
+        if (other != loop && other->hasWaiting()) {
+            other->wakeup();
+        }
+    }
+}
+
+std::shared_ptr<HttpResponse> CurlMultiHttpClient::makeRequest(const std::shared_ptr<HttpRequest> &request)
+{
+    //waiting for the loop from inside the loop would never return, and neither would
+    //waiting for a handle the transfers of this loop hold
+    if (inEventLoop()) {
+        return makeRequestNoWait(request);
+    }
+
+    std::mutex lock;
+    std::condition_variable cv;
+    std::shared_ptr<HttpResponse> result;
+    bool done = false;
+    makeRequestAsync(request, [&](const std::shared_ptr<HttpResponse> &response) {
+        std::lock_guard<std::mutex> lck(lock);
+        result = response;
+        done = true;
+        cv.notify_one();
+    });
+
+    std::unique_lock<std::mutex> lck(lock);
+    cv.wait(lck, [&] { return done; });
+    return result;
+}
+
+void CurlMultiHttpClient::makeRequestAsync(const std::shared_ptr<HttpRequest> &request, const HttpResponseHandler &handler)
+{
+    nextLoop()->addTransfer(request, handler);
+}
+
+void CurlMultiHttpClient::schedule(const std::function<void()> &task, long delayMs)
+{
+    nextLoop()->post(task, delayMs);
+}
+
+void CurlMultiHttpClient::prewarm(const std::string &url, unsigned count)
+{
+    //the connections belong to the multi handles, so warm them up through the loops
+    std::mutex lock;
+    std::condition_variable cv;
+    unsigned done = 0;
+    for (unsigned i = 0; i < count; i++) {
+        auto request = std::make_shared<HttpRequest>(Http::Method::Head);
+        request->setUrl(Url(url));
+        makeRequestAsync(request, [&](const std::shared_ptr<HttpResponse> &response) {
+            OSS_LOG(LogLevel::LogDebug, TAG, "prewarm connection to %s, ResponseCode:%d", url.c_str(), response->statusCode());
+            std::lock_guard<std::mutex> lck(lock);
+            done++;
+            cv.notify_one();
+        });
+    }
+
+    std::unique_lock<std::mutex> lck(lock);
+    cv.wait(lck, [&] { return done == count; });
+}
+
+bool CurlMultiHttpClient::pauseTransfer(CURL *curl, int64_t waitUs)
+{
+    //a blocking request made from inside the loop blocks here as well
+    return tlsEventLoop != nullptr && tlsEventLoop->resumeLater(curl, waitUs);
+}
+
+bool CurlMultiHttpClient::isEventDriven() const
+{
+    return true;
+}
+
+void CurlMultiHttpClient::drain()
+{
+    //a handler may queue more work on another loop, so drain until all are idle at once
+    bool busy = true;
+    while (busy) {
+        busy = false;
+        for (auto loop : loops_) {
+            if (loop->isCurrent()) {
+                continue;
+            }
+            loop->drain();
+        }
+        for (auto loop : loops_) {
+            busy |= !loop->isCurrent() && !loop->idle();
+        }
+    }
+}
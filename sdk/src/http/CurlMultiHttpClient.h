@@ -0,0 +1,59 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include "CurlHttpClient.h"
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class CurlEventLoop;
+
+    /*
+    * Drives the transfers with curl multi handles from a few event loop threads
+    * (curl_multi_socket_action + epoll on linux), so an in-flight request
+    * does not pin a thread. The handlers of makeRequestAsync and schedule run
+    * in the event loop threads and must not block.
+    */
+    class CurlMultiHttpClient : public CurlHttpClient
+    {
+    public:
+        CurlMultiHttpClient(const ClientConfiguration &configuration);
+        ~CurlMultiHttpClient();
+
+        virtual std::shared_ptr<HttpResponse> makeRequest(const std::shared_ptr<HttpRequest> &request) override;
+        virtual void makeRequestAsync(const std::shared_ptr<HttpRequest> &request, const HttpResponseHandler &handler) override;
+        virtual void schedule(const std::function<void()> &task, long delayMs) override;
+        virtual bool isEventDriven() const override;
+        virtual bool inEventLoop() const override;
+        virtual void drain() override;
+        virtual void prewarm(const std::string &url, unsigned count) override;
+        virtual bool pauseTransfer(CURL *curl, int64_t waitUs) override;
+
+    private:
+        friend class CurlEventLoop;
+        CurlEventLoop *nextLoop();
+        void onHandleReleased(CurlEventLoop *loop);
+
+        std::vector<CurlEventLoop *> loops_;
+        std::atomic<unsigned int> nextLoop_;
+    };
+}
+}
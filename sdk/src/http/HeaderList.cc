@@ -0,0 +1,209 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HeaderList.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace AlibabaCloud::OSS;
+
+namespace
+{
+    /*sent or read on most requests*/
+    const char *KnownNames[] =
+    {
+        "Accept-Ranges", "Authorization", "Cache-Control", "Connection", "Content-Disposition",
+        "Content-Encoding", "Content-Length", "Content-MD5", "Content-Range", "Content-Type",
+        "Date", "ETag", "Expect", "Expires", "Keep-Alive", "Last-Modified", "Range", "Server",
+        "Transfer-Encoding", "User-Agent",
+        "x-oss-date", "x-oss-hash-crc64ecma", "x-oss-next-append-position", "x-oss-object-type",
+        "x-oss-request-id", "x-oss-security-token", "x-oss-server-side-encryption",
+        "x-oss-server-time", "x-oss-storage-class", "x-oss-traffic-limit",
+    };
+    const int KnownNum = static_cast<int>(sizeof(KnownNames) / sizeof(KnownNames[0]));
+
+    //the same folding as caseInsensitiveLess, on the plain char value
+    inline int Lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+
+    /*fnv-1a of the lower case name*/
+    inline uint32_t HashName(const char *name, size_t len)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < len; i++) {
+            hash ^= static_cast<uint8_t>(Lower(name[i]));
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    inline int CompareName(const char *a, size_t aLen, const char *b, size_t bLen)
+    {
+        size_t len = std::min(aLen, bLen);
+        for (size_t i = 0; i < len; i++) {
+            int ca = Lower(a[i]);
+            int cb = Lower(b[i]);
+            if (ca != cb) {
+                return ca < cb ? -1 : 1;
+            }
+        }
+        return aLen == bLen ? 0 : (aLen < bLen ? -1 : 1);
+    }
+
+    struct KnownName
+    {
+        std::string name;
+        uint32_t hash;
+    };
+
+    const std::vector<KnownName>& Known()
+    {
+        static const std::vector<KnownName> known = []() {
+            std::vector<KnownName> names;
+            for (int i = 0; i < KnownNum; i++) {
+                KnownName known;
+                known.name = KnownNames[i];
+                known.hash = HashName(known.name.data(), known.name.size());
+                names.push_back(known);
+            }
+            return names;
+        }();
+        return known;
+    }
+
+    /*the interned name spelled exactly so, -1 if there is none*/
+    int KnownIndex(const char *name, size_t len, uint32_t hash)
+    {
+        const auto &known = Known();
+        for (int i = 0; i < KnownNum; i++) {
+            if (known[i].hash == hash && known[i].name.size() == len &&
+                memcmp(known[i].name.data(), name, len) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+}
+
+const std::string& HeaderList::Entry::name() const
+{
+    return known_ >= 0 ? Known()[known_].name : name_;
+}
+
+HeaderList::HeaderList()
+{
+}
+
+HeaderList::HeaderList(const HeaderCollection& headers)
+{
+    //already in order
+    entries_.reserve(headers.size());
+    for (const auto &header : headers) {
+        Entry entry;
+        entry.hash_ = HashName(header.first.data(), header.first.size());
+        entry.known_ = KnownIndex(header.first.data(), header.first.size(), entry.hash_);
+        if (entry.known_ < 0) {
+            entry.name_ = header.first;
+        }
+        entry.value_ = header.second;
+        entries_.push_back(std::move(entry));
+    }
+}
+
+int HeaderList::indexOf(const char* name, size_t nameLen, uint32_t hash) const
+{
+    for (size_t i = 0; i < entries_.size(); i++) {
+        const auto &entry = entries_[i];
+        if (entry.hash_ != hash) {
+            continue;
+        }
+        const std::string &entryName = entry.name();
+        if (CompareName(entryName.data(), entryName.size(), name, nameLen) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void HeaderList::set(const char* name, size_t nameLen, const char* value, size_t valueLen)
+{
+    uint32_t hash = HashName(name, nameLen);
+    int index = indexOf(name, nameLen, hash);
+    if (index >= 0) {
+        entries_[index].value_.assign(value, valueLen);
+        return;
+    }
+
+    if (entries_.capacity() == 0) {
+        entries_.reserve(16);
+    }
+    auto pos = std::upper_bound(entries_.begin(), entries_.end(), 0,
+        [name, nameLen](int, const Entry &entry) {
+            const std::string &entryName = entry.name();
+            return CompareName(name, nameLen, entryName.data(), entryName.size()) < 0;
+        });
+    Entry entry;
+    entry.hash_ = hash;
+    entry.known_ = KnownIndex(name, nameLen, hash);
+    if (entry.known_ < 0) {
+        entry.name_.assign(name, nameLen);
+    }
+    entry.value_.assign(value, valueLen);
+    entries_.insert(pos, std::move(entry));
+}
+
+void HeaderList::set(const std::string& name, const std::string& value)
+{
+    set(name.data(), name.size(), value.data(), value.size());
+}
+
+bool HeaderList::remove(const char* name)
+{
+    size_t len = strlen(name);
+    int index = indexOf(name, len, HashName(name, len));
+    if (index < 0) {
+        return false;
+    }
+    entries_.erase(entries_.begin() + index);
+    return true;
+}
+
+const std::string* HeaderList::find(const char* name, size_t nameLen) const
+{
+    int index = indexOf(name, nameLen, HashName(name, nameLen));
+    return index < 0 ? nullptr : &entries_[index].value_;
+}
+
+const std::string* HeaderList::find(const char* name) const
+{
+    return find(name, strlen(name));
+}
+
+const std::string* HeaderList::find(const std::string& name) const
+{
+    return find(name.data(), name.size());
+}
+
+HeaderCollection HeaderList::toHeaderCollection() const
+{
+    HeaderCollection headers;
+    for (const auto &entry : entries_) {
+        headers.emplace_hint(headers.end(), entry.name(), entry.value_);
+    }
+    return headers;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <alibabacloud/oss/Types.h>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /**
+    * The headers of one http message: a vector kept in the order of caseInsensitiveLess,
+    * so it iterates as a HeaderCollection does. Each entry carries the hash of its lower
+    * case name, a lookup compares hashes before names. The names the sdk sends and reads
+    * on every request are interned, those entries own no name string.
+    */
+    class HeaderList
+    {
+    public:
+        class Entry
+        {
+        public:
+            const std::string& name() const;
+            const std::string& value() const { return value_; }
+        private:
+            friend class HeaderList;
+            uint32_t hash_;
+            int known_;
+            std::string name_;
+            std::string value_;
+        };
+        typedef std::vector<Entry>::const_iterator const_iterator;
+
+        HeaderList();
+        explicit HeaderList(const HeaderCollection& headers);
+
+        /*a name already there keeps its spelling and takes the new value*/
+        void set(const char* name, size_t nameLen, const char* value, size_t valueLen);
+        void set(const std::string& name, const std::string& value);
+        bool remove(const char* name);
+        /*nullptr if there is no such header*/
+        const std::string* find(const char* name, size_t nameLen) const;
+        const std::string* find(const char* name) const;
+        const std::string* find(const std::string& name) const;
+        void clear() { entries_.clear(); }
+
+        size_t size() const { return entries_.size(); }
+        bool empty() const { return entries_.empty(); }
+        const_iterator begin() const { return entries_.begin(); }
+        const_iterator end() const { return entries_.end(); }
+
+        HeaderCollection toHeaderCollection() const;
+
+    private:
+        int indexOf(const char* name, size_t nameLen, uint32_t hash) const;
+        std::vector<Entry> entries_;
+    };
+}
+}
@@ -15,6 +15,7 @@
  */
 
 #include "HttpClient.h"
+#include "../utils/Utils.h"
 
 
 using namespace AlibabaCloud::OSS;
@@ -44,6 +45,37 @@ void HttpClient::enable()
     disable_ = false;
 }
 
+void HttpClient::makeRequestAsync(const std::shared_ptr<HttpRequest> &request, const HttpResponseHandler &handler)
+{
+    handler(makeRequest(request));
+}
+
+void HttpClient::schedule(const std::function<void()> &task, long delayMs)
+{
+    waitForRetry(delayMs);
+    task();
+}
+
+bool HttpClient::isEventDriven() const
+{
+    return false;
+}
+
+bool HttpClient::inEventLoop() const
+{
+    return false;
+}
+
+void HttpClient::drain()
+{
+}
+
+void HttpClient::prewarm(const std::string &url, unsigned count)
+{
+    UNUSED_PARAM(url);
+    UNUSED_PARAM(count);
+}
+
 void HttpClient::waitForRetry(long milliseconds)
 {
     if (milliseconds == 0)
@@ -20,6 +20,7 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
 #include "HttpRequest.h"
 #include "HttpResponse.h"
 
@@ -29,6 +30,8 @@ namespace AlibabaCloud
 namespace OSS
 {
 
+    using HttpResponseHandler = std::function<void(const std::shared_ptr<HttpResponse> &response)>;
+
     class HttpClient
     {
     public:
@@ -37,6 +40,22 @@ namespace OSS
 
         virtual std::shared_ptr<HttpResponse> makeRequest(const std::shared_ptr<HttpRequest> &request) = 0;
 
+        /*
+        * Event driven clients return at once and call the handler from their event loop,
+        * the default one blocks the caller until the response is ready.
+        */
+        virtual void makeRequestAsync(const std::shared_ptr<HttpRequest> &request, const HttpResponseHandler &handler);
+        virtual void schedule(const std::function<void()> &task, long delayMs);
+        virtual bool isEventDriven() const;
+        /*on a thread of an event loop, which must not wait for a response*/
+        virtual bool inEventLoop() const;
+        virtual void drain();
+
+        /*
+        * Opens count keep-alive connections to the url ahead of the first requests.
+        */
+        virtual void prewarm(const std::string &url, unsigned count);
+
         bool isEnable();
         void disable();
         void enable();
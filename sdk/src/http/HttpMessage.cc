@@ -30,9 +30,10 @@ HttpMessage::HttpMessage(const HttpMessage &other) :
 {
 }
 
-HttpMessage::HttpMessage(HttpMessage &&other)
+HttpMessage::HttpMessage(HttpMessage &&other) :
+    headers_(std::move(other.headers_)),
+    body_(std::move(other.body_))
 {
-    *this = std::move(other);
 }
 
 HttpMessage& HttpMessage::operator=(const HttpMessage &other)
@@ -46,8 +47,10 @@ HttpMessage& HttpMessage::operator=(const HttpMessage &other)
 
 HttpMessage& HttpMessage::operator=(HttpMessage &&other)
 {
-    if (this != &other)
-        *this = std::move(other);
+    if (this != &other) {
+        body_ = std::move(other.body_);
+        headers_ = std::move(other.headers_);
+    }
     return *this;
 }
 
@@ -58,30 +61,43 @@ void HttpMessage::addHeader(const std::string & name, const std::string & value)
 
 void HttpMessage::setHeader(const std::string & name, const std::string & value)
 {
-    headers_[name] = value;
+    headers_.set(name, value);
+}
+
+void HttpMessage::setHeader(const char *name, size_t nameLen, const char *value, size_t valueLen)
+{
+    headers_.set(name, nameLen, value, valueLen);
 }
 
 void HttpMessage::removeHeader(const std::string & name)
 {
-    headers_.erase(name);
+    headers_.remove(name.c_str());
 }
 
 
 bool HttpMessage::hasHeader(const std::string &name) const
 {
-    return  (headers_.find(name) != headers_.end()) ? true : false;
+    return headers_.find(name) != nullptr;
+}
+
+bool HttpMessage::hasHeader(const char *name) const
+{
+    return headers_.find(name) != nullptr;
 }
 
 std::string HttpMessage::Header(const std::string & name) const
 {
-    auto it = headers_.find(name);
-    if (it != headers_.end())
-        return it->second;
-    else    
-        return std::string();
+    auto value = headers_.find(name);
+    return value != nullptr ? *value : std::string();
+}
+
+std::string HttpMessage::Header(const char *name) const
+{
+    auto value = headers_.find(name);
+    return value != nullptr ? *value : std::string();
 }
 
-const HeaderCollection &HttpMessage::Headers() const
+const HeaderList &HttpMessage::Headers() const
 {
     return headers_;
 }
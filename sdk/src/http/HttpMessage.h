@@ -20,6 +20,7 @@
 #include <memory>
 #include <alibabacloud/oss/Types.h>
 #include <alibabacloud/oss/http/HttpType.h>
+#include "HeaderList.h"
 
 namespace AlibabaCloud
 {
@@ -38,17 +39,20 @@ namespace OSS
 
         void addHeader(const std::string &name, const std::string &value);
         void setHeader(const std::string &name, const std::string &value);
+        void setHeader(const char *name, size_t nameLen, const char *value, size_t valueLen);
         void removeHeader(const std::string &name);
-        bool hasHeader(const std::string &name) const ;
+        bool hasHeader(const std::string &name) const;
+        bool hasHeader(const char *name) const;
         std::string Header(const std::string &name)const;
-        const HeaderCollection &Headers()const;
+        std::string Header(const char *name)const;
+        const HeaderList &Headers()const;
 
         void addBody(const std::shared_ptr<std::iostream>& body) { body_ = body;}
         std::shared_ptr<std::iostream>& Body() { return body_;}
     protected:
         HttpMessage();
     private:
-        HeaderCollection headers_;
+        HeaderList headers_;
         std::shared_ptr<std::iostream> body_;
     };
 }
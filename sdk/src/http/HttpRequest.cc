@@ -59,7 +59,28 @@ HttpRequest::HttpRequest(Http::Method method) :
     responseStreamFactory_(nullptr),
     hasCheckCrc64_(false),
     crc64Result_(0),
-    transferedBytes_(0)
+    hasBodyCrc64_(false),
+    bodyCrc64_(0),
+    transferedBytes_(0),
+    cancelled_(false),
+    transferPriority_(AlibabaCloud::OSS::TransferPriority::Normal)
+{
+}
+
+HttpRequest::HttpRequest(const HttpRequest &other) :
+    HttpMessage(other),
+    method_(other.method_),
+    url_(other.url_),
+    responseStreamFactory_(other.responseStreamFactory_),
+    transferProgress_(other.transferProgress_),
+    hasCheckCrc64_(other.hasCheckCrc64_),
+    crc64Result_(0),
+    hasBodyCrc64_(other.hasBodyCrc64_),
+    bodyCrc64_(other.bodyCrc64_),
+    transferedBytes_(0),
+    cancelled_(false),
+    cancelFlag_(other.cancelFlag_),
+    transferPriority_(other.transferPriority_)
 {
 }
 
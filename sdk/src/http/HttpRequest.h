@@ -17,6 +17,7 @@
 #pragma once
 
 #include <alibabacloud/oss/Types.h>
+#include <atomic>
 #include <string>
 #include "HttpMessage.h"
 #include "Url.h"
@@ -31,6 +32,8 @@ namespace OSS
     {
         public:
             HttpRequest(Http::Method method = Http::Method::Get);
+            /*another attempt of the same request, the state of the last transfer is not copied*/
+            HttpRequest(const HttpRequest &other);
             ~HttpRequest();
 
             Http::Method method() const;
@@ -48,10 +51,23 @@ namespace OSS
             bool hasCheckCrc64() const { return hasCheckCrc64_; }
             void setCrc64Result(uint64_t crc) { crc64Result_ = crc; }
             uint64_t Crc64Result() const { return crc64Result_; }
+            /*crc64 of the body bytes sent, computed before the transfer together with the Content-MD5*/
+            void setBodyCrc64(uint64_t crc) { bodyCrc64_ = crc; hasBodyCrc64_ = true; }
+            bool hasBodyCrc64() const { return hasBodyCrc64_; }
+            uint64_t BodyCrc64() const { return bodyCrc64_; }
 
             void setTransferedBytes(int64_t value) { transferedBytes_ = value; }
             uint64_t TransferedBytes() const { return transferedBytes_;}
 
+            /*aborts the transfer in flight, e.g. the slower one of a hedged pair*/
+            void cancel() { cancelled_ = true; }
+            bool isCancelled() const { return cancelled_.load() || (cancelFlag_ != nullptr && cancelFlag_->load()); }
+            /*shared by all the attempts of a service request, set by its caller*/
+            void setCancelFlag(const std::shared_ptr<std::atomic<bool>> &flag) { cancelFlag_ = flag; }
+
+            void setTransferPriority(AlibabaCloud::OSS::TransferPriority priority) { transferPriority_ = priority; }
+            AlibabaCloud::OSS::TransferPriority TransferPriority() const { return transferPriority_; }
+
         private:
             Http::Method method_;
             Url url_;
@@ -59,7 +75,12 @@ namespace OSS
             AlibabaCloud::OSS::TransferProgress transferProgress_;
             bool hasCheckCrc64_;
             uint64_t crc64Result_;
+            bool hasBodyCrc64_;
+            uint64_t bodyCrc64_;
             int64_t transferedBytes_;
+            std::atomic<bool> cancelled_;
+            std::shared_ptr<std::atomic<bool>> cancelFlag_;
+            AlibabaCloud::OSS::TransferPriority transferPriority_;
     };
 }
 }
@@ -16,7 +16,6 @@
 
 
 #include <alibabacloud/oss/model/DeleteObjectsRequest.h>
-#include <sstream>
 #include "../utils/Utils.h"
 
 using namespace AlibabaCloud::OSS;
@@ -79,17 +78,25 @@ std::string DeleteObjectsRequest::payload() const
 {
     bool useUrlEncode = !ToLower(encodingType_.c_str()).compare(0, 3, "url", 3);
 
-    std::stringstream ss;
-    ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl;
-    ss << "<Delete>" << std::endl;
-    ss << "  <Quiet>" << (quiet_ ? "true":"false") << "</Quiet>" << std::endl;
+    //sized once, a 1000 keys body is built without reallocation or stream flushes
+    static const char head[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Delete>\n  <Quiet>";
+    static const char objectHead[] = "  <Object>\n    <Key>";
+    static const char objectTail[] = "</Key>\n  </Object>\n";
+    size_t size = sizeof(head) + 64;
     for (auto const &key : keyList_) {
-    ss << "  <Object>" << std::endl << ""; 
-    ss << "    <Key>" << (useUrlEncode ? UrlEncode(key) : key) << "</Key>" << std::endl;
-    ss << "  </Object>" << std::endl;
+        size += sizeof(objectHead) + sizeof(objectTail) + key.size() * (useUrlEncode ? 3 : 1);
     }
-    ss << "</Delete>" << std::endl;
-    return ss.str();
+
+    std::string xml;
+    xml.reserve(size);
+    xml.append(head).append(quiet_ ? "true" : "false").append("</Quiet>\n");
+    for (auto const &key : keyList_) {
+        xml.append(objectHead);
+        xml.append(useUrlEncode ? UrlEncode(key) : key);
+        xml.append(objectTail);
+    }
+    xml.append("</Delete>\n");
+    return xml;
 }
 
 ParameterCollection DeleteObjectsRequest::specialParameters() const
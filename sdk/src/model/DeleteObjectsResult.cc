@@ -15,12 +15,52 @@
  */
 
 #include <alibabacloud/oss/model/DeleteObjectsResult.h>
-#include <tinyxml2/tinyxml2.h>
 #include "../utils/Utils.h"
+#include "../utils/XmlStreamParser.h"
 
 using namespace AlibabaCloud::OSS;
-using namespace tinyxml2;
 
+namespace
+{
+    class DeleteResultHandler : public XmlStreamParser::Handler
+    {
+    public:
+        explicit DeleteResultHandler(std::list<std::string> &keyList) :
+            keyList_(keyList), matched_(false) {}
+
+        void onStartElement(const std::string &name, int depth) override
+        {
+            if (depth == 1) {
+                matched_ = name == "DeleteResult";
+            }
+        }
+
+        void onEndElement(const std::string &name, int depth, std::string &text) override
+        {
+            if (!matched_) {
+                return;
+            }
+            if (depth == 1) {
+                if (!ToLower(encodeType_.c_str()).compare(0, 3, "url", 3)) {
+                    for (auto &key : keyList_) {
+                        key = UrlDecode(key);
+                    }
+                }
+            }
+            else if (depth == 2 && name == "EncodingType") {
+                encodeType_ = std::move(text);
+            }
+            else if (depth == 3 && name == "Key" && !text.empty()) {
+                keyList_.push_back(std::move(text));
+            }
+        }
+
+    private:
+        std::list<std::string> &keyList_;
+        bool matched_;
+        std::string encodeType_;
+    };
+}
 
 DeleteObjectsResult::DeleteObjectsResult() :
     OssResult(),
@@ -38,9 +78,16 @@ DeleteObjectsResult::DeleteObjectsResult(const std::string& result) :
 DeleteObjectsResult::DeleteObjectsResult(const std::shared_ptr<std::iostream>& result) :
     DeleteObjectsResult()
 {
-    std::istreambuf_iterator<char> isb(*result.get()), end;
-    std::string str(isb, end);
-    *this = str;
+    //a quiet delete has an empty body
+    if (result->peek() == std::char_traits<char>::eof()) {
+        quiet_ = true;
+        parseDone_ = true;
+        return;
+    }
+    DeleteResultHandler handler(keyList_);
+    XmlStreamParser parser(handler);
+    parser.feed(*result);
+    parseDone_ = parser.finish();
 }
 
 DeleteObjectsResult& DeleteObjectsResult::operator =(const std::string& result)
@@ -51,28 +98,10 @@ DeleteObjectsResult& DeleteObjectsResult::operator =(const std::string& result)
         return *this;
     }
 
-    XMLDocument doc;
-    XMLError xml_err;
-    if ((xml_err = doc.Parse(result.c_str(), result.size())) == XML_SUCCESS) {
-        XMLElement* root = doc.RootElement();
-        if (root && !std::strncmp("DeleteResult", root->Name(), 12)) {
-            XMLElement *node;
-            std::string encodeType;
-            node = root->FirstChildElement("EncodingType");
-            if (node && node->GetText()) encodeType = node->GetText();
-
-            bool useUrlDecode = !ToLower(encodeType.c_str()).compare(0, 3, "url", 3);
-
-            //Deleted
-            node = root->FirstChildElement("Deleted");
-            for (; node; node = node->NextSiblingElement("Deleted")) {
-                XMLElement *sub_node;
-                sub_node = node->FirstChildElement("Key");
-                if (sub_node && sub_node->GetText()) keyList_.push_back(useUrlDecode?UrlDecode(sub_node->GetText()):sub_node->GetText());
-            }
-        }
-        parseDone_ = true;
-    }
+    DeleteResultHandler handler(keyList_);
+    XmlStreamParser parser(handler);
+    parser.feed(result.c_str(), result.size());
+    parseDone_ = parser.finish();
     return *this;
 }
 
@@ -85,4 +114,3 @@ const std::list<std::string>& DeleteObjectsResult::keyList() const
 {
     return keyList_;
 }
-
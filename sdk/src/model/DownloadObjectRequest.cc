@@ -29,7 +29,8 @@ DownloadObjectRequest::DownloadObjectRequest(const std::string &bucket, const st
     const uint64_t partSize, const uint32_t threadNum):
     OssResumableBaseRequest(bucket, key, checkpointDir, partSize, threadNum), 
     rangeIsSet_(false),
-    filePath_(filePath)
+    filePath_(filePath),
+    directIO_(false)
 {
     tempFilePath_ = filePath + ".temp";
 }
@@ -80,6 +81,11 @@ void DownloadObjectRequest::addResponseHeaders(RequestResponseHeader header, con
     responseHeaderParameters_[ResponseHeader[header - RequestResponseHeader::ContentType]] = value;
 }
 
+void DownloadObjectRequest::setDirectIO(bool directIO)
+{
+    directIO_ = directIO;
+}
+
 int DownloadObjectRequest::validate() const
 {
     if (partSize_ < PartSizeLowerLimit) {
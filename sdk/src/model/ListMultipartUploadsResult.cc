@@ -18,10 +18,9 @@
 #include <sstream>
 #include <alibabacloud/oss/model/ListMultipartUploadsResult.h>
 #include <alibabacloud/oss/model/Owner.h>
-#include <tinyxml2/tinyxml2.h>
 #include "../utils/Utils.h"
+#include "../utils/XmlStreamParser.h"
 using namespace AlibabaCloud::OSS;
-using namespace tinyxml2;
 using std::stringstream;
 
 ListMultipartUploadsResult::ListMultipartUploadsResult() :
@@ -31,6 +30,82 @@ ListMultipartUploadsResult::ListMultipartUploadsResult() :
 {
 }
 
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class ListMultipartUploadsResultParser : public XmlStreamParser::Handler
+    {
+    public:
+        explicit ListMultipartUploadsResultParser(ListMultipartUploadsResult &result) :
+            result_(result), matched_(false), section_(0) {}
+
+        bool Matched() const { return matched_; }
+
+        void onStartElement(const std::string &name, int depth) override
+        {
+            if (depth == 1) {
+                matched_ = name == "ListMultipartUploadsResult";
+            }
+            else if (depth == 2 && matched_) {
+                section_ = name == "Upload" ? 1 : (name == "CommonPrefixes" ? 2 : 0);
+                if (section_ == 1) {
+                    result_.multipartUploadList_.push_back(MultipartUpload());
+                }
+            }
+        }
+
+        void onEndElement(const std::string &name, int depth, std::string &text) override
+        {
+            if (!matched_) {
+                return;
+            }
+            if (depth == 1) {
+                //the keys are decoded once the encoding type is known
+                if (!ToLower(result_.encodingType_.c_str()).compare(0, 3, "url", 3)) {
+                    result_.keyMarker_ = UrlDecode(result_.keyMarker_);
+                    result_.nextKeyMarker_ = UrlDecode(result_.nextKeyMarker_);
+                    for (auto &prefix : result_.commonPrefixes_) {
+                        prefix = UrlDecode(prefix);
+                    }
+                    for (auto &upload : result_.multipartUploadList_) {
+                        upload.Key = UrlDecode(upload.Key);
+                    }
+                }
+            }
+            else if (text.empty()) {
+                section_ = depth == 2 ? 0 : section_;
+            }
+            else if (depth == 2) {
+                if (name == "Bucket") result_.bucket_ = std::move(text);
+                else if (name == "EncodingType") result_.encodingType_ = std::move(text);
+                else if (name == "KeyMarker") result_.keyMarker_ = std::move(text);
+                else if (name == "UploadIdMarker") result_.uploadIdMarker_ = std::move(text);
+                else if (name == "NextKeyMarker") result_.nextKeyMarker_ = std::move(text);
+                else if (name == "NextUploadIdMarker") result_.nextUploadIdMarker_ = std::move(text);
+                else if (name == "MaxUploads") result_.maxUploads_ = std::strtoul(text.c_str(), nullptr, 10);
+                else if (name == "IsTruncated") result_.isTruncated_ = text == "true" || text == "1";
+            }
+            else if (depth == 3 && section_ == 1) {
+                MultipartUpload &rec = result_.multipartUploadList_.back();
+                if (name == "Key") rec.Key = std::move(text);
+                else if (name == "UploadId") rec.UploadId = std::move(text);
+                else if (name == "Initiated") rec.Initiated = std::move(text);
+            }
+            else if (depth == 3 && section_ == 2 && name == "Prefix") {
+                result_.commonPrefixes_.push_back(std::move(text));
+            }
+        }
+
+    private:
+        ListMultipartUploadsResult &result_;
+        bool matched_;
+        /*1 Upload, 2 CommonPrefixes*/
+        int section_;
+    };
+}
+}
+
 ListMultipartUploadsResult::ListMultipartUploadsResult(
     const std::string& result):
     ListMultipartUploadsResult()
@@ -42,102 +117,18 @@ ListMultipartUploadsResult::ListMultipartUploadsResult(
     const std::shared_ptr<std::iostream>& result):
     ListMultipartUploadsResult()
 {
-    std::istreambuf_iterator<char> isb(*result.get()), end;
-    std::string str(isb, end);
-    *this = str;
+    ListMultipartUploadsResultParser handler(*this);
+    XmlStreamParser parser(handler);
+    parser.feed(*result.get());
+    parseDone_ = parser.finish() && handler.Matched();
 }
 
 ListMultipartUploadsResult& ListMultipartUploadsResult::operator =(
     const std::string& result)
 {
-    XMLDocument doc;
-    XMLError xml_err;
-    if ((xml_err = doc.Parse(result.c_str(), result.size())) == XML_SUCCESS) {
-        XMLElement* root =doc.RootElement();
-        if (root && !std::strncmp("ListMultipartUploadsResult", root->Name(), 26)) {
-            XMLElement *node;
-
-            node = root->FirstChildElement("Bucket");
-            if (node && node->GetText()) {
-                bucket_ = node->GetText();
-            }
-
-            node = root->FirstChildElement("EncodingType");
-            bool isUrlEncode = false;
-            if (node && node->GetText()) {
-                encodingType_ = node->GetText();
-                isUrlEncode = !ToLower(encodingType_.c_str()).compare(0, 3, "url", 3);
-            }
-
-            node  = root->FirstChildElement("KeyMarker");
-            if(node && node->GetText())
-            {
-                keyMarker_ = isUrlEncode ? UrlDecode(node->GetText()) : node->GetText();
-            }
-
-            node = root->FirstChildElement("UploadIdMarker");
-            if(node && node->GetText())
-            {
-                uploadIdMarker_ = node->GetText();
-            }
-
-            node  = root->FirstChildElement("NextKeyMarker");
-            if(node && node->GetText())
-            {
-                nextKeyMarker_ = isUrlEncode ? 
-                    UrlDecode(node->GetText()) : node->GetText();
-            }
-
-            node = root->FirstChildElement("NextUploadIdMarker");
-            if(node && node->GetText())
-            {
-                nextUploadIdMarker_ = node->GetText();
-            }
-
-            node = root->FirstChildElement("MaxUploads");
-            if(node && node->GetText())
-            {
-                maxUploads_ = std::strtoul(node->GetText(), nullptr, 10);
-            }
-
-            //CommonPrefixes
-            node = root->FirstChildElement("CommonPrefixes");
-            for (; node; node = node->NextSiblingElement("CommonPrefixes")) {
-                XMLElement *prefix_node = node->FirstChildElement("Prefix");
-                if (prefix_node->GetText()) commonPrefixes_.push_back(
-                    (isUrlEncode ? UrlDecode(prefix_node->GetText()) : prefix_node->GetText()));
-            }
-
-            node = root->FirstChildElement("IsTruncated");
-            if (node && node->GetText()) {
-                isTruncated_ = node->BoolText();
-            }
-
-            XMLElement * uploadNode = root->FirstChildElement("Upload");
-            for( ; uploadNode ; uploadNode = uploadNode->NextSiblingElement("Upload"))
-            {
-                MultipartUpload rec;
-                XMLElement * node = uploadNode->FirstChildElement("Key");
-                if(node && node->GetText())
-                {
-                    rec.Key = isUrlEncode ? UrlDecode(node->GetText()) : node->GetText();
-                }
-
-                node = uploadNode->FirstChildElement("UploadId");
-                if(node && node->GetText())
-                {
-                    rec.UploadId = node->GetText();
-                }
-
-                node = uploadNode->FirstChildElement("Initiated");
-                if(node && node->GetText())
-                {
-                    rec.Initiated = node->GetText();
-                }
-                multipartUploadList_.push_back(rec);
-            }
-            parseDone_ = true;
-		}
-    }
+    ListMultipartUploadsResultParser handler(*this);
+    XmlStreamParser parser(handler);
+    parser.feed(result.c_str(), result.size());
+    parseDone_ = parser.finish() && handler.Matched();
     return *this;
 }
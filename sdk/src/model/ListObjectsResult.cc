@@ -16,11 +16,11 @@
 
 
 #include <alibabacloud/oss/model/ListObjectsResult.h>
-#include <tinyxml2/tinyxml2.h>
 #include <alibabacloud/oss/model/Owner.h>
+#include <cstring>
+#include "ListObjectsResultParser.h"
 #include "../utils/Utils.h"
 using namespace AlibabaCloud::OSS;
-using namespace tinyxml2;
 
 
 ListObjectsResult::ListObjectsResult() :
@@ -46,106 +46,130 @@ ListObjectsResult::ListObjectsResult(const std::string& result):
 ListObjectsResult::ListObjectsResult(const std::shared_ptr<std::iostream>& result):
     ListObjectsResult()
 {
-    std::istreambuf_iterator<char> isb(*result.get()), end;
-    std::string str(isb, end);
-    *this = str;
+    ListObjectsResultParser parser;
+    if (parser.feed(*result.get())) {
+        parser.finish(*this);
+    }
 }
 
 ListObjectsResult& ListObjectsResult::operator =(const std::string& result)
 {
-    XMLDocument doc;
-    XMLError xml_err;
-    if ((xml_err = doc.Parse(result.c_str(), result.size())) == XML_SUCCESS) {
-        XMLElement* root =doc.RootElement();
-        if (root && !std::strncmp("ListBucketResult", root->Name(), 16)) {
-            XMLElement *node;
-            node = root->FirstChildElement("Name");
-            if (node && node->GetText()) name_ = node->GetText();
-
-            node = root->FirstChildElement("Prefix");
-            if (node && node->GetText()) prefix_ = node->GetText();
-
-            node = root->FirstChildElement("Marker");
-            if (node && node->GetText()) marker_ = node->GetText();
-
-            node = root->FirstChildElement("Delimiter");
-            if (node && node->GetText()) delimiter_ = node->GetText();
-
-            node = root->FirstChildElement("MaxKeys");
-            if (node && node->GetText()) maxKeys_ = atoi(node->GetText());
-
-            node = root->FirstChildElement("IsTruncated");
-            if (node && node->GetText()) isTruncated_ = !std::strncmp("true", node->GetText(), 4);
-
-            node = root->FirstChildElement("NextMarker");
-            if (node && node->GetText()) nextMarker_ = node->GetText();
-
-            node = root->FirstChildElement("EncodingType");
-            if (node && node->GetText()) encodingType_ = node->GetText();
-
-
-            //Detect encode type
-            bool useUrlDecode = !ToLower(encodingType_.c_str()).compare(0, 3, "url", 3);
-
-            //CommonPrefixes
-            node = root->FirstChildElement("CommonPrefixes");
-            for (; node; node = node->NextSiblingElement("CommonPrefixes")) {
-                XMLElement *prefix_node = node->FirstChildElement("Prefix");
-                if (prefix_node->GetText()) commonPrefixes_.push_back(
-                    (useUrlDecode ? UrlDecode(prefix_node->GetText()) : prefix_node->GetText()));
-            }
-
-            //Contents
-            XMLElement *contents_node = root->FirstChildElement("Contents");
-            for (; contents_node; contents_node = contents_node->NextSiblingElement("Contents")) {
-                ObjectSummary content;
-                XMLElement *node;
-                node = contents_node->FirstChildElement("Key");
-                if (node && node->GetText()) content.key_ = useUrlDecode ? UrlDecode(node->GetText()) : node->GetText();
-
-                node = contents_node->FirstChildElement("LastModified");
-                if (node && node->GetText()) content.lastModified_ = node->GetText();
-
-                node = contents_node->FirstChildElement("ETag");
-                if (node && node->GetText()) content.eTag_ = TrimQuotes(node->GetText());
-
-                node = contents_node->FirstChildElement("Size");
-                if (node && node->GetText()) content.size_ = std::atoll(node->GetText());
+    ListObjectsResultParser parser;
+    if (parser.feed(result.c_str(), result.size())) {
+        parser.finish(*this);
+    }
+    return *this;
+}
 
-                node = contents_node->FirstChildElement("StorageClass");
-                if (node && node->GetText()) content.storageClass_ = ToStorageClassType(node->GetText());
+ListObjectsResultParser::ListObjectsResultParser()
+{
+    reset();
+}
 
-                node = contents_node->FirstChildElement("Type");
-                if (node && node->GetText()) content.type_ = node->GetText();
+void ListObjectsResultParser::reset()
+{
+    result_ = ListObjectsResult();
+    parser_.reset(new XmlStreamParser(*this));
+    matched_ = false;
+    section_ = Section::None;
+}
 
-                node = contents_node->FirstChildElement("Owner");
-                std::string owner_ID, owner_DisplayName;
-                if (node) {
-                    XMLElement *sub_node;
-                    sub_node = node->FirstChildElement("ID");
-                    if (sub_node && sub_node->GetText()) owner_ID = sub_node->GetText();
+std::shared_ptr<std::iostream> ListObjectsResultParser::attach(const std::shared_ptr<std::iostream> &content)
+{
+    streamBuf_ = nullptr;
+    reset();
+    content_ = content;
+    streamBuf_ = std::make_shared<XmlParseStreamBuf>(*content, *parser_, "ListBucketResult");
+    return content;
+}
 
-                    sub_node = node->FirstChildElement("DisplayName");
-                    if (sub_node && sub_node->GetText()) owner_DisplayName = sub_node->GetText();
-                }
+bool ListObjectsResultParser::finish(ListObjectsResult &result)
+{
+    if (!parser_->finish()) {
+        return false;
+    }
+    //Detect encode type
+    if (!ToLower(result_.encodingType_.c_str()).compare(0, 3, "url", 3)) {
+        for (auto &prefix : result_.commonPrefixes_) {
+            prefix = UrlDecode(prefix);
+        }
+        for (auto &summary : result_.objectSummarys_) {
+            summary.key_ = UrlDecode(summary.key_);
+        }
+        result_.delimiter_  = UrlDecode(result_.delimiter_);
+        result_.marker_     = UrlDecode(result_.marker_);
+        result_.nextMarker_ = UrlDecode(result_.nextMarker_);
+        result_.prefix_     = UrlDecode(result_.prefix_);
+    }
+    result = std::move(result_);
+    //TODO check the result and the parse flag;
+    result.parseDone_ = true;
+    return true;
+}
 
-                content.owner_ = Owner(owner_ID, owner_DisplayName);
-                objectSummarys_.push_back(content);
-            }
+void ListObjectsResultParser::onStartElement(const std::string &name, int depth)
+{
+    if (depth == 1) {
+        matched_ = name == "ListBucketResult";
+    }
+    else if (depth == 2 && matched_) {
+        if (name == "Contents") {
+            section_ = Section::Contents;
+            result_.objectSummarys_.emplace_back();
+            result_.objectSummarys_.back().size_ = 0;
+            ownerId_.clear();
+            ownerDisplayName_.clear();
+        }
+        else if (name == "CommonPrefixes") {
+            section_ = Section::CommonPrefixes;
+        }
+        else {
+            section_ = Section::Other;
+        }
+    }
+}
 
-            //EncodingType
-            if (useUrlDecode) {
-                delimiter_  = UrlDecode(delimiter_);
-                marker_     = UrlDecode(marker_);
-                nextMarker_ = UrlDecode(nextMarker_);
-                prefix_     = UrlDecode(prefix_);
+void ListObjectsResultParser::onEndElement(const std::string &name, int depth, std::string &text)
+{
+    if (!matched_) {
+        return;
+    }
+    if (depth == 2) {
+        if (section_ == Section::Contents) {
+            result_.objectSummarys_.back().owner_ = Owner(ownerId_, ownerDisplayName_);
+        }
+        else if (text.empty()) {
+            //an empty element leaves the field as it is
+        }
+        else if (name == "Name") result_.name_ = std::move(text);
+        else if (name == "Prefix") result_.prefix_ = std::move(text);
+        else if (name == "Marker") result_.marker_ = std::move(text);
+        else if (name == "Delimiter") result_.delimiter_ = std::move(text);
+        else if (name == "MaxKeys") {
+            result_.maxKeys_ = atoi(text.c_str());
+            if (result_.maxKeys_ > 0 && result_.maxKeys_ <= 1000) {
+                result_.objectSummarys_.reserve(result_.maxKeys_);
             }
         }
-
-        //TODO check the result and the parse flag;
-        parseDone_ = true;
+        else if (name == "IsTruncated") result_.isTruncated_ = !std::strncmp("true", text.c_str(), 4);
+        else if (name == "NextMarker") result_.nextMarker_ = std::move(text);
+        else if (name == "EncodingType") result_.encodingType_ = std::move(text);
+        section_ = Section::None;
+    }
+    else if (depth == 3 && section_ == Section::Contents && !text.empty()) {
+        ObjectSummary &content = result_.objectSummarys_.back();
+        if (name == "Key") content.key_ = std::move(text);
+        else if (name == "LastModified") content.lastModified_ = std::move(text);
+        else if (name == "ETag") content.eTag_ = TrimQuotes(text.c_str());
+        else if (name == "Size") content.size_ = std::atoll(text.c_str());
+        else if (name == "StorageClass") content.storageClass_ = ToStorageClassType(text.c_str());
+        else if (name == "Type") content.type_ = std::move(text);
+    }
+    else if (depth == 3 && section_ == Section::CommonPrefixes) {
+        if (name == "Prefix" && !text.empty()) result_.commonPrefixes_.push_back(std::move(text));
+    }
+    else if (depth == 4 && section_ == Section::Contents) {
+        if (name == "ID") ownerId_ = std::move(text);
+        else if (name == "DisplayName") ownerDisplayName_ = std::move(text);
     }
-
-    return *this;
 }
-
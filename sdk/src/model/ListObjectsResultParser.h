@@ -0,0 +1,63 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <memory>
+#include <alibabacloud/oss/model/ListObjectsResult.h>
+#include "../utils/XmlStreamParser.h"
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /*
+    * Builds a ListObjectsResult element by element, either from a whole document or
+    * from a response body while it is received (attach). The summaries are filled
+    * in place, without a copy of the body or a document tree.
+    */
+    class ListObjectsResultParser : public XmlStreamParser::Handler
+    {
+    public:
+        ListObjectsResultParser();
+
+        /*parse what is written to content from now on, the previous content is released*/
+        std::shared_ptr<std::iostream> attach(const std::shared_ptr<std::iostream> &content);
+        const std::shared_ptr<std::iostream> &Content() const { return content_; }
+
+        bool feed(const char *data, size_t size) { return parser_->feed(data, size); }
+        bool feed(std::istream &in) { return parser_->feed(in); }
+        /*moves the result out, false when the document is not complete and well formed*/
+        bool finish(ListObjectsResult &result);
+
+        void onStartElement(const std::string &name, int depth) override;
+        void onEndElement(const std::string &name, int depth, std::string &text) override;
+
+    private:
+        enum class Section { None, Contents, CommonPrefixes, Other };
+        void reset();
+
+        ListObjectsResult result_;
+        std::unique_ptr<XmlStreamParser> parser_;
+        bool matched_;
+        Section section_;
+        std::string ownerId_;
+        std::string ownerDisplayName_;
+        std::shared_ptr<std::iostream> content_;
+        /*after content_, it restores the stream's buffer first*/
+        std::shared_ptr<XmlParseStreamBuf> streamBuf_;
+    };
+}
+}
@@ -16,11 +16,10 @@
 
 #include <sstream>
 #include <alibabacloud/oss/model/ListPartsResult.h>
-#include <tinyxml2/tinyxml2.h>
 #include "../utils/Utils.h"
+#include "../utils/XmlStreamParser.h"
 
 using namespace AlibabaCloud::OSS;
-using namespace tinyxml2;
 using std::stringstream;
 
 ListPartsResult::ListPartsResult():
@@ -32,6 +31,69 @@ ListPartsResult::ListPartsResult():
 {
 }
 
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class ListPartsResultParser : public XmlStreamParser::Handler
+    {
+    public:
+        explicit ListPartsResultParser(ListPartsResult &result) :
+            result_(result), matched_(false), inPart_(false) {}
+
+        void onStartElement(const std::string &name, int depth) override
+        {
+            if (depth == 1) {
+                matched_ = name == "ListPartsResult";
+            }
+            else if (depth == 2 && matched_ && name == "Part") {
+                inPart_ = true;
+                result_.partList_.push_back(Part());
+            }
+        }
+
+        void onEndElement(const std::string &name, int depth, std::string &text) override
+        {
+            if (!matched_) {
+                return;
+            }
+            if (depth == 1) {
+                //Detect encode type
+                if (!ToLower(result_.encodingType_.c_str()).compare(0, 3, "url", 3)) {
+                    result_.key_ = UrlDecode(result_.key_);
+                }
+            }
+            else if (text.empty()) {
+                inPart_ = inPart_ && depth > 2;
+            }
+            else if (depth == 2) {
+                if (name == "EncodingType") result_.encodingType_ = std::move(text);
+                else if (name == "Bucket") result_.bucket_ = std::move(text);
+                else if (name == "Key") result_.key_ = std::move(text);
+                else if (name == "UploadId") result_.uploadId_ = std::move(text);
+                else if (name == "PartNumberMarker") result_.partNumberMarker_ = std::strtoul(text.c_str(), nullptr, 10);
+                else if (name == "NextPartNumberMarker") result_.nextPartNumberMarker_ = std::strtoul(text.c_str(), nullptr, 10);
+                else if (name == "MaxParts") result_.maxParts_ = std::strtoul(text.c_str(), nullptr, 10);
+                else if (name == "IsTruncated") result_.isTruncated_ = text == "true" || text == "1";
+            }
+            else if (depth == 3 && inPart_) {
+                Part &part = result_.partList_.back();
+                if (name == "PartNumber") part.partNumber_ = std::atoi(text.c_str());
+                else if (name == "LastModified") part.lastModified_ = std::move(text);
+                else if (name == "ETag") part.eTag_ = TrimQuotes(text.c_str());
+                else if (name == "Size") part.size_ = std::strtoll(text.c_str(), nullptr, 10);
+                else if (name == "HashCrc64ecma") part.cRC64_ = std::strtoull(text.c_str(), nullptr, 10);
+            }
+        }
+
+    private:
+        ListPartsResult &result_;
+        bool matched_;
+        bool inPart_;
+    };
+}
+}
+
 ListPartsResult::ListPartsResult(const std::string& result):
     ListPartsResult()
 {
@@ -41,88 +103,20 @@ ListPartsResult::ListPartsResult(const std::string& result):
 ListPartsResult::ListPartsResult(const std::shared_ptr<std::iostream>& result):
     ListPartsResult()
 {
-    std::istreambuf_iterator<char> isb(*result.get()), end;
-    std::string str(isb, end);
-    *this = str;
+    ListPartsResultParser handler(*this);
+    XmlStreamParser parser(handler);
+    parser.feed(*result.get());
+    //TODO check the result and the parse flag;
+    parseDone_ = parser.finish();
 }
 
 ListPartsResult& ListPartsResult::operator =(const std::string& result)
 {
-    XMLDocument doc;
-    XMLError xml_err;
-    if ((xml_err = doc.Parse(result.c_str(), result.size())) == XML_SUCCESS) {
-        XMLElement* root =doc.RootElement();
-        if (root && !std::strncmp("ListPartsResult", root->Name(), 15)) {
-            XMLElement *node;
-            node = root->FirstChildElement("EncodingType");
-            if (node && node->GetText()) encodingType_ = node->GetText();
-
-            //Detect encode type
-            bool useUrlDecode = !ToLower(encodingType_.c_str()).compare(0, 3, "url", 3);
-
-            node = root->FirstChildElement("Bucket");
-            if (node && node->GetText()) bucket_ = node->GetText();
-
-            node = root->FirstChildElement("Key");
-            if (node && node->GetText()) key_ = useUrlDecode ? UrlDecode(node->GetText()) : node->GetText();
-
-            node = root->FirstChildElement("UploadId");
-            if (node && node->GetText()) uploadId_ = node->GetText();
-
-            node = root->FirstChildElement("PartNumberMarker");
-            if(node && node->GetText())
-            {
-                partNumberMarker_ = std::strtoul(node->GetText(), nullptr, 10);
-            }
-
-            node = root->FirstChildElement("NextPartNumberMarker");
-            if(node && node->GetText())
-            {
-                nextPartNumberMarker_ = std::strtoul(node->GetText(), nullptr, 10);
-            }
-
-            node = root->FirstChildElement("MaxParts");
-            if (node && node->GetText())
-            {
-                maxParts_ = std::strtoul(node->GetText(), nullptr, 10);
-            }
-
-            node = root->FirstChildElement("IsTruncated");
-            if (node && node->GetText()) isTruncated_ = node->BoolText();
-
-            XMLElement * partNode = root->FirstChildElement("Part");
-            for( ; partNode ; partNode = partNode->NextSiblingElement("Part"))
-            {
-                Part part;
-                XMLElement * node = partNode->FirstChildElement("PartNumber");
-                if(node && node->GetText())
-                {
-                    part.partNumber_ = std::atoi(node->GetText());
-                }
-
-                node = partNode->FirstChildElement("LastModified");
-                if(node && node->GetText()) part.lastModified_ = node->GetText();
-
-                node = partNode->FirstChildElement("ETag");
-                if (node && node->GetText()) part.eTag_ = TrimQuotes(node->GetText());
-
-                node = partNode->FirstChildElement("Size");
-                if(node && node->GetText())
-                {
-                    part.size_ = std::strtoll(node->GetText(), nullptr, 10);
-                }
-
-                node = partNode->FirstChildElement("HashCrc64ecma");
-                if(node && node->GetText())
-                {
-                    part.cRC64_ = std::strtoull(node->GetText(), nullptr, 10);
-                }
-                partList_.push_back(part);
-            }
-        }
-        //TODO check the result and the parse flag;
-        parseDone_ = true;
-    }
+    ListPartsResultParser handler(*this);
+    XmlStreamParser parser(handler);
+    parser.feed(result.c_str(), result.size());
+    //TODO check the result and the parse flag;
+    parseDone_ = parser.finish();
     return *this;
 }
 
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BandwidthShaper.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+
+using namespace AlibabaCloud::OSS;
+
+namespace
+{
+    //a class that took bytes this recently still competes for the rate
+    const int64_t ActiveWindowUs = 100 * 1000;
+    //a paused transfer asks again at least this often, the rate may have been raised
+    const int64_t MaxWaitUs = 100 * 1000;
+
+    int64_t NowUs()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    size_t ClassIndex(TransferPriority priority)
+    {
+        size_t index = static_cast<size_t>(priority);
+        return index < 3 ? index : 2;
+    }
+}
+
+const size_t BandwidthShaper::ClassNum;
+
+std::shared_ptr<BandwidthShaper> BandwidthShaper::Get(const std::shared_ptr<RateLimiter>& limiter)
+{
+    if (limiter == nullptr) {
+        return nullptr;
+    }
+    static std::mutex lock;
+    static std::map<const RateLimiter *, std::weak_ptr<BandwidthShaper>> shapers;
+    std::lock_guard<std::mutex> lck(lock);
+    for (auto it = shapers.begin(); it != shapers.end();) {
+        it = it->second.expired() ? shapers.erase(it) : std::next(it);
+    }
+    //the shaper holds the limiter, so the key stays valid while the entry is alive
+    auto shaper = shapers[limiter.get()].lock();
+    if (shaper == nullptr) {
+        shaper = std::make_shared<BandwidthShaper>(limiter);
+        shapers[limiter.get()] = shaper;
+    }
+    return shaper;
+}
+
+BandwidthShaper::BandwidthShaper(const std::shared_ptr<RateLimiter>& limiter) :
+    limiter_(limiter),
+    lastRefill_(NowUs())
+{
+    for (size_t i = 0; i < ClassNum; i++) {
+        tokens_[i] = 0;
+        activeUntil_[i] = 0;
+    }
+}
+
+bool BandwidthShaper::take(TransferPriority priority, int64_t bytes, int64_t& waitUs)
+{
+    waitUs = 0;
+    int rate = limiter_->Rate();
+    if (rate <= 0 || bytes <= 0) {
+        return true;
+    }
+    double bytesPerUs = rate * 1024.0 / 1000000.0;
+    int64_t burst = limiter_->Burst();
+    burst = burst > 0 ? burst : static_cast<int64_t>(rate) * 1024 / 10;
+
+    size_t index = ClassIndex(priority);
+    std::lock_guard<std::mutex> lck(lock_);
+    int64_t now = NowUs();
+    activeUntil_[index] = std::max(activeUntil_[index], now + ActiveWindowUs);
+    refill(now, bytesPerUs, burst);
+
+    if (tokens_[index] > 0) {
+        tokens_[index] -= static_cast<double>(bytes);
+        return true;
+    }
+    double classBytesPerUs = bytesPerUs * share(index, now);
+    waitUs = static_cast<int64_t>(std::ceil((1.0 - tokens_[index]) / classBytesPerUs));
+    waitUs = std::min(std::max<int64_t>(waitUs, 1), MaxWaitUs);
+    //still competing while it pauses, or the others would take its share
+    activeUntil_[index] = std::max(activeUntil_[index], now + waitUs + ActiveWindowUs);
+    return false;
+}
+
+double BandwidthShaper::share(size_t index, int64_t now) const
+{
+    double total = 0;
+    for (size_t i = 0; i < ClassNum; i++) {
+        if (activeUntil_[i] >= now) {
+            total += std::max(limiter_->PriorityWeight(static_cast<TransferPriority>(i)), 1);
+        }
+    }
+    double weight = std::max(limiter_->PriorityWeight(static_cast<TransferPriority>(index)), 1);
+    return total > 0 ? weight / total : 1.0;
+}
+
+void BandwidthShaper::refill(int64_t now, double bytesPerUs, int64_t burst)
+{
+    int64_t elapsed = now - lastRefill_;
+    if (elapsed <= 0) {
+        return;
+    }
+    lastRefill_ = now;
+    for (size_t i = 0; i < ClassNum; i++) {
+        if (activeUntil_[i] < now) {
+            continue;
+        }
+        double share = this->share(i, now);
+        tokens_[i] = std::min(tokens_[i] + elapsed * bytesPerUs * share, burst * share);
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <alibabacloud/oss/Types.h>
+#include <alibabacloud/oss/client/RateLimiter.h>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /**
+    * Token bucket of a RateLimiter, shared by every transfer of every client the limiter
+    * is set on. Each priority class has its own bucket, the rate is split over the classes
+    * that took bytes lately by their weights, so a class alone gets all of it. A transfer
+    * takes bytes while its bucket is not in debt and may overdraw it by one chunk, so the
+    * rate holds on average whatever the chunk size; in debt it is told how long to pause.
+    * The rate, burst and weights are read from the limiter on every take.
+    */
+    class BandwidthShaper
+    {
+    public:
+        /*the shaper of the limiter in this process*/
+        static std::shared_ptr<BandwidthShaper> Get(const std::shared_ptr<RateLimiter>& limiter);
+
+        explicit BandwidthShaper(const std::shared_ptr<RateLimiter>& limiter);
+
+        /*takes bytes, or returns false and the microseconds to pause before asking again*/
+        bool take(TransferPriority priority, int64_t bytes, int64_t& waitUs);
+
+    private:
+        BandwidthShaper(const BandwidthShaper&) = delete;
+        BandwidthShaper& operator=(const BandwidthShaper&) = delete;
+        static const size_t ClassNum = 3;
+        void refill(int64_t now, double bytesPerUs, int64_t burst);
+        double share(size_t index, int64_t now) const;
+
+        std::shared_ptr<RateLimiter> limiter_;
+        std::mutex lock_;
+        int64_t lastRefill_;
+        double tokens_[ClassNum];
+        //a class counts as competing for the rate until then
+        int64_t activeUntil_[ClassNum];
+    };
+}
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <alibabacloud/oss/utils/BatchDeleter.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/utils/ObjectLister.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include "LogUtils.h"
+
+using namespace AlibabaCloud::OSS;
+
+static const char *TAG = "BatchDeleter";
+
+namespace
+{
+    /*the DeleteObjects limit*/
+    const size_t MaxBatchSize = 1000;
+    const int DefaultMaxAttempts = 3;
+}
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class BatchDeleterState : public std::enable_shared_from_this<BatchDeleterState>
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        BatchDeleterState(const OssClient &client, const std::string &bucket, int parallel);
+
+        bool add(const std::string &key);
+        bool flush();
+        void fail(const OssError &err);
+        const OssClient &client() const { return client_; }
+        const std::string &bucket() const { return bucket_; }
+
+        size_t batchSize;
+        int maxAttempts;
+        RequestPayer requestPayer;
+
+        mutable std::mutex lock;
+        bool failed;
+        OssError error;
+        int64_t deleted;
+        int64_t requests;
+        DeletedKeyList failedKeys;
+        Clock::time_point startTime;
+        Clock::time_point lastTime;
+
+    private:
+        void send(std::unique_lock<std::mutex> &lck);
+        void issue(DeletedKeyList &&keys, int attempt);
+        void onResult(const DeleteObjectsRequest &request, int attempt, const DeleteObjecstOutcome &outcome);
+
+        const OssClient &client_;
+        std::string bucket_;
+        int parallel_;
+        std::condition_variable cv_;
+        DeletedKeyList pending_;
+        size_t pendingSize_;
+        int inFlight_;
+    };
+}
+}
+
+BatchDeleterState::BatchDeleterState(const OssClient &client, const std::string &bucket, int parallel) :
+    batchSize(MaxBatchSize),
+    maxAttempts(DefaultMaxAttempts),
+    requestPayer(RequestPayer::NotSet),
+    failed(false),
+    deleted(0),
+    requests(0),
+    client_(client),
+    bucket_(bucket),
+    parallel_(std::max(parallel, 1)),
+    pendingSize_(0),
+    inFlight_(0)
+{
+}
+
+bool BatchDeleterState::add(const std::string &key)
+{
+    std::unique_lock<std::mutex> lck(lock);
+    if (failed) {
+        return false;
+    }
+    if (requests == 0 && pendingSize_ == 0) {
+        startTime = Clock::now();
+        lastTime = startTime;
+    }
+    pending_.push_back(key);
+    if (++pendingSize_ >= batchSize) {
+        send(lck);
+    }
+    return true;
+}
+
+bool BatchDeleterState::flush()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    if (pendingSize_ > 0 && !failed) {
+        send(lck);
+    }
+    cv_.wait(lck, [this] { return inFlight_ == 0; });
+    return !failed && failedKeys.empty();
+}
+
+void BatchDeleterState::fail(const OssError &err)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    if (!failed) {
+        failed = true;
+        error = err;
+    }
+}
+
+/*hands the pending batch to a free request slot, called with the lock held*/
+void BatchDeleterState::send(std::unique_lock<std::mutex> &lck)
+{
+    cv_.wait(lck, [this] { return inFlight_ < parallel_; });
+    DeletedKeyList keys;
+    keys.swap(pending_);
+    pendingSize_ = 0;
+    inFlight_++;
+    //the request is built, hashed and sent on the executor while the next batch is filled
+    lck.unlock();
+    issue(std::move(keys), 1);
+    lck.lock();
+}
+
+void BatchDeleterState::issue(DeletedKeyList &&keys, int attempt)
+{
+    DeleteObjectsRequest request(bucket_);
+    request.setQuiet(false);
+    request.setEncodingType("url");
+    request.setRequestPayer(requestPayer);
+    request.setKeyList(keys);
+    {
+        std::lock_guard<std::mutex> lck(lock);
+        requests++;
+    }
+    auto self = shared_from_this();
+    client_.DeleteObjectsAsync(request, [self, attempt](const OssClient *, const DeleteObjectsRequest &req,
+        const DeleteObjecstOutcome &outcome, const std::shared_ptr<const AsyncCallerContext> &)
+    {
+        self->onResult(req, attempt, outcome);
+    });
+}
+
+void BatchDeleterState::onResult(const DeleteObjectsRequest &request, int attempt, const DeleteObjecstOutcome &outcome)
+{
+    DeletedKeyList missing;
+    {
+        std::lock_guard<std::mutex> lck(lock);
+        lastTime = Clock::now();
+        if (!outcome.isSuccess()) {
+            if (!failed) {
+                failed = true;
+                error = outcome.error();
+            }
+            OSS_LOG(LogLevel::LogError, TAG, "deleter(%p) request of %d keys failed, code:%s, message:%s",
+                this, static_cast<int>(request.KeyList().size()), outcome.error().Code().c_str(),
+                outcome.error().Message().c_str());
+            failedKeys.insert(failedKeys.end(), request.KeyList().begin(), request.KeyList().end());
+        }
+        else {
+            const auto &deletedKeys = outcome.result().keyList();
+            std::unordered_set<std::string> done(deletedKeys.begin(), deletedKeys.end());
+            for (const auto &key : request.KeyList()) {
+                if (done.count(key) == 0) {
+                    missing.push_back(key);
+                }
+            }
+            deleted += static_cast<int64_t>(request.KeyList().size() - missing.size());
+            if (!missing.empty() && attempt >= maxAttempts) {
+                OSS_LOG(LogLevel::LogError, TAG, "deleter(%p) gave up %d keys after %d attempts",
+                    this, static_cast<int>(missing.size()), attempt);
+                failedKeys.splice(failedKeys.end(), missing);
+            }
+        }
+        if (missing.empty()) {
+            inFlight_--;
+            cv_.notify_all();
+            return;
+        }
+    }
+    //the keys left over take the slot of this request
+    OSS_LOG(LogLevel::LogDebug, TAG, "deleter(%p) retry %d keys, attempt:%d",
+        this, static_cast<int>(missing.size()), attempt + 1);
+    issue(std::move(missing), attempt + 1);
+}
+
+BatchDeleter::BatchDeleter(const OssClient &client, const std::string &bucket, int parallel) :
+    state_(std::make_shared<BatchDeleterState>(client, bucket, parallel))
+{
+}
+
+BatchDeleter::~BatchDeleter()
+{
+    //the pending callbacks hold the state, they are done once flush returns
+    state_->flush();
+}
+
+void BatchDeleter::setBatchSize(size_t size)
+{
+    state_->batchSize = std::max<size_t>(1, std::min(size, MaxBatchSize));
+}
+
+void BatchDeleter::setMaxAttempts(int attempts)
+{
+    state_->maxAttempts = std::max(attempts, 1);
+}
+
+void BatchDeleter::setRequestPayer(RequestPayer value)
+{
+    state_->requestPayer = value;
+}
+
+bool BatchDeleter::add(const std::string &key)
+{
+    return state_->add(key);
+}
+
+bool BatchDeleter::deletePrefix(const std::string &prefix, int listParallel)
+{
+    ListObjectsRequest request(state_->bucket());
+    request.setPrefix(prefix);
+    request.setMaxKeys(static_cast<int>(MaxBatchSize));
+    //the keys are deleted behind the listing markers, the pages to come are not affected
+    ObjectLister lister(state_->client(), request, listParallel, false);
+    ObjectSummaryList page;
+    bool added = true;
+    while (added && lister.nextPage(page)) {
+        for (const auto &summary : page) {
+            if (!(added = state_->add(summary.Key()))) {
+                break;
+            }
+        }
+    }
+    if (lister.hasError()) {
+        state_->fail(lister.error());
+    }
+    return flush();
+}
+
+bool BatchDeleter::flush()
+{
+    return state_->flush();
+}
+
+int64_t BatchDeleter::DeletedCount() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->deleted;
+}
+
+int64_t BatchDeleter::RequestCount() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->requests;
+}
+
+DeletedKeyList BatchDeleter::FailedKeys() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->failedKeys;
+}
+
+double BatchDeleter::KeysPerSecond() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(state_->lastTime - state_->startTime).count();
+    return us > 0 ? state_->deleted * 1000000.0 / us : 0.0;
+}
+
+bool BatchDeleter::hasError() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->failed;
+}
+
+OssError BatchDeleter::error() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->error;
+}
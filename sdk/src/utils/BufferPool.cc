@@ -0,0 +1,315 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <alibabacloud/oss/utils/BufferPool.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+using namespace AlibabaCloud::OSS;
+
+namespace
+{
+    size_t ClassSize(size_t index)
+    {
+        return BufferPool::MinBlockSize << (2 * index);
+    }
+
+    /*the smallest class that holds size, SizeClassNum if none does*/
+    size_t ClassIndex(size_t size)
+    {
+        size_t index = 0;
+        while (index < BufferPool::SizeClassNum && ClassSize(index) < size) {
+            index++;
+        }
+        return index;
+    }
+}
+
+const size_t BufferPool::SizeClassNum;
+const size_t BufferPool::MinBlockSize;
+const size_t BufferPool::MaxBlockSize;
+
+BufferPool::BufferPool(size_t maxPooledBytes) :
+    acquires_(0),
+    hits_(0),
+    releases_(0),
+    drops_(0),
+    pooledBytes_(0)
+{
+    for (size_t i = 0; i < SizeClassNum; i++) {
+        size_t maxBlocks = maxPooledBytes / SizeClassNum / ClassSize(i);
+        classes_[i].maxBlocks = maxPooledBytes > 0 ? std::max<size_t>(maxBlocks, 1) : 0;
+        //a release never allocates
+        classes_[i].blocks.reserve(classes_[i].maxBlocks);
+    }
+}
+
+BufferPool::~BufferPool()
+{
+    clear();
+}
+
+const std::shared_ptr<BufferPool>& BufferPool::Default()
+{
+    static std::shared_ptr<BufferPool> pool = std::make_shared<BufferPool>();
+    return pool;
+}
+
+char* BufferPool::acquire(size_t size, size_t& capacity)
+{
+    acquires_++;
+    size_t index = ClassIndex(size);
+    if (index == SizeClassNum) {
+        capacity = size;
+        return new char[size];
+    }
+    capacity = ClassSize(index);
+    SizeClass &sizeClass = classes_[index];
+    {
+        std::lock_guard<std::mutex> lck(sizeClass.lock);
+        if (!sizeClass.blocks.empty()) {
+            char *block = sizeClass.blocks.back();
+            sizeClass.blocks.pop_back();
+            hits_++;
+            pooledBytes_ -= capacity;
+            return block;
+        }
+    }
+    return new char[capacity];
+}
+
+void BufferPool::release(char* block, size_t capacity)
+{
+    if (block == nullptr) {
+        return;
+    }
+    releases_++;
+    size_t index = ClassIndex(capacity);
+    if (index < SizeClassNum && ClassSize(index) == capacity) {
+        SizeClass &sizeClass = classes_[index];
+        std::lock_guard<std::mutex> lck(sizeClass.lock);
+        if (sizeClass.blocks.size() < sizeClass.maxBlocks) {
+            sizeClass.blocks.push_back(block);
+            pooledBytes_ += capacity;
+            return;
+        }
+    }
+    drops_++;
+    delete[] block;
+}
+
+void BufferPool::clear()
+{
+    for (size_t i = 0; i < SizeClassNum; i++) {
+        std::vector<char*> blocks;
+        {
+            std::lock_guard<std::mutex> lck(classes_[i].lock);
+            blocks.swap(classes_[i].blocks);
+            classes_[i].blocks.reserve(classes_[i].maxBlocks);
+            pooledBytes_ -= blocks.size() * ClassSize(i);
+        }
+        for (auto block : blocks) {
+            delete[] block;
+        }
+    }
+}
+
+BufferPool::Stats BufferPool::Statistics() const
+{
+    Stats stats;
+    stats.acquires = acquires_;
+    stats.hits = hits_;
+    stats.releases = releases_;
+    stats.drops = drops_;
+    stats.pooledBytes = pooledBytes_;
+    return stats;
+}
+
+PooledBuffer::PooledBuffer(const std::shared_ptr<BufferPool>& pool, size_t reserve) :
+    pool_(pool),
+    data_(nullptr),
+    capacity_(0),
+    size_(0)
+{
+    setPositions(0, 0);
+    if (reserve > 0) {
+        grow(reserve);
+    }
+}
+
+PooledBuffer::~PooledBuffer()
+{
+    if (pool_ != nullptr) {
+        pool_->release(data_, capacity_);
+    }
+    else {
+        delete[] data_;
+    }
+}
+
+size_t PooledBuffer::size() const
+{
+    return std::max(size_, static_cast<size_t>(pptr() - pbase()));
+}
+
+void PooledBuffer::reserve(size_t size)
+{
+    grow(size);
+}
+
+void PooledBuffer::resize(size_t size)
+{
+    size_t readPos = static_cast<size_t>(gptr() - eback());
+    size_t writePos = static_cast<size_t>(pptr() - pbase());
+    grow(size);
+    size_ = size;
+    setPositions(std::min(readPos, size), std::min(writePos, size));
+}
+
+void PooledBuffer::append(const char* data, size_t size)
+{
+    syncSize();
+    size_t readPos = static_cast<size_t>(gptr() - eback());
+    grow(size_ + size);
+    if (size > 0) {
+        memcpy(data_ + size_, data, size);
+    }
+    size_ += size;
+    setPositions(readPos, size_);
+}
+
+void PooledBuffer::clear()
+{
+    size_ = 0;
+    setPositions(0, 0);
+}
+
+std::string PooledBuffer::str() const
+{
+    return std::string(data_, size());
+}
+
+PooledBuffer::int_type PooledBuffer::underflow()
+{
+    syncSize();
+    return gptr() < egptr() ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+}
+
+PooledBuffer::int_type PooledBuffer::overflow(int_type c)
+{
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+        return traits_type::not_eof(c);
+    }
+    grow(static_cast<size_t>(pptr() - pbase()) + 1);
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+    return c;
+}
+
+std::streamsize PooledBuffer::xsputn(const char* s, std::streamsize n)
+{
+    if (n <= 0) {
+        return 0;
+    }
+    size_t writePos = static_cast<size_t>(pptr() - pbase());
+    grow(writePos + static_cast<size_t>(n));
+    memcpy(pptr(), s, static_cast<size_t>(n));
+    setPositions(static_cast<size_t>(gptr() - eback()), writePos + static_cast<size_t>(n));
+    return n;
+}
+
+std::streamsize PooledBuffer::showmanyc()
+{
+    syncSize();
+    std::streamsize avail = egptr() - gptr();
+    return avail > 0 ? avail : -1;
+}
+
+PooledBuffer::pos_type PooledBuffer::seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which)
+{
+    syncSize();
+    bool in = (which & std::ios_base::in) != 0;
+    bool out = (which & std::ios_base::out) != 0;
+    off_type readPos = gptr() - eback();
+    off_type writePos = pptr() - pbase();
+    off_type base = 0;
+    if (way == std::ios_base::end) {
+        base = static_cast<off_type>(size_);
+    }
+    else if (way == std::ios_base::cur) {
+        //like std::stringbuf, the current position of both is ambiguous
+        if (in == out) {
+            return pos_type(off_type(-1));
+        }
+        base = in ? readPos : writePos;
+    }
+    off_type pos = base + off;
+    if ((!in && !out) || pos < 0 || pos > static_cast<off_type>(size_)) {
+        return pos_type(off_type(-1));
+    }
+    setPositions(static_cast<size_t>(in ? pos : readPos), static_cast<size_t>(out ? pos : writePos));
+    return pos_type(pos);
+}
+
+PooledBuffer::pos_type PooledBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+void PooledBuffer::syncSize()
+{
+    size_ = size();
+    setg(eback(), gptr(), data_ + size_);
+}
+
+void PooledBuffer::grow(size_t size)
+{
+    if (size <= capacity_) {
+        return;
+    }
+    size_t readPos = static_cast<size_t>(gptr() - eback());
+    size_t writePos = static_cast<size_t>(pptr() - pbase());
+    size_ = this->size();
+
+    size_t request = std::max(size, capacity_ * 2);
+    size_t capacity = request;
+    char *block = pool_ != nullptr ? pool_->acquire(request, capacity) : new char[request];
+    if (size_ > 0) {
+        memcpy(block, data_, size_);
+    }
+    if (pool_ != nullptr) {
+        pool_->release(data_, capacity_);
+    }
+    else {
+        delete[] data_;
+    }
+    data_ = block;
+    capacity_ = capacity;
+    setPositions(readPos, writePos);
+}
+
+void PooledBuffer::setPositions(size_t readPos, size_t writePos)
+{
+    setg(data_, data_ + readPos, data_ + size_);
+    setp(data_, data_ + capacity_);
+    //pbump takes an int
+    while (writePos > 0) {
+        int step = static_cast<int>(std::min<size_t>(writePos, INT_MAX));
+        pbump(step);
+        writePos -= static_cast<size_t>(step);
+    }
+}
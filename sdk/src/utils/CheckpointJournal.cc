@@ -0,0 +1,364 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CheckpointJournal.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+#include "Crc32.h"
+#include "FileSystemUtils.h"
+#include "LogUtils.h"
+
+using namespace AlibabaCloud::OSS;
+
+static const char *TAG = "CheckpointJournal";
+
+namespace
+{
+    const char Magic[4] = { 'O', 'S', 'S', 'J' };
+    const uint32_t Version = 1;
+
+    void PutU32(char *p, uint32_t v)
+    {
+        for (int i = 0; i < 4; i++) {
+            p[i] = static_cast<char>((v >> (8 * i)) & 0xff);
+        }
+    }
+
+    void PutU64(char *p, uint64_t v)
+    {
+        for (int i = 0; i < 8; i++) {
+            p[i] = static_cast<char>((v >> (8 * i)) & 0xff);
+        }
+    }
+
+    uint32_t GetU32(const char *p)
+    {
+        uint32_t v = 0;
+        for (int i = 3; i >= 0; i--) {
+            v = (v << 8) | static_cast<unsigned char>(p[i]);
+        }
+        return v;
+    }
+
+    uint64_t GetU64(const char *p)
+    {
+        uint64_t v = 0;
+        for (int i = 7; i >= 0; i--) {
+            v = (v << 8) | static_cast<unsigned char>(p[i]);
+        }
+        return v;
+    }
+
+    void EncodeHeader(char *p)
+    {
+        memcpy(p, Magic, sizeof(Magic));
+        PutU32(p + 4, Version);
+        PutU32(p + 8, static_cast<uint32_t>(CheckpointJournal::EntrySize));
+        PutU32(p + 12, CRC32::CalcCRC(0, p, 12));
+    }
+
+    bool DecodeHeader(const char *p)
+    {
+        return memcmp(p, Magic, sizeof(Magic)) == 0 &&
+            GetU32(p + 4) == Version &&
+            GetU32(p + 8) == CheckpointJournal::EntrySize &&
+            GetU32(p + 12) == CRC32::CalcCRC(0, p, 12);
+    }
+
+    /*part number, etag length, offset, size, crc64, etag, reserved, then the crc32 of all that*/
+    bool EncodeEntry(char *p, const CheckpointJournal::Entry &entry)
+    {
+        if (entry.eTag.size() > CheckpointJournal::MaxETagSize) {
+            return false;
+        }
+        memset(p, 0, CheckpointJournal::EntrySize);
+        PutU32(p, static_cast<uint32_t>(entry.partNumber));
+        PutU32(p + 4, static_cast<uint32_t>(entry.eTag.size()));
+        PutU64(p + 8, static_cast<uint64_t>(entry.offset));
+        PutU64(p + 16, static_cast<uint64_t>(entry.size));
+        PutU64(p + 24, entry.crc64);
+        memcpy(p + 32, entry.eTag.data(), entry.eTag.size());
+        PutU32(p + 100, CRC32::CalcCRC(0, p, 100));
+        return true;
+    }
+
+    bool DecodeEntry(const char *p, CheckpointJournal::Entry &entry)
+    {
+        uint32_t eTagSize = GetU32(p + 4);
+        if (GetU32(p + 100) != CRC32::CalcCRC(0, p, 100) || eTagSize > CheckpointJournal::MaxETagSize) {
+            return false;
+        }
+        entry.partNumber = static_cast<int32_t>(GetU32(p));
+        entry.offset = static_cast<int64_t>(GetU64(p + 8));
+        entry.size = static_cast<int64_t>(GetU64(p + 16));
+        entry.crc64 = GetU64(p + 24);
+        entry.eTag.assign(p + 32, eTagSize);
+        return true;
+    }
+
+    int OpenFile(const std::string &path, bool truncate)
+    {
+        int fd = -1;
+#ifdef _WIN32
+        int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : _O_APPEND);
+        if (_sopen_s(&fd, path.c_str(), flags, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0) {
+            fd = -1;
+        }
+#else
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND);
+        fd = ::open(path.c_str(), flags, 0644);
+#endif
+        return fd;
+    }
+
+    void CloseFile(int fd)
+    {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+
+    int64_t FileSize(int fd)
+    {
+#ifdef _WIN32
+        return _lseeki64(fd, 0, SEEK_END);
+#else
+        return static_cast<int64_t>(::lseek(fd, 0, SEEK_END));
+#endif
+    }
+
+    bool WriteAll(int fd, const char *data, size_t size)
+    {
+        while (size > 0) {
+#ifdef _WIN32
+            int n = _write(fd, data, static_cast<unsigned int>(size));
+#else
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+#endif
+            if (n <= 0) {
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    void SyncFile(int fd)
+    {
+#ifdef _WIN32
+        _commit(fd);
+#else
+        ::fsync(fd);
+#endif
+    }
+
+    //from takes the place of to in one step, to is never missing
+    bool MoveFileOver(const std::string &from, const std::string &to)
+    {
+#ifdef _WIN32
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return RenameFile(from, to);
+#endif
+    }
+}
+
+const size_t CheckpointJournal::HeaderSize;
+const size_t CheckpointJournal::EntrySize;
+const size_t CheckpointJournal::MaxETagSize;
+
+CheckpointJournal::CheckpointJournal(const std::string& path, uint32_t syncEvery) :
+    path_(path),
+    syncEvery_(syncEvery),
+    fd_(-1),
+    unsynced_(0)
+{
+}
+
+CheckpointJournal::~CheckpointJournal()
+{
+    close();
+}
+
+bool CheckpointJournal::replay(std::vector<Entry>& entries)
+{
+    std::string data;
+    {
+        std::ifstream file(path_, std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::stringstream ss;
+        ss << file.rdbuf();
+        data = ss.str();
+    }
+
+    entries.clear();
+    bool wasted = data.size() < HeaderSize || !DecodeHeader(data.data());
+    std::map<int32_t, size_t> indexes;
+    for (size_t pos = HeaderSize; !wasted && pos < data.size(); pos += EntrySize) {
+        Entry entry;
+        if (pos + EntrySize > data.size() || !DecodeEntry(data.data() + pos, entry)) {
+            //a torn write at the end, or garbage: the rest can not be trusted
+            wasted = true;
+            break;
+        }
+        auto it = indexes.find(entry.partNumber);
+        if (it != indexes.end()) {
+            entries[it->second] = entry;
+            wasted = true;
+        }
+        else {
+            indexes[entry.partNumber] = entries.size();
+            entries.push_back(entry);
+        }
+    }
+
+    if (wasted) {
+        OSS_LOG(LogLevel::LogInfo, TAG, "journal(%s) compacted to %d entries from %d bytes",
+            path_.c_str(), static_cast<int>(entries.size()), static_cast<int>(data.size()));
+        compact(entries);
+    }
+    return true;
+}
+
+bool CheckpointJournal::open()
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    if (fd_ >= 0) {
+        return true;
+    }
+    fd_ = OpenFile(path_, false);
+    if (fd_ < 0) {
+        OSS_LOG(LogLevel::LogWarn, TAG, "journal(%s) can not be opened", path_.c_str());
+        return false;
+    }
+    if (FileSize(fd_) == 0) {
+        char header[HeaderSize];
+        EncodeHeader(header);
+        return write(header, sizeof(header));
+    }
+    return true;
+}
+
+bool CheckpointJournal::append(const Entry& entry)
+{
+    char data[EntrySize];
+    if (!EncodeEntry(data, entry)) {
+        OSS_LOG(LogLevel::LogWarn, TAG, "journal(%s) skips part %d, etag of %d bytes",
+            path_.c_str(), entry.partNumber, static_cast<int>(entry.eTag.size()));
+        return false;
+    }
+    if (!open()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lck(lock_);
+    if (!write(data, sizeof(data))) {
+        return false;
+    }
+    if (syncEvery_ > 0 && ++unsynced_ >= syncEvery_) {
+        sync();
+    }
+    return true;
+}
+
+bool CheckpointJournal::compact(const std::vector<Entry>& entries)
+{
+    std::string data(HeaderSize + EntrySize * entries.size(), '\0');
+    EncodeHeader(&data[0]);
+    size_t size = HeaderSize;
+    for (const auto &entry : entries) {
+        if (EncodeEntry(&data[size], entry)) {
+            size += EntrySize;
+        }
+    }
+
+    std::string tmpPath = path_ + ".tmp";
+    int fd = OpenFile(tmpPath, true);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = WriteAll(fd, data.data(), size);
+    //the old journal is only replaced by a complete one
+    SyncFile(fd);
+    CloseFile(fd);
+
+    std::lock_guard<std::mutex> lck(lock_);
+    if (fd_ >= 0) {
+        CloseFile(fd_);
+        fd_ = -1;
+    }
+    if (!ok || !MoveFileOver(tmpPath, path_)) {
+        RemoveFile(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+void CheckpointJournal::close()
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    if (fd_ >= 0) {
+        if (unsynced_ > 0) {
+            sync();
+        }
+        CloseFile(fd_);
+        fd_ = -1;
+    }
+}
+
+void CheckpointJournal::remove()
+{
+    close();
+    RemoveFile(path_);
+}
+
+bool CheckpointJournal::write(const char* data, size_t size)
+{
+    //called with lock_ held
+    if (!WriteAll(fd_, data, size)) {
+        OSS_LOG(LogLevel::LogWarn, TAG, "journal(%s) write failed", path_.c_str());
+        return false;
+    }
+    return true;
+}
+
+void CheckpointJournal::sync()
+{
+    //called with lock_ held
+    SyncFile(fd_);
+    unsynced_ = 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /**
+    * Append-only log of the parts a resumable transfer has completed, kept next to its
+    * json record. Each part is one fixed-size little-endian entry with its own CRC32, so
+    * a part costs one small write instead of a rewrite of the whole record. A replay
+    * stops at the first torn or corrupted entry; when it found one, or a part logged
+    * twice, the log is compacted to the valid entries, written aside and renamed over.
+    */
+    class CheckpointJournal
+    {
+    public:
+        struct Entry
+        {
+            Entry() : partNumber(0), offset(0), size(0), crc64(0) {}
+            int32_t partNumber;
+            int64_t offset;
+            int64_t size;
+            uint64_t crc64;
+            std::string eTag;
+        };
+        static const size_t HeaderSize = 16;
+        static const size_t EntrySize = 104;
+        static const size_t MaxETagSize = 64;
+
+        /*fsync after every syncEvery entries, 0 leaves the flushing to the system*/
+        CheckpointJournal(const std::string& path, uint32_t syncEvery = 0);
+        ~CheckpointJournal();
+
+        /*the entries of an existing journal, false if there is none*/
+        bool replay(std::vector<Entry>& entries);
+        /*opens for appending, a missing journal is created*/
+        bool open();
+        bool append(const Entry& entry);
+        /*replaces the journal with these entries*/
+        bool compact(const std::vector<Entry>& entries);
+        void close();
+        void remove();
+
+        const std::string& Path() const { return path_; }
+
+    private:
+        CheckpointJournal(const CheckpointJournal&) = delete;
+        CheckpointJournal& operator=(const CheckpointJournal&) = delete;
+        bool write(const char* data, size_t size);
+        void sync();
+
+        std::string path_;
+        uint32_t syncEvery_;
+        int fd_;
+        uint32_t unsynced_;
+        std::mutex lock_;
+    };
+}
+}
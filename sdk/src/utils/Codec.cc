@@ -0,0 +1,426 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Codec.h"
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CODEC_SSE2 1
+#define CODEC_AVX2 1
+#define CODEC_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_M_X64) && defined(_MSC_VER)
+#include <intrin.h>
+#define CODEC_SSE2 1
+#endif
+
+using namespace AlibabaCloud::OSS;
+
+namespace
+{
+    typedef size_t(*UrlKernel)(const unsigned char *src, size_t len, char *out);
+
+    struct CodecTables
+    {
+        CodecTables()
+        {
+            static const char *hex = "0123456789ABCDEF";
+            static const char *enc = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (int c = 0; c < 256; c++) {
+                kept[c] = (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                    c == '-' || c == '_' || c == '.' || c == '~';
+                hexPair[c][0] = hex[c >> 4];
+                hexPair[c][1] = hex[c & 15];
+                hexValue[c] = -1;
+            }
+            for (int i = 0; i < 16; i++) {
+                hexValue[static_cast<unsigned char>(hex[i])] = static_cast<signed char>(i);
+                hexValue[static_cast<unsigned char>(::tolower(hex[i]))] = static_cast<signed char>(i);
+            }
+            //12 bits to two base64 characters
+            for (int i = 0; i < 4096; i++) {
+                base64Pair[i][0] = enc[i >> 6];
+                base64Pair[i][1] = enc[i & 63];
+            }
+            base64 = enc;
+        }
+        bool kept[256];
+        char hexPair[256][2];
+        signed char hexValue[256];
+        char base64Pair[4096][2];
+        const char *base64;
+    };
+
+    const CodecTables Tables;
+
+    inline char *EncodeByte(unsigned char c, char *out)
+    {
+        if (Tables.kept[c]) {
+            *out++ = static_cast<char>(c);
+        }
+        else {
+            *out++ = '%';
+            *out++ = Tables.hexPair[c][0];
+            *out++ = Tables.hexPair[c][1];
+        }
+        return out;
+    }
+
+    /*src[pos] is a %, returns the position after the escape*/
+    inline size_t DecodeEscape(const unsigned char *src, size_t len, size_t pos, char *&out)
+    {
+        if (pos + 2 >= len) {
+            *out++ = '%';
+            return pos + 1;
+        }
+        int high = Tables.hexValue[src[pos + 1]];
+        int low = Tables.hexValue[src[pos + 2]];
+        if (high >= 0 && low >= 0) {
+            *out++ = static_cast<char>((high << 4) | low);
+        }
+        else {
+            //as strtol takes them, " 1", "-1" or "1g" too
+            char hex[3] = { static_cast<char>(src[pos + 1]), static_cast<char>(src[pos + 2]), 0 };
+            *out++ = static_cast<char>(strtol(hex, nullptr, 16));
+        }
+        return pos + 3;
+    }
+
+    /*the escapes of a utf-8 name come in a row, they are decoded without another load*/
+    inline size_t DecodeEscapes(const unsigned char *src, size_t len, size_t pos, char *&out)
+    {
+        do {
+            pos = DecodeEscape(src, len, pos, out);
+        } while (pos < len && src[pos] == '%');
+        return pos;
+    }
+
+    /*escapes the bytes of the run of set bits at the bottom of escaped, from src[pos] on*/
+    inline char *EscapeRun(const unsigned char *src, size_t &pos, unsigned escaped, char *out)
+    {
+        do {
+            unsigned char c = src[pos++];
+            *out++ = '%';
+            *out++ = Tables.hexPair[c][0];
+            *out++ = Tables.hexPair[c][1];
+            escaped >>= 1;
+        } while (escaped & 1);
+        return out;
+    }
+
+    size_t UrlEncodeScalar(const unsigned char *src, size_t len, char *out)
+    {
+        char *start = out;
+        for (size_t i = 0; i < len; i++) {
+            out = EncodeByte(src[i], out);
+        }
+        return static_cast<size_t>(out - start);
+    }
+
+    size_t UrlDecodeScalar(const unsigned char *src, size_t len, char *out)
+    {
+        char *start = out;
+        for (size_t i = 0; i < len;) {
+            if (src[i] != '%') {
+                *out++ = static_cast<char>(src[i++]);
+            }
+            else {
+                i = DecodeEscape(src, len, i, out);
+            }
+        }
+        return static_cast<size_t>(out - start);
+    }
+
+#ifdef CODEC_SSE2
+    inline unsigned CountTrailingZeros(unsigned mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    /*no popcnt in the sse2 baseline*/
+    inline unsigned PopCount(uint32_t mask)
+    {
+        mask = mask - ((mask >> 1) & 0x55555555u);
+        mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+        return (((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+    }
+
+    /*the signed compares leave the bytes over 0x7f out of every range*/
+    inline __m128i InRange128(__m128i v, char lo, char hi)
+    {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+    }
+
+    inline unsigned KeptMask128(__m128i v)
+    {
+        __m128i kept = _mm_or_si128(InRange128(v, '0', '9'), InRange128(v, 'A', 'Z'));
+        kept = _mm_or_si128(kept, InRange128(v, 'a', 'z'));
+        kept = _mm_or_si128(kept, InRange128(v, '-', '.'));
+        kept = _mm_or_si128(kept, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+        kept = _mm_or_si128(kept, _mm_cmpeq_epi8(v, _mm_set1_epi8('~')));
+        return static_cast<unsigned>(_mm_movemask_epi8(kept));
+    }
+
+    size_t UrlEncodeSse2(const unsigned char *src, size_t len, char *out)
+    {
+        char *start = out;
+        size_t i = 0;
+        while (i + 16 <= len) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            unsigned escaped = ~KeptMask128(v) & 0xFFFF;
+            //the whole block goes out, only the run before the first escaped byte counts
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out), v);
+            if (escaped == 0) {
+                out += 16;
+                i += 16;
+                continue;
+            }
+            if (PopCount(escaped) > 4) {
+                //mostly escaped, as utf-8 names are, the rest goes byte by byte instead of reloading per run
+                break;
+            }
+            unsigned run = CountTrailingZeros(escaped);
+            out += run;
+            i += run;
+            out = EscapeRun(src, i, escaped >> run, out);
+        }
+        out += UrlEncodeScalar(src + i, len - i, out);
+        return static_cast<size_t>(out - start);
+    }
+
+    size_t UrlDecodeSse2(const unsigned char *src, size_t len, char *out)
+    {
+        char *start = out;
+        const __m128i percent = _mm_set1_epi8('%');
+        size_t i = 0;
+        while (i + 16 <= len) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, percent)));
+            //the whole block goes out, only the part before the first % counts
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out), v);
+            if (mask == 0) {
+                out += 16;
+                i += 16;
+                continue;
+            }
+            unsigned run = CountTrailingZeros(mask);
+            out += run;
+            i = DecodeEscapes(src, len, i + run, out);
+        }
+        out += UrlDecodeScalar(src + i, len - i, out);
+        return static_cast<size_t>(out - start);
+    }
+#endif
+
+#ifdef CODEC_AVX2
+    CODEC_AVX2_TARGET
+    inline __m256i InRange256(__m256i v, char lo, char hi)
+    {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+    }
+
+    CODEC_AVX2_TARGET
+    inline unsigned KeptMask256(__m256i v)
+    {
+        __m256i kept = _mm256_or_si256(InRange256(v, '0', '9'), InRange256(v, 'A', 'Z'));
+        kept = _mm256_or_si256(kept, InRange256(v, 'a', 'z'));
+        kept = _mm256_or_si256(kept, InRange256(v, '-', '.'));
+        kept = _mm256_or_si256(kept, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+        kept = _mm256_or_si256(kept, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('~')));
+        return static_cast<unsigned>(_mm256_movemask_epi8(kept));
+    }
+
+    CODEC_AVX2_TARGET
+    size_t UrlEncodeAvx2(const unsigned char *src, size_t len, char *out)
+    {
+        char *start = out;
+        size_t i = 0;
+        while (i + 32 <= len) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+            unsigned escaped = ~KeptMask256(v);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), v);
+            if (escaped == 0) {
+                out += 32;
+                i += 32;
+                continue;
+            }
+            if (PopCount(escaped) > 8) {
+                out += UrlEncodeScalar(src + i, len - i, out);
+                return static_cast<size_t>(out - start);
+            }
+            unsigned run = CountTrailingZeros(escaped);
+            out += run;
+            i += run;
+            out = EscapeRun(src, i, escaped >> run, out);
+        }
+        out += UrlEncodeSse2(src + i, len - i, out);
+        return static_cast<size_t>(out - start);
+    }
+
+    CODEC_AVX2_TARGET
+    size_t UrlDecodeAvx2(const unsigned char *src, size_t len, char *out)
+    {
+        char *start = out;
+        const __m256i percent = _mm256_set1_epi8('%');
+        size_t i = 0;
+        while (i + 32 <= len) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, percent)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), v);
+            if (mask == 0) {
+                out += 32;
+                i += 32;
+                continue;
+            }
+            unsigned run = CountTrailingZeros(mask);
+            out += run;
+            i = DecodeEscapes(src, len, i + run, out);
+        }
+        out += UrlDecodeSse2(src + i, len - i, out);
+        return static_cast<size_t>(out - start);
+    }
+#endif
+
+    bool KernelSupported(Codec::Kernel kernel)
+    {
+        switch (kernel) {
+        case Codec::Scalar:
+            return true;
+#ifdef CODEC_SSE2
+        case Codec::Sse2:
+            return true;
+#endif
+#ifdef CODEC_AVX2
+        case Codec::Avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    struct CodecKernel
+    {
+        CodecKernel()
+        {
+            if (!set(Codec::Avx2) && !set(Codec::Sse2)) {
+                set(Codec::Scalar);
+            }
+        }
+        bool set(Codec::Kernel k)
+        {
+            if (!KernelSupported(k)) {
+                return false;
+            }
+            switch (k) {
+#ifdef CODEC_AVX2
+            case Codec::Avx2:
+                encode = UrlEncodeAvx2;
+                decode = UrlDecodeAvx2;
+                break;
+#endif
+#ifdef CODEC_SSE2
+            case Codec::Sse2:
+                encode = UrlEncodeSse2;
+                decode = UrlDecodeSse2;
+                break;
+#endif
+            default:
+                encode = UrlEncodeScalar;
+                decode = UrlDecodeScalar;
+                break;
+            }
+            kernel = k;
+            return true;
+        }
+        Codec::Kernel kernel;
+        UrlKernel encode;
+        UrlKernel decode;
+    };
+
+    CodecKernel Kernels;
+}
+
+Codec::Kernel Codec::ActiveKernel()
+{
+    return Kernels.kernel;
+}
+
+bool Codec::setKernel(Kernel kernel)
+{
+    return Kernels.set(kernel);
+}
+
+void Codec::UrlEncode(const char *src, size_t len, std::string &dest)
+{
+    //the vector kernels store whole blocks, so there is room for one past the worst case
+    size_t pos = dest.size();
+    dest.resize(pos + len * 3 + 32);
+    size_t n = Kernels.encode(reinterpret_cast<const unsigned char *>(src), len, &dest[pos]);
+    dest.resize(pos + n);
+}
+
+void Codec::UrlDecode(const char *src, size_t len, std::string &dest)
+{
+    size_t pos = dest.size();
+    dest.resize(pos + len + 32);
+    size_t n = Kernels.decode(reinterpret_cast<const unsigned char *>(src), len, &dest[pos]);
+    dest.resize(pos + n);
+}
+
+void Codec::Base64Encode(const char *src, size_t len, std::string &dest)
+{
+    size_t pos = dest.size();
+    dest.resize(pos + (len + 2) / 3 * 4);
+    auto in = reinterpret_cast<const unsigned char *>(src);
+    char *out = &dest[0] + pos;
+    for (; len >= 3; len -= 3, in += 3, out += 4) {
+        uint32_t n = (static_cast<uint32_t>(in[0]) << 16) | (static_cast<uint32_t>(in[1]) << 8) | in[2];
+        memcpy(out, Tables.base64Pair[n >> 12], 2);
+        memcpy(out + 2, Tables.base64Pair[n & 0xFFF], 2);
+    }
+    if (len == 1) {
+        out[0] = Tables.base64[in[0] >> 2];
+        out[1] = Tables.base64[(in[0] & 0x3) << 4];
+        out[2] = '=';
+        out[3] = '=';
+    }
+    else if (len == 2) {
+        out[0] = Tables.base64[in[0] >> 2];
+        out[1] = Tables.base64[((in[0] & 0x3) << 4) | (in[1] >> 4)];
+        out[2] = Tables.base64[(in[1] & 0xF) << 2];
+        out[3] = '=';
+    }
+}
+
+void Codec::HexEncode(const unsigned char *src, size_t len, std::string &dest)
+{
+    size_t pos = dest.size();
+    dest.resize(pos + len * 2);
+    char *out = &dest[0] + pos;
+    for (size_t i = 0; i < len; i++, out += 2) {
+        memcpy(out, Tables.hexPair[src[i]], 2);
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /**
+    * Url, base64 and hex coding that appends to the caller's string, sized once for the
+    * worst case instead of a stream per byte. The url coding scans 16 or 32 bytes at a
+    * time with sse2 or avx2 for the runs that pass through unchanged; the base64 and hex
+    * coding of the digests is table driven.
+    */
+    class Codec
+    {
+    public:
+        enum Kernel
+        {
+            Scalar,
+            Sse2,
+            Avx2,
+        };
+        /*the best the cpu has, picked at startup*/
+        static Kernel ActiveKernel();
+        /*for tests and benchmarks, false and no change if the cpu does not have it*/
+        static bool setKernel(Kernel kernel);
+
+        /*alnum and -_.~ are kept, the other bytes become %XX*/
+        static void UrlEncode(const char *src, size_t len, std::string &dest);
+        /*a % without two more characters after it is kept as it is*/
+        static void UrlDecode(const char *src, size_t len, std::string &dest);
+        static void Base64Encode(const char *src, size_t len, std::string &dest);
+        /*upper case*/
+        static void HexEncode(const unsigned char *src, size_t len, std::string &dest);
+    };
+}
+}
@@ -35,9 +35,27 @@
    1.3  15 Dec 2013  Add eight-byte processing for big endian as well
                      Make use of the pthread library optional
    1.4  16 Dec 2013  Make once variable volatile for limited thread protection
+
+   Altered for the OSS sdk: carry-less multiply kernel on x86-64, combine
+   with x^2^n tables and a cache of recent combine operators
  */
 
 #include "Crc64.h"
+#include <alibabacloud/oss/utils/FileRegionStream.h>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CRC64_CLMUL 1
+#define CRC64_CLMUL_TARGET __attribute__((target("pclmul,sse2")))
+#elif defined(_M_X64) && defined(_MSC_VER)
+#include <intrin.h>
+#define CRC64_CLMUL 1
+#define CRC64_CLMUL_TARGET
+#endif
 namespace AlibabaCloud
 {
 namespace OSS
@@ -169,6 +187,102 @@ static uint64_t crc64_big(uint64_t crc, void *buf, size_t len)
     return ~rev8(crc);
 }
 
+#ifdef CRC64_CLMUL
+/* Carry-less multiply folding (Intel, "Fast CRC Computation for Generic
+   Polynomials Using PCLMULQDQ Instruction"), in the bit-reflected domain.
+   A 16 byte block A = H*x^64 + L followed by D bits of data is replaced by
+   H*(x^(64+D) mod P) + L*(x^D mod P), which leaves the CRC unchanged.  The
+   reflected product of two 64-bit values carries an extra factor x, so the
+   constants are x^(64+D-1) and x^(D-1) mod P.  The last block is reduced with
+   the tables. */
+
+/* fold constants, low half for H and high half for L: 4 blocks, 1 block */
+static uint64_t crc64_clmul_k512[2];
+static uint64_t crc64_clmul_k128[2];
+
+/* x^n mod P, bit-reflected */
+static uint64_t crc64_xpow(unsigned n)
+{
+    uint64_t r = UINT64_C(1) << 63;
+    while (n--)
+        r = r & 1 ? POLY ^ (r >> 1) : r >> 1;
+    return r;
+}
+
+static void crc64_clmul_init(void)
+{
+    crc64_clmul_k512[0] = crc64_xpow(64 + 512 - 1);
+    crc64_clmul_k512[1] = crc64_xpow(512 - 1);
+    crc64_clmul_k128[0] = crc64_xpow(64 + 128 - 1);
+    crc64_clmul_k128[1] = crc64_xpow(128 - 1);
+}
+
+static bool crc64_clmul_supported(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 1)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") != 0;
+#endif
+}
+
+CRC64_CLMUL_TARGET
+static inline __m128i crc64_fold(__m128i x, __m128i k)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11));
+}
+
+CRC64_CLMUL_TARGET
+static uint64_t crc64_clmul(uint64_t crc, void *buf, size_t len)
+{
+    const unsigned char *next = (const unsigned char *)buf;
+    unsigned char last[16];
+
+    if (len < 64)
+        return crc64_little(crc, buf, len);
+
+    const __m128i k512 = _mm_set_epi64x((long long)crc64_clmul_k512[1], (long long)crc64_clmul_k512[0]);
+    const __m128i k128 = _mm_set_epi64x((long long)crc64_clmul_k128[1], (long long)crc64_clmul_k128[0]);
+
+    /* the pre-conditioned crc is xor-ed into the first eight bytes */
+    __m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)next), _mm_set_epi64x(0, (long long)~crc));
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(next + 16));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(next + 32));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(next + 48));
+    next += 64;
+    len -= 64;
+
+    while (len >= 64) {
+        x0 = _mm_xor_si128(crc64_fold(x0, k512), _mm_loadu_si128((const __m128i *)next));
+        x1 = _mm_xor_si128(crc64_fold(x1, k512), _mm_loadu_si128((const __m128i *)(next + 16)));
+        x2 = _mm_xor_si128(crc64_fold(x2, k512), _mm_loadu_si128((const __m128i *)(next + 32)));
+        x3 = _mm_xor_si128(crc64_fold(x3, k512), _mm_loadu_si128((const __m128i *)(next + 48)));
+        next += 64;
+        len -= 64;
+    }
+
+    x0 = _mm_xor_si128(crc64_fold(x0, k128), x1);
+    x0 = _mm_xor_si128(crc64_fold(x0, k128), x2);
+    x0 = _mm_xor_si128(crc64_fold(x0, k128), x3);
+    while (len >= 16) {
+        x0 = _mm_xor_si128(crc64_fold(x0, k128), _mm_loadu_si128((const __m128i *)next));
+        next += 16;
+        len -= 16;
+    }
+
+    /* x0 has the crc of the data so far, with a zero initial crc */
+    _mm_storeu_si128((__m128i *)last, x0);
+    crc = crc64_little(~UINT64_C(0), last, sizeof(last));
+    return crc64_little(crc, (void *)next, len);
+}
+#endif
+
+typedef uint64_t (*crc64_func)(uint64_t crc, void *buf, size_t len);
+static crc64_func crc64_calc = crc64_little;
+
 /* Return the CRC-64 of buf[0..len-1] with initial crc, processing eight bytes
    at a time.  This selects one of two routines depending on the endianess of
    the architecture.  A good optimizing compiler will determine the endianess
@@ -177,28 +291,78 @@ static uint64_t crc64_big(uint64_t crc, void *buf, size_t len)
    well, initializing and using two tables, if called upon to do so. */
 
 
-#define GF2_DIM 64      /* dimension of GF(2) vectors (length of CRC) */
+/* Combining is multiplying crc1 by x^(8*len2) modulo P, as zlib 1.2.12 does
+   for CRC-32: x^(2^k) mod P is tabulated, so the operator for any length
+   is a product over the set bits of the length, instead of squaring 64x64
+   GF(2) matrices on every call.  The operators of recent lengths are kept,
+   the part sizes of a transfer repeat. */
 
-static uint64_t gf2_matrix_times(uint64_t *mat, uint64_t vec)
+/* x^(2^k) mod P for k = 0..66, enough for any 64-bit byte count */
+#define X2N_DIM 67
+static uint64_t crc64_x2n_table[X2N_DIM];
+
+/* Return a(x) * b(x) modulo P, bit-reflected. */
+static uint64_t crc64_multmodp(uint64_t a, uint64_t b)
 {
-    uint64_t sum;
-
-    sum = 0;
-    while (vec) {
-        if (vec & 1)
-            sum ^= *mat;
-        vec >>= 1;
-        mat++;
+    uint64_t m, p;
+
+    m = UINT64_C(1) << 63;
+    p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = b & 1 ? POLY ^ (b >> 1) : b >> 1;
     }
-    return sum;
+    return p;
 }
 
-static void gf2_matrix_square(uint64_t *square, uint64_t *mat)
+static void crc64_x2n_init(void)
 {
     unsigned n;
+    uint64_t p;
 
-    for (n = 0; n < GF2_DIM; n++)
-        square[n] = gf2_matrix_times(mat, mat[n]);
+    p = UINT64_C(1) << 62;      /* x^1 */
+    crc64_x2n_table[0] = p;
+    for (n = 1; n < X2N_DIM; n++)
+        crc64_x2n_table[n] = p = crc64_multmodp(p, p);
+}
+
+/* Return x^(8 * len) modulo P, the operator for len zero bytes. */
+static uint64_t crc64_zeros_op(uintmax_t len)
+{
+    unsigned k;
+    uint64_t p;
+
+    p = UINT64_C(1) << 63;      /* x^0 == 1 */
+    for (k = 3; len; k++, len >>= 1) {
+        if (len & 1)
+            p = crc64_multmodp(crc64_x2n_table[k], p);
+    }
+    return p;
+}
+
+#define COMBINE_CACHE_SIZE 64
+static std::mutex crc64_combine_lock;
+static std::unordered_map<uintmax_t, uint64_t> crc64_combine_cache;
+
+static uint64_t crc64_combine_op(uintmax_t len2)
+{
+    {
+        std::lock_guard<std::mutex> lck(crc64_combine_lock);
+        auto it = crc64_combine_cache.find(len2);
+        if (it != crc64_combine_cache.end())
+            return it->second;
+    }
+    uint64_t op = crc64_zeros_op(len2);
+    std::lock_guard<std::mutex> lck(crc64_combine_lock);
+    if (crc64_combine_cache.size() >= COMBINE_CACHE_SIZE)
+        crc64_combine_cache.clear();
+    crc64_combine_cache[len2] = op;
+    return op;
 }
 
 /* Return the CRC-64 of two sequential blocks, where crc1 is the CRC-64 of the
@@ -206,54 +370,11 @@ static void gf2_matrix_square(uint64_t *square, uint64_t *mat)
    of the second block. */
 static uint64_t crc64_combine(uint64_t crc1, uint64_t crc2, uintmax_t len2)
 {
-    unsigned n;
-    uint64_t row;
-    uint64_t even[GF2_DIM];     /* even-power-of-two zeros operator */
-    uint64_t odd[GF2_DIM];      /* odd-power-of-two zeros operator */
-
     /* degenerate case */
     if (len2 == 0)
         return crc1;
 
-    /* put operator for one zero bit in odd */
-    odd[0] = POLY;              /* CRC-64 polynomial */
-    row = 1;
-    for (n = 1; n < GF2_DIM; n++) {
-        odd[n] = row;
-        row <<= 1;
-    }
-
-    /* put operator for two zero bits in even */
-    gf2_matrix_square(even, odd);
-
-    /* put operator for four zero bits in odd */
-    gf2_matrix_square(odd, even);
-
-    /* apply len2 zeros to crc1 (first square will put the operator for one
-       zero byte, eight zero bits, in even) */
-    do {
-        /* apply zeros operator for this bit of len2 */
-        gf2_matrix_square(even, odd);
-        if (len2 & 1)
-            crc1 = gf2_matrix_times(even, crc1);
-        len2 >>= 1;
-
-        /* if no more bits set, then done */
-        if (len2 == 0)
-            break;
-
-        /* another iteration of the loop with odd and even swapped */
-        gf2_matrix_square(odd, even);
-        if (len2 & 1)
-            crc1 = gf2_matrix_times(odd, crc1);
-        len2 >>= 1;
-
-        /* if no more bits set, then done */
-    } while (len2 != 0);
-
-    /* return combined crc */
-    crc1 ^= crc2;
-    return crc1;
+    return crc64_multmodp(crc64_combine_op(len2), crc1) ^ crc2;
 }
 
 class CRC64_GUARD
@@ -261,12 +382,20 @@ class CRC64_GUARD
 public:
     CRC64_GUARD()
     {
+        crc64_x2n_init();
         uint64_t n = 1;
         if (*(char *)&n) {
             crc64_little_init();
+#ifdef CRC64_CLMUL
+            if (crc64_clmul_supported()) {
+                crc64_clmul_init();
+                crc64_calc = crc64_clmul;
+            }
+#endif
         }
         else {
             crc64_big_init();
+            crc64_calc = crc64_big;
         }
     }
     ~CRC64_GUARD() = default;
@@ -275,16 +404,91 @@ public:
 static CRC64_GUARD crc64Guard;
 
 uint64_t CRC64::CalcCRC(uint64_t crc, void *buf, size_t len)
+{
+    return crc64_calc(crc, buf, len);
+}
+
+uint64_t CRC64::CalcCRCTable(uint64_t crc, void *buf, size_t len)
 {
     uint64_t n = 1;
     return *(char *)&n ? crc64_little(crc, buf, len) : crc64_big(crc, buf, len);
 }
 
+bool CRC64::HardwareAccelerated()
+{
+#ifdef CRC64_CLMUL
+    return crc64_calc == crc64_clmul;
+#else
+    return false;
+#endif
+}
+
 uint64_t CRC64::CombineCRC(uint64_t crc1, uint64_t crc2, uintmax_t len2)
 {
     return crc64_combine(crc1, crc2, len2);
 }
 
+/* each thread gets at least this much of the file */
+#define FILE_CRC_MIN_CHUNK (UINT64_C(8) << 20)
+#define FILE_CRC_READ_SIZE (1 << 20)
+
+bool CRC64::CalcFileCRC(const std::string &path, uint32_t threadNum, uint64_t &crc)
+{
+    uint64_t length;
+    {
+        FileRegionStream file(path);
+        if (!file.isOpen())
+            return false;
+        length = static_cast<uint64_t>(file.length());
+    }
+
+    if (threadNum == 0)
+        threadNum = (std::max)(1U, std::thread::hardware_concurrency());
+    uint64_t chunkNum = (std::min)(static_cast<uint64_t>(threadNum),
+        (length + FILE_CRC_MIN_CHUNK - 1) / FILE_CRC_MIN_CHUNK);
+    chunkNum = (std::max)(chunkNum, UINT64_C(1));
+    uint64_t chunkSize = (length + chunkNum - 1) / chunkNum;
+
+    /* the chunks are summed concurrently, then combined in order */
+    std::vector<uint64_t> crcs(static_cast<size_t>(chunkNum), 0);
+    std::vector<char> done(static_cast<size_t>(chunkNum), 0);
+    auto calcChunk = [&](size_t index) {
+        uint64_t offset = chunkSize * index;
+        uint64_t size = (std::min)(chunkSize, length - offset);
+        FileRegionStream stream(path, static_cast<int64_t>(offset), static_cast<int64_t>(size));
+        std::vector<char> buffer(static_cast<size_t>((std::min)(size, static_cast<uint64_t>(FILE_CRC_READ_SIZE))));
+        uint64_t value = 0;
+        uint64_t got = 0;
+        while (got < size) {
+            stream.read(buffer.data(), buffer.size());
+            size_t n = static_cast<size_t>(stream.gcount());
+            if (n == 0)
+                break;
+            value = CalcCRC(value, buffer.data(), n);
+            got += n;
+        }
+        crcs[index] = value;
+        done[index] = (got == size);
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < crcs.size(); i++)
+        threads.emplace_back(calcChunk, i);
+    calcChunk(0);
+    for (auto &thread : threads)
+        thread.join();
+
+    uint64_t value = crcs[0];
+    for (size_t i = 0; i < crcs.size(); i++) {
+        if (!done[i])
+            return false;
+        if (i > 0)
+            value = CombineCRC(value, crcs[i], (std::min)(chunkSize, length - chunkSize * i));
+    }
+    crc = value;
+    return true;
+}
+
 
 }
 }
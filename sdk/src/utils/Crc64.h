@@ -17,6 +17,7 @@
 #pragma once
 #include <stdint.h>
 #include <cstddef>
+#include <string>
 namespace AlibabaCloud
 {
 namespace OSS
@@ -25,7 +26,12 @@ namespace OSS
     {
     public:
         static uint64_t CalcCRC(uint64_t crc, void *buf, size_t len);
+        /*the portable table driven version, CalcCRC uses carry-less multiply when the cpu has it*/
+        static uint64_t CalcCRCTable(uint64_t crc, void *buf, size_t len);
+        static bool HardwareAccelerated();
         static uint64_t CombineCRC(uint64_t crc1, uint64_t crc2, uintmax_t len2);
+        /*splits the file over threadNum threads (0 for one per core), false if it can not be read*/
+        static bool CalcFileCRC(const std::string &path, uint32_t threadNum, uint64_t &crc);
     };
 }
 }
@@ -16,75 +16,222 @@
 
 #include "Executor.h"
 #include <alibabacloud/oss/utils/Runnable.h>
-#include <assert.h>
 #include "../utils/LogUtils.h"
 
 using namespace AlibabaCloud::OSS;
 
 static const char *TAG = "Executor";
 
-Executor::Executor():
-    state_(State::Free)
+//the pool and worker index the current thread belongs to
+static thread_local const Executor *tlsExecutor = nullptr;
+static thread_local int tlsWorkerIndex = -1;
+
+Executor::Executor(int threadNum, int maxQueueDepth) :
+    threadNum_(threadNum),
+    maxQueueDepth_(maxQueueDepth > 0 ? maxQueueDepth : 0),
+    reserved_(0),
+    idleWorkers_(0),
+    spaceWaiters_(0),
+    nextWorker_(0),
+    started_(false),
+    shutdown_(false)
 {
+    if (threadNum_ <= 0) {
+        threadNum_ = static_cast<int>(std::thread::hardware_concurrency());
+        threadNum_ = threadNum_ > 0 ? threadNum_ : 1;
+    }
 }
 
 Executor::~Executor()
 {
-    auto expected = State::Free;
-    while (!state_.compare_exchange_strong(expected, State::Shutdown))
-    {
-        assert(expected == State::Locked);
-        expected = State::Free;
+    shutdown();
+}
+
+void Executor::start()
+{
+    //called with lock_ held, so shutdown() sees either all the workers or none.
+    //the deques all exist before the first worker looks at them
+    for (int i = 0; i < threadNum_; i++) {
+        workers_.emplace_back(new Worker());
     }
+    for (int i = 0; i < threadNum_; i++) {
+        workers_[i]->thread = std::thread(&Executor::workerMain, this, i);
+    }
+    started_ = true;
+    OSS_LOG(LogLevel::LogDebug, TAG, "executor(%p) start %d workers, max queue depth:%d", this, threadNum_, maxQueueDepth_);
+}
 
-    auto it = threads_.begin();
-    while (!threads_.empty())
-    {
-        it->second.join();
-        it = threads_.erase(it);
+int Executor::currentWorkerIndex() const
+{
+    return tlsExecutor == this ? tlsWorkerIndex : -1;
+}
+
+bool Executor::inWorker() const
+{
+    return currentWorkerIndex() >= 0;
+}
+
+void Executor::reserve(bool bounded)
+{
+    if (bounded) {
+        int reserved = reserved_.load();
+        while (reserved < maxQueueDepth_) {
+            if (reserved_.compare_exchange_weak(reserved, reserved + 1)) {
+                return;
+            }
+        }
+        //the queue is full, park until a worker takes a task or the pool shuts down
+        std::unique_lock<std::mutex> lck(lock_);
+        spaceWaiters_++;
+        spaceCv_.wait(lck, [this, &reserved] {
+            reserved = reserved_.load();
+            while (reserved < maxQueueDepth_) {
+                if (reserved_.compare_exchange_weak(reserved, reserved + 1)) {
+                    return true;
+                }
+            }
+            return shutdown_.load();
+        });
+        spaceWaiters_--;
+        if (reserved < maxQueueDepth_) {
+            return;
+        }
+    }
+    reserved_++;
+}
+
+void Executor::release()
+{
+    int reserved = --reserved_;
+    if (spaceWaiters_ > 0) {
+        std::lock_guard<std::mutex> lck(lock_);
+        spaceCv_.notify_one();
+    }
+    if (reserved == 0 && shutdown_) {
+        //the last queued task is taken, the parked workers can leave
+        std::lock_guard<std::mutex> lck(lock_);
+        taskCv_.notify_all();
     }
 }
 
 void Executor::execute(Runnable* task)
 {
-    auto main = [task, this] {
-        OSS_LOG(LogLevel::LogDebug, TAG, "task(%p) enter execute main thread", task);
+    int index = currentWorkerIndex();
+    reserve(!shutdown_ && index < 0 && maxQueueDepth_ > 0);
+
+    if (!started_ && !shutdown_) {
+        std::lock_guard<std::mutex> lck(lock_);
+        if (!started_ && !shutdown_) {
+            start();
+        }
+    }
+
+    if (shutdown_) {
+        release();
+        OSS_LOG(LogLevel::LogWarn, TAG, "executor(%p) is shutdown, run task(%p) in caller thread", this, task);
         task->run();
         delete task;
-        detach(std::this_thread::get_id());
-        OSS_LOG(LogLevel::LogDebug, TAG, "task(%p) leave execute main thread", task);
-    };
+        return;
+    }
 
-    State expected;
-    do
+    if (index < 0) {
+        index = static_cast<int>(nextWorker_++ % static_cast<unsigned int>(threadNum_));
+    }
     {
-        expected = State::Free;
-        if (state_.compare_exchange_strong(expected, State::Locked))
-        {
-            std::thread t(main);
-            const auto id = t.get_id(); 
-            threads_.emplace(id, std::move(t));
-            state_ = State::Free;
-            return;
+        std::lock_guard<std::mutex> lck(workers_[index]->lock);
+        workers_[index]->tasks.push_back(task);
+    }
+
+    //a worker going idle counts itself before its last look at the deques,
+    //so either it finds the task or it is seen here and woken up
+    if (idleWorkers_ > 0) {
+        std::lock_guard<std::mutex> lck(lock_);
+        taskCv_.notify_one();
+    }
+}
+
+Runnable* Executor::findTask(int index)
+{
+    //the owner takes from the front, thieves take from the back
+    {
+        Worker &self = *workers_[index];
+        std::lock_guard<std::mutex> lck(self.lock);
+        if (!self.tasks.empty()) {
+            Runnable* task = self.tasks.front();
+            self.tasks.pop_front();
+            return task;
+        }
+    }
+    for (int i = 1; i < threadNum_; i++) {
+        Worker &victim = *workers_[(index + i) % threadNum_];
+        std::lock_guard<std::mutex> lck(victim.lock);
+        if (!victim.tasks.empty()) {
+            Runnable* task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return task;
         }
-    } while (expected != State::Shutdown);
-    return;
+    }
+    return nullptr;
 }
 
-void Executor::detach(std::thread::id id)
+void Executor::workerMain(int index)
+{
+    tlsExecutor = this;
+    tlsWorkerIndex = index;
+
+    for (;;) {
+        Runnable* task = findTask(index);
+        if (task == nullptr) {
+            std::unique_lock<std::mutex> lck(lock_);
+            idleWorkers_++;
+            taskCv_.wait(lck, [this, index, &task] {
+                task = findTask(index);
+                return task != nullptr || (shutdown_ && reserved_ == 0);
+            });
+            idleWorkers_--;
+            if (task == nullptr) {
+                break;
+            }
+        }
+        release();
+
+        OSS_LOG(LogLevel::LogDebug, TAG, "task(%p) enter execute worker(%d)", task, index);
+        task->run();
+        OSS_LOG(LogLevel::LogDebug, TAG, "task(%p) leave execute worker(%d)", task, index);
+        delete task;
+        if (tlsExecutor != this) {
+            //the task shut the pool down and may have destroyed it, do not touch it
+            break;
+        }
+    }
+
+    tlsExecutor = nullptr;
+    tlsWorkerIndex = -1;
+}
+
+void Executor::shutdown()
 {
-    State expected;
-    do
     {
-        expected = State::Free;
-        if (state_.compare_exchange_strong(expected, State::Locked))
-        {
-            auto it = threads_.find(id);
-            assert(it != threads_.end());
-            it->second.detach();
-            threads_.erase(it);
-            state_ = State::Free;
+        std::lock_guard<std::mutex> lck(lock_);
+        if (shutdown_) {
             return;
         }
-    } while (expected != State::Shutdown);
-}
\ No newline at end of file
+        shutdown_ = true;
+    }
+    taskCv_.notify_all();
+    spaceCv_.notify_all();
+
+    //the queued tasks are drained by the workers before they exit.
+    //a worker shutting its own pool down, e.g. a callback destroying the client,
+    //is detached and leaves once its task returns
+    for (auto &worker : workers_) {
+        if (worker->thread.get_id() == std::this_thread::get_id()) {
+            tlsExecutor = nullptr;
+            worker->thread.detach();
+        }
+        else if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    OSS_LOG(LogLevel::LogDebug, TAG, "executor(%p) shutdown", this);
+}
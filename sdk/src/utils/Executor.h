@@ -18,31 +18,63 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <queue>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <thread>
 #include <mutex>
-#include <unordered_map>
 
 namespace AlibabaCloud
 {
 namespace OSS
 {
     class Runnable;
+
+    /**
+    * Fixed size thread pool. Every worker owns a task deque under its own
+    * lock, idle workers steal from the others. The pool lock only parks the
+    * idle workers and the blocked submitters. Submitting blocks while the number of queued
+    * tasks reaches maxQueueDepth, except when the caller is a worker of
+    * the same pool (which would otherwise deadlock).
+    */
     class Executor
     {
     public:
-        Executor();
+        Executor(int threadNum = 0, int maxQueueDepth = 0);
         ~Executor();
         void execute(Runnable* task);
+        void shutdown();
+        /*true on one of the workers of this pool*/
+        bool inWorker() const;
+        int ThreadNum() const { return threadNum_; }
+        int MaxQueueDepth() const { return maxQueueDepth_; }
     private:
-        enum class State
+        struct Worker
         {
-            Free, Locked, Shutdown
+            std::mutex lock;
+            std::deque<Runnable*> tasks;
+            std::thread thread;
         };
-        void detach(std::thread::id id);
-        std::atomic<State> state_;
-        std::unordered_map<std::thread::id, std::thread> threads_;
+        void start();
+        void workerMain(int index);
+        Runnable* findTask(int index);
+        void reserve(bool bounded);
+        void release();
+        int currentWorkerIndex() const;
+
+        int threadNum_;
+        int maxQueueDepth_;
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::mutex lock_;
+        std::condition_variable taskCv_;
+        std::condition_variable spaceCv_;
+        /*the tasks submitted and not yet taken by a worker*/
+        std::atomic<int> reserved_;
+        std::atomic<int> idleWorkers_;
+        std::atomic<int> spaceWaiters_;
+        std::atomic<unsigned int> nextWorker_;
+        std::atomic<bool> started_;
+        std::atomic<bool> shutdown_;
     };
 }
 }
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <alibabacloud/oss/utils/FileRegionStream.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class FileRegionBuf : public std::streambuf
+    {
+    public:
+        FileRegionBuf(const std::string &path, int64_t offset, int64_t length);
+        ~FileRegionBuf();
+
+        bool isOpen() const { return fd_ >= 0; }
+        int64_t length() const { return length_; }
+
+    protected:
+        int_type underflow() override;
+        std::streamsize xsgetn(char *s, std::streamsize n) override;
+        std::streamsize showmanyc() override;
+        pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which) override;
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+    private:
+        std::streamsize readAt(int64_t pos, char *s, std::streamsize n);
+        int64_t position() const { return pos_ - (egptr() - gptr()); }
+
+        int fd_;
+        int64_t offset_;
+        int64_t length_;
+        //region position of egptr()
+        int64_t pos_;
+        //only for the single character reads, bulk reads bypass it
+        char small_[4096];
+    };
+}
+}
+
+using namespace AlibabaCloud::OSS;
+
+FileRegionBuf::FileRegionBuf(const std::string &path, int64_t offset, int64_t length) :
+    fd_(-1),
+    offset_(offset < 0 ? 0 : offset),
+    length_(0),
+    pos_(0)
+{
+    int64_t fileSize = 0;
+#ifdef _WIN32
+    if (_sopen_s(&fd_, path.c_str(), _O_RDONLY | _O_BINARY, _SH_DENYNO, _S_IREAD) != 0) {
+        fd_ = -1;
+    }
+    struct _stat64 st;
+    if (fd_ >= 0 && _fstat64(fd_, &st) == 0) {
+        fileSize = st.st_size;
+    }
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd_ >= 0 && ::fstat(fd_, &st) == 0) {
+        fileSize = st.st_size;
+    }
+#endif
+    if (fd_ < 0) {
+        return;
+    }
+
+    int64_t remains = std::max<int64_t>(0, fileSize - offset_);
+    length_ = (length < 0) ? remains : std::min(length, remains);
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(fd_, offset_, length_, POSIX_FADV_SEQUENTIAL);
+#endif
+    setg(small_, small_, small_);
+}
+
+FileRegionBuf::~FileRegionBuf()
+{
+    if (fd_ >= 0) {
+#ifdef _WIN32
+        _close(fd_);
+#else
+        ::close(fd_);
+#endif
+    }
+}
+
+std::streamsize FileRegionBuf::readAt(int64_t pos, char *s, std::streamsize n)
+{
+    if (fd_ < 0 || pos >= length_) {
+        return 0;
+    }
+    n = static_cast<std::streamsize>(std::min<int64_t>(n, length_ - pos));
+
+    std::streamsize got = 0;
+    while (got < n) {
+#ifdef _WIN32
+        unsigned int chunk = static_cast<unsigned int>(std::min<std::streamsize>(n - got, 1 << 30));
+        if (_lseeki64(fd_, offset_ + pos + got, SEEK_SET) < 0) {
+            break;
+        }
+        int r = _read(fd_, s + got, chunk);
+#else
+        ssize_t r = ::pread(fd_, s + got, static_cast<size_t>(n - got), static_cast<off_t>(offset_ + pos + got));
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (r <= 0) {
+            break;
+        }
+        got += r;
+    }
+    return got;
+}
+
+FileRegionBuf::int_type FileRegionBuf::underflow()
+{
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    std::streamsize n = readAt(pos_, small_, sizeof(small_));
+    if (n <= 0) {
+        return traits_type::eof();
+    }
+    setg(small_, small_, small_ + n);
+    pos_ += n;
+    return traits_type::to_int_type(*gptr());
+}
+
+std::streamsize FileRegionBuf::xsgetn(char *s, std::streamsize n)
+{
+    std::streamsize copied = 0;
+    std::streamsize buffered = egptr() - gptr();
+    if (buffered > 0) {
+        copied = std::min(buffered, n);
+        std::memcpy(s, gptr(), static_cast<size_t>(copied));
+        gbump(static_cast<int>(copied));
+    }
+    if (copied < n) {
+        std::streamsize got = readAt(pos_, s + copied, n - copied);
+        pos_ += got;
+        copied += got;
+    }
+    return copied;
+}
+
+std::streamsize FileRegionBuf::showmanyc()
+{
+    int64_t remains = length_ - position();
+    return remains > 0 ? static_cast<std::streamsize>(remains) : -1;
+}
+
+FileRegionBuf::pos_type FileRegionBuf::seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which)
+{
+    if (fd_ < 0 || !(which & std::ios_base::in)) {
+        return pos_type(off_type(-1));
+    }
+
+    int64_t base = 0;
+    if (way == std::ios_base::cur) {
+        base = position();
+    }
+    else if (way == std::ios_base::end) {
+        base = length_;
+    }
+    int64_t target = base + off;
+    if (target < 0 || target > length_) {
+        return pos_type(off_type(-1));
+    }
+
+    setg(small_, small_, small_);
+    pos_ = target;
+    return pos_type(off_type(target));
+}
+
+FileRegionBuf::pos_type FileRegionBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+FileRegionStream::FileRegionStream(const std::string &path, int64_t offset, int64_t length) :
+    std::iostream(nullptr),
+    buf_(new FileRegionBuf(path, offset, length))
+{
+    rdbuf(buf_);
+    if (!buf_->isOpen()) {
+        setstate(std::ios_base::failbit);
+    }
+}
+
+FileRegionStream::~FileRegionStream()
+{
+    delete buf_;
+}
+
+bool FileRegionStream::isOpen() const
+{
+    return buf_->isOpen();
+}
+
+int64_t FileRegionStream::length() const
+{
+    return buf_->length();
+}
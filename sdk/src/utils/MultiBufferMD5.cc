@@ -0,0 +1,245 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MultiBufferMD5.h"
+#include <openssl/md5.h>
+#include <cstdint>
+#include <cstring>
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MD5_MULTI_BUFFER 1
+#endif
+
+using namespace AlibabaCloud::OSS;
+
+#ifdef MD5_MULTI_BUFFER
+
+namespace
+{
+    const int Lanes = 4;
+    const uint32_t InitState[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+    /*one message in a lane, the padded end lives in tail*/
+    struct LaneJob
+    {
+        MD5Buffer *buffer;
+        const unsigned char *next;
+        size_t fullBlocks;
+        unsigned char tail[128];
+        size_t tailBlocks;
+        size_t tailIndex;
+    };
+
+    void StartJob(LaneJob &job, MD5Buffer *buffer)
+    {
+        job.buffer = buffer;
+        job.next = reinterpret_cast<const unsigned char *>(buffer->data);
+        job.fullBlocks = buffer->size / 64;
+        size_t rem = buffer->size % 64;
+        std::memset(job.tail, 0, sizeof(job.tail));
+        if (rem > 0) {
+            std::memcpy(job.tail, job.next + job.fullBlocks * 64, rem);
+        }
+        job.tail[rem] = 0x80;
+        job.tailBlocks = (rem < 56) ? 1 : 2;
+        uint64_t bits = static_cast<uint64_t>(buffer->size) * 8;
+        for (int i = 0; i < 8; i++) {
+            job.tail[job.tailBlocks * 64 - 8 + i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+        job.tailIndex = 0;
+    }
+
+    inline uint32_t Load32(const unsigned char *p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+            (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+}
+
+#define MD5_F(x, y, z) _mm_xor_si128(z, _mm_and_si128(x, _mm_xor_si128(y, z)))
+#define MD5_G(x, y, z) _mm_xor_si128(y, _mm_and_si128(z, _mm_xor_si128(x, y)))
+#define MD5_H(x, y, z) _mm_xor_si128(_mm_xor_si128(x, y), z)
+#define MD5_I(x, y, z) _mm_xor_si128(y, _mm_or_si128(x, _mm_xor_si128(z, ones)))
+#define MD5_ROTL(x, s) _mm_or_si128(_mm_slli_epi32(x, s), _mm_srli_epi32(x, 32 - s))
+#define MD5_STEP(f, a, b, c, d, w, k, s) \
+    a = _mm_add_epi32(a, _mm_add_epi32(f(b, c, d), _mm_add_epi32(w, _mm_set1_epi32(static_cast<int>(k))))); \
+    a = _mm_add_epi32(MD5_ROTL(a, s), b)
+
+/*one 64 byte block of each lane*/
+static void Compress4(uint32_t state[4][Lanes], const unsigned char *blocks[Lanes])
+{
+    const __m128i ones = _mm_set1_epi32(-1);
+    __m128i w[16];
+    for (int i = 0; i < 16; i++) {
+        w[i] = _mm_set_epi32(static_cast<int>(Load32(blocks[3] + i * 4)), static_cast<int>(Load32(blocks[2] + i * 4)),
+            static_cast<int>(Load32(blocks[1] + i * 4)), static_cast<int>(Load32(blocks[0] + i * 4)));
+    }
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(state[0]));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(state[1]));
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(state[2]));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(state[3]));
+    __m128i aa = a, bb = b, cc = c, dd = d;
+
+    MD5_STEP(MD5_F, a, b, c, d, w[0], 0xd76aa478, 7);
+    MD5_STEP(MD5_F, d, a, b, c, w[1], 0xe8c7b756, 12);
+    MD5_STEP(MD5_F, c, d, a, b, w[2], 0x242070db, 17);
+    MD5_STEP(MD5_F, b, c, d, a, w[3], 0xc1bdceee, 22);
+    MD5_STEP(MD5_F, a, b, c, d, w[4], 0xf57c0faf, 7);
+    MD5_STEP(MD5_F, d, a, b, c, w[5], 0x4787c62a, 12);
+    MD5_STEP(MD5_F, c, d, a, b, w[6], 0xa8304613, 17);
+    MD5_STEP(MD5_F, b, c, d, a, w[7], 0xfd469501, 22);
+    MD5_STEP(MD5_F, a, b, c, d, w[8], 0x698098d8, 7);
+    MD5_STEP(MD5_F, d, a, b, c, w[9], 0x8b44f7af, 12);
+    MD5_STEP(MD5_F, c, d, a, b, w[10], 0xffff5bb1, 17);
+    MD5_STEP(MD5_F, b, c, d, a, w[11], 0x895cd7be, 22);
+    MD5_STEP(MD5_F, a, b, c, d, w[12], 0x6b901122, 7);
+    MD5_STEP(MD5_F, d, a, b, c, w[13], 0xfd987193, 12);
+    MD5_STEP(MD5_F, c, d, a, b, w[14], 0xa679438e, 17);
+    MD5_STEP(MD5_F, b, c, d, a, w[15], 0x49b40821, 22);
+
+    MD5_STEP(MD5_G, a, b, c, d, w[1], 0xf61e2562, 5);
+    MD5_STEP(MD5_G, d, a, b, c, w[6], 0xc040b340, 9);
+    MD5_STEP(MD5_G, c, d, a, b, w[11], 0x265e5a51, 14);
+    MD5_STEP(MD5_G, b, c, d, a, w[0], 0xe9b6c7aa, 20);
+    MD5_STEP(MD5_G, a, b, c, d, w[5], 0xd62f105d, 5);
+    MD5_STEP(MD5_G, d, a, b, c, w[10], 0x02441453, 9);
+    MD5_STEP(MD5_G, c, d, a, b, w[15], 0xd8a1e681, 14);
+    MD5_STEP(MD5_G, b, c, d, a, w[4], 0xe7d3fbc8, 20);
+    MD5_STEP(MD5_G, a, b, c, d, w[9], 0x21e1cde6, 5);
+    MD5_STEP(MD5_G, d, a, b, c, w[14], 0xc33707d6, 9);
+    MD5_STEP(MD5_G, c, d, a, b, w[3], 0xf4d50d87, 14);
+    MD5_STEP(MD5_G, b, c, d, a, w[8], 0x455a14ed, 20);
+    MD5_STEP(MD5_G, a, b, c, d, w[13], 0xa9e3e905, 5);
+    MD5_STEP(MD5_G, d, a, b, c, w[2], 0xfcefa3f8, 9);
+    MD5_STEP(MD5_G, c, d, a, b, w[7], 0x676f02d9, 14);
+    MD5_STEP(MD5_G, b, c, d, a, w[12], 0x8d2a4c8a, 20);
+
+    MD5_STEP(MD5_H, a, b, c, d, w[5], 0xfffa3942, 4);
+    MD5_STEP(MD5_H, d, a, b, c, w[8], 0x8771f681, 11);
+    MD5_STEP(MD5_H, c, d, a, b, w[11], 0x6d9d6122, 16);
+    MD5_STEP(MD5_H, b, c, d, a, w[14], 0xfde5380c, 23);
+    MD5_STEP(MD5_H, a, b, c, d, w[1], 0xa4beea44, 4);
+    MD5_STEP(MD5_H, d, a, b, c, w[4], 0x4bdecfa9, 11);
+    MD5_STEP(MD5_H, c, d, a, b, w[7], 0xf6bb4b60, 16);
+    MD5_STEP(MD5_H, b, c, d, a, w[10], 0xbebfbc70, 23);
+    MD5_STEP(MD5_H, a, b, c, d, w[13], 0x289b7ec6, 4);
+    MD5_STEP(MD5_H, d, a, b, c, w[0], 0xeaa127fa, 11);
+    MD5_STEP(MD5_H, c, d, a, b, w[3], 0xd4ef3085, 16);
+    MD5_STEP(MD5_H, b, c, d, a, w[6], 0x04881d05, 23);
+    MD5_STEP(MD5_H, a, b, c, d, w[9], 0xd9d4d039, 4);
+    MD5_STEP(MD5_H, d, a, b, c, w[12], 0xe6db99e5, 11);
+    MD5_STEP(MD5_H, c, d, a, b, w[15], 0x1fa27cf8, 16);
+    MD5_STEP(MD5_H, b, c, d, a, w[2], 0xc4ac5665, 23);
+
+    MD5_STEP(MD5_I, a, b, c, d, w[0], 0xf4292244, 6);
+    MD5_STEP(MD5_I, d, a, b, c, w[7], 0x432aff97, 10);
+    MD5_STEP(MD5_I, c, d, a, b, w[14], 0xab9423a7, 15);
+    MD5_STEP(MD5_I, b, c, d, a, w[5], 0xfc93a039, 21);
+    MD5_STEP(MD5_I, a, b, c, d, w[12], 0x655b59c3, 6);
+    MD5_STEP(MD5_I, d, a, b, c, w[3], 0x8f0ccc92, 10);
+    MD5_STEP(MD5_I, c, d, a, b, w[10], 0xffeff47d, 15);
+    MD5_STEP(MD5_I, b, c, d, a, w[1], 0x85845dd1, 21);
+    MD5_STEP(MD5_I, a, b, c, d, w[8], 0x6fa87e4f, 6);
+    MD5_STEP(MD5_I, d, a, b, c, w[15], 0xfe2ce6e0, 10);
+    MD5_STEP(MD5_I, c, d, a, b, w[6], 0xa3014314, 15);
+    MD5_STEP(MD5_I, b, c, d, a, w[13], 0x4e0811a1, 21);
+    MD5_STEP(MD5_I, a, b, c, d, w[4], 0xf7537e82, 6);
+    MD5_STEP(MD5_I, d, a, b, c, w[11], 0xbd3af235, 10);
+    MD5_STEP(MD5_I, c, d, a, b, w[2], 0x2ad7d2bb, 15);
+    MD5_STEP(MD5_I, b, c, d, a, w[9], 0xeb86d391, 21);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state[0]), _mm_add_epi32(a, aa));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state[1]), _mm_add_epi32(b, bb));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state[2]), _mm_add_epi32(c, cc));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state[3]), _mm_add_epi32(d, dd));
+}
+
+void AlibabaCloud::OSS::MD5MultiBuffer(MD5Buffer *buffers, size_t count)
+{
+    static const unsigned char idleBlock[64] = { 0 };
+    uint32_t state[4][Lanes];
+    LaneJob jobs[Lanes];
+    bool active[Lanes] = { false, false, false, false };
+    size_t nextBuffer = 0;
+    int activeNum = 0;
+
+    auto assign = [&](int lane) {
+        active[lane] = nextBuffer < count;
+        if (active[lane]) {
+            StartJob(jobs[lane], &buffers[nextBuffer++]);
+            for (int i = 0; i < 4; i++) {
+                state[i][lane] = InitState[i];
+            }
+        }
+        return active[lane];
+    };
+
+    for (int lane = 0; lane < Lanes; lane++) {
+        activeNum += assign(lane) ? 1 : 0;
+    }
+
+    while (activeNum > 0) {
+        const unsigned char *blocks[Lanes];
+        for (int lane = 0; lane < Lanes; lane++) {
+            LaneJob &job = jobs[lane];
+            if (!active[lane]) {
+                blocks[lane] = idleBlock;
+            }
+            else if (job.fullBlocks > 0) {
+                blocks[lane] = job.next;
+            }
+            else {
+                blocks[lane] = job.tail + job.tailIndex * 64;
+            }
+        }
+
+        Compress4(state, blocks);
+
+        for (int lane = 0; lane < Lanes; lane++) {
+            if (!active[lane]) {
+                continue;
+            }
+            LaneJob &job = jobs[lane];
+            if (job.fullBlocks > 0) {
+                job.next += 64;
+                job.fullBlocks--;
+                continue;
+            }
+            if (++job.tailIndex < job.tailBlocks) {
+                continue;
+            }
+            for (int i = 0; i < 4; i++) {
+                for (int j = 0; j < 4; j++) {
+                    job.buffer->digest[i * 4 + j] = static_cast<unsigned char>(state[i][lane] >> (8 * j));
+                }
+            }
+            if (!assign(lane)) {
+                activeNum--;
+            }
+        }
+    }
+}
+
+#else
+
+void AlibabaCloud::OSS::MD5MultiBuffer(MD5Buffer *buffers, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        MD5(reinterpret_cast<const unsigned char *>(buffers[i].data), buffers[i].size, buffers[i].digest);
+    }
+}
+
+#endif
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    struct MD5Buffer
+    {
+        const char *data;
+        size_t size;
+        unsigned char digest[16];
+    };
+
+    /*
+    * MD5 of many independent buffers. On x86-64 four buffers are hashed at once,
+    * one per 32-bit lane of the SSE2 registers, a finished lane takes the next
+    * buffer. MD5 is serial within a message, so this is what helps for many
+    * small payloads. Elsewhere the buffers are hashed one by one.
+    */
+    void MD5MultiBuffer(MD5Buffer *buffers, size_t count);
+}
+}
@@ -0,0 +1,457 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <alibabacloud/oss/utils/ObjectLister.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <utility>
+#include "LogUtils.h"
+
+using namespace AlibabaCloud::OSS;
+
+static const char *TAG = "ObjectLister";
+
+namespace
+{
+    const int DefaultPageSize = 1000;
+    /*pages listed ahead per range*/
+    const size_t MaxBufferedPages = 2;
+    /*ranges per parallel listing, more of them balance better but each ends with a trimmed page*/
+    const size_t RangesPerThread = 16;
+    const int SampleRounds = 4;
+    /*pages of the "/" delimited listing read for the split keys, a larger listing is sampled instead*/
+    const int DiscoveryPages = 2;
+}
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class ObjectListerState : public std::enable_shared_from_this<ObjectListerState>
+    {
+    public:
+        struct Page
+        {
+            ObjectSummaryList summaries;
+            CommonPrefixeList prefixes;
+        };
+
+        ObjectListerState(const OssClient &client, const ListObjectsRequest &request, int parallel, bool ordered);
+
+        void start();
+        bool nextPage(Page &page);
+        void cancel();
+
+        std::vector<std::string> splitKeys;
+        std::mutex lock;
+        bool failed;
+        OssError error;
+
+    private:
+        /*keys in (marker, upper], no upper bound for the last range*/
+        struct Range
+        {
+            Range(const std::string &lower, const std::string &upperKey, bool isBounded) :
+                marker(lower), upper(upperKey), bounded(isBounded), inFlight(false), done(false) {}
+            std::string marker;
+            std::string upper;
+            bool bounded;
+            bool inFlight;
+            bool done;
+            std::deque<Page> pages;
+        };
+        typedef std::vector<std::pair<size_t, std::string>> IssueList;
+
+        std::vector<std::string> discoverSplitKeys();
+        std::vector<std::string> sampleSplitKeys();
+        void fail(const OssError &err);
+        void schedule(IssueList &todo);
+        void issue(const IssueList &todo);
+        void onPage(size_t index, const ListObjectOutcome &outcome);
+
+        const OssClient &client_;
+        ListObjectsRequest request_;
+        int parallel_;
+        bool ordered_;
+        std::condition_variable cv_;
+        std::vector<Range> ranges_;
+        size_t current_;
+        int inFlight_;
+        bool cancelled_;
+    };
+}
+}
+
+ObjectListerState::ObjectListerState(const OssClient &client, const ListObjectsRequest &request, int parallel, bool ordered) :
+    failed(false),
+    client_(client),
+    request_(request),
+    parallel_(std::max(parallel, 1)),
+    ordered_(ordered),
+    current_(0),
+    inFlight_(0),
+    cancelled_(false)
+{
+    if (request_.MaxKeys() <= 0) {
+        request_.setMaxKeys(DefaultPageSize);
+    }
+    //a delimited listing returns the common prefixes in order with the keys
+    if (!request_.Delimiter().empty()) {
+        parallel_ = 1;
+    }
+}
+
+void ObjectListerState::start()
+{
+    std::vector<std::string> keys;
+    if (parallel_ > 1) {
+        keys = splitKeys.empty() ? discoverSplitKeys() : splitKeys;
+        if (failed) {
+            return;
+        }
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    keys.erase(keys.begin(), std::upper_bound(keys.begin(), keys.end(), request_.Marker()));
+    size_t maxRanges = static_cast<size_t>(parallel_) * RangesPerThread;
+    if (keys.size() >= maxRanges) {
+        std::vector<std::string> thinned;
+        for (size_t i = 1; i < maxRanges; i++) {
+            thinned.push_back(keys[i * keys.size() / maxRanges]);
+        }
+        keys.swap(thinned);
+    }
+
+    IssueList todo;
+    {
+        std::lock_guard<std::mutex> lck(lock);
+        std::string lower = request_.Marker();
+        for (const auto &key : keys) {
+            ranges_.emplace_back(lower, key, true);
+            lower = key;
+        }
+        ranges_.emplace_back(lower, "", false);
+        OSS_LOG(LogLevel::LogDebug, TAG, "lister(%p) list bucket:%s, prefix:%s in %d ranges, parallel:%d",
+            this, request_.Bucket().c_str(), request_.Prefix().c_str(), static_cast<int>(ranges_.size()), parallel_);
+        schedule(todo);
+    }
+    issue(todo);
+}
+
+std::vector<std::string> ObjectListerState::discoverSplitKeys()
+{
+    //the common prefixes of a "/" delimited listing split the key space between the "directories"
+    std::vector<std::string> keys;
+    ListObjectsRequest request(request_);
+    request.setDelimiter("/");
+    request.setMaxKeys(DefaultPageSize);
+    bool truncated = false;
+    bool complete = false;
+    for (int page = 0; page < DiscoveryPages; page++) {
+        auto outcome = client_.ListObjects(request);
+        if (!outcome.isSuccess()) {
+            fail(outcome.error());
+            return keys;
+        }
+        const auto &prefixes = outcome.result().CommonPrefixes();
+        keys.insert(keys.end(), prefixes.begin(), prefixes.end());
+        if (!outcome.result().IsTruncated() || outcome.result().NextMarker().empty()) {
+            complete = true;
+            break;
+        }
+        truncated = true;
+        request.setMarker(outcome.result().NextMarker());
+    }
+
+    //no "directories" and one page of keys, not worth the probes
+    if (keys.empty() && !truncated) {
+        return keys;
+    }
+    //the prefixes seen so far only split the start of a large, flat key space
+    if (!complete) {
+        auto sampled = sampleSplitKeys();
+        if (!sampled.empty()) {
+            keys.swap(sampled);
+        }
+        return keys;
+    }
+    if (keys.size() + 1 < static_cast<size_t>(parallel_)) {
+        auto sampled = sampleSplitKeys();
+        if (sampled.size() > keys.size()) {
+            keys.swap(sampled);
+        }
+    }
+    return keys;
+}
+
+std::vector<std::string> ObjectListerState::sampleSplitKeys()
+{
+    //the first key after stem + c for every printable c, the stem grows while all the
+    //sampled keys share a longer prefix, e.g. "logs/2019-" under "logs/"
+    std::vector<std::string> best;
+    std::string stem = request_.Prefix();
+    for (int round = 0; round < SampleRounds && !failed; round++) {
+        std::vector<ListObjectOutcomeCallable> probes;
+        for (int c = 0x20; c < 0x7f; c++) {
+            ListObjectsRequest request(request_);
+            request.setMarker(std::max(stem + static_cast<char>(c), request_.Marker()));
+            request.setMaxKeys(1);
+            probes.push_back(client_.ListObjectsCallable(request));
+        }
+        std::set<std::string> keys;
+        for (auto &probe : probes) {
+            auto outcome = probe.get();
+            if (!outcome.isSuccess()) {
+                fail(outcome.error());
+            }
+            else if (!outcome.result().ObjectSummarys().empty()) {
+                keys.insert(outcome.result().ObjectSummarys().front().Key());
+            }
+        }
+        if (keys.size() > best.size()) {
+            best.assign(keys.begin(), keys.end());
+        }
+        if (keys.size() < 2 || best.size() + 1 >= static_cast<size_t>(parallel_)) {
+            break;
+        }
+        const std::string &first = *keys.begin();
+        const std::string &last = *keys.rbegin();
+        auto diff = std::mismatch(first.begin(), first.end(), last.begin());
+        size_t common = static_cast<size_t>(diff.first - first.begin());
+        if (common <= stem.size()) {
+            break;
+        }
+        stem = first.substr(0, common);
+    }
+    return failed ? std::vector<std::string>() : best;
+}
+
+void ObjectListerState::fail(const OssError &err)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    if (!failed) {
+        failed = true;
+        error = err;
+        OSS_LOG(LogLevel::LogError, TAG, "lister(%p) failed, code:%s, message:%s",
+            this, err.Code().c_str(), err.Message().c_str());
+    }
+    cv_.notify_all();
+}
+
+void ObjectListerState::schedule(IssueList &todo)
+{
+    //called with lock held, the requests are sent by issue() after it is released
+    if (failed || cancelled_) {
+        return;
+    }
+    for (size_t i = current_; i < ranges_.size() && inFlight_ < parallel_; i++) {
+        Range &range = ranges_[i];
+        if (range.done || range.inFlight || range.pages.size() >= MaxBufferedPages) {
+            continue;
+        }
+        range.inFlight = true;
+        inFlight_++;
+        todo.push_back(std::make_pair(i, range.marker));
+    }
+}
+
+void ObjectListerState::issue(const IssueList &todo)
+{
+    auto self = shared_from_this();
+    for (const auto &item : todo) {
+        ListObjectsRequest request(request_);
+        request.setMarker(item.second);
+        size_t index = item.first;
+        client_.ListObjectsAsync(request, [self, index](const OssClient *, const ListObjectsRequest &,
+            const ListObjectOutcome &outcome, const std::shared_ptr<const AsyncCallerContext> &)
+        {
+            self->onPage(index, outcome);
+        });
+    }
+}
+
+void ObjectListerState::onPage(size_t index, const ListObjectOutcome &outcome)
+{
+    IssueList todo;
+    {
+        std::lock_guard<std::mutex> lck(lock);
+        Range &range = ranges_[index];
+        range.inFlight = false;
+        inFlight_--;
+        cv_.notify_all();
+        if (cancelled_ || failed) {
+            return;
+        }
+        if (!outcome.isSuccess()) {
+            failed = true;
+            error = outcome.error();
+            OSS_LOG(LogLevel::LogError, TAG, "lister(%p) failed, code:%s, message:%s",
+                this, error.Code().c_str(), error.Message().c_str());
+            return;
+        }
+
+        const auto &result = outcome.result();
+        Page page;
+        for (const auto &summary : result.ObjectSummarys()) {
+            if (range.bounded && summary.Key() > range.upper) {
+                range.done = true;
+                break;
+            }
+            page.summaries.push_back(summary);
+        }
+        page.prefixes = result.CommonPrefixes();
+        if (!range.done) {
+            std::string next = result.NextMarker();
+            if (next.empty() && !page.summaries.empty()) {
+                next = page.summaries.back().Key();
+            }
+            if (!result.IsTruncated() || next.empty()) {
+                range.done = true;
+            }
+            range.marker = next;
+        }
+        if (!page.summaries.empty() || !page.prefixes.empty()) {
+            range.pages.push_back(std::move(page));
+        }
+        schedule(todo);
+    }
+    issue(todo);
+}
+
+bool ObjectListerState::nextPage(Page &page)
+{
+    IssueList todo;
+    {
+        std::unique_lock<std::mutex> lck(lock);
+        while (true) {
+            if (failed) {
+                return false;
+            }
+            bool found = false;
+            bool finished = true;
+            for (size_t i = current_; i < ranges_.size(); i++) {
+                Range &range = ranges_[i];
+                if (!range.pages.empty()) {
+                    page = std::move(range.pages.front());
+                    range.pages.pop_front();
+                    found = true;
+                    break;
+                }
+                if (!range.done) {
+                    finished = false;
+                    if (ordered_) {
+                        break;
+                    }
+                }
+                else if (ordered_ && i == current_) {
+                    current_++;
+                }
+            }
+            if (found) {
+                break;
+            }
+            if (finished) {
+                return false;
+            }
+            cv_.wait(lck);
+        }
+        schedule(todo);
+    }
+    issue(todo);
+    return true;
+}
+
+void ObjectListerState::cancel()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    cancelled_ = true;
+    cv_.wait(lck, [this] { return inFlight_ == 0; });
+}
+
+ObjectLister::ObjectLister(const OssClient &client, const ListObjectsRequest &request, int parallel, bool ordered) :
+    state_(std::make_shared<ObjectListerState>(client, request, parallel, ordered)),
+    pos_(0),
+    started_(false)
+{
+}
+
+ObjectLister::~ObjectLister()
+{
+    //the pending callbacks hold the state, the client must stay valid until they are done
+    state_->cancel();
+}
+
+void ObjectLister::setSplitKeys(const std::vector<std::string> &keys)
+{
+    state_->splitKeys = keys;
+}
+
+bool ObjectLister::nextPage(ObjectSummaryList &summaries, CommonPrefixeList &prefixes)
+{
+    if (!started_) {
+        started_ = true;
+        state_->start();
+    }
+    ObjectListerState::Page page;
+    if (!state_->nextPage(page)) {
+        return false;
+    }
+    summaries.swap(page.summaries);
+    prefixes.swap(page.prefixes);
+    return true;
+}
+
+bool ObjectLister::nextPage(ObjectSummaryList &summaries)
+{
+    CommonPrefixeList prefixes;
+    return nextPage(summaries, prefixes);
+}
+
+bool ObjectLister::next(ObjectSummary &summary)
+{
+    while (pos_ >= page_.size()) {
+        pos_ = 0;
+        page_.clear();
+        if (!nextPage(page_)) {
+            return false;
+        }
+    }
+    summary = page_[pos_++];
+    return true;
+}
+
+bool ObjectLister::hasError() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->failed;
+}
+
+const OssError &ObjectLister::error() const
+{
+    return state_->error;
+}
+
+void ObjectLister::iterator::advance()
+{
+    if (lister_ != nullptr && !lister_->next(current_)) {
+        lister_ = nullptr;
+    }
+}
@@ -0,0 +1,472 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <alibabacloud/oss/utils/ObjectReader.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "LogUtils.h"
+
+using namespace AlibabaCloud::OSS;
+
+static const char *TAG = "ObjectReader";
+
+namespace
+{
+    const int64_t BlockSizeLowerLimit = 4 * 1024;
+    const int InitialWindow = 2;
+}
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class ObjectReaderState : public std::enable_shared_from_this<ObjectReaderState>
+    {
+    public:
+        /*one range, from its request until the reader is past it*/
+        struct Block
+        {
+            Block(int64_t off, size_t len, char *buffer) :
+                offset(off), size(len), data(buffer), filled(0), done(false), failed(false), seen(false),
+                cancel(std::make_shared<std::atomic<bool>>(false)) {}
+
+            void reset()
+            {
+                std::lock_guard<std::mutex> lck(sinkLock);
+                filled = 0;
+            }
+
+            const int64_t offset;
+            const size_t size;
+            /*data and filled are written by the transfer, a cancel takes data away*/
+            std::mutex sinkLock;
+            char *data;
+            size_t filled;
+            /*under the state lock*/
+            bool done;
+            bool failed;
+            bool seen;
+            OssError error;
+            /*aborts the range request of the block*/
+            std::shared_ptr<std::atomic<bool>> cancel;
+        };
+
+        ObjectReaderState(const OssClient &client, const std::string &bucket, const std::string &key,
+            int64_t blockSize, int parallel);
+
+        bool open();
+        int64_t read(char *buffer, size_t length);
+        bool seek(int64_t offset);
+        void close();
+
+        mutable std::mutex lock;
+        bool failed;
+        OssError error;
+        int64_t size;
+        std::string eTag;
+        int64_t pos;
+        int window;
+
+    private:
+        typedef std::vector<std::shared_ptr<Block>> BlockList;
+
+        std::shared_ptr<Block> front();
+        BlockList fill();
+        void launch(BlockList &&blocks, std::unique_lock<std::mutex> &lck);
+        void send(const std::shared_ptr<Block> &block);
+        void release(const std::shared_ptr<Block> &block);
+        void onBlock(const std::shared_ptr<Block> &block, const GetObjectOutcome &outcome);
+
+        const OssClient &client_;
+        std::string bucket_;
+        std::string key_;
+        size_t blockSize_;
+        int parallel_;
+        bool opened_;
+        bool closed_;
+        std::condition_variable cv_;
+        std::vector<std::unique_ptr<char[]>> buffers_;
+        std::vector<char *> free_;
+        /*the blocks from the one under the read cursor on, in offset order*/
+        std::deque<std::shared_ptr<Block>> blocks_;
+        int64_t next_;
+        /*the transfers still running, the cancelled ones included*/
+        int inFlight_;
+        int readyRun_;
+    };
+}
+}
+
+namespace
+{
+    /*write only sink into the buffer of a block, drops the data once the block is cancelled*/
+    class BlockBuf : public std::streambuf
+    {
+    public:
+        explicit BlockBuf(const std::shared_ptr<ObjectReaderState::Block> &block) : block_(block) {}
+
+    protected:
+        std::streamsize xsputn(const char *s, std::streamsize n) override
+        {
+            std::lock_guard<std::mutex> lck(block_->sinkLock);
+            if (block_->data == nullptr) {
+                return n;
+            }
+            size_t len = std::min(static_cast<size_t>(n), block_->size - block_->filled);
+            std::memcpy(block_->data + block_->filled, s, len);
+            block_->filled += len;
+            return static_cast<std::streamsize>(len);
+        }
+        int_type overflow(int_type c) override
+        {
+            if (traits_type::eq_int_type(c, traits_type::eof())) {
+                return traits_type::not_eof(c);
+            }
+            char ch = traits_type::to_char_type(c);
+            return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+        }
+
+    private:
+        std::shared_ptr<ObjectReaderState::Block> block_;
+    };
+
+    class BlockStream : public std::iostream
+    {
+    public:
+        explicit BlockStream(const std::shared_ptr<ObjectReaderState::Block> &block) :
+            std::iostream(nullptr), buf_(block) { rdbuf(&buf_); }
+    private:
+        BlockBuf buf_;
+    };
+}
+
+ObjectReaderState::ObjectReaderState(const OssClient &client, const std::string &bucket, const std::string &key,
+    int64_t blockSize, int parallel) :
+    failed(false),
+    size(-1),
+    pos(0),
+    window(std::min(InitialWindow, std::max(parallel, 1))),
+    client_(client),
+    bucket_(bucket),
+    key_(key),
+    blockSize_(static_cast<size_t>(std::max(blockSize, BlockSizeLowerLimit))),
+    parallel_(std::max(parallel, 1)),
+    opened_(false),
+    closed_(false),
+    next_(0),
+    inFlight_(0),
+    readyRun_(0)
+{
+}
+
+bool ObjectReaderState::open()
+{
+    std::lock_guard<std::mutex> lck(lock);
+    if (!opened_) {
+        opened_ = true;
+        auto outcome = client_.HeadObject(bucket_, key_);
+        if (outcome.isSuccess()) {
+            size = outcome.result().ContentLength();
+            eTag = outcome.result().ETag();
+        }
+        else {
+            failed = true;
+            error = outcome.error();
+            OSS_LOG(LogLevel::LogError, TAG, "reader(%p) open %s failed, code:%s, message:%s",
+                this, key_.c_str(), error.Code().c_str(), error.Message().c_str());
+        }
+    }
+    return size >= 0;
+}
+
+int64_t ObjectReaderState::read(char *buffer, size_t length)
+{
+    if (!open()) {
+        return -1;
+    }
+    int64_t total = 0;
+    while (length > 0) {
+        auto block = front();
+        if (block == nullptr) {
+            break;
+        }
+        //only this thread recycles the buffer of the front block
+        size_t offset = static_cast<size_t>(pos - block->offset);
+        size_t n = std::min(length, block->size - offset);
+        std::memcpy(buffer, block->data + offset, n);
+        buffer += n;
+        length -= n;
+        total += static_cast<int64_t>(n);
+
+        std::unique_lock<std::mutex> lck(lock);
+        pos += static_cast<int64_t>(n);
+        if (offset + n == block->size) {
+            release(block);
+            blocks_.pop_front();
+            launch(fill(), lck);
+        }
+    }
+    std::lock_guard<std::mutex> lck(lock);
+    return (total > 0 || !failed) ? total : -1;
+}
+
+/*the block under the read cursor once it is fetched, nullptr at the end or on failure*/
+std::shared_ptr<ObjectReaderState::Block> ObjectReaderState::front()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    if (failed || pos >= size) {
+        return nullptr;
+    }
+    launch(fill(), lck);
+    auto block = blocks_.front();
+    if (!block->seen) {
+        block->seen = true;
+        if (!block->done) {
+            //the transfers fall behind the reader
+            readyRun_ = 0;
+            if (window < parallel_) {
+                window = std::min(window * 2, parallel_);
+                launch(fill(), lck);
+            }
+        }
+        else if (blocks_.back()->done && ++readyRun_ >= window) {
+            //the whole window was ready ahead of the reader
+            readyRun_ = 0;
+            window = std::max(window - 1, 1);
+        }
+    }
+    cv_.wait(lck, [&] { return block->done; });
+    if (block->failed) {
+        if (!failed) {
+            failed = true;
+            error = block->error;
+        }
+        return nullptr;
+    }
+    return block;
+}
+
+/*the blocks to request for the window, called with the lock held*/
+ObjectReaderState::BlockList ObjectReaderState::fill()
+{
+    BlockList blocks;
+    while (!closed_ && pos < size && next_ < size && blocks_.size() < static_cast<size_t>(window)) {
+        //the block under the cursor does not wait for the cancelled transfers
+        if (!blocks_.empty() && inFlight_ >= parallel_) {
+            break;
+        }
+        char *buffer = nullptr;
+        if (!free_.empty()) {
+            buffer = free_.back();
+            free_.pop_back();
+        }
+        else {
+            buffers_.emplace_back(new char[blockSize_]);
+            buffer = buffers_.back().get();
+        }
+        auto block = std::make_shared<Block>(next_, static_cast<size_t>(std::min<int64_t>(blockSize_, size - next_)), buffer);
+        next_ += static_cast<int64_t>(block->size);
+        blocks_.push_back(block);
+        blocks.push_back(block);
+        inFlight_++;
+    }
+    return blocks;
+}
+
+void ObjectReaderState::launch(BlockList &&blocks, std::unique_lock<std::mutex> &lck)
+{
+    if (blocks.empty()) {
+        return;
+    }
+    lck.unlock();
+    for (const auto &block : blocks) {
+        send(block);
+    }
+    lck.lock();
+}
+
+void ObjectReaderState::send(const std::shared_ptr<Block> &block)
+{
+    GetObjectRequest request(bucket_, key_);
+    request.setRange(block->offset, block->offset + static_cast<int64_t>(block->size) - 1);
+    request.addMatchingETagConstraint("\"" + eTag + "\"");
+    request.setCancelFlag(block->cancel);
+    request.setResponseStreamFactory([block]() {
+        //a retry writes the block from its start
+        block->reset();
+        return std::make_shared<BlockStream>(block);
+    });
+    auto self = shared_from_this();
+    client_.GetObjectAsync(request, [self, block](const OssClient *, const GetObjectRequest &,
+        const GetObjectOutcome &outcome, const std::shared_ptr<const AsyncCallerContext> &)
+    {
+        self->onBlock(block, outcome);
+    });
+}
+
+/*gives the buffer of a block back, a transfer still running drops its data from now on
+  and is aborted, called with the lock held*/
+void ObjectReaderState::release(const std::shared_ptr<Block> &block)
+{
+    if (!block->done) {
+        *block->cancel = true;
+    }
+    std::lock_guard<std::mutex> lck(block->sinkLock);
+    if (block->data != nullptr) {
+        free_.push_back(block->data);
+        block->data = nullptr;
+    }
+}
+
+void ObjectReaderState::onBlock(const std::shared_ptr<Block> &block, const GetObjectOutcome &outcome)
+{
+    std::unique_lock<std::mutex> lck(lock);
+    inFlight_--;
+    block->done = true;
+    bool cancelled = false;
+    size_t filled = 0;
+    {
+        std::lock_guard<std::mutex> blck(block->sinkLock);
+        cancelled = block->data == nullptr;
+        filled = block->filled;
+    }
+    if (!cancelled) {
+        if (!outcome.isSuccess()) {
+            block->failed = true;
+            block->error = outcome.error();
+        }
+        else if (filled != block->size) {
+            block->failed = true;
+            block->error = OssError("ObjectReaderError", "The range at " + std::to_string(block->offset) +
+                " returned " + std::to_string(filled) + " bytes, " + std::to_string(block->size) + " expected.");
+        }
+        if (block->failed) {
+            OSS_LOG(LogLevel::LogError, TAG, "reader(%p) range at %lld failed, code:%s, message:%s",
+                this, static_cast<long long>(block->offset), block->error.Code().c_str(), block->error.Message().c_str());
+        }
+    }
+    cv_.notify_all();
+    //the slot of a cancelled transfer goes to the read-ahead
+    launch(fill(), lck);
+}
+
+bool ObjectReaderState::seek(int64_t offset)
+{
+    if (!open()) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lck(lock);
+    if (failed || offset < 0 || offset > size) {
+        return false;
+    }
+    pos = offset;
+    while (!blocks_.empty() && blocks_.front()->offset + static_cast<int64_t>(blocks_.front()->size) <= offset) {
+        release(blocks_.front());
+        blocks_.pop_front();
+    }
+    if (!blocks_.empty() && blocks_.front()->offset > offset) {
+        for (const auto &block : blocks_) {
+            release(block);
+        }
+        blocks_.clear();
+    }
+    if (blocks_.empty()) {
+        //the access is not sequential, the read-ahead starts over
+        OSS_LOG(LogLevel::LogDebug, TAG, "reader(%p) seek to %lld cancels the read-ahead, in flight:%d",
+            this, static_cast<long long>(offset), inFlight_);
+        next_ = offset - offset % static_cast<int64_t>(blockSize_);
+        window = std::min(InitialWindow, parallel_);
+        readyRun_ = 0;
+    }
+    launch(fill(), lck);
+    return true;
+}
+
+void ObjectReaderState::close()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    closed_ = true;
+    for (const auto &block : blocks_) {
+        release(block);
+    }
+    blocks_.clear();
+    //the transfers write to the blocks, not to the buffers, until they are done
+    cv_.wait(lck, [this] { return inFlight_ == 0; });
+}
+
+ObjectReader::ObjectReader(const OssClient &client, const std::string &bucket, const std::string &key,
+    int64_t blockSize, int parallel) :
+    state_(std::make_shared<ObjectReaderState>(client, bucket, key, blockSize, parallel))
+{
+}
+
+ObjectReader::~ObjectReader()
+{
+    state_->close();
+}
+
+int64_t ObjectReader::read(char *buffer, size_t size)
+{
+    return state_->read(buffer, size);
+}
+
+bool ObjectReader::seek(int64_t offset)
+{
+    return state_->seek(offset);
+}
+
+int64_t ObjectReader::tell() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->pos;
+}
+
+int64_t ObjectReader::Size() const
+{
+    state_->open();
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->size;
+}
+
+const std::string &ObjectReader::ETag() const
+{
+    state_->open();
+    return state_->eTag;
+}
+
+int ObjectReader::Window() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->window;
+}
+
+bool ObjectReader::hasError() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->failed;
+}
+
+OssError ObjectReader::error() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->error;
+}
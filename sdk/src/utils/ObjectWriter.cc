@@ -0,0 +1,438 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <alibabacloud/oss/utils/ObjectWriter.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include "Crc64.h"
+#include "LogUtils.h"
+
+using namespace AlibabaCloud::OSS;
+
+static const char *TAG = "ObjectWriter";
+
+namespace
+{
+    /*read only view of a part buffer, seekable for the content length and the md5*/
+    class PartBuf : public std::streambuf
+    {
+    public:
+        PartBuf(char *data, size_t size) { setg(data, data, data + size); }
+
+    protected:
+        std::streamsize showmanyc() override
+        {
+            return egptr() - gptr();
+        }
+        pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which) override
+        {
+            if (!(which & std::ios_base::in)) {
+                return pos_type(off_type(-1));
+            }
+            off_type base = way == std::ios_base::beg ? 0 : (way == std::ios_base::cur ? gptr() - eback() : egptr() - eback());
+            off_type pos = base + off;
+            if (pos < 0 || pos > egptr() - eback()) {
+                return pos_type(off_type(-1));
+            }
+            setg(eback(), eback() + pos, egptr());
+            return pos_type(pos);
+        }
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+
+    class PartStream : public std::iostream
+    {
+    public:
+        PartStream(char *data, size_t size) : std::iostream(nullptr), buf_(data, size) { rdbuf(&buf_); }
+    private:
+        PartBuf buf_;
+    };
+}
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class ObjectWriterState : public std::enable_shared_from_this<ObjectWriterState>
+    {
+    public:
+        ObjectWriterState(const OssClient &client, const std::string &bucket, const std::string &key,
+            const ObjectMetaData &metaData, int64_t partSize, int parallel);
+
+        bool write(const char *data, size_t size);
+        bool close();
+        void abort();
+
+        mutable std::mutex lock;
+        bool failed;
+        OssError error;
+        int64_t size;
+        int partCount;
+        std::string eTag;
+        uint64_t crc64;
+
+    private:
+        struct PartCrc
+        {
+            uint64_t crc64;
+            int64_t size;
+        };
+
+        bool sendPart();
+        char *acquire();
+        void onPart(int partNumber, char *buffer, int64_t length, const PutObjectOutcome &outcome);
+        void fail(const OssError &err);
+        void waitParts();
+        bool putObject();
+        bool complete();
+
+        const OssClient &client_;
+        std::string bucket_;
+        std::string key_;
+        ObjectMetaData metaData_;
+        size_t partSize_;
+        int parallel_;
+        bool closed_;
+        std::condition_variable cv_;
+        std::vector<std::unique_ptr<char[]>> buffers_;
+        std::vector<char *> free_;
+        /*only the writing thread touches current_ and filled_*/
+        char *current_;
+        size_t filled_;
+        std::string uploadId_;
+        int inFlight_;
+        PartList parts_;
+        std::vector<PartCrc> partCrcs_;
+    };
+}
+}
+
+ObjectWriterState::ObjectWriterState(const OssClient &client, const std::string &bucket, const std::string &key,
+    const ObjectMetaData &metaData, int64_t partSize, int parallel) :
+    failed(false),
+    size(0),
+    partCount(0),
+    crc64(0),
+    client_(client),
+    bucket_(bucket),
+    key_(key),
+    metaData_(metaData),
+    partSize_(static_cast<size_t>(std::max<int64_t>(partSize, PartSizeLowerLimit))),
+    parallel_(std::max(parallel, 1)),
+    closed_(false),
+    current_(nullptr),
+    filled_(0),
+    inFlight_(0)
+{
+}
+
+bool ObjectWriterState::write(const char *data, size_t length)
+{
+    while (length > 0) {
+        if (current_ == nullptr && (current_ = acquire()) == nullptr) {
+            return false;
+        }
+        size_t n = std::min(length, partSize_ - filled_);
+        std::memcpy(current_ + filled_, data, n);
+        filled_ += n;
+        data += n;
+        length -= n;
+        {
+            std::lock_guard<std::mutex> lck(lock);
+            size += static_cast<int64_t>(n);
+        }
+        if (filled_ == partSize_ && !sendPart()) {
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lck(lock);
+    return !failed;
+}
+
+/*a free buffer, a new one while there are less than parallel, else wait for a part to finish*/
+char *ObjectWriterState::acquire()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    cv_.wait(lck, [this] {
+        return failed || closed_ || !free_.empty() || buffers_.size() < static_cast<size_t>(parallel_);
+    });
+    if (failed || closed_) {
+        return nullptr;
+    }
+    if (!free_.empty()) {
+        char *buffer = free_.back();
+        free_.pop_back();
+        return buffer;
+    }
+    buffers_.emplace_back(new char[partSize_]);
+    return buffers_.back().get();
+}
+
+bool ObjectWriterState::sendPart()
+{
+    if (uploadId_.empty()) {
+        InitiateMultipartUploadRequest request(bucket_, key_, metaData_);
+        auto outcome = client_.InitiateMultipartUpload(request);
+        if (!outcome.isSuccess()) {
+            fail(outcome.error());
+            return false;
+        }
+        uploadId_ = outcome.result().UploadId();
+    }
+
+    int partNumber;
+    {
+        std::lock_guard<std::mutex> lck(lock);
+        if (failed) {
+            return false;
+        }
+        if (partCount >= PartNumberUpperLimit) {
+            failed = true;
+            error = OssError("ValidateError", "The object needs more than 10000 parts, the part size is too small.");
+            return false;
+        }
+        partNumber = ++partCount;
+        parts_.resize(partCount);
+        partCrcs_.resize(partCount);
+        inFlight_++;
+    }
+
+    char *buffer = current_;
+    int64_t length = static_cast<int64_t>(filled_);
+    current_ = nullptr;
+    filled_ = 0;
+
+    auto content = std::make_shared<PartStream>(buffer, static_cast<size_t>(length));
+    UploadPartRequest request(bucket_, key_, partNumber, uploadId_, content);
+    request.setContentLength(static_cast<uint64_t>(length));
+    auto self = shared_from_this();
+    client_.UploadPartAsync(request, [self, partNumber, buffer, length](const OssClient *, const UploadPartRequest &,
+        const PutObjectOutcome &outcome, const std::shared_ptr<const AsyncCallerContext> &)
+    {
+        self->onPart(partNumber, buffer, length, outcome);
+    });
+    return true;
+}
+
+void ObjectWriterState::onPart(int partNumber, char *buffer, int64_t length, const PutObjectOutcome &outcome)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    if (outcome.isSuccess()) {
+        PutObjectResult result = outcome.result();
+        parts_[partNumber - 1] = Part(partNumber, result.ETag());
+        partCrcs_[partNumber - 1] = { result.CRC64(), length };
+    }
+    else if (!failed) {
+        failed = true;
+        error = outcome.error();
+        OSS_LOG(LogLevel::LogError, TAG, "writer(%p) part %d of %s failed, code:%s, message:%s",
+            this, partNumber, key_.c_str(), error.Code().c_str(), error.Message().c_str());
+    }
+    free_.push_back(buffer);
+    inFlight_--;
+    cv_.notify_all();
+}
+
+void ObjectWriterState::fail(const OssError &err)
+{
+    std::lock_guard<std::mutex> lck(lock);
+    if (!failed) {
+        failed = true;
+        error = err;
+    }
+    cv_.notify_all();
+}
+
+void ObjectWriterState::waitParts()
+{
+    std::unique_lock<std::mutex> lck(lock);
+    cv_.wait(lck, [this] { return inFlight_ == 0; });
+}
+
+bool ObjectWriterState::close()
+{
+    bool hasFailed;
+    {
+        std::lock_guard<std::mutex> lck(lock);
+        if (closed_) {
+            return !failed;
+        }
+        hasFailed = failed;
+        closed_ = failed;
+    }
+    if (hasFailed) {
+        waitParts();
+        if (!uploadId_.empty()) {
+            client_.AbortMultipartUpload(AbortMultipartUploadRequest(bucket_, key_, uploadId_));
+        }
+        return false;
+    }
+    if (uploadId_.empty()) {
+        bool done = putObject();
+        std::lock_guard<std::mutex> lck(lock);
+        closed_ = true;
+        return done;
+    }
+    if (filled_ > 0) {
+        sendPart();
+    }
+    waitParts();
+    {
+        std::lock_guard<std::mutex> lck(lock);
+        closed_ = true;
+    }
+    if (complete()) {
+        return true;
+    }
+    client_.AbortMultipartUpload(AbortMultipartUploadRequest(bucket_, key_, uploadId_));
+    return false;
+}
+
+/*less than one part was written*/
+bool ObjectWriterState::putObject()
+{
+    auto content = std::make_shared<PartStream>(current_, filled_);
+    PutObjectRequest request(bucket_, key_, content, metaData_);
+    auto outcome = client_.PutObject(request);
+    if (!outcome.isSuccess()) {
+        fail(outcome.error());
+        return false;
+    }
+    PutObjectResult result = outcome.result();
+    std::lock_guard<std::mutex> lck(lock);
+    eTag = result.ETag();
+    crc64 = result.CRC64();
+    return true;
+}
+
+bool ObjectWriterState::complete()
+{
+    {
+        std::lock_guard<std::mutex> lck(lock);
+        if (failed) {
+            return false;
+        }
+    }
+    CompleteMultipartUploadRequest request(bucket_, key_, parts_, uploadId_);
+    auto outcome = client_.CompleteMultipartUpload(request);
+    if (!outcome.isSuccess()) {
+        fail(outcome.error());
+        return false;
+    }
+
+    uint64_t localCRC64 = partCrcs_[0].crc64;
+    for (size_t i = 1; i < partCrcs_.size(); i++) {
+        localCRC64 = CRC64::CombineCRC(localCRC64, partCrcs_[i].crc64, partCrcs_[i].size);
+    }
+    uint64_t ossCRC64 = outcome.result().CRC64();
+    if (ossCRC64 != 0 && localCRC64 != ossCRC64) {
+        fail(OssError("CrcCheckError", "ObjectWriter Object CRC Checksum fail."));
+        return false;
+    }
+    std::lock_guard<std::mutex> lck(lock);
+    eTag = outcome.result().ETag();
+    crc64 = ossCRC64 != 0 ? ossCRC64 : localCRC64;
+    return true;
+}
+
+void ObjectWriterState::abort()
+{
+    {
+        std::lock_guard<std::mutex> lck(lock);
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        if (!failed) {
+            failed = true;
+            error = OssError("ObjectWriterError", "The upload is aborted.");
+        }
+        cv_.notify_all();
+    }
+    waitParts();
+    if (!uploadId_.empty()) {
+        client_.AbortMultipartUpload(AbortMultipartUploadRequest(bucket_, key_, uploadId_));
+    }
+}
+
+ObjectWriter::ObjectWriter(const OssClient &client, const std::string &bucket, const std::string &key,
+    const ObjectMetaData &metaData, int64_t partSize, int parallel) :
+    state_(std::make_shared<ObjectWriterState>(client, bucket, key, metaData, partSize, parallel))
+{
+}
+
+ObjectWriter::~ObjectWriter()
+{
+    //a partial object is never completed, the pending callbacks hold the state
+    state_->abort();
+}
+
+bool ObjectWriter::write(const char *data, size_t size)
+{
+    return state_->write(data, size);
+}
+
+bool ObjectWriter::close()
+{
+    return state_->close();
+}
+
+void ObjectWriter::abort()
+{
+    state_->abort();
+}
+
+int64_t ObjectWriter::Size() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->size;
+}
+
+int ObjectWriter::PartCount() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->partCount;
+}
+
+const std::string &ObjectWriter::ETag() const
+{
+    return state_->eTag;
+}
+
+uint64_t ObjectWriter::CRC64() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->crc64;
+}
+
+bool ObjectWriter::hasError() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->failed;
+}
+
+OssError ObjectWriter::error() const
+{
+    std::lock_guard<std::mutex> lck(state_->lock);
+    return state_->error;
+}
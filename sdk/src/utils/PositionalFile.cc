@@ -0,0 +1,294 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PositionalFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+using namespace AlibabaCloud::OSS;
+
+namespace
+{
+    //bytes collected before an O_DIRECT write
+    const size_t DirectIOBufferSize = 1024 * 1024;
+}
+
+const int64_t PositionalFile::DirectIOAlignment;
+
+PositionalFile::PositionalFile(const std::string &path, bool directIO) :
+    fd_(-1),
+    directFd_(-1)
+{
+#ifdef _WIN32
+    if (_sopen_s(&fd_, path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0) {
+        fd_ = -1;
+    }
+    (void)directIO;
+#else
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+#if defined(O_DIRECT)
+    //not every file system supports it (e.g. tmpfs), the buffered fd is used then
+    if (fd_ >= 0 && directIO) {
+        directFd_ = ::open(path.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+    }
+#else
+    (void)directIO;
+#endif
+#endif
+}
+
+PositionalFile::~PositionalFile()
+{
+#ifdef _WIN32
+    if (fd_ >= 0) {
+        _close(fd_);
+    }
+#else
+    if (directFd_ >= 0) {
+        ::close(directFd_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+bool PositionalFile::preallocate(int64_t size)
+{
+    if (fd_ < 0 || size <= 0) {
+        return false;
+    }
+#if defined(__linux__)
+    //unlike posix_fallocate, never falls back to writing zeros
+    return ::fallocate(fd_, 0, 0, static_cast<off_t>(size)) == 0;
+#else
+    return false;
+#endif
+}
+
+bool PositionalFile::writeAll(int fd, const char *data, int64_t size, int64_t offset)
+{
+    while (size > 0) {
+#ifdef _WIN32
+        unsigned int chunk = static_cast<unsigned int>((std::min)(size, static_cast<int64_t>(1 << 30)));
+        if (_lseeki64(fd, offset, SEEK_SET) < 0) {
+            return false;
+        }
+        int n = _write(fd, data, chunk);
+#else
+        ssize_t n = ::pwrite(fd, data, static_cast<size_t>(size), static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+bool PositionalFile::write(const char *data, int64_t size, int64_t offset)
+{
+    if (fd_ < 0) {
+        return false;
+    }
+#ifdef _WIN32
+    std::lock_guard<std::mutex> lck(lock_);
+#endif
+    return writeAll(fd_, data, size, offset);
+}
+
+bool PositionalFile::writeDirect(const char *data, int64_t size, int64_t offset)
+{
+    if (directFd_ < 0) {
+        return write(data, size, offset);
+    }
+    return writeAll(directFd_, data, size, offset);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    class PositionalWriteBuf : public std::streambuf
+    {
+    public:
+        PositionalWriteBuf(const std::shared_ptr<PositionalFile> &file, int64_t offset);
+        ~PositionalWriteBuf();
+
+    protected:
+        std::streamsize xsputn(const char *s, std::streamsize n) override;
+        int_type overflow(int_type c) override;
+        int sync() override;
+        pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which) override;
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+    private:
+        int64_t position() const { return bufferStart_ + static_cast<int64_t>(used_); }
+
+        std::shared_ptr<PositionalFile> file_;
+        int64_t offset_;
+        //O_DIRECT writes need an aligned buffer, offset and size
+        bool direct_;
+        char *aligned_;
+        size_t used_;
+        //stream position of aligned_[0], or of the next write without direct io
+        int64_t bufferStart_;
+    };
+}
+}
+
+PositionalWriteBuf::PositionalWriteBuf(const std::shared_ptr<PositionalFile> &file, int64_t offset) :
+    file_(file),
+    offset_(offset),
+    direct_(false),
+    aligned_(nullptr),
+    used_(0),
+    bufferStart_(0)
+{
+#ifndef _WIN32
+    if (file_->directIO() && (offset_ % PositionalFile::DirectIOAlignment) == 0) {
+        void *ptr = nullptr;
+        if (posix_memalign(&ptr, static_cast<size_t>(PositionalFile::DirectIOAlignment), DirectIOBufferSize) == 0) {
+            aligned_ = static_cast<char *>(ptr);
+            direct_ = true;
+        }
+    }
+#endif
+}
+
+PositionalWriteBuf::~PositionalWriteBuf()
+{
+    sync();
+    free(aligned_);
+}
+
+std::streamsize PositionalWriteBuf::xsputn(const char *s, std::streamsize n)
+{
+    if (!direct_) {
+        if (!file_->write(s, n, offset_ + bufferStart_)) {
+            return 0;
+        }
+        bufferStart_ += n;
+        return n;
+    }
+
+    std::streamsize copied = 0;
+    while (copied < n) {
+        size_t chunk = (std::min)(static_cast<size_t>(n - copied), DirectIOBufferSize - used_);
+        std::memcpy(aligned_ + used_, s + copied, chunk);
+        used_ += chunk;
+        copied += chunk;
+        if (used_ == DirectIOBufferSize) {
+            if (!file_->writeDirect(aligned_, DirectIOBufferSize, offset_ + bufferStart_)) {
+                return 0;
+            }
+            bufferStart_ += DirectIOBufferSize;
+            used_ = 0;
+        }
+    }
+    return n;
+}
+
+PositionalWriteBuf::int_type PositionalWriteBuf::overflow(int_type c)
+{
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+        return traits_type::not_eof(c);
+    }
+    char ch = traits_type::to_char_type(c);
+    return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+}
+
+int PositionalWriteBuf::sync()
+{
+    if (!direct_ || used_ == 0) {
+        return 0;
+    }
+    //the aligned head goes with O_DIRECT, the tail with a plain write. The tail stays
+    //buffered, so later data still starts on an aligned offset
+    size_t head = used_ - used_ % static_cast<size_t>(PositionalFile::DirectIOAlignment);
+    size_t tail = used_ - head;
+    if (head > 0 && !file_->writeDirect(aligned_, head, offset_ + bufferStart_)) {
+        return -1;
+    }
+    if (tail > 0 && !file_->write(aligned_ + head, tail, offset_ + bufferStart_ + head)) {
+        return -1;
+    }
+    if (head > 0) {
+        std::memmove(aligned_, aligned_ + head, tail);
+        bufferStart_ += head;
+        used_ = tail;
+    }
+    return 0;
+}
+
+PositionalWriteBuf::pos_type PositionalWriteBuf::seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::out) || way == std::ios_base::end) {
+        return pos_type(off_type(-1));
+    }
+    int64_t target = (way == std::ios_base::cur) ? position() + off : off;
+    if (way == std::ios_base::cur && off == 0) {
+        //tellp
+        return pos_type(off_type(target));
+    }
+    if (target < 0 || sync() != 0) {
+        return pos_type(off_type(-1));
+    }
+    //the buffered bytes are written, continue from the target
+    direct_ = direct_ && (target % PositionalFile::DirectIOAlignment) == 0;
+    bufferStart_ = target;
+    used_ = 0;
+    return pos_type(off_type(target));
+}
+
+PositionalWriteBuf::pos_type PositionalWriteBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+PositionalWriteStream::PositionalWriteStream(const std::shared_ptr<PositionalFile> &file, int64_t offset) :
+    std::iostream(nullptr),
+    buf_(new PositionalWriteBuf(file, offset))
+{
+    rdbuf(buf_);
+    if (!file->isOpen()) {
+        setstate(std::ios_base::badbit);
+    }
+}
+
+PositionalWriteStream::~PositionalWriteStream()
+{
+    delete buf_;
+}
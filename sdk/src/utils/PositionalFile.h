@@ -0,0 +1,81 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /**
+    * A file opened once and written at explicit offsets (pwrite), shared by
+    * the parts of a parallel download, so the writers neither seek nor
+    * serialize on a file position. With directIO the file is also opened
+    * with O_DIRECT (Linux only), which the streams use for block aligned writes.
+    */
+    class PositionalFile
+    {
+    public:
+        static const int64_t DirectIOAlignment = 4096;
+
+        PositionalFile(const std::string &path, bool directIO = false);
+        ~PositionalFile();
+
+        bool isOpen() const { return fd_ >= 0; }
+        bool directIO() const { return directFd_ >= 0; }
+
+        /*reserves the disk blocks up front, false when not supported*/
+        bool preallocate(int64_t size);
+        /*returns false unless all the bytes are written*/
+        bool write(const char *data, int64_t size, int64_t offset);
+        /*data, size and offset must be DirectIOAlignment aligned*/
+        bool writeDirect(const char *data, int64_t size, int64_t offset);
+
+    private:
+        PositionalFile(const PositionalFile &) = delete;
+        PositionalFile &operator = (const PositionalFile &) = delete;
+        static bool writeAll(int fd, const char *data, int64_t size, int64_t offset);
+
+        int fd_;
+        int directFd_;
+#ifdef _WIN32
+        //no pwrite, the seek and the write have to stay together
+        std::mutex lock_;
+#endif
+    };
+
+    class PositionalWriteBuf;
+
+    /**
+    * Write only stream over a PositionalFile starting at offset, positions are
+    * relative to it. Used as the response body of a range download part.
+    */
+    class PositionalWriteStream : public std::iostream
+    {
+    public:
+        PositionalWriteStream(const std::shared_ptr<PositionalFile> &file, int64_t offset);
+        ~PositionalWriteStream();
+    private:
+        PositionalWriteBuf *buf_;
+    };
+}
+}
@@ -16,7 +16,7 @@
 
 #include "SignUtils.h"
 #include "Utils.h"
-#include <sstream>
+#include <cctype>
 #include <map>
 #include <set>
 #include <alibabacloud/oss/Const.h>
@@ -36,29 +36,58 @@ const static std::set<std::string> ParamtersToSign =
     "callback", "callback-var", "tagging", "policy", "requestPayment", "x-oss-traffic-limit"
 };
 
-SignUtils::SignUtils(const std::string &version):
-    signVersion_(version),
-    canonicalString_()
+//the range of str without the leading and trailing white spaces, as Trim does
+static void TrimmedRange(const std::string &str, size_t &first, size_t &last)
 {
+    first = 0;
+    last = str.size();
+    while (first < last && ::isspace(static_cast<unsigned char>(str[first]))) {
+        first++;
+    }
+    while (last > first && ::isspace(static_cast<unsigned char>(str[last - 1]))) {
+        last--;
+    }
 }
 
-SignUtils::~SignUtils()
+static bool IsOssHeader(const std::string &name, size_t first, size_t last)
 {
+    static const char prefix[] = "x-oss-";
+    if (last - first < sizeof(prefix) - 1) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(prefix) - 1; i++) {
+        if (::tolower(static_cast<unsigned char>(name[first + i])) != prefix[i]) {
+            return false;
+        }
+    }
+    return true;
 }
 
-const std::string &SignUtils::CanonicalString() const
+static const std::string *FindHeader(const HeaderCollection &headers, const char *name)
 {
-    return canonicalString_;
+    auto it = headers.find(name);
+    return it != headers.end() ? &it->second : nullptr;
 }
 
-void SignUtils::build(const std::string &method, 
-                      const std::string &resource, 
-                      const std::string &date,
-                      const HeaderCollection &headers,
-                      const ParameterCollection &parameters)
+static const std::string *FindHeader(const HeaderList &headers, const char *name)
 {
-    std::stringstream ss;
+    return headers.find(name);
+}
+
+static const std::string &HeaderName(const HeaderCollection::value_type &header) { return header.first; }
+static const std::string &HeaderValue(const HeaderCollection::value_type &header) { return header.second; }
+static const std::string &HeaderName(const HeaderList::Entry &header) { return header.name(); }
+static const std::string &HeaderValue(const HeaderList::Entry &header) { return header.value(); }
 
+/*both header containers iterate in the order of caseInsensitiveLess*/
+template <typename Headers>
+static void BuildCanonical(std::string &out,
+                           const std::string &method,
+                           const std::string &resource,
+                           const std::string &date,
+                           const Headers &headers,
+                           const ParameterCollection &parameters)
+{
     /*Version 1*/
     // VERB + "\n" +
     // Content-MD5 + "\n"  +
@@ -67,57 +96,104 @@ void SignUtils::build(const std::string &method,
     // CanonicalizedOSSHeaders +
     // CanonicalizedResource) +
 
+    //appended in place, the buffer is reused when the same object builds again
+    out.clear();
+    out.reserve(method.size() + date.size() + resource.size() + 256);
+
     //common headers
-    ss << method << "\n";
-    if (headers.find(Http::CONTENT_MD5) != headers.end()) {
-        ss << headers.at(Http::CONTENT_MD5);
+    out.append(method).push_back('\n');
+    auto value = FindHeader(headers, Http::CONTENT_MD5);
+    if (value != nullptr) {
+        out.append(*value);
     }
-    ss << "\n";
-    if (headers.find(Http::CONTENT_TYPE) != headers.end()) {
-        ss << headers.at(Http::CONTENT_TYPE);
+    out.push_back('\n');
+    value = FindHeader(headers, Http::CONTENT_TYPE);
+    if (value != nullptr) {
+        out.append(*value);
     }
-    ss << "\n";
+    out.push_back('\n');
     //Date or EXPIRES
-    ss << date << "\n";
+    out.append(date).push_back('\n');
 
     //CanonicalizedOSSHeaders, start with x-oss-
     for (const auto &header : headers) {
-        std::string lower = Trim(ToLower(header.first.c_str()).c_str());
-        if (lower.compare(0, 6, "x-oss-", 6) == 0) {
-            std::string value = Trim(header.second.c_str());
-            ss << lower << ":" << value << "\n";
+        const std::string &name = HeaderName(header);
+        size_t first, last;
+        TrimmedRange(name, first, last);
+        if (!IsOssHeader(name, first, last)) {
+            continue;
+        }
+        for (size_t i = first; i < last; i++) {
+            out.push_back(static_cast<char>(::tolower(static_cast<unsigned char>(name[i]))));
         }
+        out.push_back(':');
+        const std::string &headerValue = HeaderValue(header);
+        TrimmedRange(headerValue, first, last);
+        out.append(headerValue, first, last - first).push_back('\n');
     }
 
     //CanonicalizedResource, the sub resouce in
-    ss << resource;
+    out.append(resource);
     char separator = '?';
     for (auto const& param : parameters) {
         if (ParamtersToSign.find(param.first) == ParamtersToSign.end()) {
             continue;
         }
 
-        ss << separator;
-        ss << param.first;
+        out.push_back(separator);
+        out.append(param.first);
         if (!param.second.empty()) {
-            ss << "=" << param.second;
+            out.push_back('=');
+            out.append(param.second);
         }
         separator = '&';
     }
+}
 
-    canonicalString_ = ss.str();
+SignUtils::SignUtils(const std::string &version):
+    signVersion_(version),
+    canonicalString_()
+{
+}
+
+SignUtils::~SignUtils()
+{
+}
+
+const std::string &SignUtils::CanonicalString() const
+{
+    return canonicalString_;
+}
+
+void SignUtils::build(const std::string &method, 
+                      const std::string &resource, 
+                      const std::string &date,
+                      const HeaderCollection &headers,
+                      const ParameterCollection &parameters)
+{
+    BuildCanonical(canonicalString_, method, resource, date, headers, parameters);
+}
+
+void SignUtils::build(const std::string &method,
+                      const std::string &resource,
+                      const std::string &date,
+                      const HeaderList &headers,
+                      const ParameterCollection &parameters)
+{
+    BuildCanonical(canonicalString_, method, resource, date, headers, parameters);
 }
 
 void SignUtils::build(const std::string &expires,
     const std::string &resource,
     const ParameterCollection &parameters)
 {
-    std::stringstream ss;
-    ss << expires << '\n';
+    std::string &out = canonicalString_;
+    out.clear();
+    out.append(expires).push_back('\n');
     for(auto const& param : parameters)
     {
-        ss << param.first << ":" << param.second << '\n';
+        out.append(param.first).push_back(':');
+        out.append(param.second).push_back('\n');
     }
-    ss << resource;
-    canonicalString_ = ss.str();
+    out.append(resource);
 }
@@ -22,6 +22,7 @@
 #include <ctime>
 #include <iostream>
 #include <alibabacloud/oss/Types.h>
+#include "../http/HeaderList.h"
 
 namespace AlibabaCloud
 {
@@ -37,6 +38,11 @@ namespace OSS
                    const std::string &date,
                    const HeaderCollection &headers,
                    const ParameterCollection &parameters);
+        void build(const std::string &method,
+                   const std::string &resource,
+                   const std::string &date,
+                   const HeaderList &headers,
+                   const ParameterCollection &parameters);
         void build(const std::string &expires,
                     const std::string &resource,
                     const ParameterCollection &parameters);
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TransferManager.h"
+#include "LogUtils.h"
+
+using namespace AlibabaCloud::OSS;
+
+static const char *TAG = "TransferManager";
+
+namespace
+{
+    const size_t PriorityClassNum = 3;
+
+    size_t ClassIndex(TransferPriority priority)
+    {
+        size_t index = static_cast<size_t>(priority);
+        return index < PriorityClassNum ? index : PriorityClassNum - 1;
+    }
+}
+
+TransferManager::TransferManager(int threadNum, uint64_t maxInflightBytes) :
+    threadNum_(threadNum),
+    maxInflightBytes_(maxInflightBytes),
+    classes_(PriorityClassNum),
+    inflightBytes_(0),
+    inflightParts_(0),
+    started_(false),
+    shutdown_(false)
+{
+    if (threadNum_ <= 0) {
+        threadNum_ = static_cast<int>(std::thread::hardware_concurrency());
+        threadNum_ = threadNum_ > 0 ? threadNum_ : 1;
+    }
+}
+
+TransferManager::~TransferManager()
+{
+    shutdown();
+}
+
+void TransferManager::start()
+{
+    //called with lock_ held
+    for (int i = 0; i < threadNum_; i++) {
+        workers_.emplace_back(&TransferManager::workerMain, this);
+    }
+    started_ = true;
+    OSS_LOG(LogLevel::LogDebug, TAG, "manager(%p) start %d workers, max inflight bytes:%llu",
+        this, threadNum_, static_cast<unsigned long long>(maxInflightBytes_));
+}
+
+TransferManager::State TransferManager::run(TransferPriority priority, const TakeHandler& take)
+{
+    std::unique_lock<std::mutex> lck(lock_);
+    if (shutdown_) {
+        lck.unlock();
+        OSS_LOG(LogLevel::LogWarn, TAG, "manager(%p) is shutdown, run the parts in caller thread", this);
+        Task task;
+        State state;
+        while ((state = take(task)) == Ready) {
+            task.run();
+        }
+        return state;
+    }
+    if (!started_) {
+        start();
+    }
+
+    Transfer transfer;
+    transfer.take = &take;
+    transfer.active = 0;
+    transfer.done = false;
+    transfer.result = Done;
+    transfer.hasPending = false;
+    auto &transfers = classes_[ClassIndex(priority)];
+    auto it = transfers.insert(transfers.end(), &transfer);
+    cv_.notify_all();
+
+    transfer.cv.wait(lck, [&transfer] {
+        return transfer.done && transfer.active == 0 && !transfer.hasPending;
+    });
+    transfers.erase(it);
+    if (shutdown_) {
+        cv_.notify_all();
+    }
+    if (transfer.result != Done) {
+        OSS_LOG(LogLevel::LogError, TAG, "manager(%p) transfer(%p) is busy with no part in flight, stop it", this, &transfer);
+    }
+    return transfer.result;
+}
+
+bool TransferManager::fits(uint64_t bytes) const
+{
+    return maxInflightBytes_ == 0 || inflightParts_ == 0 || inflightBytes_ + bytes <= maxInflightBytes_;
+}
+
+bool TransferManager::schedule(Transfer*& owner, Task& task)
+{
+    //called with lock_ held
+    for (auto &transfers : classes_) {
+        for (auto it = transfers.begin(); it != transfers.end(); ++it) {
+            Transfer* transfer = *it;
+            if (transfer->hasPending) {
+                if (!fits(transfer->pending.bytes)) {
+                    return false;
+                }
+                task = std::move(transfer->pending);
+                transfer->hasPending = false;
+            }
+            else {
+                if (transfer->done) {
+                    continue;
+                }
+                State state = (*transfer->take)(task);
+                if (state == Busy && transfer->active > 0) {
+                    continue;
+                }
+                if (state != Ready) {
+                    //busy with nothing in flight would never be asked again, the transfer stops unfinished
+                    transfer->done = true;
+                    transfer->result = state;
+                    if (transfer->active == 0) {
+                        transfer->cv.notify_all();
+                    }
+                    continue;
+                }
+                if (!fits(task.bytes)) {
+                    transfer->pending = std::move(task);
+                    transfer->hasPending = true;
+                    return false;
+                }
+            }
+            transfer->active++;
+            inflightParts_++;
+            inflightBytes_ += task.bytes;
+            //the others of the class go first next time
+            transfers.splice(transfers.end(), transfers, it);
+            owner = transfer;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TransferManager::workerMain()
+{
+    std::unique_lock<std::mutex> lck(lock_);
+    for (;;) {
+        Transfer* owner = nullptr;
+        Task task;
+        if (!schedule(owner, task)) {
+            bool idle = true;
+            for (const auto &transfers : classes_) {
+                idle = idle && transfers.empty();
+            }
+            if (shutdown_ && idle) {
+                break;
+            }
+            cv_.wait(lck);
+            continue;
+        }
+
+        lck.unlock();
+        task.run();
+        task.run = nullptr;
+        lck.lock();
+
+        owner->active--;
+        inflightParts_--;
+        inflightBytes_ -= task.bytes;
+        if (owner->done && owner->active == 0 && !owner->hasPending) {
+            owner->cv.notify_all();
+        }
+        //a slot of the transfer and some bytes are free
+        cv_.notify_all();
+    }
+}
+
+void TransferManager::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        if (shutdown_) {
+            return;
+        }
+        shutdown_ = true;
+    }
+    cv_.notify_all();
+
+    //the transfers still running are finished by the workers before they exit
+    for (auto &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    OSS_LOG(LogLevel::LogDebug, TAG, "manager(%p) shutdown", this);
+}
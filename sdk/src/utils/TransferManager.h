@@ -0,0 +1,103 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <alibabacloud/oss/Types.h>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /**
+    * Runs the parts of all the resumable transfers of a client on one pool of worker
+    * threads. A transfer hands out its parts one at a time when a worker asks for them,
+    * so it decides the part size and its own parts in flight at that moment. The higher
+    * priority classes are served first, the transfers of a class take turns part by part.
+    * The bytes of the parts in flight are kept under maxInflightBytes, a part that does
+    * not fit waits at the head of the line for the running ones to finish, a single part
+    * always runs.
+    */
+    class TransferManager
+    {
+    public:
+        enum State
+        {
+            Ready,  //a part is taken
+            Busy,   //no part can start now, ask again when a part of the transfer ends
+            Done    //no part is left to start
+        };
+        struct Task
+        {
+            uint64_t bytes;
+            std::function<void()> run;
+        };
+        /*called under the lock of the manager, must not block nor call the manager*/
+        typedef std::function<State(Task& task)> TakeHandler;
+
+        TransferManager(int threadNum = 0, uint64_t maxInflightBytes = 0);
+        ~TransferManager();
+
+        /*
+        * runs the parts of a transfer until take returns Done, then waits for the ones in flight.
+        * Returns Done, or Busy when take was busy with no part of the transfer in flight, which
+        * nothing would ask again, so the transfer stopped with parts left.
+        */
+        State run(TransferPriority priority, const TakeHandler& take);
+        void shutdown();
+
+        int ThreadNum() const { return threadNum_; }
+        uint64_t MaxInflightBytes() const { return maxInflightBytes_; }
+
+    private:
+        TransferManager(const TransferManager&) = delete;
+        TransferManager& operator=(const TransferManager&) = delete;
+        struct Transfer
+        {
+            const TakeHandler* take;
+            int active;
+            bool done;
+            State result;
+            bool hasPending;
+            Task pending;
+            std::condition_variable cv;
+        };
+        void start();
+        void workerMain();
+        bool schedule(Transfer*& owner, Task& task);
+        bool fits(uint64_t bytes) const;
+
+        int threadNum_;
+        uint64_t maxInflightBytes_;
+        std::vector<std::thread> workers_;
+        std::mutex lock_;
+        std::condition_variable cv_;
+        /*by priority class, the next transfer to serve at the front*/
+        std::vector<std::list<Transfer*>> classes_;
+        uint64_t inflightBytes_;
+        int inflightParts_;
+        bool started_;
+        bool shutdown_;
+    };
+}
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TransferTuner.h"
+#include <algorithm>
+#include <chrono>
+#include "LogUtils.h"
+
+using namespace AlibabaCloud::OSS;
+
+static const char *TAG = "TransferTuner";
+
+namespace
+{
+    /*a round with 10% more throughput than the best one is faster*/
+    const double GainRatio = 1.1;
+    /*a round under 70% of the best one is congestion*/
+    const double DropRatio = 0.7;
+    const int PlateauProbeRounds = 4;
+}
+
+const int64_t TransferTuner::TargetPartUs;
+
+TransferTuner::TransferTuner(int threadNum) :
+    adaptive_(false),
+    maxConcurrency_(std::max(threadNum, 1)),
+    maxChunks_(1),
+    concurrency_(maxConcurrency_),
+    chunks_(1),
+    active_(0),
+    slowStart_(false),
+    probing_(false),
+    best_(0.0),
+    plateauRounds_(0),
+    roundStart_(-1),
+    roundParts_(0),
+    roundFailures_(0),
+    roundBytes_(0),
+    roundPartUs_(0)
+{
+}
+
+TransferTuner::TransferTuner(int concurrency, int maxConcurrency, int maxChunks) :
+    adaptive_(true),
+    maxConcurrency_(std::max(maxConcurrency, 1)),
+    maxChunks_(std::max(maxChunks, 1)),
+    concurrency_(std::min(std::max(concurrency, 1), maxConcurrency_)),
+    chunks_(1),
+    active_(0),
+    slowStart_(true),
+    probing_(false),
+    best_(0.0),
+    plateauRounds_(0),
+    roundStart_(-1),
+    roundParts_(0),
+    roundFailures_(0),
+    roundBytes_(0),
+    roundPartUs_(0)
+{
+}
+
+bool TransferTuner::acquire(int64_t& start)
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    if (active_ >= concurrency_) {
+        return false;
+    }
+    active_++;
+    start = nowUs();
+    if (roundStart_ < 0) {
+        roundStart_ = start;
+    }
+    return true;
+}
+
+void TransferTuner::release(int64_t start, uint64_t bytes, bool success)
+{
+    int64_t now = nowUs();
+    std::lock_guard<std::mutex> lck(lock_);
+    active_--;
+    if (adaptive_ && (bytes > 0 || !success)) {
+        roundParts_++;
+        roundBytes_ += bytes;
+        roundPartUs_ += now - start;
+        if (!success) {
+            roundFailures_++;
+        }
+        if (roundParts_ >= concurrency_) {
+            endRound(now);
+        }
+    }
+}
+
+void TransferTuner::endRound(int64_t now)
+{
+    double throughput = static_cast<double>(roundBytes_) / std::max<int64_t>(now - roundStart_, 1);
+    int64_t partUs = roundPartUs_ / roundParts_;
+    int previous = concurrency_;
+    if (roundFailures_ > 0) {
+        concurrency_ = std::max(concurrency_ / 2, 1);
+        slowStart_ = false;
+        probing_ = false;
+        best_ = 0.0;
+        plateauRounds_ = 0;
+    }
+    else if (throughput > best_ * GainRatio) {
+        best_ = throughput;
+        probing_ = false;
+        plateauRounds_ = 0;
+        concurrency_ = std::min(slowStart_ ? concurrency_ * 2 : concurrency_ + 1, maxConcurrency_);
+    }
+    else if (throughput < best_ * DropRatio) {
+        concurrency_ = std::max(concurrency_ - concurrency_ / 4, 1);
+        slowStart_ = false;
+        probing_ = false;
+        best_ = throughput;
+        plateauRounds_ = 0;
+    }
+    else {
+        slowStart_ = false;
+        if (probing_) {
+            //the last step did not pay
+            concurrency_ = std::max(concurrency_ - 1, 1);
+            probing_ = false;
+        }
+        else if (++plateauRounds_ >= PlateauProbeRounds && concurrency_ < maxConcurrency_) {
+            concurrency_++;
+            probing_ = true;
+            plateauRounds_ = 0;
+        }
+    }
+    if (roundFailures_ == 0) {
+        if (partUs < TargetPartUs / 2) {
+            chunks_ = std::min(chunks_ * 2, maxChunks_);
+        }
+        else if (partUs > TargetPartUs * 2) {
+            chunks_ = std::max(chunks_ / 2, 1);
+        }
+    }
+    OSS_LOG(LogLevel::LogDebug, TAG, "tuner(%p) round of %d parts, %.1f MB/s, %lld ms per part, failures:%d, concurrency:%d->%d, chunks:%d",
+        this, roundParts_, throughput, static_cast<long long>(partUs / 1000), roundFailures_, previous, concurrency_, chunks_);
+
+    roundStart_ = now;
+    roundParts_ = 0;
+    roundFailures_ = 0;
+    roundBytes_ = 0;
+    roundPartUs_ = 0;
+}
+
+int TransferTuner::chunks(size_t pendingChunks) const
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    size_t perSlot = pendingChunks / static_cast<size_t>(concurrency_);
+    return static_cast<int>(std::max<size_t>(1, std::min(static_cast<size_t>(chunks_), perSlot)));
+}
+
+int TransferTuner::Concurrency() const
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    return concurrency_;
+}
+
+int TransferTuner::Chunks() const
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    return chunks_;
+}
+
+int64_t TransferTuner::nowUs() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
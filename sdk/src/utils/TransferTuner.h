@@ -0,0 +1,86 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /**
+    * Paces the parts of a resumable transfer. A slot is taken before each part, so
+    * at most Concurrency() parts are in flight. A fixed tuner keeps the
+    * caller's thread number. An adaptive one measures the throughput of each round,
+    * as many parts as the concurrency, and ramps the concurrency like a congestion
+    * window: doubling while the rounds get faster, then one step at a time, back by a
+    * quarter when the throughput drops and by half when a part fails. After a few
+    * rounds at a plateau it probes one step higher again. Parts much shorter than
+    * TargetPartUs are merged from more chunks of the part layout, much longer ones
+    * from fewer, so the per request overhead stays small on a fast link.
+    */
+    class TransferTuner
+    {
+    public:
+        static const int64_t TargetPartUs = 1000 * 1000;
+
+        explicit TransferTuner(int threadNum);
+        TransferTuner(int concurrency, int maxConcurrency, int maxChunks);
+        virtual ~TransferTuner() = default;
+
+        /*takes a free slot and the start of the part, false if all of them are in use*/
+        bool acquire(int64_t& start);
+        /*frees the slot of a part, bytes 0 for a slot that sent nothing*/
+        void release(int64_t start, uint64_t bytes, bool success);
+        /*the chunks the next part is made of, fewer near the end to keep the parts in flight*/
+        int chunks(size_t pendingChunks) const;
+
+        bool adaptive() const { return adaptive_; }
+        int MaxConcurrency() const { return maxConcurrency_; }
+        int Concurrency() const;
+        int Chunks() const;
+
+    protected:
+        virtual int64_t nowUs() const;
+
+    private:
+        TransferTuner(const TransferTuner&) = delete;
+        TransferTuner& operator=(const TransferTuner&) = delete;
+        void endRound(int64_t now);
+
+        const bool adaptive_;
+        const int maxConcurrency_;
+        const int maxChunks_;
+        mutable std::mutex lock_;
+        int concurrency_;
+        int chunks_;
+        int active_;
+        bool slowStart_;
+        bool probing_;
+        double best_;
+        int plateauRounds_;
+        /*the current round*/
+        int64_t roundStart_;
+        int roundParts_;
+        int roundFailures_;
+        uint64_t roundBytes_;
+        int64_t roundPartUs_;
+    };
+}
+}
@@ -31,6 +31,9 @@
 #include <alibabacloud/oss/Const.h>
 #include <alibabacloud/oss/http/HttpType.h>
 #include "../http/Url.h"
+#include "Codec.h"
+#include "Crc64.h"
+#include "MultiBufferMD5.h"
 
 using namespace AlibabaCloud::OSS;
 
@@ -41,52 +44,16 @@ std::string AlibabaCloud::OSS::GenerateUuid()
 
 std::string AlibabaCloud::OSS::UrlEncode(const std::string & src)
 {
-    std::stringstream dest;
-    static const char *hex = "0123456789ABCDEF";
-    unsigned char c;
-
-    for (size_t i = 0; i < src.size(); i++) {
-        c = src[i];
-        if (isalnum(c) || (c == '-') || (c == '_') || (c == '.') || (c == '~')) {
-            dest << c;
-        } else if (c == ' ') {
-            dest << "%20";
-        } else {
-            dest << '%' << hex[c >> 4] << hex[c & 15];
-        }
-    }
-
-    return dest.str();
+    std::string dest;
+    Codec::UrlEncode(src.data(), src.size(), dest);
+    return dest;
 }
 
 std::string AlibabaCloud::OSS::UrlDecode(const std::string & src)
 {
-    std::stringstream unescaped;
-    unescaped.fill('0');
-    unescaped << std::hex;
-
-    size_t safeLength = src.size();
-    const char *safe = src.c_str();
-    for (auto i = safe, n = safe + safeLength; i != n; ++i)
-    {
-        char c = *i;
-        if(c == '%')
-        {
-            char hex[3];
-            hex[0] = *(i + 1);
-            hex[1] = *(i + 2);
-            hex[2] = 0;
-            i += 2;
-            auto hexAsInteger = strtol(hex, nullptr, 16);
-            unescaped << (char)hexAsInteger;
-        }
-        else
-        {
-            unescaped << *i;
-        }
-    }
-
-    return unescaped.str();
+    std::string dest;
+    Codec::UrlDecode(src.data(), src.size(), dest);
+    return dest;
 }
 
 std::string AlibabaCloud::OSS::Base64Encode(const std::string &src)
@@ -96,41 +63,12 @@ std::string AlibabaCloud::OSS::Base64Encode(const std::string &src)
 
 std::string AlibabaCloud::OSS::Base64Encode(const char *src, int len)
 {
-    if (!src || len == 0) {
+    if (!src || len <= 0) {
         return "";
     }
-
-    static const char *ENC = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    auto in = reinterpret_cast<const unsigned char *>(src);
-    auto inLen = len;
-    std::stringstream ss;
-    while (inLen) {
-        // first 6 bits of char 1
-        ss << ENC[*in >> 2];
-        if (!--inLen) {
-            // last 2 bits of char 1, 4 bits of 0
-            ss << ENC[(*in & 0x3) << 4];
-            ss << '=';
-            ss << '=';
-            break;
-        }
-        // last 2 bits of char 1, first 4 bits of char 2
-        ss << ENC[((*in & 0x3) << 4) | (*(in + 1) >> 4)];
-        in++;
-        if (!--inLen) {
-            // last 4 bits of char 2, 2 bits of 0
-            ss << ENC[(*in & 0xF) << 2];
-            ss << '=';
-            break;
-        }
-        // last 4 bits of char 2, first 2 bits of char 3
-        ss << ENC[((*in & 0xF) << 2) | (*(in + 1) >> 6)];
-        in++;
-        // last 6 bits of char 3
-        ss << ENC[*in & 0x3F];
-        in++, inLen--;
-    }
-    return ss.str();
+    std::string dest;
+    Codec::Base64Encode(src, static_cast<size_t>(len), dest);
+    return dest;
 }
 
 std::string AlibabaCloud::OSS::Base64EncodeUrlSafe(const std::string &src)
@@ -172,11 +110,10 @@ std::string AlibabaCloud::OSS::ComputeContentMD5(const char * data, size_t size)
     return encodedData;
 }
 
-std::string AlibabaCloud::OSS::ComputeContentMD5(std::istream& stream) 
+/*hashes the whole stream from its start, or size bytes from the read position, and restores the position*/
+static unsigned int DigestStream(std::istream& stream, int64_t size, unsigned char *md, uint64_t *crc64)
 {
     auto ctx = EVP_MD_CTX_create();
-
-    unsigned char md_value[EVP_MAX_MD_SIZE];
     unsigned int md_len = 0;
 
     EVP_MD_CTX_init(ctx);
@@ -190,37 +127,123 @@ std::string AlibabaCloud::OSS::ComputeContentMD5(std::istream& stream)
         currentPos = 0;
         stream.clear();
     }
-    stream.seekg(0, stream.beg);
+    if (size < 0) {
+        stream.seekg(0, stream.beg);
+    }
 
-    char streamBuffer[2048];
-    while (stream.good())
+    //reused by the calls on this thread, fewer trips through the stream than 2KB reads
+    static thread_local std::vector<char> streamBuffer(64 * 1024);
+    uint64_t crc = 0;
+    int64_t left = size;
+    while (stream.good() && left != 0)
     {
-        stream.read(streamBuffer, 2048);
+        int64_t wanted = static_cast<int64_t>(streamBuffer.size());
+        if (left > 0 && left < wanted) {
+            wanted = left;
+        }
+        stream.read(streamBuffer.data(), static_cast<std::streamsize>(wanted));
         auto bytesRead = stream.gcount();
+        if (left > 0) {
+            left -= bytesRead;
+        }
 
         if (bytesRead > 0)
         {
-            EVP_DigestUpdate(ctx, streamBuffer, static_cast<size_t>(bytesRead));
+            EVP_DigestUpdate(ctx, streamBuffer.data(), static_cast<size_t>(bytesRead));
+            if (crc64 != nullptr) {
+                crc = CRC64::CalcCRC(crc, streamBuffer.data(), static_cast<size_t>(bytesRead));
+            }
         }
     }
 
-    EVP_DigestFinal_ex(ctx, md_value, &md_len);
+    EVP_DigestFinal_ex(ctx, md, &md_len);
     EVP_MD_CTX_destroy(ctx);
     stream.clear();
     stream.seekg(currentPos, stream.beg);
+    if (crc64 != nullptr) {
+        *crc64 = crc;
+    }
+    return md_len;
+}
+
+std::string AlibabaCloud::OSS::ComputeContentMD5(std::istream& stream) 
+{
+    unsigned char md_value[EVP_MAX_MD_SIZE];
+    unsigned int md_len = DigestStream(stream, -1, md_value, nullptr);
 
     //Based64
     char encodedData[100];
     EVP_EncodeBlock(reinterpret_cast<unsigned char*>(encodedData), md_value, md_len);
     return encodedData;
 }
+
+std::string AlibabaCloud::OSS::ComputeContentMD5(std::istream& stream, int64_t size, uint64_t* crc64)
+{
+    unsigned char md_value[EVP_MAX_MD_SIZE];
+    unsigned int md_len = DigestStream(stream, size, md_value, crc64);
+
+    char encodedData[100];
+    EVP_EncodeBlock(reinterpret_cast<unsigned char*>(encodedData), md_value, md_len);
+    return encodedData;
+}
+
+std::vector<std::string> AlibabaCloud::OSS::ComputeContentMD5(const std::vector<std::shared_ptr<std::iostream>>& contents)
+{
+    //bodies up to this size are read into memory and hashed four at a time
+    const int64_t MultiBufferLimit = 4 * 1024 * 1024;
+
+    std::vector<std::string> md5s(contents.size());
+    std::vector<std::string> datas;
+    std::vector<size_t> indexes;
+    datas.reserve(contents.size());
+    for (size_t i = 0; i < contents.size(); i++) {
+        auto &content = contents[i];
+        if (content == nullptr) {
+            continue;
+        }
+        auto currentPos = content->tellg();
+        if (currentPos == static_cast<std::streampos>(-1)) {
+            currentPos = 0;
+            content->clear();
+        }
+        content->seekg(0, content->end);
+        int64_t size = static_cast<int64_t>(content->tellg());
+        if (size < 0 || size > MultiBufferLimit) {
+            content->clear();
+            content->seekg(currentPos, content->beg);
+            md5s[i] = ComputeContentMD5(*content);
+            continue;
+        }
+        std::string data(static_cast<size_t>(size), '\0');
+        content->seekg(0, content->beg);
+        content->read(&data[0], size);
+        data.resize(static_cast<size_t>(content->gcount()));
+        content->clear();
+        content->seekg(currentPos, content->beg);
+        datas.push_back(std::move(data));
+        indexes.push_back(i);
+    }
+
+    std::vector<MD5Buffer> buffers(datas.size());
+    for (size_t i = 0; i < datas.size(); i++) {
+        buffers[i].data = datas[i].data();
+        buffers[i].size = datas[i].size();
+    }
+    MD5MultiBuffer(buffers.data(), buffers.size());
+
+    for (size_t i = 0; i < buffers.size(); i++) {
+        char encodedData[100];
+        EVP_EncodeBlock(reinterpret_cast<unsigned char*>(encodedData), buffers[i].digest, sizeof(buffers[i].digest));
+        md5s[indexes[i]] = encodedData;
+    }
+    return md5s;
+}
+
 static std::string HexToString(const unsigned char *data, size_t size)
-{ 
-    static char hex[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
-    std::stringstream ss;
-    for (size_t i = 0; i < size; i++)
-        ss << hex[(data[i] >> 4)] << hex[(data[i] & 0x0F)];
-    return ss.str();
+{
+    std::string dest;
+    Codec::HexEncode(data, size, dest);
+    return dest;
 }
 
 std::string AlibabaCloud::OSS::ComputeContentETag(const std::string& data)
@@ -241,42 +264,8 @@ std::string AlibabaCloud::OSS::ComputeContentETag(const char * data, size_t size
 
 std::string AlibabaCloud::OSS::ComputeContentETag(std::istream& stream)
 {
-    auto ctx = EVP_MD_CTX_create();
-
     unsigned char md_value[EVP_MAX_MD_SIZE];
-    unsigned int md_len = 0;
-
-    EVP_MD_CTX_init(ctx);
-#ifndef OPENSSL_IS_BORINGSSL 
-    EVP_MD_CTX_set_flags(ctx, EVP_MD_CTX_FLAG_NON_FIPS_ALLOW);
-#endif
-
-    EVP_DigestInit_ex(ctx, EVP_md5(), nullptr);
-
-    auto currentPos = stream.tellg();
-    if (currentPos == static_cast<std::streampos>(-1)) {
-        currentPos = 0;
-        stream.clear();
-    }
-    stream.seekg(0, stream.beg);
-
-    char streamBuffer[2048];
-    while (stream.good())
-    {
-        stream.read(streamBuffer, 2048);
-        auto bytesRead = stream.gcount();
-
-        if (bytesRead > 0)
-        {
-            EVP_DigestUpdate(ctx, streamBuffer, static_cast<size_t>(bytesRead));
-        }
-    }
-
-    EVP_DigestFinal_ex(ctx, md_value, &md_len);
-    EVP_MD_CTX_destroy(ctx);
-    stream.clear();
-    stream.seekg(currentPos, stream.beg);
-
+    unsigned int md_len = DigestStream(stream, -1, md_value, nullptr);
     return HexToString(md_value, md_len);
 }
 
@@ -370,7 +359,7 @@ bool AlibabaCloud::OSS::IsIp(const std::string &host)
     }
     return false;
 #else
-    std::regex ipPattern("((25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9][0-9]|[0-9])\\.){3}(25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9][0-9]|[0-9])");
+    static const std::regex ipPattern("((25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9][0-9]|[0-9])\\.){3}(25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9][0-9]|[0-9])");
     return std::regex_match(host, ipPattern);
 #endif
 }
@@ -452,7 +441,7 @@ bool AlibabaCloud::OSS::IsValidBucketName(const std::string &bucketName)
 #else
     if (bucketName.empty())
         return false;
-    std::regex ipPattern("^[a-z0-9][a-z0-9\\-]{1,61}[a-z0-9]$");
+    static const std::regex ipPattern("^[a-z0-9][a-z0-9\\-]{1,61}[a-z0-9]$");
     return std::regex_match(bucketName, ipPattern);
 #endif
 }
@@ -484,7 +473,7 @@ bool AlibabaCloud::OSS::IsValidBucketName(const std::string &bucketName)
      }
      return true;
 #else
-     std::regex ipPattern("^[a-zA-Z][a-zA-Z0-9\\-]{0,31}$");
+     static const std::regex ipPattern("^[a-zA-Z][a-zA-Z0-9\\-]{0,31}$");
      return std::regex_match(prefix, ipPattern);
 #endif
  }
@@ -728,7 +717,7 @@ std::string AlibabaCloud::OSS::CombinePathString(
     if (IsIp(url.host())) {
         path.append(bucket).append("/");
     }
-    path.append(UrlEncode(key));
+    Codec::UrlEncode(key.data(), key.size(), path);
     return path;
 }
 
@@ -751,17 +740,20 @@ std::string AlibabaCloud::OSS::CombineRTMPString(
 
 std::string AlibabaCloud::OSS::CombineQueryString(const ParameterCollection &parameters)
 {
-    std::stringstream ss;
-    if (!parameters.empty()) {
-        for (const auto &p : parameters)
-        {
-            if (p.second.empty())
-                ss << "&" << UrlEncode(p.first);
-            else
-                ss << "&" << UrlEncode(p.first) << "=" << UrlEncode(p.second);
+    std::string query;
+    bool first = true;
+    for (const auto &p : parameters) {
+        if (!first) {
+            query.push_back('&');
+        }
+        first = false;
+        Codec::UrlEncode(p.first.data(), p.first.size(), query);
+        if (!p.second.empty()) {
+            query.push_back('=');
+            Codec::UrlEncode(p.second.data(), p.second.size(), query);
         }
     }
-    return ss.str().substr(1);
+    return query;
 }
 
 std::streampos AlibabaCloud::OSS::GetIOStreamLength(std::iostream &stream)
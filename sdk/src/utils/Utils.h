@@ -19,6 +19,8 @@
 #include <string>
 #include <ctime>
 #include <iostream>
+#include <memory>
+#include <vector>
 #include <alibabacloud/oss/Types.h>
 
 namespace AlibabaCloud
@@ -30,6 +32,10 @@ namespace OSS
     std::string ComputeContentMD5(const std::string& data);
     std::string ComputeContentMD5(const char *data, size_t size);
     std::string ComputeContentMD5(std::istream & stream); 
+    /*of the size bytes from the read position, the ones a request sends. The crc64 of
+    them comes from the same pass when crc64 is not null*/
+    std::string ComputeContentMD5(std::istream & stream, int64_t size, uint64_t* crc64);
+    std::vector<std::string> ComputeContentMD5(const std::vector<std::shared_ptr<std::iostream>>& contents);
 
     std::string ComputeContentETag(const std::string& data);
     std::string ComputeContentETag(const char *data, size_t size);
@@ -0,0 +1,295 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "XmlStreamParser.h"
+#include <cstdlib>
+#include <cstring>
+
+using namespace AlibabaCloud::OSS;
+
+static void AppendUtf8(unsigned long cp, std::string &dst)
+{
+    if (cp < 0x80) {
+        dst.push_back(static_cast<char>(cp));
+    }
+    else if (cp < 0x800) {
+        dst.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        dst.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else if (cp < 0x10000) {
+        dst.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        dst.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        dst.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else {
+        dst.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        dst.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        dst.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        dst.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+static bool DecodeEntity(const char *name, size_t len, std::string &dst)
+{
+    struct Entity { const char *name; size_t len; char ch; };
+    static const Entity entities[] = {
+        { "lt", 2, '<' }, { "gt", 2, '>' }, { "amp", 3, '&' }, { "quot", 4, '"' }, { "apos", 4, '\'' }
+    };
+    if (len >= 2 && name[0] == '#') {
+        bool hex = name[1] == 'x' || name[1] == 'X';
+        const char *digits = name + (hex ? 2 : 1);
+        size_t count = len - (hex ? 2 : 1);
+        if (count == 0 || count > 8) {
+            return false;
+        }
+        unsigned long cp = 0;
+        for (size_t i = 0; i < count; i++) {
+            char c = digits[i];
+            int v;
+            if (c >= '0' && c <= '9') v = c - '0';
+            else if (hex && c >= 'a' && c <= 'f') v = c - 'a' + 10;
+            else if (hex && c >= 'A' && c <= 'F') v = c - 'A' + 10;
+            else return false;
+            cp = cp * (hex ? 16 : 10) + v;
+        }
+        if (cp == 0 || cp > 0x10FFFF) {
+            return false;
+        }
+        AppendUtf8(cp, dst);
+        return true;
+    }
+    for (auto const &entity : entities) {
+        if (entity.len == len && !std::strncmp(entity.name, name, len)) {
+            dst.push_back(entity.ch);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AlibabaCloud::OSS::XmlDecodeEntities(const char *src, size_t size, std::string &dst)
+{
+    const char *p = src;
+    const char *end = src + size;
+    while (p < end) {
+        const char *amp = static_cast<const char *>(std::memchr(p, '&', end - p));
+        if (amp == nullptr) {
+            dst.append(p, end - p);
+            return;
+        }
+        dst.append(p, amp - p);
+        const char *semi = static_cast<const char *>(std::memchr(amp + 1, ';', end - amp - 1));
+        if (semi != nullptr && semi - amp <= 11 && DecodeEntity(amp + 1, semi - amp - 1, dst)) {
+            p = semi + 1;
+        }
+        else {
+            dst.push_back('&');
+            p = amp + 1;
+        }
+    }
+}
+
+XmlStreamParser::XmlStreamParser(Handler &handler) :
+    handler_(handler),
+    inMarkup_(false),
+    failed_(false),
+    leaf_(false),
+    quote_(0),
+    depth_(0),
+    rootClosed_(false)
+{
+}
+
+bool XmlStreamParser::feed(const char *data, size_t size)
+{
+    const char *p = data;
+    const char *end = data + size;
+    while (p < end && !failed_) {
+        if (inMarkup_) {
+            if (scanMarkup(p, end)) {
+                inMarkup_ = false;
+                failed_ = !processMarkup();
+                markup_.clear();
+            }
+            continue;
+        }
+        const char *lt = static_cast<const char *>(std::memchr(p, '<', end - p));
+        const char *stop = lt ? lt : end;
+        //only the text of a leaf element is kept, a whole run is decoded in place
+        if (leaf_) {
+            if (lt != nullptr && rawText_.empty()) {
+                XmlDecodeEntities(p, stop - p, text_);
+            }
+            else {
+                rawText_.append(p, stop - p);
+            }
+        }
+        p = stop;
+        if (lt != nullptr) {
+            flushText();
+            inMarkup_ = true;
+            p++;
+        }
+    }
+    return !failed_;
+}
+
+bool XmlStreamParser::feed(std::istream &in)
+{
+    char buffer[16384];
+    while (in.good() && !failed_) {
+        in.read(buffer, sizeof(buffer));
+        if (in.gcount() > 0) {
+            feed(buffer, static_cast<size_t>(in.gcount()));
+        }
+    }
+    return !failed_;
+}
+
+bool XmlStreamParser::finish()
+{
+    return !failed_ && !inMarkup_ && depth_ == 0 && rootClosed_;
+}
+
+void XmlStreamParser::flushText()
+{
+    if (!rawText_.empty()) {
+        XmlDecodeEntities(rawText_.data(), rawText_.size(), text_);
+        rawText_.clear();
+    }
+}
+
+bool XmlStreamParser::scanMarkup(const char *&p, const char *end)
+{
+    while (p < end) {
+        char c = *p++;
+        if (quote_ != 0) {
+            if (c == quote_) {
+                quote_ = 0;
+            }
+            markup_.push_back(c);
+            continue;
+        }
+        if (c == '>') {
+            //comments and CDATA sections end with "-->" and "]]>", they may hold a '>'
+            size_t size = markup_.size();
+            if (!markup_.compare(0, 3, "!--") && (size < 5 || markup_.compare(size - 2, 2, "--"))) {
+                markup_.push_back(c);
+                continue;
+            }
+            if (!markup_.compare(0, 8, "![CDATA[") && (size < 10 || markup_.compare(size - 2, 2, "]]"))) {
+                markup_.push_back(c);
+                continue;
+            }
+            return true;
+        }
+        if ((c == '"' || c == '\'') && !markup_.empty() && markup_[0] != '!') {
+            quote_ = c;
+        }
+        markup_.push_back(c);
+    }
+    return false;
+}
+
+bool XmlStreamParser::processMarkup()
+{
+    if (markup_.empty()) {
+        return false;
+    }
+    if (markup_[0] == '?') {
+        return true;
+    }
+    if (markup_[0] == '!') {
+        if (!markup_.compare(0, 8, "![CDATA[") && leaf_) {
+            text_.append(markup_, 8, markup_.size() - 10);
+        }
+        return true;
+    }
+
+    bool isEnd = markup_[0] == '/';
+    bool isEmpty = !isEnd && markup_.back() == '/';
+    size_t start = isEnd ? 1 : 0;
+    size_t stop = markup_.find_first_of(" \t\r\n/", start);
+    if (stop == std::string::npos) {
+        stop = markup_.size();
+    }
+    if (stop == start) {
+        return false;
+    }
+    name_.assign(markup_, start, stop - start);
+
+    if (!isEnd) {
+        if (rootClosed_) {
+            return false;
+        }
+        if (depth_ == 0) {
+            rootName_ = name_;
+        }
+        if (stack_.size() <= depth_) {
+            stack_.resize(depth_ + 1);
+        }
+        stack_[depth_++] = name_;
+        text_.clear();
+        leaf_ = true;
+        handler_.onStartElement(name_, static_cast<int>(depth_));
+        if (!isEmpty) {
+            return true;
+        }
+    }
+    else if (depth_ == 0 || stack_[depth_ - 1] != name_) {
+        return false;
+    }
+
+    if (!leaf_) {
+        text_.clear();
+    }
+    handler_.onEndElement(name_, static_cast<int>(depth_), text_);
+    text_.clear();
+    leaf_ = false;
+    if (--depth_ == 0) {
+        rootClosed_ = true;
+    }
+    return true;
+}
+
+XmlParseStreamBuf::XmlParseStreamBuf(std::iostream &stream, XmlStreamParser &parser, const std::string &rootName) :
+    StreamBufProxy(stream),
+    parser_(parser),
+    rootName_(rootName),
+    passThrough_(true)
+{
+}
+
+XmlParseStreamBuf::int_type XmlParseStreamBuf::overflow(int_type ch)
+{
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+        return traits_type::not_eof(ch);
+    }
+    char c = traits_type::to_char_type(ch);
+    xsputn(&c, 1);
+    return ch;
+}
+
+std::streamsize XmlParseStreamBuf::xsputn(const char *ptr, std::streamsize count)
+{
+    parser_.feed(ptr, static_cast<size_t>(count));
+    if (!passThrough_) {
+        return count;
+    }
+    std::streamsize written = StreamBufProxy::xsputn(ptr, count);
+    passThrough_ = parser_.RootName() != rootName_;
+    return written;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "StreamBuf.h"
+
+namespace AlibabaCloud
+{
+namespace OSS
+{
+    /*
+    * Incremental SAX style parser for the data oriented xml of the OSS responses:
+    * elements, text, entities, CDATA; comments, declarations and attributes are
+    * skipped. The document can be fed in chunks of any size, tokens may straddle
+    * them. No tree is built, the handler gets every element as it closes.
+    */
+    class XmlStreamParser
+    {
+    public:
+        class Handler
+        {
+        public:
+            virtual ~Handler() = default;
+            /*depth 1 is the root element*/
+            virtual void onStartElement(const std::string &name, int depth) = 0;
+            /*text is the decoded content of a leaf element, empty for the others. It may be moved from.*/
+            virtual void onEndElement(const std::string &name, int depth, std::string &text) = 0;
+        };
+
+        explicit XmlStreamParser(Handler &handler);
+
+        /*false once the document is malformed*/
+        bool feed(const char *data, size_t size);
+        /*feeds the rest of the stream in blocks*/
+        bool feed(std::istream &in);
+        /*true when a complete, well formed document was fed*/
+        bool finish();
+        const std::string &RootName() const { return rootName_; }
+
+    private:
+        bool scanMarkup(const char *&p, const char *end);
+        bool processMarkup();
+        void flushText();
+
+        Handler &handler_;
+        bool inMarkup_;
+        bool failed_;
+        bool leaf_;
+        char quote_;
+        size_t depth_;
+        bool rootClosed_;
+        std::string markup_;
+        std::string rawText_;
+        std::string text_;
+        std::string name_;
+        /*names of the open elements, kept to reuse their storage*/
+        std::vector<std::string> stack_;
+        std::string rootName_;
+    };
+
+    /*append the entity decoded src to dst, unknown entities are kept as they are*/
+    void XmlDecodeEntities(const char *src, size_t size, std::string &dst);
+
+    /*
+    * Parses the bytes written to a stream as they arrive. They are also passed on to
+    * the stream until the root element turns out to be rootName, the expected result,
+    * so an error document is still there for the error path to read.
+    */
+    class XmlParseStreamBuf : public StreamBufProxy
+    {
+    public:
+        XmlParseStreamBuf(std::iostream &stream, XmlStreamParser &parser, const std::string &rootName);
+
+    protected:
+        int_type overflow(int_type ch = traits_type::eof());
+        std::streamsize xsputn(const char *ptr, std::streamsize count);
+
+    private:
+        XmlStreamParser &parser_;
+        std::string rootName_;
+        bool passThrough_;
+    };
+}
+}
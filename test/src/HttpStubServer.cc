@@ -0,0 +1,373 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HttpStubServer.h"
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+#include <sstream>
+#include <unordered_map>
+#include <algorithm>
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace AlibabaCloud::OSS;
+
+HttpStubServer::HttpStubServer() :
+    listenFd_(-1),
+    port_(0),
+    body_("stub"),
+    delayMs_(0),
+    stop_(false),
+    requestCount_(0),
+    peakConnections_(0),
+    peakPending_(0)
+{
+}
+
+HttpStubServer::~HttpStubServer()
+{
+    stop();
+}
+
+std::string HttpStubServer::endpoint() const
+{
+    std::stringstream ss;
+    ss << "http://127.0.0.1:" << port_;
+    return ss.str();
+}
+
+#ifdef __linux__
+
+namespace
+{
+    struct Connection
+    {
+        std::string in;
+        std::string out;
+        size_t outPos = 0;
+        bool waiting = false;
+        bool continued = false;
+    };
+
+    struct Pending
+    {
+        std::chrono::steady_clock::time_point due;
+        int fd;
+    };
+
+    bool iequalsPrefix(const std::string &s, size_t pos, const char *name)
+    {
+        size_t len = strlen(name);
+        if (s.size() < pos + len) {
+            return false;
+        }
+        for (size_t i = 0; i < len; i++) {
+            if (::tolower(static_cast<unsigned char>(s[pos + i])) != name[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*returns the length of the chunked body starting at pos when it is complete, 0 otherwise*/
+    size_t parseChunkedBody(const std::string &in, size_t pos)
+    {
+        size_t start = pos;
+        for (;;) {
+            size_t eol = in.find("\r\n", pos);
+            if (eol == std::string::npos) {
+                return 0;
+            }
+            size_t size = std::strtoul(in.c_str() + pos, nullptr, 16);
+            pos = eol + 2;
+            if (size == 0) {
+                //no trailers are sent by the sdk
+                return in.size() >= pos + 2 ? pos + 2 - start : 0;
+            }
+            pos += size + 2;
+            if (in.size() < pos) {
+                return 0;
+            }
+        }
+    }
+
+    /*returns the request length when a full request is buffered, 0 otherwise*/
+    size_t parseRequest(const std::string &in, bool &isHead, bool &expectContinue)
+    {
+        size_t end = in.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            return 0;
+        }
+        size_t contentLength = 0;
+        bool chunked = false;
+        expectContinue = false;
+        isHead = in.compare(0, 5, "HEAD ") == 0;
+        size_t pos = in.find("\r\n");
+        while (pos < end) {
+            pos += 2;
+            if (iequalsPrefix(in, pos, "content-length:")) {
+                contentLength = std::strtoul(in.c_str() + pos + 15, nullptr, 10);
+            }
+            else if (iequalsPrefix(in, pos, "transfer-encoding:")) {
+                chunked = in.compare(pos + 18, 8, " chunked") == 0;
+            }
+            else if (iequalsPrefix(in, pos, "expect:")) {
+                expectContinue = true;
+            }
+            pos = in.find("\r\n", pos);
+        }
+        if (chunked) {
+            size_t bodyLength = parseChunkedBody(in, end + 4);
+            return bodyLength > 0 ? end + 4 + bodyLength : 0;
+        }
+        size_t total = end + 4 + contentLength;
+        return in.size() >= total ? total : 0;
+    }
+}
+
+bool HttpStubServer::start()
+{
+    listenFd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        return false;
+    }
+    int one = 1;
+    setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (bind(listenFd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(listenFd_, 8192) != 0) {
+        close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd_, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    stop_ = false;
+    thread_ = std::thread(&HttpStubServer::run, this);
+    return true;
+}
+
+void HttpStubServer::stop()
+{
+    stop_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+        listenFd_ = -1;
+    }
+}
+
+void HttpStubServer::run()
+{
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd_;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, listenFd_, &ev);
+
+    std::unordered_map<int, Connection> conns;
+    std::deque<Pending> pending;
+    std::vector<epoll_event> events(1024);
+    char buffer[16384];
+
+    auto closeConn = [&](int fd) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        conns.erase(fd);
+    };
+
+    auto flush = [&](int fd, Connection &c) -> bool {
+        while (c.outPos < c.out.size()) {
+            ssize_t n = send(fd, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    epoll_event wev;
+                    wev.events = EPOLLIN | EPOLLOUT;
+                    wev.data.fd = fd;
+                    epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &wev);
+                    return true;
+                }
+                return false;
+            }
+            c.outPos += static_cast<size_t>(n);
+        }
+        c.out.clear();
+        c.outPos = 0;
+        return true;
+    };
+
+    auto process = [&](int fd, Connection &c) -> bool {
+        while (!c.waiting) {
+            bool isHead = false, expectContinue = false;
+            size_t len = parseRequest(c.in, isHead, expectContinue);
+            if (len == 0) {
+                if (expectContinue && !c.continued) {
+                    c.continued = true;
+                    c.out.append("HTTP/1.1 100 Continue\r\n\r\n");
+                    if (!flush(fd, c)) return false;
+                }
+                return true;
+            }
+            c.in.erase(0, len);
+            c.continued = false;
+            requestCount_++;
+
+            std::stringstream ss;
+            ss << "HTTP/1.1 200 OK\r\n"
+               << "Content-Length: " << body_.size() << "\r\n"
+               << "x-oss-request-id: 5C0000000000000000000000\r\n"
+               << "ETag: \"D41D8CD98F00B204E9800998ECF8427E\"\r\n"
+               << "Connection: keep-alive\r\n\r\n";
+            if (!isHead) {
+                ss << body_;
+            }
+            c.out.append(ss.str());
+
+            if (delayMs_ > 0) {
+                c.waiting = true;
+                pending.push_back(Pending{ std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs_), fd });
+                if (static_cast<int>(pending.size()) > peakPending_) {
+                    peakPending_ = static_cast<int>(pending.size());
+                }
+                return true;
+            }
+            if (!flush(fd, c)) return false;
+        }
+        return true;
+    };
+
+    while (!stop_) {
+        int timeout = 100;
+        if (!pending.empty()) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(pending.front().due - std::chrono::steady_clock::now()).count();
+            timeout = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(wait, 100)));
+        }
+        int n = epoll_wait(epfd, events.data(), static_cast<int>(events.size()), timeout);
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd_) {
+                for (;;) {
+                    int cfd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (cfd < 0) {
+                        break;
+                    }
+                    int one = 1;
+                    setsockopt(cfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    epoll_event cev;
+                    cev.events = EPOLLIN;
+                    cev.data.fd = cfd;
+                    epoll_ctl(epfd, EPOLL_CTL_ADD, cfd, &cev);
+                    conns[cfd] = Connection();
+                    if (static_cast<int>(conns.size()) > peakConnections_) {
+                        peakConnections_ = static_cast<int>(conns.size());
+                    }
+                }
+                continue;
+            }
+
+            auto it = conns.find(fd);
+            if (it == conns.end()) {
+                continue;
+            }
+            Connection &c = it->second;
+            bool ok = true;
+            if (events[i].events & EPOLLOUT) {
+                ok = flush(fd, c);
+                if (ok && c.out.empty()) {
+                    epoll_event rev;
+                    rev.events = EPOLLIN;
+                    rev.data.fd = fd;
+                    epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &rev);
+                }
+            }
+            if (ok && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                for (;;) {
+                    ssize_t r = recv(fd, buffer, sizeof(buffer), 0);
+                    if (r > 0) {
+                        c.in.append(buffer, static_cast<size_t>(r));
+                        continue;
+                    }
+                    if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                        ok = false;
+                    }
+                    break;
+                }
+                if (ok) {
+                    ok = process(fd, c);
+                }
+            }
+            if (!ok) {
+                closeConn(fd);
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        while (!pending.empty() && pending.front().due <= now) {
+            int fd = pending.front().fd;
+            pending.pop_front();
+            auto it = conns.find(fd);
+            if (it == conns.end()) {
+                continue;
+            }
+            it->second.waiting = false;
+            if (!flush(fd, it->second) || !process(fd, it->second)) {
+                closeConn(fd);
+            }
+        }
+    }
+
+    for (auto &c : conns) {
+        close(c.first);
+    }
+    close(epfd);
+}
+
+#else
+
+bool HttpStubServer::start()
+{
+    return false;
+}
+
+void HttpStubServer::stop()
+{
+}
+
+void HttpStubServer::run()
+{
+}
+
+#endif
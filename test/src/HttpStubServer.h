@@ -0,0 +1,64 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+/*
+ * Single threaded keep-alive http/1.1 server on 127.0.0.1, answers every
+ * request with 200 and a fixed body. Responses can be held back for a while
+ * to keep many requests in flight at once. Linux only, start() fails elsewhere.
+ */
+class HttpStubServer
+{
+public:
+    HttpStubServer();
+    ~HttpStubServer();
+
+    bool start();
+    void stop();
+
+    int port() const { return port_; }
+    std::string endpoint() const;
+
+    void setResponseBody(const std::string &body) { body_ = body; }
+    void setResponseDelayMs(int ms) { delayMs_ = ms; }
+
+    int64_t requestCount() const { return requestCount_; }
+    int peakConnections() const { return peakConnections_; }
+    int peakPendingResponses() const { return peakPending_; }
+
+private:
+    void run();
+
+    int listenFd_;
+    int port_;
+    std::string body_;
+    int delayMs_;
+    std::atomic<bool> stop_;
+    std::atomic<int64_t> requestCount_;
+    std::atomic<int> peakConnections_;
+    std::atomic<int> peakPending_;
+    std::thread thread_;
+};
+
+}
+}
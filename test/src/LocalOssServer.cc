@@ -0,0 +1,1035 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LocalOssServer.h"
+#include <alibabacloud/oss/OssClient.h>
+#include <src/external/tinyxml2/tinyxml2.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace AlibabaCloud::OSS;
+
+struct LocalOssServer::Object
+{
+    std::shared_ptr<const std::string> data;
+    std::string eTag;
+    uint64_t crc64;
+    std::time_t lastModified;
+    std::string type;
+    std::map<std::string, std::string> headers;
+};
+
+struct LocalOssServer::Upload
+{
+    std::string bucket;
+    std::string key;
+    std::map<std::string, std::string> headers;
+    std::map<int, std::shared_ptr<const Object>> parts;
+};
+
+struct LocalOssServer::Request
+{
+    std::string method;
+    std::string bucket;
+    std::string key;
+    std::map<std::string, std::string> query;
+    //names in lower case
+    std::map<std::string, std::string> headers;
+    std::string body;
+
+    bool hasQuery(const char *name) const { return query.find(name) != query.end(); }
+    std::string queryValue(const char *name) const
+    {
+        auto it = query.find(name);
+        return it == query.end() ? std::string() : it->second;
+    }
+    std::string header(const char *name) const
+    {
+        auto it = headers.find(name);
+        return it == headers.end() ? std::string() : it->second;
+    }
+};
+
+struct LocalOssServer::Response
+{
+    Response() : status(200), offset(0), length(0), headOnly(false) {}
+
+    void setBody(const std::string &body)
+    {
+        data = std::make_shared<const std::string>(body);
+        offset = 0;
+        length = body.size();
+    }
+
+    void setXml(const std::string &xml)
+    {
+        headers.push_back(std::make_pair("Content-Type", "application/xml"));
+        setBody(xml);
+    }
+
+    void setError(int code, const char *errorCode, const std::string &message)
+    {
+        status = code;
+        std::stringstream ss;
+        ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+           << "<Error>\n"
+           << "  <Code>" << errorCode << "</Code>\n"
+           << "  <Message>" << message << "</Message>\n"
+           << "  <RequestId>5C0000000000000000000000</RequestId>\n"
+           << "  <HostId>127.0.0.1</HostId>\n"
+           << "</Error>\n";
+        setXml(ss.str());
+    }
+
+    int status;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::shared_ptr<const std::string> data;
+    size_t offset;
+    size_t length;
+    bool headOnly;
+};
+
+LocalOssServer::LocalOssServer(const Options &options) :
+    options_(options),
+    listenFd_(-1),
+    port_(0),
+    stop_(false),
+    requestCount_(0),
+    activeRequests_(0),
+    maxActiveRequests_(0),
+    verifiedDigestCount_(0),
+    nextUploadId_(1),
+    deletedKeyCount_(0)
+{
+}
+
+LocalOssServer::~LocalOssServer()
+{
+    stop();
+}
+
+std::string LocalOssServer::endpoint() const
+{
+    std::stringstream ss;
+    ss << "http://127.0.0.1:" << port_;
+    return ss.str();
+}
+
+bool LocalOssServer::start()
+{
+    if (!listen()) {
+        return false;
+    }
+    thread_ = std::thread(&LocalOssServer::serve, this);
+    return true;
+}
+
+static std::string XmlEscape(const std::string &src)
+{
+    std::string out;
+    out.reserve(src.size());
+    for (char c : src) {
+        switch (c) {
+        case '<': out.append("&lt;"); break;
+        case '>': out.append("&gt;"); break;
+        case '&': out.append("&amp;"); break;
+        case '"': out.append("&quot;"); break;
+        default: out.push_back(c); break;
+        }
+    }
+    return out;
+}
+
+static std::string Crc64String(uint64_t crc)
+{
+    return std::to_string(crc);
+}
+
+static std::shared_ptr<const std::string> EmptyData()
+{
+    static const std::shared_ptr<const std::string> empty = std::make_shared<const std::string>();
+    return empty;
+}
+
+static const char *StatusText(int status)
+{
+    switch (status) {
+    case 100: return "Continue";
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 206: return "Partial Content";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 412: return "Precondition Failed";
+    case 416: return "Requested Range Not Satisfiable";
+    case 501: return "Not Implemented";
+    case 503: return "Service Unavailable";
+    default: return "Unknown";
+    }
+}
+
+void LocalOssServer::handle(const Request &request, Response &response)
+{
+    const std::string &method = request.method;
+    std::string contentMd5 = request.header("content-md5");
+    if (!contentMd5.empty()) {
+        if (contentMd5 != ComputeContentMD5(request.body.data(), request.body.size())) {
+            response.setError(400, "InvalidDigest", "The Content-MD5 you specified is not valid.");
+            return;
+        }
+        verifiedDigestCount_++;
+    }
+    if (request.bucket.empty()) {
+        response.setError(501, "NotImplemented", "ListBuckets is not supported");
+        return;
+    }
+
+    if (request.key.empty()) {
+        if (method == "GET" && request.query.size() == request.query.count("prefix") + request.query.count("marker") +
+            request.query.count("max-keys") + request.query.count("delimiter") + request.query.count("encoding-type")) {
+            listObjects(request, response);
+        }
+        else if (method == "POST" && request.hasQuery("delete")) {
+            deleteObjects(request, response);
+        }
+        else if (method == "PUT" && request.query.empty()) {
+            std::lock_guard<std::mutex> lck(lock_);
+            buckets_[request.bucket];
+        }
+        else {
+            response.setError(501, "NotImplemented", "the bucket operation is not supported");
+        }
+        return;
+    }
+
+    if (method == "PUT") {
+        if (request.hasQuery("uploadId")) {
+            uploadPart(request, response);
+        }
+        else if (request.query.empty()) {
+            putObject(request, response);
+        }
+        else {
+            response.setError(501, "NotImplemented", "the object operation is not supported");
+        }
+    }
+    else if (method == "GET" || method == "HEAD") {
+        if (request.hasQuery("uploadId")) {
+            listParts(request, response);
+        }
+        else {
+            getObject(request, response, method == "HEAD");
+        }
+    }
+    else if (method == "POST") {
+        if (request.hasQuery("uploads")) {
+            initiateUpload(request, response);
+        }
+        else if (request.hasQuery("uploadId")) {
+            completeUpload(request, response);
+        }
+        else {
+            response.setError(501, "NotImplemented", "the object operation is not supported");
+        }
+    }
+    else if (method == "DELETE") {
+        if (request.hasQuery("uploadId")) {
+            abortUpload(request, response);
+        }
+        else {
+            deleteObject(request, response);
+        }
+    }
+    else {
+        response.setError(501, "NotImplemented", "the method is not supported");
+    }
+}
+
+static std::map<std::string, std::string> StoredHeaders(const std::map<std::string, std::string> &headers)
+{
+    std::map<std::string, std::string> stored;
+    for (auto const &header : headers) {
+        if (header.first.compare(0, 11, "x-oss-meta-") == 0 ||
+            header.first == "content-type" || header.first == "cache-control" ||
+            header.first == "content-disposition" || header.first == "content-encoding") {
+            stored[header.first] = header.second;
+        }
+    }
+    return stored;
+}
+
+void LocalOssServer::putObject(const Request &request, Response &response)
+{
+    auto data = std::make_shared<const std::string>(request.body);
+    auto object = std::make_shared<Object>();
+    object->data = data;
+    object->eTag = ComputeContentETag(data->data(), data->size());
+    object->crc64 = ComputeCRC64(0, const_cast<char *>(data->data()), data->size());
+    object->lastModified = std::time(nullptr);
+    object->type = "Normal";
+    object->headers = StoredHeaders(request.headers);
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        buckets_[request.bucket][request.key] = object;
+    }
+    response.headers.push_back(std::make_pair("ETag", "\"" + object->eTag + "\""));
+    response.headers.push_back(std::make_pair("x-oss-hash-crc64ecma", Crc64String(object->crc64)));
+}
+
+void LocalOssServer::getObject(const Request &request, Response &response, bool isHead)
+{
+    std::shared_ptr<const Object> object;
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        auto bucket = buckets_.find(request.bucket);
+        if (bucket != buckets_.end()) {
+            auto it = bucket->second.find(request.key);
+            if (it != bucket->second.end()) {
+                object = it->second;
+            }
+        }
+    }
+    if (object == nullptr) {
+        response.setError(404, "NoSuchKey", "The specified key does not exist.");
+        response.headOnly = isHead;
+        return;
+    }
+    std::string ifMatch = request.header("if-match");
+    ifMatch.erase(std::remove(ifMatch.begin(), ifMatch.end(), '"'), ifMatch.end());
+    if (!ifMatch.empty() && ifMatch != object->eTag) {
+        response.setError(412, "PreconditionFailed", "At least one of the pre-conditions you specified did not hold.");
+        response.headOnly = isHead;
+        return;
+    }
+
+    std::time_t lastModified = object->lastModified;
+    response.headers.push_back(std::make_pair("ETag", "\"" + object->eTag + "\""));
+    response.headers.push_back(std::make_pair("Last-Modified", ToGmtTime(lastModified)));
+    response.headers.push_back(std::make_pair("x-oss-object-type", object->type));
+    response.headers.push_back(std::make_pair("x-oss-hash-crc64ecma", Crc64String(object->crc64)));
+    for (auto const &header : object->headers) {
+        response.headers.push_back(header);
+    }
+    response.data = object->data;
+    response.offset = 0;
+    response.length = object->data->size();
+    response.headOnly = isHead;
+
+    //bytes=first-last, bytes=first- or bytes=-suffix, anything else gets the whole object
+    std::string range = request.header("range");
+    int64_t size = static_cast<int64_t>(object->data->size());
+    if (range.compare(0, 6, "bytes=") == 0 && range.find(',') == std::string::npos && size > 0) {
+        std::string spec = range.substr(6);
+        size_t dash = spec.find('-');
+        if (dash != std::string::npos) {
+            int64_t first = -1;
+            int64_t last = size - 1;
+            if (dash == 0) {
+                int64_t suffix = std::atoll(spec.c_str() + 1);
+                first = std::max<int64_t>(0, size - suffix);
+            }
+            else {
+                first = std::atoll(spec.c_str());
+                if (dash + 1 < spec.size()) {
+                    last = std::min(last, static_cast<int64_t>(std::atoll(spec.c_str() + dash + 1)));
+                }
+            }
+            if (first >= size) {
+                response.headers.clear();
+                response.setError(416, "InvalidRange", "The requested range cannot be satisfied.");
+                return;
+            }
+            if (first >= 0 && first <= last) {
+                std::stringstream ss;
+                ss << "bytes " << first << "-" << last << "/" << size;
+                response.status = 206;
+                response.headers.push_back(std::make_pair("Content-Range", ss.str()));
+                response.offset = static_cast<size_t>(first);
+                response.length = static_cast<size_t>(last - first + 1);
+            }
+        }
+    }
+}
+
+void LocalOssServer::deleteObject(const Request &request, Response &response)
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    auto bucket = buckets_.find(request.bucket);
+    if (bucket != buckets_.end()) {
+        bucket->second.erase(request.key);
+    }
+    response.status = 204;
+}
+
+void LocalOssServer::listObjects(const Request &request, Response &response)
+{
+    std::string prefix = request.queryValue("prefix");
+    std::string marker = request.queryValue("marker");
+    std::string delimiter = request.queryValue("delimiter");
+    bool urlEncode = request.queryValue("encoding-type") == "url";
+    int maxKeys = request.hasQuery("max-keys") ? std::atoi(request.queryValue("max-keys").c_str()) : 100;
+    maxKeys = std::max(1, std::min(maxKeys, 1000));
+    auto encode = [&](const std::string &value) { return XmlEscape(urlEncode ? UrlEncode(value) : value); };
+
+    std::stringstream contents;
+    std::vector<std::string> commonPrefixes;
+    std::string nextMarker;
+    bool truncated = false;
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        auto &objects = buckets_[request.bucket];
+        auto it = objects.lower_bound(std::max(prefix, marker));
+        if (it != objects.end() && !marker.empty() && it->first == marker) {
+            ++it;
+        }
+        int count = 0;
+        for (; it != objects.end(); ++it) {
+            const std::string &key = it->first;
+            if (key.compare(0, prefix.size(), prefix) != 0) {
+                break;
+            }
+            if (count == maxKeys) {
+                truncated = true;
+                break;
+            }
+            if (!delimiter.empty()) {
+                size_t pos = key.find(delimiter, prefix.size());
+                if (pos != std::string::npos) {
+                    std::string common = key.substr(0, pos + delimiter.size());
+                    if (commonPrefixes.empty() || commonPrefixes.back() != common) {
+                        commonPrefixes.push_back(common);
+                        count++;
+                    }
+                    nextMarker = key;
+                    continue;
+                }
+            }
+            const Object &object = *it->second;
+            std::time_t lastModified = object.lastModified;
+            contents << "  <Contents>\n"
+                << "    <Key>" << encode(key) << "</Key>\n"
+                << "    <LastModified>" << ToUtcTime(lastModified) << "</LastModified>\n"
+                << "    <ETag>\"" << object.eTag << "\"</ETag>\n"
+                << "    <Type>" << object.type << "</Type>\n"
+                << "    <Size>" << object.data->size() << "</Size>\n"
+                << "    <StorageClass>Standard</StorageClass>\n"
+                << "    <Owner>\n"
+                << "      <ID>0</ID>\n"
+                << "      <DisplayName>0</DisplayName>\n"
+                << "    </Owner>\n"
+                << "  </Contents>\n";
+            nextMarker = key;
+            count++;
+        }
+    }
+
+    std::stringstream ss;
+    ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+       << "<ListBucketResult>\n"
+       << "  <Name>" << XmlEscape(request.bucket) << "</Name>\n"
+       << "  <Prefix>" << encode(prefix) << "</Prefix>\n"
+       << "  <Marker>" << encode(marker) << "</Marker>\n"
+       << "  <MaxKeys>" << maxKeys << "</MaxKeys>\n"
+       << "  <Delimiter>" << encode(delimiter) << "</Delimiter>\n"
+       << "  <IsTruncated>" << (truncated ? "true" : "false") << "</IsTruncated>\n";
+    if (truncated) {
+        ss << "  <NextMarker>" << encode(nextMarker) << "</NextMarker>\n";
+    }
+    if (urlEncode) {
+        ss << "  <EncodingType>url</EncodingType>\n";
+    }
+    ss << contents.str();
+    for (auto const &common : commonPrefixes) {
+        ss << "  <CommonPrefixes>\n"
+           << "    <Prefix>" << encode(common) << "</Prefix>\n"
+           << "  </CommonPrefixes>\n";
+    }
+    ss << "</ListBucketResult>\n";
+    response.setXml(ss.str());
+}
+
+void LocalOssServer::deleteObjects(const Request &request, Response &response)
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(request.body.c_str(), request.body.size()) != tinyxml2::XML_SUCCESS ||
+        doc.RootElement() == nullptr) {
+        response.setError(400, "MalformedXML", "The XML you provided was not well-formed.");
+        return;
+    }
+    bool urlEncode = request.queryValue("encoding-type") == "url";
+    auto quietNode = doc.RootElement()->FirstChildElement("Quiet");
+    bool quiet = quietNode && quietNode->GetText() && std::strcmp(quietNode->GetText(), "true") == 0;
+
+    std::stringstream ss;
+    ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+       << "<DeleteResult>\n";
+    if (urlEncode) {
+        ss << "  <EncodingType>url</EncodingType>\n";
+    }
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        auto &objects = buckets_[request.bucket];
+        for (auto node = doc.RootElement()->FirstChildElement("Object"); node; node = node->NextSiblingElement("Object")) {
+            auto keyNode = node->FirstChildElement("Key");
+            if (keyNode == nullptr || keyNode->GetText() == nullptr) {
+                continue;
+            }
+            std::string key = urlEncode ? UrlDecode(keyNode->GetText()) : keyNode->GetText();
+            if (options_.deleteSkipEvery > 0 && ++deletedKeyCount_ % options_.deleteSkipEvery == 0) {
+                continue;
+            }
+            objects.erase(key);
+            if (!quiet) {
+                ss << "  <Deleted>\n"
+                   << "    <Key>" << XmlEscape(urlEncode ? UrlEncode(key) : key) << "</Key>\n"
+                   << "  </Deleted>\n";
+            }
+        }
+    }
+    ss << "</DeleteResult>\n";
+    response.setXml(ss.str());
+}
+
+void LocalOssServer::initiateUpload(const Request &request, Response &response)
+{
+    auto upload = std::make_shared<Upload>();
+    upload->bucket = request.bucket;
+    upload->key = request.key;
+    upload->headers = StoredHeaders(request.headers);
+    std::string uploadId;
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        std::stringstream id;
+        id << "0004B9" << std::uppercase << std::hex << nextUploadId_++;
+        uploadId = id.str();
+        uploads_[uploadId] = upload;
+    }
+
+    std::stringstream ss;
+    ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+       << "<InitiateMultipartUploadResult>\n"
+       << "  <Bucket>" << XmlEscape(request.bucket) << "</Bucket>\n"
+       << "  <Key>" << XmlEscape(request.key) << "</Key>\n"
+       << "  <UploadId>" << uploadId << "</UploadId>\n"
+       << "</InitiateMultipartUploadResult>\n";
+    response.setXml(ss.str());
+}
+
+void LocalOssServer::uploadPart(const Request &request, Response &response)
+{
+    int partNumber = std::atoi(request.queryValue("partNumber").c_str());
+    if (partNumber < 1 || partNumber > 10000) {
+        response.setError(400, "InvalidArgument", "Part number must be an integer between 1 and 10000, inclusive.");
+        return;
+    }
+    auto part = std::make_shared<Object>();
+    part->data = std::make_shared<const std::string>(request.body);
+    part->eTag = ComputeContentETag(part->data->data(), part->data->size());
+    part->crc64 = ComputeCRC64(0, const_cast<char *>(part->data->data()), part->data->size());
+    part->lastModified = std::time(nullptr);
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        auto it = uploads_.find(request.queryValue("uploadId"));
+        if (it == uploads_.end() || it->second->bucket != request.bucket || it->second->key != request.key) {
+            response.setError(404, "NoSuchUpload", "The specified upload does not exist.");
+            return;
+        }
+        it->second->parts[partNumber] = part;
+    }
+    response.headers.push_back(std::make_pair("ETag", "\"" + part->eTag + "\""));
+    response.headers.push_back(std::make_pair("x-oss-hash-crc64ecma", Crc64String(part->crc64)));
+}
+
+void LocalOssServer::completeUpload(const Request &request, Response &response)
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(request.body.c_str(), request.body.size()) != tinyxml2::XML_SUCCESS ||
+        doc.RootElement() == nullptr) {
+        response.setError(400, "MalformedXML", "The XML you provided was not well-formed.");
+        return;
+    }
+
+    std::shared_ptr<Upload> upload;
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        auto it = uploads_.find(request.queryValue("uploadId"));
+        if (it != uploads_.end() && it->second->bucket == request.bucket && it->second->key == request.key) {
+            upload = it->second;
+            uploads_.erase(it);
+        }
+    }
+    if (upload == nullptr) {
+        response.setError(404, "NoSuchUpload", "The specified upload does not exist.");
+        return;
+    }
+
+    //the parts in the order of the request, their md5 make up the etag
+    auto data = std::make_shared<std::string>();
+    std::string md5s;
+    int partCount = 0;
+    uint64_t crc64 = 0;
+    for (auto node = doc.RootElement()->FirstChildElement("Part"); node; node = node->NextSiblingElement("Part")) {
+        auto numberNode = node->FirstChildElement("PartNumber");
+        int partNumber = (numberNode && numberNode->GetText()) ? std::atoi(numberNode->GetText()) : 0;
+        auto part = upload->parts.find(partNumber);
+        if (part == upload->parts.end()) {
+            response.setError(400, "InvalidPart", "One or more of the specified parts could not be found.");
+            return;
+        }
+        const std::string &partData = *part->second->data;
+        data->append(partData);
+        crc64 = CombineCRC64(crc64, part->second->crc64, partData.size());
+        md5s.append(part->second->eTag);
+        partCount++;
+    }
+
+    auto object = std::make_shared<Object>();
+    object->data = data;
+    object->eTag = ComputeContentETag(md5s.data(), md5s.size()) + "-" + std::to_string(partCount);
+    object->crc64 = crc64;
+    object->lastModified = std::time(nullptr);
+    object->type = "Multipart";
+    object->headers = upload->headers;
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        buckets_[request.bucket][request.key] = object;
+    }
+
+    std::stringstream ss;
+    ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+       << "<CompleteMultipartUploadResult>\n"
+       << "  <Location>" << XmlEscape(endpoint() + "/" + request.bucket + "/" + request.key) << "</Location>\n"
+       << "  <Bucket>" << XmlEscape(request.bucket) << "</Bucket>\n"
+       << "  <Key>" << XmlEscape(request.key) << "</Key>\n"
+       << "  <ETag>\"" << object->eTag << "\"</ETag>\n"
+       << "</CompleteMultipartUploadResult>\n";
+    response.headers.push_back(std::make_pair("ETag", "\"" + object->eTag + "\""));
+    response.headers.push_back(std::make_pair("x-oss-hash-crc64ecma", Crc64String(object->crc64)));
+    response.setXml(ss.str());
+}
+
+void LocalOssServer::abortUpload(const Request &request, Response &response)
+{
+    std::lock_guard<std::mutex> lck(lock_);
+    if (uploads_.erase(request.queryValue("uploadId")) == 0) {
+        response.setError(404, "NoSuchUpload", "The specified upload does not exist.");
+        return;
+    }
+    response.status = 204;
+}
+
+void LocalOssServer::listParts(const Request &request, Response &response)
+{
+    int marker = std::atoi(request.queryValue("part-number-marker").c_str());
+    int maxParts = request.hasQuery("max-parts") ? std::atoi(request.queryValue("max-parts").c_str()) : 1000;
+    maxParts = std::max(1, std::min(maxParts, 1000));
+
+    std::stringstream parts;
+    int nextMarker = marker;
+    bool truncated = false;
+    {
+        std::lock_guard<std::mutex> lck(lock_);
+        auto it = uploads_.find(request.queryValue("uploadId"));
+        if (it == uploads_.end()) {
+            response.setError(404, "NoSuchUpload", "The specified upload does not exist.");
+            return;
+        }
+        int count = 0;
+        for (auto part = it->second->parts.upper_bound(marker); part != it->second->parts.end(); ++part) {
+            if (count == maxParts) {
+                truncated = true;
+                break;
+            }
+            std::time_t lastModified = part->second->lastModified;
+            parts << "  <Part>\n"
+                << "    <PartNumber>" << part->first << "</PartNumber>\n"
+                << "    <LastModified>" << ToUtcTime(lastModified) << "</LastModified>\n"
+                << "    <ETag>\"" << part->second->eTag << "\"</ETag>\n"
+                << "    <HashCrc64ecma>" << part->second->crc64 << "</HashCrc64ecma>\n"
+                << "    <Size>" << part->second->data->size() << "</Size>\n"
+                << "  </Part>\n";
+            nextMarker = part->first;
+            count++;
+        }
+    }
+
+    std::stringstream ss;
+    ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+       << "<ListPartsResult>\n"
+       << "  <Bucket>" << XmlEscape(request.bucket) << "</Bucket>\n"
+       << "  <Key>" << XmlEscape(request.key) << "</Key>\n"
+       << "  <UploadId>" << XmlEscape(request.queryValue("uploadId")) << "</UploadId>\n"
+       << "  <PartNumberMarker>" << marker << "</PartNumberMarker>\n"
+       << "  <NextPartNumberMarker>" << nextMarker << "</NextPartNumberMarker>\n"
+       << "  <MaxParts>" << maxParts << "</MaxParts>\n"
+       << "  <IsTruncated>" << (truncated ? "true" : "false") << "</IsTruncated>\n"
+       << parts.str()
+       << "</ListPartsResult>\n";
+    response.setXml(ss.str());
+}
+
+#ifdef __linux__
+
+namespace
+{
+    /*sleeps as needed to keep the bytes passed since start under the rate*/
+    //the most a throttled connection may be behind its schedule
+    const int64_t ThrottleMaxCreditMs = 10;
+
+    class Throttle
+    {
+    public:
+        explicit Throttle(int kBps) : bytesPerSecond_(static_cast<int64_t>(kBps) * 1024), bytes_(0),
+            start_(std::chrono::steady_clock::now()) {}
+        bool enabled() const { return bytesPerSecond_ > 0; }
+        void pass(size_t bytes)
+        {
+            if (!enabled()) {
+                return;
+            }
+            //the idle time of a keep-alive connection is not saved up as a burst
+            auto now = std::chrono::steady_clock::now();
+            auto due = start_ + std::chrono::microseconds(bytes_ * 1000000 / bytesPerSecond_);
+            if (due + std::chrono::milliseconds(ThrottleMaxCreditMs) < now) {
+                start_ = now - std::chrono::milliseconds(ThrottleMaxCreditMs);
+                bytes_ = 0;
+            }
+            bytes_ += static_cast<int64_t>(bytes);
+            std::this_thread::sleep_until(start_ + std::chrono::microseconds(bytes_ * 1000000 / bytesPerSecond_));
+        }
+    private:
+        int64_t bytesPerSecond_;
+        int64_t bytes_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    const size_t IoChunkSize = 64 * 1024;
+
+    bool SendAll(int fd, const char *data, size_t size, Throttle &throttle)
+    {
+        while (size > 0) {
+            size_t chunk = throttle.enabled() ? std::min(size, IoChunkSize) : size;
+            ssize_t n = send(fd, data, chunk, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            throttle.pass(static_cast<size_t>(n));
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /*appends at least one byte to in, false when the connection is done*/
+    bool Receive(int fd, std::string &in, Throttle &throttle)
+    {
+        char buffer[IoChunkSize];
+        for (;;) {
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            in.append(buffer, static_cast<size_t>(n));
+            throttle.pass(static_cast<size_t>(n));
+            return true;
+        }
+    }
+
+    std::string ToLowerCase(std::string value)
+    {
+        std::transform(value.begin(), value.end(), value.begin(),
+            [](unsigned char c) { return static_cast<char>(::tolower(c)); });
+        return value;
+    }
+
+    std::string TrimSpaces(const std::string &value)
+    {
+        size_t first = value.find_first_not_of(" \t");
+        if (first == std::string::npos) {
+            return std::string();
+        }
+        size_t last = value.find_last_not_of(" \t");
+        return value.substr(first, last - first + 1);
+    }
+}
+
+bool LocalOssServer::listen()
+{
+    listenFd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        return false;
+    }
+    int one = 1;
+    setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (bind(listenFd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenFd_, 1024) != 0) {
+        close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd_, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    stop_ = false;
+    return true;
+}
+
+void LocalOssServer::serve()
+{
+    while (!stop_) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        std::lock_guard<std::mutex> lck(connLock_);
+        if (stop_) {
+            close(fd);
+            break;
+        }
+        connFds_.push_back(fd);
+        connThreads_.emplace_back(&LocalOssServer::handleConnection, this, fd);
+    }
+}
+
+void LocalOssServer::stop()
+{
+    stop_ = true;
+    if (listenFd_ >= 0) {
+        //wakes up accept
+        shutdown(listenFd_, SHUT_RDWR);
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    std::list<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lck(connLock_);
+        for (int fd : connFds_) {
+            shutdown(fd, SHUT_RDWR);
+        }
+        threads.swap(connThreads_);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+        listenFd_ = -1;
+    }
+}
+
+void LocalOssServer::handleConnection(int fd)
+{
+    static thread_local std::mt19937 engine(std::random_device{}());
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    Throttle recvThrottle(options_.bandwidthKBps);
+    Throttle sendThrottle(options_.bandwidthKBps);
+    std::string in;
+    bool ok = true;
+
+    while (ok && !stop_) {
+        //header
+        size_t end;
+        while ((end = in.find("\r\n\r\n")) == std::string::npos) {
+            if (!Receive(fd, in, recvThrottle)) {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+
+        Request request;
+        std::string target;
+        {
+            std::stringstream line(in.substr(0, in.find("\r\n")));
+            line >> request.method >> target;
+        }
+        size_t pos = in.find("\r\n") + 2;
+        while (pos < end + 2) {
+            size_t eol = in.find("\r\n", pos);
+            size_t colon = in.find(':', pos);
+            if (colon != std::string::npos && colon < eol) {
+                request.headers[ToLowerCase(in.substr(pos, colon - pos))] = TrimSpaces(in.substr(colon + 1, eol - colon - 1));
+            }
+            pos = eol + 2;
+        }
+        in.erase(0, end + 4);
+
+        //body
+        if (request.header("expect") == "100-continue") {
+            std::string cont("HTTP/1.1 100 Continue\r\n\r\n");
+            ok = SendAll(fd, cont.data(), cont.size(), sendThrottle);
+        }
+        if (ok && request.header("transfer-encoding") == "chunked") {
+            for (;;) {
+                size_t eol;
+                while (ok && (eol = in.find("\r\n")) == std::string::npos) {
+                    ok = Receive(fd, in, recvThrottle);
+                }
+                if (!ok) {
+                    break;
+                }
+                size_t size = std::strtoul(in.c_str(), nullptr, 16);
+                while (ok && in.size() < eol + 2 + size + 2) {
+                    ok = Receive(fd, in, recvThrottle);
+                }
+                if (!ok) {
+                    break;
+                }
+                request.body.append(in, eol + 2, size);
+                in.erase(0, eol + 2 + size + 2);
+                if (size == 0) {
+                    break;
+                }
+            }
+        }
+        else if (ok) {
+            size_t length = std::strtoull(request.header("content-length").c_str(), nullptr, 10);
+            while (ok && in.size() < length) {
+                ok = Receive(fd, in, recvThrottle);
+            }
+            if (ok) {
+                request.body = in.substr(0, length);
+                in.erase(0, length);
+            }
+        }
+        if (!ok) {
+            break;
+        }
+
+        //path style, /bucket/key?query
+        size_t qpos = target.find('?');
+        std::string path = target.substr(0, qpos);
+        if (qpos != std::string::npos) {
+            std::stringstream query(target.substr(qpos + 1));
+            std::string item;
+            while (std::getline(query, item, '&')) {
+                size_t eq = item.find('=');
+                request.query[UrlDecode(item.substr(0, eq))] = eq == std::string::npos ? "" : UrlDecode(item.substr(eq + 1));
+            }
+        }
+        size_t slash = path.find('/', 1);
+        request.bucket = path.substr(1, slash == std::string::npos ? std::string::npos : slash - 1);
+        if (slash != std::string::npos) {
+            request.key = UrlDecode(path.substr(slash + 1));
+        }
+
+        int64_t seq = ++requestCount_;
+        int active = ++activeRequests_;
+        for (int most = maxActiveRequests_; active > most && !maxActiveRequests_.compare_exchange_weak(most, active); ) {
+        }
+        Response response;
+        if (options_.errorRate > 0 && chance(engine) < options_.errorRate) {
+            response.setError(503, "ServiceUnavailable", "Please reduce your request rate.");
+        }
+        else {
+            handle(request, response);
+        }
+        response.headOnly = response.headOnly || request.method == "HEAD";
+
+        int delayMs = options_.latencyMs;
+        if (options_.slowEvery > 0 && seq % options_.slowEvery == 0) {
+            delayMs += options_.slowLatencyMs;
+        }
+        if (delayMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        }
+
+        if (response.data == nullptr) {
+            response.data = EmptyData();
+        }
+        std::stringstream head;
+        head << "HTTP/1.1 " << response.status << " " << StatusText(response.status) << "\r\n"
+             << "Server: AliyunOSS\r\n"
+             << "Content-Length: " << response.length << "\r\n"
+             << "x-oss-request-id: 5C" << std::setfill('0') << std::setw(22) << seq << "\r\n"
+             << "Connection: keep-alive\r\n";
+        for (auto const &header : response.headers) {
+            head << header.first << ": " << header.second << "\r\n";
+        }
+        head << "\r\n";
+        std::string headStr = head.str();
+        ok = SendAll(fd, headStr.data(), headStr.size(), sendThrottle);
+        if (ok && !response.headOnly && response.length > 0) {
+            ok = SendAll(fd, response.data->data() + response.offset, response.length, sendThrottle);
+        }
+        --activeRequests_;
+        if (request.header("connection") == "close") {
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lck(connLock_);
+    connFds_.remove(fd);
+    close(fd);
+}
+
+#else
+
+bool LocalOssServer::listen()
+{
+    return false;
+}
+
+void LocalOssServer::serve()
+{
+}
+
+void LocalOssServer::stop()
+{
+}
+
+void LocalOssServer::handleConnection(int fd)
+{
+    (void)fd;
+}
+
+#endif
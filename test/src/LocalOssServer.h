@@ -0,0 +1,160 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+/*
+ * In memory stand-in for OSS on 127.0.0.1, path style (http://127.0.0.1:port/bucket/key).
+ * Speaks enough of the protocol for the sdk hot paths: Put/Get/Head/Delete object,
+ * range GET with If-Match, multipart Initiate/UploadPart/Complete/Abort/ListParts, ListObjects
+ * and DeleteObjects, with ETag and x-oss-hash-crc64ecma headers. A Content-MD5 is checked. Buckets exist on
+ * first use and signatures are not checked. One thread per connection, so injected
+ * latency and bandwidth limits delay only that connection. Linux only, start() fails elsewhere.
+ */
+class LocalOssServer
+{
+public:
+    struct Options
+    {
+        Options() : latencyMs(0), bandwidthKBps(0), errorRate(0.0), slowEvery(0), slowLatencyMs(0), deleteSkipEvery(0) {}
+        /*added to every response*/
+        int latencyMs;
+        /*per connection in each direction, 0 means unlimited*/
+        int bandwidthKBps;
+        /*share of the requests answered with 503 ServiceUnavailable*/
+        double errorRate;
+        /*every slowEvery-th request waits slowLatencyMs more, the latency tail*/
+        int slowEvery;
+        int slowLatencyMs;
+        /*every deleteSkipEvery-th key of the DeleteObjects requests is kept and not reported, a per key failure*/
+        int deleteSkipEvery;
+    };
+
+    explicit LocalOssServer(const Options &options = Options());
+    ~LocalOssServer();
+
+    /*listen() and serve() on a thread*/
+    bool start();
+    void stop();
+
+    /*binds an ephemeral port, serve() then accepts until stop(), e.g. in a forked child*/
+    bool listen();
+    void serve();
+
+    int port() const { return port_; }
+    std::string endpoint() const;
+    int64_t requestCount() const { return requestCount_; }
+    /*the most requests served at the same time*/
+    int maxActiveRequests() const { return maxActiveRequests_; }
+    /*the requests whose body matched their Content-MD5, a mismatch is answered with 400 InvalidDigest*/
+    int64_t verifiedDigestCount() const { return verifiedDigestCount_; }
+
+private:
+    struct Object;
+    struct Upload;
+    struct Request;
+    struct Response;
+
+    void handleConnection(int fd);
+    void handle(const Request &request, Response &response);
+    void putObject(const Request &request, Response &response);
+    void getObject(const Request &request, Response &response, bool isHead);
+    void deleteObject(const Request &request, Response &response);
+    void listObjects(const Request &request, Response &response);
+    void deleteObjects(const Request &request, Response &response);
+    void initiateUpload(const Request &request, Response &response);
+    void uploadPart(const Request &request, Response &response);
+    void completeUpload(const Request &request, Response &response);
+    void abortUpload(const Request &request, Response &response);
+    void listParts(const Request &request, Response &response);
+
+    Options options_;
+    int listenFd_;
+    int port_;
+    std::atomic<bool> stop_;
+    std::atomic<int64_t> requestCount_;
+    std::atomic<int> activeRequests_;
+    std::atomic<int> maxActiveRequests_;
+    std::atomic<int64_t> verifiedDigestCount_;
+    std::thread thread_;
+
+    std::mutex connLock_;
+    std::list<std::thread> connThreads_;
+    std::list<int> connFds_;
+
+    std::mutex lock_;
+    std::map<std::string, std::map<std::string, std::shared_ptr<const Object>>> buckets_;
+    std::map<std::string, std::shared_ptr<Upload>> uploads_;
+    int64_t nextUploadId_;
+    int64_t deletedKeyCount_;
+};
+
+/*
+ * A test suite against a LocalOssServer. StartServer() fails off Linux and the test then
+ * returns as skipped. Client is released before the server stops.
+ */
+class LocalOssServerFixture : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        Client = nullptr;
+        if (Server != nullptr) {
+            Server->stop();
+        }
+    }
+
+    /*no retries, an injected error reaches the test*/
+    static ClientConfiguration NoRetryConfiguration()
+    {
+        ClientConfiguration conf;
+        conf.retryStrategy = std::make_shared<JitterRetryStrategy>(0, 1, 1);
+        return conf;
+    }
+
+    bool StartServer(const LocalOssServer::Options &options = LocalOssServer::Options(),
+        const ClientConfiguration &conf = NoRetryConfiguration())
+    {
+        Server = std::make_shared<LocalOssServer>(options);
+        if (!Server->start()) {
+            std::cout << "skip, loopback server is not available." << std::endl;
+            return false;
+        }
+        Client = std::make_shared<OssClient>(Server->endpoint(), "ak", "sk", conf);
+        return true;
+    }
+
+    std::shared_ptr<LocalOssServer> Server;
+    std::shared_ptr<OssClient> Client;
+};
+
+}
+}
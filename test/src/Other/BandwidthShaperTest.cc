@@ -0,0 +1,206 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RateLimiter.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <src/utils/BandwidthShaper.h>
+#include "../LocalOssServer.h"
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+namespace
+{
+    typedef std::chrono::steady_clock TestClock;
+
+    int64_t ElapsedMs(TestClock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(TestClock::now() - start).count();
+    }
+
+    //takes chunks from the shaper for durationMs, pausing as told, returns the bytes taken
+    int64_t Drain(BandwidthShaper &shaper, TransferPriority priority, int64_t durationMs)
+    {
+        int64_t bytes = 0;
+        auto start = TestClock::now();
+        while (ElapsedMs(start) < durationMs) {
+            int64_t waitUs = 0;
+            if (shaper.take(priority, 16 * 1024, waitUs)) {
+                bytes += 16 * 1024;
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::microseconds(waitUs));
+            }
+        }
+        return bytes;
+    }
+}
+
+TEST(BandwidthShaperTest, RateTest)
+{
+    auto limiter = std::make_shared<TokenBucketRateLimiter>(1024);
+    auto shaper = BandwidthShaper::Get(limiter);
+    //one bucket per limiter
+    EXPECT_EQ(BandwidthShaper::Get(limiter), shaper);
+    EXPECT_NE(BandwidthShaper::Get(std::make_shared<TokenBucketRateLimiter>(1024)), shaper);
+
+    //four takers together get the rate of the limiter, not four times it
+    std::vector<std::thread> threads;
+    std::vector<int64_t> bytes(4, 0);
+    for (size_t i = 0; i < bytes.size(); i++) {
+        threads.emplace_back([&, i]() { bytes[i] = Drain(*shaper, TransferPriority::Normal, 1000); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    int64_t total = 0;
+    for (auto b : bytes) {
+        total += b;
+        EXPECT_GT(b, 0);
+    }
+    EXPECT_GT(total, 1024 * 1024 * 8 / 10);
+    EXPECT_LT(total, 1024 * 1024 * 12 / 10);
+
+    //no rate, no limit
+    limiter->setRate(0);
+    int64_t waitUs = 0;
+    EXPECT_TRUE(shaper->take(TransferPriority::Normal, 1LL << 40, waitUs));
+    EXPECT_EQ(waitUs, 0);
+}
+
+TEST(BandwidthShaperTest, PriorityShareTest)
+{
+    auto limiter = std::make_shared<TokenBucketRateLimiter>(1024);
+    limiter->setPriorityWeight(TransferPriority::High, 3);
+    limiter->setPriorityWeight(TransferPriority::Low, 1);
+    auto shaper = BandwidthShaper::Get(limiter);
+    int64_t high = 0;
+    int64_t low = 0;
+    std::thread a([&]() { high = Drain(*shaper, TransferPriority::High, 1000); });
+    std::thread b([&]() { low = Drain(*shaper, TransferPriority::Low, 1000); });
+    a.join();
+    b.join();
+    //3:1 of the rate while both compete
+    EXPECT_GT(high, low * 2);
+    EXPECT_LT(high, low * 4);
+    EXPECT_LT(high + low, 1024 * 1024 * 12 / 10);
+
+    //a class alone has all of it
+    int64_t alone = Drain(*shaper, TransferPriority::Low, 500);
+    EXPECT_GT(alone, 512 * 1024 * 7 / 10);
+}
+
+class BandwidthShaperClientTest : public LocalOssServerFixture {
+protected:
+    void SetUp() override
+    {
+        Started = StartServer();
+        Data.resize(128 * 1024);
+        for (size_t i = 0; i < Data.size(); i++) {
+            Data[i] = static_cast<char>(i * 131 + i / 7);
+        }
+    }
+
+    std::shared_ptr<OssClient> NewClient(unsigned eventLoopThreadNum, const std::shared_ptr<RateLimiter> &send,
+        const std::shared_ptr<RateLimiter> &recv)
+    {
+        ClientConfiguration conf = NoRetryConfiguration();
+        conf.sendRateLimiter = send;
+        conf.recvRateLimiter = recv;
+        conf.eventLoopThreadNum = eventLoopThreadNum;
+        return std::make_shared<OssClient>(Server->endpoint(), "ak", "sk", conf);
+    }
+
+    //runs op for 0..num-1 on num threads, the milliseconds it took
+    template <typename Op>
+    static int64_t RunParallel(int num, Op op)
+    {
+        auto start = TestClock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num; i++) {
+            threads.emplace_back([&op, i]() { op(i); });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        return ElapsedMs(start);
+    }
+
+    void SharedLimit(unsigned eventLoopThreadNum)
+    {
+        //8 parallel transfers of 128KB under one 1MB/s limit take about a second
+        auto limiter = std::make_shared<TokenBucketRateLimiter>(1024);
+        auto client = NewClient(eventLoopThreadNum, limiter, limiter);
+        std::vector<int> ok(8, 0);
+        int64_t putMs = RunParallel(8, [&](int i) {
+            auto content = std::make_shared<std::stringstream>(Data);
+            ok[i] = client->PutObject("bucket", "object" + std::to_string(i), content).isSuccess();
+        });
+        for (auto v : ok) {
+            EXPECT_TRUE(v);
+        }
+        EXPECT_GT(putMs, 700);
+        EXPECT_LT(putMs, 3000);
+
+        int64_t getMs = RunParallel(8, [&](int i) {
+            auto outcome = client->GetObject("bucket", "object" + std::to_string(i));
+            std::stringstream ss;
+            if (outcome.isSuccess()) {
+                ss << outcome.result().Content()->rdbuf();
+            }
+            ok[i] = ss.str() == Data;
+        });
+        for (auto v : ok) {
+            EXPECT_TRUE(v);
+        }
+        EXPECT_GT(getMs, 700);
+        EXPECT_LT(getMs, 3000);
+
+        //a second client with the same limiter shares it
+        auto other = NewClient(eventLoopThreadNum, nullptr, limiter);
+        int64_t sharedMs = RunParallel(8, [&](int i) {
+            auto outcome = (i % 2 == 0 ? client : other)->GetObject("bucket", "object" + std::to_string(i));
+            ok[i] = outcome.isSuccess();
+        });
+        EXPECT_GT(sharedMs, 700);
+    }
+
+    bool Started;
+    std::string Data;
+};
+
+TEST_F(BandwidthShaperClientTest, SharedLimitTest)
+{
+    if (Started) {
+        SharedLimit(0);
+    }
+}
+
+TEST_F(BandwidthShaperClientTest, EventLoopSharedLimitTest)
+{
+    //paused and resumed by the loop instead of a blocked thread
+    if (Started) {
+        SharedLimit(1);
+    }
+}
+
+}
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <alibabacloud/oss/utils/BatchDeleter.h>
+#include <alibabacloud/oss/utils/ObjectLister.h>
+#include "../LocalOssServer.h"
+#include <algorithm>
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class BatchDeleterTest : public LocalOssServerFixture {
+protected:
+    std::vector<std::string> PutKeys(const std::string &prefix, int num)
+    {
+        std::vector<std::string> keys;
+        for (int i = 0; i < num; i++) {
+            std::string key = prefix + std::to_string(i);
+            EXPECT_TRUE(Client->PutObject("bucket", key, std::make_shared<std::stringstream>()).isSuccess());
+            keys.push_back(key);
+        }
+        return keys;
+    }
+
+    std::vector<std::string> ListKeys()
+    {
+        std::vector<std::string> keys;
+        ObjectLister lister(*Client, ListObjectsRequest("bucket"));
+        for (const auto &summary : lister) {
+            keys.push_back(summary.Key());
+        }
+        return keys;
+    }
+};
+
+TEST_F(BatchDeleterTest, DeleteKeysTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    auto keys = PutKeys("key-", 230);
+    //keys that need the url encoding of the request body
+    for (const char *key : { "a&b", "<x>", "space key", "\xE4\xB8\xAD/%2F" }) {
+        ASSERT_TRUE(Client->PutObject("bucket", key, std::make_shared<std::stringstream>()).isSuccess());
+        keys.push_back(key);
+    }
+    auto kept = PutKeys("kept-", 3);
+
+    BatchDeleter deleter(*Client, "bucket", 3);
+    deleter.setBatchSize(50);
+    for (const auto &key : keys) {
+        EXPECT_TRUE(deleter.add(key));
+    }
+    EXPECT_TRUE(deleter.flush());
+    EXPECT_FALSE(deleter.hasError());
+    EXPECT_EQ(deleter.DeletedCount(), static_cast<int64_t>(keys.size()));
+    EXPECT_EQ(deleter.RequestCount(), 5);
+    EXPECT_TRUE(deleter.FailedKeys().empty());
+    EXPECT_GT(deleter.KeysPerSecond(), 0.0);
+    EXPECT_EQ(ListKeys(), kept);
+
+    //nothing pending
+    EXPECT_TRUE(deleter.flush());
+    EXPECT_EQ(deleter.RequestCount(), 5);
+}
+
+TEST_F(BatchDeleterTest, RetryKeysTest)
+{
+    LocalOssServer::Options options;
+    options.deleteSkipEvery = 3;
+    if (!StartServer(options)) {
+        return;
+    }
+    auto keys = PutKeys("key-", 120);
+
+    //a third of the keys is left at each attempt
+    BatchDeleter oneAttempt(*Client, "bucket", 2);
+    oneAttempt.setBatchSize(30);
+    oneAttempt.setMaxAttempts(1);
+    for (const auto &key : keys) {
+        oneAttempt.add(key);
+    }
+    EXPECT_FALSE(oneAttempt.flush());
+    EXPECT_FALSE(oneAttempt.hasError());
+    EXPECT_EQ(oneAttempt.FailedKeys().size(), 40U);
+    EXPECT_EQ(oneAttempt.DeletedCount(), 80);
+    auto left = ListKeys();
+    auto failed = oneAttempt.FailedKeys();
+    std::vector<std::string> failedKeys(failed.begin(), failed.end());
+    std::sort(failedKeys.begin(), failedKeys.end());
+    EXPECT_EQ(left, failedKeys);
+
+    BatchDeleter deleter(*Client, "bucket", 2);
+    deleter.setBatchSize(30);
+    deleter.setMaxAttempts(10);
+    for (const auto &key : left) {
+        deleter.add(key);
+    }
+    EXPECT_TRUE(deleter.flush());
+    EXPECT_EQ(deleter.DeletedCount(), 40);
+    EXPECT_GT(deleter.RequestCount(), 2);
+    EXPECT_TRUE(ListKeys().empty());
+}
+
+TEST_F(BatchDeleterTest, DeletePrefixTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    PutKeys("a/", 150);
+    auto kept = PutKeys("b/", 5);
+    PutKeys("c", 1);
+
+    BatchDeleter deleter(*Client, "bucket", 4);
+    deleter.setBatchSize(40);
+    EXPECT_TRUE(deleter.deletePrefix("a/"));
+    EXPECT_EQ(deleter.DeletedCount(), 150);
+    EXPECT_TRUE(deleter.deletePrefix("c"));
+    EXPECT_EQ(deleter.DeletedCount(), 151);
+    EXPECT_TRUE(deleter.deletePrefix("none/"));
+    std::sort(kept.begin(), kept.end());
+    EXPECT_EQ(ListKeys(), kept);
+}
+
+TEST_F(BatchDeleterTest, ErrorTest)
+{
+    LocalOssServer::Options options;
+    options.errorRate = 1.0;
+    if (!StartServer(options)) {
+        return;
+    }
+
+    BatchDeleter deleter(*Client, "bucket", 2);
+    deleter.setBatchSize(10);
+    bool added = true;
+    int count = 0;
+    for (; count < 1000 && added; count++) {
+        added = deleter.add("key-" + std::to_string(count));
+    }
+    EXPECT_FALSE(deleter.flush());
+    EXPECT_FALSE(added);
+    EXPECT_TRUE(deleter.hasError());
+    EXPECT_EQ(deleter.error().Code(), "ServiceUnavailable");
+    EXPECT_EQ(deleter.DeletedCount(), 0);
+    EXPECT_FALSE(deleter.FailedKeys().empty());
+
+    BatchDeleter lister(*Client, "bucket");
+    EXPECT_FALSE(lister.deletePrefix("a/"));
+    EXPECT_EQ(lister.error().Code(), "ServiceUnavailable");
+}
+
+}
+}
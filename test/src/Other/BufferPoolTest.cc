@@ -0,0 +1,175 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/utils/BufferPool.h>
+#include "../LocalOssServer.h"
+#include <random>
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class BufferPoolTest : public LocalOssServerFixture {
+};
+
+TEST_F(BufferPoolTest, SizeClassTest)
+{
+    BufferPool pool(BufferPool::SizeClassNum * 2 * BufferPool::MaxBlockSize);
+    size_t capacity = 0;
+    char *block = pool.acquire(1, capacity);
+    EXPECT_EQ(capacity, 4096U);
+    pool.release(block, capacity);
+    //the same block again
+    EXPECT_EQ(pool.acquire(4000, capacity), block);
+    pool.release(block, capacity);
+
+    block = pool.acquire(4097, capacity);
+    EXPECT_EQ(capacity, 16384U);
+    pool.release(block, capacity);
+    block = pool.acquire(BufferPool::MaxBlockSize + 1, capacity);
+    EXPECT_EQ(capacity, BufferPool::MaxBlockSize + 1);
+    pool.release(block, capacity);
+
+    auto stats = pool.Statistics();
+    EXPECT_EQ(stats.acquires, 4U);
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.releases, 4U);
+    //the block over the largest class is not kept
+    EXPECT_EQ(stats.drops, 1U);
+    EXPECT_EQ(stats.pooledBytes, 4096U + 16384U);
+    EXPECT_DOUBLE_EQ(stats.HitRate(), 0.25);
+
+    //two blocks of the largest class fit its share
+    char *blocks[3];
+    for (auto &b : blocks) {
+        b = pool.acquire(BufferPool::MaxBlockSize, capacity);
+    }
+    for (auto &b : blocks) {
+        pool.release(b, capacity);
+    }
+    EXPECT_EQ(pool.Statistics().drops, 2U);
+    pool.clear();
+    EXPECT_EQ(pool.Statistics().pooledBytes, 0U);
+}
+
+TEST_F(BufferPoolTest, StreamMatchesStringStreamTest)
+{
+    //random writes, reads and seeks give the same results as std::stringstream
+    auto pool = std::make_shared<BufferPool>();
+    std::mt19937 rng(20);
+    for (int round = 0; round < 20; round++) {
+        PooledBufferStream pooled(pool, round % 2 == 0 ? 0 : 100);
+        std::stringstream expected;
+        for (int op = 0; op < 300; op++) {
+            int kind = static_cast<int>(rng() % 5);
+            if (kind <= 1) {
+                std::string data(rng() % (kind == 0 ? 10 : 40000), static_cast<char>('a' + op % 26));
+                pooled.write(data.data(), data.size());
+                expected.write(data.data(), data.size());
+            }
+            else if (kind == 2) {
+                size_t size = rng() % 20000;
+                std::string a(size, '\0'), b(size, '\0');
+                pooled.read(&a[0], size);
+                expected.read(&b[0], size);
+                ASSERT_EQ(pooled.gcount(), expected.gcount());
+                ASSERT_EQ(a.substr(0, static_cast<size_t>(pooled.gcount())), b.substr(0, static_cast<size_t>(expected.gcount())));
+                ASSERT_EQ(pooled.eof(), expected.eof());
+                pooled.clear();
+                expected.clear();
+            }
+            else {
+                std::streamoff size = static_cast<std::streamoff>(expected.str().size());
+                std::streamoff pos = static_cast<std::streamoff>(rng() % (size + 2));
+                if (kind == 3) {
+                    pooled.seekg(pos);
+                    expected.seekg(pos);
+                }
+                else {
+                    pooled.seekp(pos);
+                    expected.seekp(pos);
+                }
+                ASSERT_EQ(pooled.fail(), expected.fail());
+                pooled.clear();
+                expected.clear();
+            }
+            ASSERT_EQ(pooled.tellg(), expected.tellg());
+            ASSERT_EQ(pooled.tellp(), expected.tellp());
+        }
+        ASSERT_EQ(pooled.buffer().str(), expected.str());
+        pooled.seekg(0);
+        std::string all((std::istreambuf_iterator<char>(pooled)), std::istreambuf_iterator<char>());
+        ASSERT_EQ(all, expected.str());
+    }
+    EXPECT_GT(pool->Statistics().hits, 0U);
+}
+
+TEST_F(BufferPoolTest, DirectAccessTest)
+{
+    PooledBuffer buffer(nullptr);
+    buffer.append("hello", 5);
+    buffer.append(" world", 6);
+    EXPECT_EQ(buffer.size(), 11U);
+    EXPECT_EQ(std::string(buffer.data(), buffer.size()), "hello world");
+
+    std::iostream stream(&buffer);
+    stream << "!";
+    std::string word;
+    stream >> word;
+    EXPECT_EQ(word, "hello");
+    EXPECT_EQ(buffer.str(), "hello world!");
+
+    //filled in place, then read through the stream
+    buffer.resize(5);
+    buffer.resize(8);
+    memcpy(buffer.data() + 5, "abc", 3);
+    stream.clear();
+    stream.seekg(0);
+    std::getline(stream, word);
+    EXPECT_EQ(word, "helloabc");
+    buffer.clear();
+    EXPECT_EQ(buffer.size(), 0U);
+    EXPECT_GE(buffer.capacity(), 8U);
+}
+
+TEST_F(BufferPoolTest, DefaultResponseStreamTest)
+{
+    if (!StartServer(LocalOssServer::Options(), ClientConfiguration())) {
+        return;
+    }
+    std::string data(40 * 1024 + 3, 'x');
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(i * 7 + i / 13);
+    }
+    ASSERT_TRUE(Client->PutObject("bucket", "object", std::make_shared<std::stringstream>(data)).isSuccess());
+
+    auto before = BufferPool::Default()->Statistics();
+    for (int i = 0; i < 10; i++) {
+        auto outcome = Client->GetObject("bucket", "object");
+        ASSERT_TRUE(outcome.isSuccess());
+        std::stringstream ss;
+        ss << outcome.result().Content()->rdbuf();
+        EXPECT_EQ(ss.str(), data);
+    }
+    //the bodies of the later requests reuse the blocks of the earlier ones
+    auto after = BufferPool::Default()->Statistics();
+    EXPECT_GE(after.hits - before.hits, 9U);
+}
+
+}
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <alibabacloud/oss/Const.h>
+#include <src/utils/CheckpointJournal.h>
+#include <src/utils/FileSystemUtils.h>
+#include <src/utils/Utils.h>
+#include "../LocalOssServer.h"
+#include "../Utils.h"
+#include <fstream>
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class CheckpointJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Path = TestUtils::GetTargetFileName("journal").append(".journal");
+    }
+
+    void TearDown() override
+    {
+        RemoveFile(Path);
+        RemoveFile(Path + ".tmp");
+    }
+
+    static CheckpointJournal::Entry MakeEntry(int32_t partNumber)
+    {
+        CheckpointJournal::Entry entry;
+        entry.partNumber = partNumber;
+        entry.offset = static_cast<int64_t>(partNumber) * 3000000000LL;
+        entry.size = 100 * 1024 + partNumber;
+        entry.crc64 = 0x8000000000000000ULL + static_cast<uint64_t>(partNumber) * 7919;
+        entry.eTag = "\"5B3C1A2E05E1B002CC607C5A" + std::to_string(100000 + partNumber) + "\"";
+        return entry;
+    }
+
+    static void ExpectEntry(const CheckpointJournal::Entry &entry, int32_t partNumber)
+    {
+        auto expected = MakeEntry(partNumber);
+        EXPECT_EQ(entry.partNumber, expected.partNumber);
+        EXPECT_EQ(entry.offset, expected.offset);
+        EXPECT_EQ(entry.size, expected.size);
+        EXPECT_EQ(entry.crc64, expected.crc64);
+        EXPECT_EQ(entry.eTag, expected.eTag);
+    }
+
+    std::string ReadFile()
+    {
+        std::ifstream file(Path, std::ios::in | std::ios::binary);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    void WriteFile(const std::string &data)
+    {
+        std::ofstream file(Path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(data.data(), data.size());
+    }
+
+    std::string Path;
+};
+
+TEST_F(CheckpointJournalTest, AppendReplayTest)
+{
+    std::vector<CheckpointJournal::Entry> entries;
+    CheckpointJournal journal(Path, 2);
+    EXPECT_FALSE(journal.replay(entries));
+    for (int32_t i = 1; i <= 5; i++) {
+        EXPECT_TRUE(journal.append(MakeEntry(i)));
+    }
+    //an etag that does not fit is not logged
+    auto entry = MakeEntry(6);
+    entry.eTag.assign(CheckpointJournal::MaxETagSize + 1, 'e');
+    EXPECT_FALSE(journal.append(entry));
+    journal.close();
+    EXPECT_EQ(ReadFile().size(), CheckpointJournal::HeaderSize + 5 * CheckpointJournal::EntrySize);
+
+    CheckpointJournal reopened(Path);
+    ASSERT_TRUE(reopened.replay(entries));
+    ASSERT_EQ(entries.size(), 5U);
+    for (int32_t i = 1; i <= 5; i++) {
+        ExpectEntry(entries[i - 1], i);
+    }
+    //appended after the existing entries
+    EXPECT_TRUE(reopened.append(MakeEntry(7)));
+    reopened.close();
+    ASSERT_TRUE(reopened.replay(entries));
+    ASSERT_EQ(entries.size(), 6U);
+    ExpectEntry(entries[5], 7);
+
+    reopened.remove();
+    EXPECT_FALSE(reopened.replay(entries));
+}
+
+TEST_F(CheckpointJournalTest, TornTailTest)
+{
+    CheckpointJournal journal(Path);
+    for (int32_t i = 1; i <= 3; i++) {
+        journal.append(MakeEntry(i));
+    }
+    journal.close();
+    std::string data = ReadFile();
+    WriteFile(data.substr(0, data.size() - 10));
+
+    std::vector<CheckpointJournal::Entry> entries;
+    ASSERT_TRUE(journal.replay(entries));
+    ASSERT_EQ(entries.size(), 2U);
+    ExpectEntry(entries[1], 2);
+    //the torn entry is cut off, so the next one is read back
+    EXPECT_EQ(ReadFile().size(), CheckpointJournal::HeaderSize + 2 * CheckpointJournal::EntrySize);
+    journal.append(MakeEntry(3));
+    journal.close();
+    ASSERT_TRUE(journal.replay(entries));
+    ASSERT_EQ(entries.size(), 3U);
+    ExpectEntry(entries[2], 3);
+
+    //a journal torn in its header has no entries
+    WriteFile(data.substr(0, 7));
+    ASSERT_TRUE(journal.replay(entries));
+    EXPECT_TRUE(entries.empty());
+    EXPECT_EQ(ReadFile().size(), CheckpointJournal::HeaderSize);
+}
+
+TEST_F(CheckpointJournalTest, CorruptionTest)
+{
+    CheckpointJournal journal(Path);
+    for (int32_t i = 1; i <= 4; i++) {
+        journal.append(MakeEntry(i));
+    }
+    journal.close();
+    std::string data = ReadFile();
+    data[CheckpointJournal::HeaderSize + 2 * CheckpointJournal::EntrySize + 20] ^= 0x01;
+    WriteFile(data);
+
+    //nothing after a corrupted entry is trusted
+    std::vector<CheckpointJournal::Entry> entries;
+    ASSERT_TRUE(journal.replay(entries));
+    ASSERT_EQ(entries.size(), 2U);
+    ExpectEntry(entries[0], 1);
+    ExpectEntry(entries[1], 2);
+}
+
+TEST_F(CheckpointJournalTest, CompactTest)
+{
+    CheckpointJournal journal(Path);
+    journal.append(MakeEntry(1));
+    journal.append(MakeEntry(2));
+    auto again = MakeEntry(1);
+    again.size = 1;
+    journal.append(again);
+    journal.close();
+
+    //the last entry of a part wins, the log keeps one per part
+    std::vector<CheckpointJournal::Entry> entries;
+    ASSERT_TRUE(journal.replay(entries));
+    ASSERT_EQ(entries.size(), 2U);
+    EXPECT_EQ(entries[0].size, 1);
+    ExpectEntry(entries[1], 2);
+    EXPECT_EQ(ReadFile().size(), CheckpointJournal::HeaderSize + 2 * CheckpointJournal::EntrySize);
+
+    ASSERT_TRUE(journal.compact({ MakeEntry(9) }));
+    ASSERT_TRUE(journal.replay(entries));
+    ASSERT_EQ(entries.size(), 1U);
+    ExpectEntry(entries[0], 9);
+}
+
+class CheckpointJournalResumableTest : public LocalOssServerFixture {
+protected:
+    void SetUp() override
+    {
+        CheckpointDir = TestUtils::GetTargetFileName("journal-checkpoint");
+        CreateDirectory(CheckpointDir);
+        FilePath = TestUtils::GetTargetFileName("journal-upload").append(".tmp");
+        Data.resize(1024 * 1024 + 5);
+        for (size_t i = 0; i < Data.size(); i++) {
+            Data[i] = static_cast<char>(i * 131 + i / 7);
+        }
+        std::ofstream file(FilePath, std::ios::out | std::ios::binary);
+        file.write(Data.data(), Data.size());
+    }
+
+    void TearDown() override
+    {
+        LocalOssServerFixture::TearDown();
+        RemoveFile(FilePath);
+        RemoveDirectory(CheckpointDir);
+    }
+
+    std::string RecordPath(const std::string &src, const std::string &dest)
+    {
+        return CheckpointDir + PATH_DELIMITER + ComputeContentETag(src) + "--" + ComputeContentETag(dest);
+    }
+
+    static std::string ReadFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    std::string CheckpointDir;
+    std::string FilePath;
+    std::string Data;
+};
+
+TEST_F(CheckpointJournalResumableTest, UploadTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    //part 2 fails, the others are in the journal
+    UploadObjectRequest failed("bucket", "object", FilePath, CheckpointDir, 100 * 1024, 3);
+    failed.setCheckpointSyncInterval(1);
+    failed.setFlags(failed.Flags() | (1 << 30));
+    EXPECT_FALSE(Client->ResumableUploadObject(failed).isSuccess());
+
+    std::string record = RecordPath(FilePath, "oss://bucket/object");
+    std::vector<CheckpointJournal::Entry> entries;
+    CheckpointJournal journal(record + ".journal");
+    ASSERT_TRUE(journal.replay(entries));
+    EXPECT_EQ(entries.size(), 10U);
+    for (const auto &entry : entries) {
+        EXPECT_NE(entry.partNumber, 2);
+        EXPECT_FALSE(entry.eTag.empty());
+    }
+
+    //only part 2 is sent again
+    int64_t before = Server->requestCount();
+    UploadObjectRequest retry("bucket", "object", FilePath, CheckpointDir, 100 * 1024, 3);
+    auto outcome = Client->ResumableUploadObject(retry);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(Server->requestCount() - before, 2);
+    EXPECT_EQ(ReadFile(record), "");
+    EXPECT_FALSE(journal.replay(entries));
+
+    auto get = Client->GetObject("bucket", "object");
+    ASSERT_TRUE(get.isSuccess());
+    std::stringstream ss;
+    ss << get.result().Content()->rdbuf();
+    EXPECT_EQ(ss.str(), Data);
+}
+
+TEST_F(CheckpointJournalResumableTest, DownloadTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    auto content = std::make_shared<std::stringstream>(Data);
+    ASSERT_TRUE(Client->PutObject("bucket", "object", content).isSuccess());
+    std::string target = FilePath + ".download";
+
+    DownloadObjectRequest failed("bucket", "object", target, CheckpointDir, 100 * 1024, 3);
+    failed.setFlags(failed.Flags() | (1 << 30));
+    EXPECT_FALSE(Client->ResumableDownloadObject(failed).isSuccess());
+
+    //the record is written once, the parts go to the journal
+    std::string record = RecordPath("oss://bucket/object", target);
+    EXPECT_NE(ReadFile(record).find("\"parts\" : []"), std::string::npos);
+    std::vector<CheckpointJournal::Entry> entries;
+    CheckpointJournal journal(record + ".journal");
+    ASSERT_TRUE(journal.replay(entries));
+    EXPECT_EQ(entries.size(), 10U);
+
+    int64_t before = Server->requestCount();
+    DownloadObjectRequest retry("bucket", "object", target, CheckpointDir, 100 * 1024, 3);
+    auto outcome = Client->ResumableDownloadObject(retry);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    //the object meta and part 2
+    EXPECT_EQ(Server->requestCount() - before, 2);
+    EXPECT_EQ(ReadFile(target), Data);
+    EXPECT_FALSE(journal.replay(entries));
+    RemoveFile(target);
+}
+
+}
+}
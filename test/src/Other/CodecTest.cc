@@ -0,0 +1,191 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <src/utils/Codec.h>
+#include <src/utils/Utils.h>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+namespace
+{
+    /*the stream based versions the codec replaced, as the reference*/
+    std::string LegacyUrlEncode(const std::string &src)
+    {
+        std::stringstream dest;
+        static const char *hex = "0123456789ABCDEF";
+        unsigned char c;
+        for (size_t i = 0; i < src.size(); i++) {
+            c = src[i];
+            if (isalnum(c) || (c == '-') || (c == '_') || (c == '.') || (c == '~')) {
+                dest << c;
+            } else if (c == ' ') {
+                dest << "%20";
+            } else {
+                dest << '%' << hex[c >> 4] << hex[c & 15];
+            }
+        }
+        return dest.str();
+    }
+
+    std::string LegacyUrlDecode(const std::string &src)
+    {
+        std::stringstream unescaped;
+        const char *safe = src.c_str();
+        for (auto i = safe, n = safe + src.size(); i != n; ++i) {
+            if (*i == '%') {
+                char hex[3] = { *(i + 1), *(i + 2), 0 };
+                i += 2;
+                unescaped << (char)strtol(hex, nullptr, 16);
+            }
+            else {
+                unescaped << *i;
+            }
+        }
+        return unescaped.str();
+    }
+
+    std::string LegacyBase64Encode(const std::string &src)
+    {
+        static const char *ENC = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        auto in = reinterpret_cast<const unsigned char *>(src.data());
+        auto inLen = src.size();
+        std::stringstream ss;
+        while (inLen) {
+            ss << ENC[*in >> 2];
+            if (!--inLen) {
+                ss << ENC[(*in & 0x3) << 4] << "==";
+                break;
+            }
+            ss << ENC[((*in & 0x3) << 4) | (*(in + 1) >> 4)];
+            in++;
+            if (!--inLen) {
+                ss << ENC[(*in & 0xF) << 2] << '=';
+                break;
+            }
+            ss << ENC[((*in & 0xF) << 2) | (*(in + 1) >> 6)];
+            in++;
+            ss << ENC[*in & 0x3F];
+            in++, inLen--;
+        }
+        return ss.str();
+    }
+
+    std::string LegacyHexEncode(const std::string &src)
+    {
+        static char hex[] = "0123456789ABCDEF";
+        std::stringstream ss;
+        for (unsigned char c : src) {
+            ss << hex[c >> 4] << hex[c & 0x0F];
+        }
+        return ss.str();
+    }
+
+    /*long kept runs, bytes to escape, and % escapes valid or not, in random mixes*/
+    std::string RandomInput(std::mt19937 &rng)
+    {
+        static const std::string kept = "abcxyzABCXYZ0189-_.~";
+        static const std::string hex = "0123456789abcdefABCDEF";
+        static const std::string odd = " +-xg0\t";
+        std::string s(rng() % 200, '\0');
+        int style = rng() % 4;
+        for (size_t i = 0; i < s.size(); i++) {
+            unsigned r = rng() % 100;
+            if (style == 0 || r < 60) {
+                s[i] = kept[rng() % kept.size()];
+            }
+            else if (r < 80) {
+                s[i] = static_cast<char>(rng() % 256);
+            }
+            else if (i + 2 < s.size()) {
+                s[i++] = '%';
+                s[i++] = (r < 95 ? hex : odd)[rng() % (r < 95 ? hex.size() : odd.size())];
+                s[i] = (r < 95 ? hex : odd)[rng() % (r < 95 ? hex.size() : odd.size())];
+            }
+            else {
+                s[i] = '/';
+            }
+        }
+        return s;
+    }
+
+    std::vector<Codec::Kernel> SupportedKernels()
+    {
+        std::vector<Codec::Kernel> kernels;
+        auto active = Codec::ActiveKernel();
+        for (auto kernel : { Codec::Scalar, Codec::Sse2, Codec::Avx2 }) {
+            if (Codec::setKernel(kernel)) {
+                kernels.push_back(kernel);
+            }
+        }
+        Codec::setKernel(active);
+        return kernels;
+    }
+}
+
+TEST(CodecTest, FuzzEquivalenceTest)
+{
+    auto active = Codec::ActiveKernel();
+    std::mt19937 rng(20261018);
+    std::vector<std::string> inputs = { "", "a", "%41", "%4", "100%25", std::string(64, 'k'), std::string(65, '%') + "00" };
+    for (int i = 0; i < 3000; i++) {
+        inputs.push_back(RandomInput(rng));
+    }
+    for (auto kernel : SupportedKernels()) {
+        ASSERT_TRUE(Codec::setKernel(kernel));
+        for (const auto &input : inputs) {
+            EXPECT_EQ(UrlEncode(input), LegacyUrlEncode(input)) << "kernel " << kernel;
+            EXPECT_EQ(UrlDecode(UrlEncode(input)), input) << "kernel " << kernel;
+            //a trailing % without two characters after it was read past the end before
+            size_t pos = input.rfind('%');
+            if (pos == std::string::npos || pos + 2 < input.size()) {
+                EXPECT_EQ(UrlDecode(input), LegacyUrlDecode(input)) << "kernel " << kernel;
+            }
+        }
+    }
+    Codec::setKernel(active);
+
+    for (size_t i = 0; i < 200; i++) {
+        std::string input = RandomInput(rng).substr(0, i);
+        EXPECT_EQ(Base64Encode(input), LegacyBase64Encode(input));
+        std::string hex;
+        Codec::HexEncode(reinterpret_cast<const unsigned char *>(input.data()), input.size(), hex);
+        EXPECT_EQ(hex, LegacyHexEncode(input));
+    }
+}
+
+TEST(CodecTest, AppendTest)
+{
+    std::string dest = "/bucket/";
+    Codec::UrlEncode("a b", 3, dest);
+    dest.push_back('?');
+    Codec::Base64Encode("ab", 2, dest);
+    EXPECT_EQ(dest, "/bucket/a%20b?YWI=");
+
+    //a truncated escape is kept
+    EXPECT_EQ(UrlDecode("a%"), "a%");
+    EXPECT_EQ(UrlDecode("a%4"), "a%4");
+    //not hex, read as strtol reads it
+    EXPECT_EQ(UrlDecode("%4%41"), std::string("\x04") + "41");
+    EXPECT_EQ(UrlDecode(std::string(40, 'x') + "%"), std::string(40, 'x') + "%");
+}
+
+}
+}
@@ -18,6 +18,9 @@
 #include <src/utils/Crc64.h>
 #include "../Config.h"
 #include "../Utils.h"
+#include <alibabacloud/oss/Const.h>
+#include <src/utils/FileSystemUtils.h>
+#include <fstream>
 
 namespace AlibabaCloud {
 namespace OSS {
@@ -95,6 +98,85 @@ TEST_F(Crc64Test, CombineCRCTest)
     EXPECT_EQ(crc3, crc4);
 }
 
+TEST_F(Crc64Test, CalcCRCMatchTableTest)
+{
+    std::cout << "hardware accelerated:" << CRC64::HardwareAccelerated() << std::endl;
+    std::string data(70000, '\0');
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(rand());
+    }
+
+    //every length around the block sizes, unaligned starts and a non-zero initial crc
+    for (size_t len = 0; len < 300; len++) {
+        for (size_t offset = 0; offset < 3; offset++) {
+            void *buf = (void *)(data.c_str() + offset);
+            EXPECT_EQ(CRC64::CalcCRC(0, buf, len), CRC64::CalcCRCTable(0, buf, len));
+            EXPECT_EQ(CRC64::CalcCRC(UINT64_C(0x0123456789abcdef), buf, len),
+                CRC64::CalcCRCTable(UINT64_C(0x0123456789abcdef), buf, len));
+        }
+    }
+    for (size_t len : { 4095, 4096, 4097, 65536, 69999 }) {
+        void *buf = (void *)(data.c_str() + 1);
+        EXPECT_EQ(CRC64::CalcCRC(0, buf, len), CRC64::CalcCRCTable(0, buf, len));
+    }
+
+    //incremental
+    uint64_t crc = 0;
+    for (size_t pos = 0; pos < data.size(); pos += 1000) {
+        crc = CRC64::CalcCRC(crc, (void *)(data.c_str() + pos), std::min<size_t>(1000, data.size() - pos));
+    }
+    EXPECT_EQ(crc, CRC64::CalcCRCTable(0, (void *)data.c_str(), data.size()));
+}
+
+TEST_F(Crc64Test, CombineCRCLengthsTest)
+{
+    std::string data(5000, '\0');
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(rand());
+    }
+    uint64_t whole = CRC64::CalcCRC(0, (void *)data.c_str(), data.size());
+    //twice, the second round uses the cached operators
+    for (int round = 0; round < 2; round++) {
+        for (size_t split : { 0, 1, 7, 8, 9, 100, 2047, 2048, 4999, 5000 }) {
+            uint64_t crc1 = CRC64::CalcCRC(0, (void *)data.c_str(), split);
+            uint64_t crc2 = CRC64::CalcCRC(0, (void *)(data.c_str() + split), data.size() - split);
+            EXPECT_EQ(CRC64::CombineCRC(crc1, crc2, data.size() - split), whole);
+        }
+    }
+}
+
+TEST_F(Crc64Test, ComputeFileCRC64Test)
+{
+    std::string path = TestUtils::GetExecutableDirectory();
+    path.push_back(PATH_DELIMITER);
+    path.append(TestUtils::GetTargetFileName("ComputeFileCRC64Test"));
+    TestUtils::WriteRandomDatatoFile(path, 20 * 1024 * 1024 + 123);
+
+    std::string data;
+    {
+        std::ifstream in(path, std::ios::in | std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        data = ss.str();
+    }
+    uint64_t expected = CRC64::CalcCRC(0, (void *)data.c_str(), data.size());
+
+    for (uint32_t threadNum : { 0, 1, 2, 3, 8 }) {
+        uint64_t crc = 0;
+        EXPECT_TRUE(ComputeFileCRC64(path, threadNum, crc));
+        EXPECT_EQ(crc, expected);
+    }
+
+    //empty file
+    TestUtils::WriteRandomDatatoFile(path, 0);
+    uint64_t crc = 1;
+    EXPECT_TRUE(ComputeFileCRC64(path, 4, crc));
+    EXPECT_EQ(crc, 0ULL);
+    RemoveFile(path);
+
+    EXPECT_FALSE(ComputeFileCRC64(path + ".not-exist", 4, crc));
+}
+
 TEST_F(Crc64Test, PubObjectCrc64HeaderTest)
 {
     std::string data("This is a test of the emergency broadcast system.");
@@ -0,0 +1,250 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include "../HttpStubServer.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class EventLoopHttpClientTest : public ::testing::Test {
+protected:
+    EventLoopHttpClientTest()
+    {
+    }
+
+    ~EventLoopHttpClientTest() override
+    {
+    }
+
+    void SetUp() override
+    {
+        Started = Server.start();
+    }
+
+    void TearDown() override
+    {
+        Server.stop();
+    }
+
+    static int ThreadCount()
+    {
+#ifdef __linux__
+        std::ifstream in("/proc/self/status");
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, 8, "Threads:") == 0) {
+                return std::atoi(line.c_str() + 8);
+            }
+        }
+#endif
+        return -1;
+    }
+
+    static bool EnsureFileLimit(unsigned long wanted)
+    {
+#ifdef __linux__
+        struct rlimit rl;
+        if (getrlimit(RLIMIT_NOFILE, &rl) != 0) {
+            return false;
+        }
+        if (rl.rlim_cur < wanted && rl.rlim_max >= wanted) {
+            rl.rlim_cur = wanted;
+            setrlimit(RLIMIT_NOFILE, &rl);
+            getrlimit(RLIMIT_NOFILE, &rl);
+        }
+        return rl.rlim_cur >= wanted;
+#else
+        return false;
+#endif
+    }
+
+public:
+    HttpStubServer Server;
+    bool Started;
+};
+
+TEST_F(EventLoopHttpClientTest, ConcurrentGetObjectAsyncTest)
+{
+    const int count = 5000;
+    if (!Started || !EnsureFileLimit(2 * count + 512)) {
+        std::cout << "skip, loopback server or file limit is not available." << std::endl;
+        return;
+    }
+    //hold the responses long enough for all the requests to be sent
+    Server.setResponseDelayMs(3000);
+
+    ClientConfiguration conf;
+    conf.eventLoopThreadNum = 2;
+    conf.maxConnections = count + 100;
+    conf.connectTimeoutMs = 30000;
+    conf.requestTimeoutMs = 30000;
+    int baseThreads = ThreadCount();
+    {
+        OssClient client(Server.endpoint(), "ak", "sk", conf);
+
+        std::mutex lock;
+        std::condition_variable cv;
+        std::atomic<int> done(0);
+        std::atomic<int> succeed(0);
+        std::atomic<int> peakThreads(0);
+
+        auto handler = [&](const OssClient*, const GetObjectRequest&, const GetObjectOutcome& outcome,
+            const std::shared_ptr<const AsyncCallerContext>&) {
+            if (outcome.isSuccess()) {
+                std::string body;
+                *outcome.result().Content() >> body;
+                if (body == "stub") {
+                    succeed++;
+                }
+            }
+            if (++done == count) {
+                std::lock_guard<std::mutex> lck(lock);
+                cv.notify_all();
+            }
+        };
+
+        for (int i = 0; i < count; i++) {
+            GetObjectRequest request("bucket", "key-" + std::to_string(i));
+            client.GetObjectAsync(request, handler);
+        }
+
+        {
+            std::unique_lock<std::mutex> lck(lock);
+            while (!cv.wait_for(lck, std::chrono::milliseconds(20), [&] { return done == count; })) {
+                int cnt = ThreadCount();
+                if (cnt > peakThreads) peakThreads = cnt;
+            }
+        }
+
+        EXPECT_EQ(succeed, count);
+        //all the requests were in flight at the same time
+        EXPECT_GE(Server.peakPendingResponses(), count * 9 / 10);
+        //2 event loops, no thread per request
+        EXPECT_LE(peakThreads - baseThreads, 4);
+    }
+}
+
+TEST_F(EventLoopHttpClientTest, CallableAndSyncApiTest)
+{
+    if (!Started) {
+        return;
+    }
+    ClientConfiguration conf;
+    conf.eventLoopThreadNum = 1;
+    OssClient client(Server.endpoint(), "ak", "sk", conf);
+
+    auto content = std::make_shared<std::stringstream>("hello world");
+    auto putFuture = client.PutObjectCallable(PutObjectRequest("bucket", "put-key", content));
+    auto getFuture = client.GetObjectCallable(GetObjectRequest("bucket", "get-key"));
+    EXPECT_EQ(putFuture.get().isSuccess(), true);
+    EXPECT_EQ(getFuture.get().isSuccess(), true);
+
+    auto outcome = client.GetObject("bucket", "key");
+    EXPECT_EQ(outcome.isSuccess(), true);
+    EXPECT_EQ(Server.requestCount(), 3);
+}
+
+TEST_F(EventLoopHttpClientTest, SyncApiInHandlerTest)
+{
+    if (!Started) {
+        return;
+    }
+    ClientConfiguration conf;
+    conf.eventLoopThreadNum = 1;
+    OssClient client(Server.endpoint(), "ak", "sk", conf);
+
+    std::promise<bool> result;
+    client.GetObjectAsync(GetObjectRequest("bucket", "key"),
+        [&](const OssClient* c, const GetObjectRequest&, const GetObjectOutcome& outcome,
+            const std::shared_ptr<const AsyncCallerContext>&) {
+        //the blocking api called from the event loop must not dead lock
+        auto head = c->HeadObject("bucket", "key");
+        result.set_value(outcome.isSuccess() && head.isSuccess());
+    });
+    EXPECT_EQ(result.get_future().get(), true);
+}
+
+TEST_F(EventLoopHttpClientTest, SyncApiInProgressCallbackTest)
+{
+    if (!Started) {
+        return;
+    }
+    Server.setResponseBody(std::string(64 * 1024, 'x'));
+    ClientConfiguration conf;
+    conf.eventLoopThreadNum = 1;
+    conf.maxConnections = 1;
+    OssClient client(Server.endpoint(), "ak", "sk", conf);
+
+    //the transfer calling back holds the only handle of the pool
+    bool called = false;
+    bool headSuccess = false;
+    GetObjectRequest request("bucket", "key");
+    TransferProgress progress = { [&](size_t, int64_t, int64_t, void *) {
+        if (!called) {
+            called = true;
+            headSuccess = client.HeadObject("bucket", "key").isSuccess();
+        }
+    }, nullptr };
+    request.setTransferProgress(progress);
+
+    std::promise<bool> result;
+    client.GetObjectAsync(request,
+        [&](const OssClient*, const GetObjectRequest&, const GetObjectOutcome& outcome,
+            const std::shared_ptr<const AsyncCallerContext>&) {
+        result.set_value(outcome.isSuccess());
+    });
+    auto future = result.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_TRUE(future.get());
+    EXPECT_TRUE(called);
+    EXPECT_TRUE(headSuccess);
+}
+
+TEST_F(EventLoopHttpClientTest, DestroyClientWithPendingRequestsTest)
+{
+    if (!Started) {
+        return;
+    }
+    Server.setResponseDelayMs(100);
+    std::atomic<int> done(0);
+    {
+        ClientConfiguration conf;
+        conf.eventLoopThreadNum = 2;
+        OssClient client(Server.endpoint(), "ak", "sk", conf);
+        for (int i = 0; i < 50; i++) {
+            client.GetObjectAsync(GetObjectRequest("bucket", "key"),
+                [&](const OssClient*, const GetObjectRequest&, const GetObjectOutcome&,
+                    const std::shared_ptr<const AsyncCallerContext>&) {
+                done++;
+            });
+        }
+    }
+    EXPECT_EQ(done, 50);
+}
+
+}
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/utils/Runnable.h>
+#include <src/utils/Executor.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <set>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class ExecutorTest : public ::testing::Test {
+protected:
+    ExecutorTest()
+    {
+    }
+
+    ~ExecutorTest() override
+    {
+    }
+
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+TEST_F(ExecutorTest, RunAllTasksTest)
+{
+    std::atomic<int> count(0);
+    std::mutex lock;
+    std::set<std::thread::id> ids;
+    {
+        Executor executor(4, 0);
+        for (int i = 0; i < 1000; i++) {
+            executor.execute(new Runnable([&]() {
+                count++;
+                std::lock_guard<std::mutex> lck(lock);
+                ids.insert(std::this_thread::get_id());
+            }));
+        }
+    }
+    EXPECT_EQ(count, 1000);
+    EXPECT_LE(ids.size(), 4U);
+}
+
+TEST_F(ExecutorTest, ThreadNumDefaultTest)
+{
+    Executor executor;
+    EXPECT_GE(executor.ThreadNum(), 1);
+    EXPECT_EQ(executor.MaxQueueDepth(), 0);
+
+    Executor executor1(3, -1);
+    EXPECT_EQ(executor1.ThreadNum(), 3);
+    EXPECT_EQ(executor1.MaxQueueDepth(), 0);
+}
+
+TEST_F(ExecutorTest, BackpressureTest)
+{
+    std::atomic<int> count(0);
+    std::atomic<bool> release(false);
+    Executor executor(1, 2);
+
+    //the only worker is blocked, 2 more tasks fill the queue
+    for (int i = 0; i < 3; i++) {
+        executor.execute(new Runnable([&]() {
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            count++;
+        }));
+    }
+
+    std::atomic<bool> submitted(false);
+    std::thread t([&]() {
+        executor.execute(new Runnable([&]() { count++; }));
+        submitted = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(submitted, false);
+
+    release = true;
+    t.join();
+    EXPECT_EQ(submitted, true);
+    executor.shutdown();
+    EXPECT_EQ(count, 4);
+}
+
+TEST_F(ExecutorTest, SubmitFromWorkerTest)
+{
+    std::atomic<int> count(0);
+    {
+        Executor executor(2, 1);
+        for (int i = 0; i < 10; i++) {
+            executor.execute(new Runnable([&]() {
+                //must not block even though the queue is full
+                for (int j = 0; j < 10; j++) {
+                    executor.execute(new Runnable([&]() { count++; }));
+                }
+                count++;
+            }));
+        }
+    }
+    EXPECT_EQ(count, 110);
+}
+
+TEST_F(ExecutorTest, DestroyFromWorkerTest)
+{
+    std::atomic<int> count(0);
+    std::mutex lock;
+    std::condition_variable cv;
+    bool destroyed = false;
+    auto executor = std::make_shared<Executor>(2, 0);
+    for (int i = 0; i < 10; i++) {
+        executor->execute(new Runnable([&]() { count++; }));
+    }
+    //the last reference goes away on a worker of the pool
+    auto holder = std::make_shared<std::shared_ptr<Executor>>(executor);
+    executor->execute(new Runnable([&, holder]() {
+        holder->reset();
+        std::lock_guard<std::mutex> lck(lock);
+        destroyed = true;
+        cv.notify_one();
+    }));
+    executor = nullptr;
+
+    std::unique_lock<std::mutex> lck(lock);
+    EXPECT_TRUE(cv.wait_for(lck, std::chrono::seconds(10), [&] { return destroyed; }));
+    EXPECT_EQ(count, 10);
+}
+
+TEST_F(ExecutorTest, ExecuteAfterShutdownTest)
+{
+    Executor executor(2, 0);
+    executor.shutdown();
+
+    std::thread::id id;
+    executor.execute(new Runnable([&]() { id = std::this_thread::get_id(); }));
+    EXPECT_EQ(id, std::this_thread::get_id());
+}
+
+}
+}
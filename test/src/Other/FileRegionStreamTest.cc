@@ -0,0 +1,152 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/utils/FileRegionStream.h>
+#include <alibabacloud/oss/Const.h>
+#include <src/utils/Utils.h>
+#include <src/utils/FileSystemUtils.h>
+#include "../Utils.h"
+#include <fstream>
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class FileRegionStreamTest : public ::testing::Test {
+protected:
+    FileRegionStreamTest()
+    {
+    }
+
+    ~FileRegionStreamTest() override
+    {
+    }
+
+    static void SetUpTestCase()
+    {
+        FilePath = TestUtils::GetExecutableDirectory();
+        FilePath.push_back(PATH_DELIMITER);
+        FilePath.append(TestUtils::GetTargetFileName("FileRegionStreamTest"));
+        TestUtils::WriteRandomDatatoFile(FilePath, 100 * 1024 + 123);
+
+        std::ifstream in(FilePath, std::ios::in | std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        Content = ss.str();
+    }
+
+    static void TearDownTestCase()
+    {
+        RemoveFile(FilePath);
+    }
+
+    static std::string ReadAll(std::istream &stream)
+    {
+        std::string data;
+        char buffer[7000];
+        while (stream.read(buffer, sizeof(buffer)), stream.gcount() > 0) {
+            data.append(buffer, static_cast<size_t>(stream.gcount()));
+        }
+        return data;
+    }
+
+public:
+    static std::string FilePath;
+    static std::string Content;
+};
+
+std::string FileRegionStreamTest::FilePath;
+std::string FileRegionStreamTest::Content;
+
+TEST_F(FileRegionStreamTest, ReadWholeFileTest)
+{
+    FileRegionStream stream(FilePath);
+    EXPECT_TRUE(stream.isOpen());
+    EXPECT_EQ(stream.length(), static_cast<int64_t>(Content.size()));
+    EXPECT_EQ(GetIOStreamLength(stream), static_cast<int64_t>(Content.size()));
+    EXPECT_EQ(ReadAll(stream), Content);
+}
+
+TEST_F(FileRegionStreamTest, ReadRegionTest)
+{
+    FileRegionStream stream(FilePath, 1000, 50000);
+    EXPECT_EQ(stream.length(), 50000);
+    EXPECT_EQ(GetIOStreamLength(stream), 50000);
+    EXPECT_EQ(ReadAll(stream), Content.substr(1000, 50000));
+}
+
+TEST_F(FileRegionStreamTest, RegionBeyondEndOfFileTest)
+{
+    int64_t offset = static_cast<int64_t>(Content.size()) - 100;
+    FileRegionStream stream(FilePath, offset, 1000);
+    EXPECT_EQ(stream.length(), 100);
+    EXPECT_EQ(ReadAll(stream), Content.substr(static_cast<size_t>(offset)));
+
+    FileRegionStream empty(FilePath, static_cast<int64_t>(Content.size()) + 10);
+    EXPECT_TRUE(empty.isOpen());
+    EXPECT_EQ(empty.length(), 0);
+    EXPECT_EQ(ReadAll(empty), "");
+}
+
+TEST_F(FileRegionStreamTest, SeekAndTellTest)
+{
+    FileRegionStream stream(FilePath, 10, 20000);
+    EXPECT_EQ(stream.get(), static_cast<unsigned char>(Content[10]));
+    EXPECT_EQ(stream.get(), static_cast<unsigned char>(Content[11]));
+    EXPECT_EQ(stream.tellg(), std::streampos(2));
+
+    //mixed single character and bulk reads
+    char buffer[5000];
+    stream.read(buffer, sizeof(buffer));
+    EXPECT_EQ(std::string(buffer, sizeof(buffer)), Content.substr(12, sizeof(buffer)));
+    EXPECT_EQ(stream.tellg(), std::streampos(5002));
+
+    stream.seekg(-100, std::ios::end);
+    EXPECT_EQ(stream.tellg(), std::streampos(19900));
+    EXPECT_EQ(ReadAll(stream), Content.substr(10 + 19900, 100));
+
+    stream.clear();
+    stream.seekg(300, std::ios::beg);
+    stream.seekg(-50, std::ios::cur);
+    EXPECT_EQ(stream.tellg(), std::streampos(250));
+    EXPECT_EQ(stream.get(), static_cast<unsigned char>(Content[260]));
+
+    //out of the region
+    stream.seekg(20001, std::ios::beg);
+    EXPECT_TRUE(stream.fail());
+}
+
+TEST_F(FileRegionStreamTest, ContentMd5Test)
+{
+    FileRegionStream stream(FilePath, 4096, 65536);
+    std::stringstream expected(Content.substr(4096, 65536));
+    EXPECT_EQ(ComputeContentMD5(stream), ComputeContentMD5(expected));
+    //the position is kept
+    EXPECT_EQ(stream.tellg(), std::streampos(0));
+}
+
+TEST_F(FileRegionStreamTest, OpenNonExistentFileTest)
+{
+    FileRegionStream stream(FilePath + ".not-exist");
+    EXPECT_FALSE(stream.isOpen());
+    EXPECT_TRUE(stream.fail());
+    EXPECT_EQ(stream.length(), 0);
+}
+
+}
+}
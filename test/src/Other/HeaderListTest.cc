@@ -0,0 +1,103 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/http/HttpType.h>
+#include <src/http/HeaderList.h>
+#include <src/http/HttpResponse.h>
+#include <src/utils/SignUtils.h>
+#include <random>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+TEST(HeaderListTest, MatchesHeaderCollectionTest)
+{
+    std::vector<std::string> names = { "Content-Length", "content-length", "ETag", "etag", "x-oss-request-id",
+        "X-OSS-Request-Id", "x-oss-meta-a", "x-oss-meta-B", "x-oss-meta-", "Date", "date-", "A", "a", "_", "~" };
+    std::mt19937 rng(24);
+    for (int round = 0; round < 200; round++) {
+        HeaderList list;
+        HeaderCollection map;
+        for (int i = 0; i < 20; i++) {
+            const auto &name = names[rng() % names.size()];
+            std::string value = std::to_string(rng() % 1000);
+            if (rng() % 5 == 0) {
+                list.remove(name.c_str());
+                map.erase(name);
+                continue;
+            }
+            list.set(name, value);
+            map[name] = value;
+        }
+        //same spellings, values and order
+        EXPECT_EQ(list.toHeaderCollection(), map);
+        ASSERT_EQ(list.size(), map.size());
+        auto it = map.begin();
+        for (const auto &entry : list) {
+            EXPECT_EQ(entry.name(), it->first);
+            EXPECT_EQ(entry.value(), it->second);
+            ++it;
+        }
+        for (const auto &name : names) {
+            auto found = list.find(name);
+            auto mapIt = map.find(name);
+            ASSERT_EQ(found != nullptr, mapIt != map.end()) << name;
+            if (found != nullptr) {
+                EXPECT_EQ(*found, mapIt->second);
+            }
+        }
+        EXPECT_EQ(HeaderList(map).toHeaderCollection(), map);
+    }
+}
+
+TEST(HeaderListTest, ResponseHeaderTest)
+{
+    auto response = std::make_shared<HttpResponse>(std::make_shared<HttpRequest>());
+    std::string line = "x-oss-request-id: 5C06A3B67B8B5A3DA422299D\r\n";
+    response->setHeader(line.data(), 16, line.data() + 18, line.size() - 20);
+    response->setHeader("content-length", 14, "12", 2);
+    response->setHeader(Http::CONTENT_LENGTH, "13");
+    EXPECT_EQ(response->Header("X-Oss-Request-Id"), "5C06A3B67B8B5A3DA422299D");
+    EXPECT_TRUE(response->hasHeader(Http::CONTENT_LENGTH));
+    //the first spelling is kept
+    EXPECT_EQ(response->Headers().begin()->name(), "content-length");
+    EXPECT_EQ(response->Header(Http::CONTENT_LENGTH), "13");
+    response->removeHeader("CONTENT-LENGTH");
+    EXPECT_FALSE(response->hasHeader("content-length"));
+    EXPECT_EQ(response->Headers().size(), 1U);
+}
+
+TEST(HeaderListTest, CanonicalStringTest)
+{
+    HeaderCollection headers;
+    headers[Http::CONTENT_TYPE] = "text/plain";
+    headers[Http::CONTENT_MD5] = "md5";
+    headers["  X-OSS-Meta-Owner "] = "  bench ";
+    headers["x-oss-acl"] = "private";
+    headers["X-Other"] = "not-signed";
+    ParameterCollection parameters;
+    parameters["acl"] = "";
+
+    SignUtils fromMap("1.0");
+    fromMap.build("PUT", "/bucket/key", "date", headers, parameters);
+    SignUtils fromList("1.0");
+    fromList.build("PUT", "/bucket/key", "date", HeaderList(headers), parameters);
+    EXPECT_EQ(fromList.CanonicalString(), fromMap.CanonicalString());
+}
+
+}
+}
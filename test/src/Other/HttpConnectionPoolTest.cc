@@ -0,0 +1,155 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include "../HttpStubServer.h"
+#include <atomic>
+#include <future>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class HttpConnectionPoolTest : public ::testing::Test {
+protected:
+    HttpConnectionPoolTest()
+    {
+    }
+
+    ~HttpConnectionPoolTest() override
+    {
+    }
+
+    void SetUp() override
+    {
+        Started = Server.start();
+    }
+
+    void TearDown() override
+    {
+        Server.stop();
+    }
+
+public:
+    HttpStubServer Server;
+    bool Started;
+};
+
+TEST_F(HttpConnectionPoolTest, PrewarmConnectionsTest)
+{
+    if (!Started) {
+        return;
+    }
+    ClientConfiguration conf;
+    conf.maxConnections = 8;
+    conf.prewarmConnections = 4;
+    OssClient client(Server.endpoint(), "ak", "sk", conf);
+    EXPECT_EQ(Server.requestCount(), 4);
+    EXPECT_EQ(Server.peakConnections(), 4);
+
+    for (int i = 0; i < 4; i++) {
+        auto outcome = client.GetObject("bucket", "key");
+        EXPECT_EQ(outcome.isSuccess(), true);
+    }
+    //served by the warm connections
+    EXPECT_EQ(Server.requestCount(), 8);
+    EXPECT_EQ(Server.peakConnections(), 4);
+}
+
+TEST_F(HttpConnectionPoolTest, PrewarmEventLoopConnectionsTest)
+{
+    if (!Started) {
+        return;
+    }
+    ClientConfiguration conf;
+    conf.eventLoopThreadNum = 1;
+    conf.prewarmConnections = 4;
+    OssClient client(Server.endpoint(), "ak", "sk", conf);
+    EXPECT_EQ(Server.requestCount(), 4);
+    EXPECT_EQ(Server.peakConnections(), 4);
+
+    std::vector<std::future<GetObjectOutcome>> futures;
+    for (int i = 0; i < 4; i++) {
+        futures.push_back(client.GetObjectCallable(GetObjectRequest("bucket", "key")));
+    }
+    for (auto &f : futures) {
+        EXPECT_EQ(f.get().isSuccess(), true);
+    }
+    EXPECT_EQ(Server.peakConnections(), 4);
+}
+
+TEST_F(HttpConnectionPoolTest, ConcurrentRequestsTest)
+{
+    if (!Started) {
+        return;
+    }
+    const int threadNum = 16;
+    const int requestNum = 20;
+    ClientConfiguration conf;
+    conf.maxConnections = 4;
+    OssClient client(Server.endpoint(), "ak", "sk", conf);
+
+    std::atomic<int> succeed(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadNum; i++) {
+        threads.emplace_back([&, i]() {
+            for (int j = 0; j < requestNum; j++) {
+                auto outcome = client.GetObject("bucket", "key-" + std::to_string(i));
+                if (outcome.isSuccess()) {
+                    succeed++;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(succeed, threadNum * requestNum);
+    //no more handles than maxConnections, each one keeps its connection
+    EXPECT_LE(Server.peakConnections(), 4);
+}
+
+TEST_F(HttpConnectionPoolTest, ReuseHandleAcrossMethodsTest)
+{
+    if (!Started) {
+        return;
+    }
+    Server.setResponseBody("hello world");
+    ClientConfiguration conf;
+    conf.maxConnections = 1;
+    OssClient client(Server.endpoint(), "ak", "sk", conf);
+
+    //one handle for all, nothing of the last method may stick to it
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(client.HeadObject("bucket", "key").isSuccess());
+        auto get = client.GetObject("bucket", "key");
+        ASSERT_TRUE(get.isSuccess());
+        std::stringstream ss;
+        ss << get.result().Content()->rdbuf();
+        EXPECT_EQ(ss.str(), "hello world");
+        auto content = std::make_shared<std::stringstream>("data");
+        EXPECT_TRUE(client.PutObject("bucket", "key", content).isSuccess());
+        EXPECT_TRUE(client.DeleteObject("bucket", "key").isSuccess());
+    }
+    EXPECT_EQ(Server.requestCount(), 12);
+    EXPECT_EQ(Server.peakConnections(), 1);
+}
+
+}
+}
@@ -0,0 +1,387 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <alibabacloud/oss/Const.h>
+#include <src/utils/FileSystemUtils.h>
+#include "../LocalOssServer.h"
+#include "../Utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+/*the sdk against the loopback stand-in, no network or account needed*/
+class LocalOssServerTest : public LocalOssServerFixture {
+protected:
+    static std::string Pattern(size_t size, int seed)
+    {
+        std::string data(size, '\0');
+        for (size_t i = 0; i < size; i++) {
+            data[i] = static_cast<char>(i * 13 + seed);
+        }
+        return data;
+    }
+
+    static std::shared_ptr<std::iostream> Stream(const std::string &data)
+    {
+        return std::make_shared<std::stringstream>(data);
+    }
+
+    static std::string Content(const GetObjectOutcome &outcome)
+    {
+        std::stringstream ss;
+        ss << outcome.result().Content()->rdbuf();
+        return ss.str();
+    }
+};
+
+TEST_F(LocalOssServerTest, ObjectTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    OssClient client(Server->endpoint(), "ak", "sk", ClientConfiguration());
+    std::string data = Pattern(300 * 1024, 1);
+
+    ObjectMetaData meta;
+    meta.setContentType("text/plain");
+    meta.UserMetaData()["owner"] = "local";
+    auto putOutcome = client.PutObject(PutObjectRequest("bucket", "dir/object", Stream(data), meta));
+    ASSERT_TRUE(putOutcome.isSuccess()) << putOutcome.error().Message();
+    EXPECT_EQ(putOutcome.result().ETag(), ComputeContentETag(data.data(), data.size()));
+
+    auto headOutcome = client.HeadObject("bucket", "dir/object");
+    ASSERT_TRUE(headOutcome.isSuccess());
+    EXPECT_EQ(headOutcome.result().ContentLength(), static_cast<int64_t>(data.size()));
+    EXPECT_EQ(headOutcome.result().ContentType(), "text/plain");
+    EXPECT_EQ(headOutcome.result().UserMetaData().at("owner"), "local");
+
+    //the crc64 of the whole body is checked by the sdk
+    auto getOutcome = client.GetObject("bucket", "dir/object");
+    ASSERT_TRUE(getOutcome.isSuccess()) << getOutcome.error().Message();
+    EXPECT_EQ(Content(getOutcome), data);
+
+    GetObjectRequest rangeRequest("bucket", "dir/object");
+    rangeRequest.setRange(1000, 1999);
+    getOutcome = client.GetObject(rangeRequest);
+    ASSERT_TRUE(getOutcome.isSuccess());
+    EXPECT_EQ(Content(getOutcome), data.substr(1000, 1000));
+
+    EXPECT_TRUE(client.DeleteObject("bucket", "dir/object").isSuccess());
+    getOutcome = client.GetObject("bucket", "dir/object");
+    ASSERT_FALSE(getOutcome.isSuccess());
+    EXPECT_EQ(getOutcome.error().Code(), "NoSuchKey");
+}
+
+TEST_F(LocalOssServerTest, MultipartTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    OssClient client(Server->endpoint(), "ak", "sk", ClientConfiguration());
+    const size_t partSize = 100 * 1024;
+    std::string data = Pattern(partSize * 2 + 12345, 2);
+
+    auto initOutcome = client.InitiateMultipartUpload(InitiateMultipartUploadRequest("bucket", "multipart"));
+    ASSERT_TRUE(initOutcome.isSuccess());
+    std::string uploadId = initOutcome.result().UploadId();
+
+    PartList parts;
+    for (int i = 0; i * partSize < data.size(); i++) {
+        auto content = Stream(data.substr(i * partSize, partSize));
+        auto outcome = client.UploadPart(UploadPartRequest("bucket", "multipart", i + 1, uploadId, content));
+        ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+        parts.push_back(Part(i + 1, outcome.result().ETag()));
+    }
+
+    auto listOutcome = client.ListParts(ListPartsRequest("bucket", "multipart", uploadId));
+    ASSERT_TRUE(listOutcome.isSuccess());
+    ASSERT_EQ(listOutcome.result().PartList().size(), 3U);
+    EXPECT_EQ(listOutcome.result().PartList()[2].Size(), 12345);
+
+    auto completeOutcome = client.CompleteMultipartUpload(CompleteMultipartUploadRequest("bucket", "multipart", parts, uploadId));
+    ASSERT_TRUE(completeOutcome.isSuccess()) << completeOutcome.error().Message();
+
+    auto getOutcome = client.GetObject("bucket", "multipart");
+    ASSERT_TRUE(getOutcome.isSuccess()) << getOutcome.error().Message();
+    EXPECT_EQ(Content(getOutcome), data);
+
+    //ranged parts in parallel into one file
+    std::string filePath = TestUtils::GetExecutableDirectory() + PATH_DELIMITER + TestUtils::GetTargetFileName("LocalOssServerTest");
+    DownloadObjectRequest download("bucket", "multipart", filePath);
+    download.setPartSize(partSize);
+    download.setThreadNum(3);
+    auto downloadOutcome = client.ResumableDownloadObject(download);
+    ASSERT_TRUE(downloadOutcome.isSuccess()) << downloadOutcome.error().Message();
+    std::ifstream in(filePath, std::ios::in | std::ios::binary);
+    std::stringstream file;
+    file << in.rdbuf();
+    in.close();
+    EXPECT_EQ(file.str(), data);
+    RemoveFile(filePath);
+}
+
+TEST_F(LocalOssServerTest, ContentMd5UploadTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    ClientConfiguration conf;
+    conf.enableContentMd5 = true;
+    OssClient client(Server->endpoint(), "ak", "sk", conf);
+    const size_t partSize = 100 * 1024;
+    std::string data = Pattern(partSize * 2 + 12345, 3);
+
+    auto putOutcome = client.PutObject(PutObjectRequest("bucket", "object", Stream(data)));
+    ASSERT_TRUE(putOutcome.isSuccess()) << putOutcome.error().Message();
+    EXPECT_EQ(Server->verifiedDigestCount(), 1);
+
+    auto initOutcome = client.InitiateMultipartUpload(InitiateMultipartUploadRequest("bucket", "multipart"));
+    ASSERT_TRUE(initOutcome.isSuccess());
+    std::string uploadId = initOutcome.result().UploadId();
+
+    //the parts share one stream, each digest covers only the bytes its request sends
+    auto content = Stream(data);
+    PartList parts;
+    for (int i = 0; i * partSize < data.size(); i++) {
+        content->clear();
+        content->seekg(i * partSize);
+        UploadPartRequest request("bucket", "multipart", i + 1, uploadId, content);
+        request.setContentLength(std::min(partSize, data.size() - i * partSize));
+        auto outcome = client.UploadPart(request);
+        ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+        parts.push_back(Part(i + 1, outcome.result().ETag()));
+    }
+    EXPECT_EQ(Server->verifiedDigestCount(), 4);
+
+    auto completeOutcome = client.CompleteMultipartUpload(CompleteMultipartUploadRequest("bucket", "multipart", parts, uploadId));
+    ASSERT_TRUE(completeOutcome.isSuccess()) << completeOutcome.error().Message();
+    auto getOutcome = client.GetObject("bucket", "multipart");
+    ASSERT_TRUE(getOutcome.isSuccess()) << getOutcome.error().Message();
+    EXPECT_EQ(Content(getOutcome), data);
+}
+
+TEST_F(LocalOssServerTest, ListAndDeleteObjectsTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    OssClient client(Server->endpoint(), "ak", "sk", ClientConfiguration());
+    DeleteObjectsRequest deleteRequest("bucket");
+    for (int i = 0; i < 25; i++) {
+        std::string key = (i < 20 ? "list/a" : "list/sub/b") + std::to_string(100 + i);
+        ASSERT_TRUE(client.PutObject("bucket", key, Stream("x")).isSuccess());
+        deleteRequest.addKey(key);
+    }
+
+    ListObjectsRequest request("bucket");
+    request.setPrefix("list/");
+    request.setMaxKeys(10);
+    std::vector<std::string> keys;
+    bool truncated = true;
+    while (truncated) {
+        auto outcome = client.ListObjects(request);
+        ASSERT_TRUE(outcome.isSuccess());
+        for (auto const &object : outcome.result().ObjectSummarys()) {
+            keys.push_back(object.Key());
+        }
+        truncated = outcome.result().IsTruncated();
+        request.setMarker(outcome.result().NextMarker());
+    }
+    ASSERT_EQ(keys.size(), 25U);
+    EXPECT_EQ(keys.front(), "list/a100");
+    EXPECT_EQ(keys.back(), "list/sub/b124");
+
+    ListObjectsRequest delimited("bucket");
+    delimited.setPrefix("list/");
+    delimited.setDelimiter("/");
+    auto outcome = client.ListObjects(delimited);
+    ASSERT_TRUE(outcome.isSuccess());
+    EXPECT_EQ(outcome.result().ObjectSummarys().size(), 20U);
+    ASSERT_EQ(outcome.result().CommonPrefixes().size(), 1U);
+    EXPECT_EQ(outcome.result().CommonPrefixes().front(), "list/sub/");
+
+    auto deleteOutcome = client.DeleteObjects(deleteRequest);
+    ASSERT_TRUE(deleteOutcome.isSuccess()) << deleteOutcome.error().Message();
+    EXPECT_EQ(deleteOutcome.result().keyList().size(), 25U);
+    outcome = client.ListObjects(ListObjectsRequest("bucket"));
+    ASSERT_TRUE(outcome.isSuccess());
+    EXPECT_TRUE(outcome.result().ObjectSummarys().empty());
+}
+
+TEST_F(LocalOssServerTest, InjectedErrorRetryTest)
+{
+    LocalOssServer::Options options;
+    options.errorRate = 0.3;
+    if (!StartServer(options)) {
+        return;
+    }
+    ClientConfiguration conf;
+    conf.retryStrategy = std::make_shared<JitterRetryStrategy>(20, 1, 5);
+    OssClient client(Server->endpoint(), "ak", "sk", conf);
+    for (int i = 0; i < 20; i++) {
+        auto outcome = client.PutObject("bucket", "retry", Stream("data"));
+        EXPECT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    }
+    EXPECT_GT(Server->requestCount(), 20);
+}
+
+TEST_F(LocalOssServerTest, HedgedGetTest)
+{
+    //every second request stalls for 2s, the hedged GET answers instead
+    LocalOssServer::Options options;
+    options.slowEvery = 2;
+    options.slowLatencyMs = 2000;
+    if (!StartServer(options)) {
+        return;
+    }
+    ClientConfiguration conf;
+    conf.enableHedgedGet = true;
+    conf.hedgeDelayMs = 100;
+    OssClient client(Server->endpoint(), "ak", "sk", conf);
+    std::string data = Pattern(4096, 3);
+    ASSERT_TRUE(client.PutObject("bucket", "hedged", Stream(data)).isSuccess());
+    //only an object of a known size is hedged
+    ASSERT_TRUE(client.HeadObject("bucket", "hedged").isSuccess());
+
+    for (int i = 0; i < 4; i++) {
+        auto start = std::chrono::steady_clock::now();
+        auto outcome = client.GetObject("bucket", "hedged");
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+        EXPECT_EQ(Content(outcome), data);
+        EXPECT_LT(elapsed, 1000);
+    }
+}
+
+TEST_F(LocalOssServerTest, HedgedGetScopeTest)
+{
+    LocalOssServer::Options options;
+    options.latencyMs = 200;
+    if (!StartServer(options)) {
+        return;
+    }
+    ClientConfiguration conf;
+    conf.enableHedgedGet = true;
+    conf.hedgeDelayMs = 20;
+    conf.executorThreadNum = 2;
+    OssClient client(Server->endpoint(), "ak", "sk", conf);
+    std::string data = Pattern(4096, 4);
+    ASSERT_TRUE(client.PutObject("bucket", "hedged", Stream(data)).isSuccess());
+
+    //the size is not known yet, the GET goes alone and learns it
+    auto count = Server->requestCount();
+    auto outcome = client.GetObject("bucket", "hedged");
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(Server->requestCount(), count + 1);
+
+    //the caller sees the progress of one of the two GETs
+    std::atomic<int64_t> progressBytes(0);
+    GetObjectRequest request("bucket", "hedged");
+    request.setTransferProgress({ [&progressBytes](size_t increment, int64_t, int64_t, void *) {
+        progressBytes += static_cast<int64_t>(increment);
+    }, nullptr });
+    count = Server->requestCount();
+    outcome = client.GetObject(request);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(Content(outcome), data);
+    EXPECT_EQ(Server->requestCount(), count + 2);
+    EXPECT_EQ(progressBytes, static_cast<int64_t>(data.size()));
+
+    //a larger object goes alone, straight into the caller's stream
+    std::string large = Pattern(static_cast<size_t>(conf.hedgeMaxSize) + 1, 6);
+    ASSERT_TRUE(client.PutObject("bucket", "large", Stream(large)).isSuccess());
+    ASSERT_TRUE(client.HeadObject("bucket", "large").isSuccess());
+    auto largeTarget = std::make_shared<std::stringstream>();
+    GetObjectRequest largeRequest("bucket", "large");
+    largeRequest.setResponseStreamFactory([largeTarget] { return largeTarget; });
+    count = Server->requestCount();
+    outcome = client.GetObject(largeRequest);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(outcome.result().Content(), largeTarget);
+    EXPECT_EQ(largeTarget->str(), large);
+    EXPECT_EQ(Server->requestCount(), count + 1);
+
+    //a range is never hedged
+    count = Server->requestCount();
+    GetObjectRequest rangeRequest("bucket", "hedged");
+    rangeRequest.setRange(0, 99);
+    outcome = client.GetObject(rangeRequest);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(Content(outcome), data.substr(0, 100));
+    EXPECT_EQ(Server->requestCount(), count + 1);
+
+    //a worker of the executor may be the one its attempts wait for, the GET goes alone
+    count = Server->requestCount();
+    outcome = client.GetObjectCallable(GetObjectRequest("bucket", "hedged")).get();
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(Content(outcome), data);
+    EXPECT_EQ(Server->requestCount(), count + 1);
+
+    //deleted by another client after its size was seen, the error body of the hedged
+    //GETs is parsed into the error and the caller's stream stays empty
+    ASSERT_TRUE(client.PutObject("bucket", "gone", Stream(data)).isSuccess());
+    ASSERT_TRUE(client.HeadObject("bucket", "gone").isSuccess());
+    OssClient other(Server->endpoint(), "ak", "sk", ClientConfiguration());
+    ASSERT_TRUE(other.DeleteObject("bucket", "gone").isSuccess());
+    auto target = std::make_shared<std::stringstream>();
+    GetObjectRequest missing("bucket", "gone");
+    missing.setResponseStreamFactory([target] { return target; });
+    count = Server->requestCount();
+    outcome = client.GetObject(missing);
+    ASSERT_FALSE(outcome.isSuccess());
+    EXPECT_EQ(outcome.error().Code(), "NoSuchKey");
+    EXPECT_TRUE(target->str().empty());
+    EXPECT_EQ(Server->requestCount(), count + 2);
+}
+
+TEST_F(LocalOssServerTest, HedgedGetInEventLoopTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    ClientConfiguration conf;
+    conf.enableHedgedGet = true;
+    conf.hedgeDelayMs = 20;
+    conf.eventLoopThreadNum = 1;
+    OssClient client(Server->endpoint(), "ak", "sk", conf);
+    std::string data = Pattern(4096, 5);
+    ASSERT_TRUE(client.PutObject("bucket", "hedged", Stream(data)).isSuccess());
+    ASSERT_TRUE(client.HeadObject("bucket", "hedged").isSuccess());
+
+    //the loop thread can not wait for the attempts it runs itself
+    auto promise = std::make_shared<std::promise<std::string>>();
+    client.GetObjectAsync(GetObjectRequest("bucket", "hedged"),
+        [&client, promise](const OssClient *, const GetObjectRequest &, const GetObjectOutcome &,
+            const std::shared_ptr<const AsyncCallerContext> &) {
+        auto outcome = client.GetObject("bucket", "hedged");
+        promise->set_value(outcome.isSuccess() ? Content(outcome) : outcome.error().Code());
+    }, nullptr);
+    auto future = promise->get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_EQ(future.get(), data);
+}
+
+}
+}
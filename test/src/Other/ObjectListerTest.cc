@@ -0,0 +1,222 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <alibabacloud/oss/utils/ObjectLister.h>
+#include "../LocalOssServer.h"
+#include <algorithm>
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class ObjectListerTest : public LocalOssServerFixture {
+protected:
+    //"a/000".."c/059" in three directories, "dir/" markers and flat keys at the top level
+    void PutKeys()
+    {
+        for (const char *dir : { "a/", "b/", "c/" }) {
+            Keys.push_back(dir);
+            for (int i = 0; i < 60; i++) {
+                std::string num = std::to_string(i);
+                Keys.push_back(dir + std::string(3 - num.size(), '0') + num);
+            }
+        }
+        for (int i = 0; i < 50; i++) {
+            Keys.push_back("flat-" + std::to_string(i));
+        }
+        for (const auto &key : Keys) {
+            auto content = std::make_shared<std::stringstream>(key);
+            ASSERT_TRUE(Client->PutObject("bucket", key, content).isSuccess());
+        }
+        std::sort(Keys.begin(), Keys.end());
+    }
+
+    static std::vector<std::string> Collect(ObjectLister &lister)
+    {
+        std::vector<std::string> keys;
+        for (const auto &summary : lister) {
+            keys.push_back(summary.Key());
+        }
+        EXPECT_FALSE(lister.hasError());
+        return keys;
+    }
+
+    static ListObjectsRequest PageRequest(int maxKeys)
+    {
+        ListObjectsRequest request("bucket");
+        request.setMaxKeys(maxKeys);
+        return request;
+    }
+
+    std::vector<std::string> Keys;
+};
+
+TEST_F(ObjectListerTest, SerialTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    PutKeys();
+
+    ObjectLister lister(*Client, PageRequest(17));
+    EXPECT_EQ(Collect(lister), Keys);
+
+    ObjectSummary summary;
+    EXPECT_FALSE(lister.next(summary));
+
+    ListObjectsRequest request = PageRequest(20);
+    request.setPrefix("b/");
+    request.setMarker("b/041");
+    ObjectLister prefixLister(*Client, request);
+    auto keys = Collect(prefixLister);
+    ASSERT_EQ(keys.size(), 18U);
+    EXPECT_EQ(keys.front(), "b/042");
+    EXPECT_EQ(keys.back(), "b/059");
+}
+
+TEST_F(ObjectListerTest, ParallelTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    PutKeys();
+
+    //split by the "a/", "b/", "c/" common prefixes
+    ObjectLister ordered(*Client, PageRequest(13), 4, true);
+    EXPECT_EQ(Collect(ordered), Keys);
+
+    ObjectLister unordered(*Client, PageRequest(13), 4, false);
+    auto keys = Collect(unordered);
+    std::sort(keys.begin(), keys.end());
+    EXPECT_EQ(keys, Keys);
+
+    ListObjectsRequest request = PageRequest(10);
+    request.setMarker("b/010");
+    ObjectLister fromMarker(*Client, request, 3, true);
+    std::vector<std::string> expected(std::upper_bound(Keys.begin(), Keys.end(), "b/010"), Keys.end());
+    EXPECT_EQ(Collect(fromMarker), expected);
+}
+
+TEST_F(ObjectListerTest, SampledSplitTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    PutKeys();
+
+    //no common prefixes below "a/", the split keys are sampled
+    ListObjectsRequest request = PageRequest(7);
+    request.setPrefix("a/");
+    ObjectLister lister(*Client, request, 8, true);
+    std::vector<std::string> expected;
+    for (const auto &key : Keys) {
+        if (key.compare(0, 2, "a/") == 0) {
+            expected.push_back(key);
+        }
+    }
+    EXPECT_EQ(Collect(lister), expected);
+}
+
+TEST_F(ObjectListerTest, FlatSplitTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    //more keys than the pages the split keys are looked for in, the rest is sampled
+    std::vector<std::string> keys;
+    for (int i = 0; i < 2500; i++) {
+        std::string num = std::to_string(i * 7919 % 10000);
+        keys.push_back("log-" + std::string(4 - num.size(), '0') + num);
+        auto content = std::make_shared<std::stringstream>(keys.back());
+        ASSERT_TRUE(Client->PutObject("bucket", keys.back(), content).isSuccess());
+    }
+    std::sort(keys.begin(), keys.end());
+    ObjectLister lister(*Client, PageRequest(100), 4, true);
+    EXPECT_EQ(Collect(lister), keys);
+}
+
+TEST_F(ObjectListerTest, SplitKeysTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    PutKeys();
+
+    //a split key is the last key of its range, keys out of the listing are harmless
+    ObjectLister lister(*Client, PageRequest(11), 3, true);
+    lister.setSplitKeys({ "c/030", "a/", "b/015x", "zzz", "a/" });
+    EXPECT_EQ(Collect(lister), Keys);
+
+    ObjectLister pages(*Client, PageRequest(11), 3, false);
+    pages.setSplitKeys({ "b/", "c/" });
+    ObjectSummaryList summaries;
+    size_t count = 0;
+    while (pages.nextPage(summaries)) {
+        EXPECT_LE(summaries.size(), 11U);
+        count += summaries.size();
+    }
+    EXPECT_EQ(count, Keys.size());
+}
+
+TEST_F(ObjectListerTest, DelimiterTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    PutKeys();
+
+    ListObjectsRequest request = PageRequest(5);
+    request.setDelimiter("/");
+    ObjectLister lister(*Client, request, 4, true);
+    ObjectSummaryList summaries;
+    CommonPrefixeList prefixes;
+    std::vector<std::string> keys;
+    std::vector<std::string> allPrefixes;
+    while (lister.nextPage(summaries, prefixes)) {
+        for (const auto &summary : summaries) {
+            keys.push_back(summary.Key());
+        }
+        allPrefixes.insert(allPrefixes.end(), prefixes.begin(), prefixes.end());
+    }
+    EXPECT_FALSE(lister.hasError());
+    EXPECT_EQ(keys.size(), 50U);
+    EXPECT_EQ(allPrefixes, std::vector<std::string>({ "a/", "b/", "c/" }));
+}
+
+TEST_F(ObjectListerTest, ErrorTest)
+{
+    LocalOssServer::Options options;
+    options.errorRate = 1.0;
+    if (!StartServer(options)) {
+        return;
+    }
+
+    ObjectLister serial(*Client, PageRequest(10));
+    ObjectSummary summary;
+    EXPECT_FALSE(serial.next(summary));
+    EXPECT_TRUE(serial.hasError());
+    EXPECT_EQ(serial.error().Code(), "ServiceUnavailable");
+
+    ObjectLister parallel(*Client, PageRequest(10), 4, false);
+    EXPECT_EQ(parallel.begin(), parallel.end());
+    EXPECT_TRUE(parallel.hasError());
+}
+
+}
+}
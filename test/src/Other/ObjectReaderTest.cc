@@ -0,0 +1,192 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <alibabacloud/oss/utils/ObjectReader.h>
+#include "../LocalOssServer.h"
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class ObjectReaderTest : public LocalOssServerFixture {
+protected:
+    std::string PutData(const std::string &key, size_t size, int seed = 0)
+    {
+        std::string data(size, '\0');
+        for (size_t i = 0; i < size; i++) {
+            data[i] = static_cast<char>(i * 131 + i / 7 + seed);
+        }
+        auto content = std::make_shared<std::stringstream>(data);
+        EXPECT_TRUE(Client->PutObject("bucket", key, content).isSuccess());
+        return data;
+    }
+
+    //the rest of the object in reads of 1 byte to 40KB
+    static std::string ReadAll(ObjectReader &reader)
+    {
+        std::string data;
+        std::vector<char> buffer(40 * 1024);
+        for (size_t i = 0; ; i++) {
+            int64_t n = reader.read(buffer.data(), (i * 7919) % buffer.size() + 1);
+            if (n <= 0) {
+                EXPECT_EQ(n, 0);
+                return data;
+            }
+            data.append(buffer.data(), static_cast<size_t>(n));
+        }
+    }
+
+    static std::string ReadAt(ObjectReader &reader, int64_t offset, size_t size)
+    {
+        std::string data(size, '\0');
+        EXPECT_TRUE(reader.seek(offset));
+        int64_t n = reader.read(&data[0], size);
+        data.resize(n > 0 ? static_cast<size_t>(n) : 0);
+        return data;
+    }
+};
+
+TEST_F(ObjectReaderTest, SequentialReadTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    std::string data = PutData("object", 1100 * 1024 + 333);
+    for (int parallel : { 1, 4 }) {
+        ObjectReader reader(*Client, "bucket", "object", 64 * 1024, parallel);
+        EXPECT_EQ(reader.Size(), static_cast<int64_t>(data.size()));
+        EXPECT_EQ(reader.ETag(), Client->HeadObject("bucket", "object").result().ETag());
+        EXPECT_EQ(ReadAll(reader), data);
+        EXPECT_EQ(reader.tell(), static_cast<int64_t>(data.size()));
+        char c;
+        EXPECT_EQ(reader.read(&c, 1), 0);
+        EXPECT_FALSE(reader.hasError());
+        EXPECT_LE(reader.Window(), parallel);
+    }
+
+    //one read across all the blocks
+    ObjectReader reader(*Client, "bucket", "object", 64 * 1024, 3);
+    std::string all(data.size() + 10, '\0');
+    EXPECT_EQ(reader.read(&all[0], all.size()), static_cast<int64_t>(data.size()));
+    all.resize(data.size());
+    EXPECT_EQ(all, data);
+
+    PutData("empty", 0);
+    ObjectReader empty(*Client, "bucket", "empty");
+    EXPECT_EQ(empty.Size(), 0);
+    EXPECT_EQ(ReadAll(empty), "");
+    EXPECT_FALSE(empty.hasError());
+}
+
+TEST_F(ObjectReaderTest, SeekTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    std::string data = PutData("object", 500 * 1024);
+    ObjectReader reader(*Client, "bucket", "object", 16 * 1024, 4);
+    //within the read-ahead, across blocks, backwards and far away
+    for (int64_t offset : { 100, 20000, 40000, 5, 300000, 299999, 450000, 16384, 500 * 1024 - 10 }) {
+        EXPECT_EQ(ReadAt(reader, offset, 30000), data.substr(static_cast<size_t>(offset), 30000));
+        EXPECT_EQ(reader.tell(), std::min<int64_t>(offset + 30000, data.size()));
+    }
+    EXPECT_TRUE(reader.seek(static_cast<int64_t>(data.size())));
+    char c;
+    EXPECT_EQ(reader.read(&c, 1), 0);
+    EXPECT_FALSE(reader.seek(static_cast<int64_t>(data.size()) + 1));
+    EXPECT_FALSE(reader.seek(-1));
+    EXPECT_TRUE(reader.seek(1000));
+    EXPECT_EQ(ReadAll(reader), data.substr(1000));
+    EXPECT_FALSE(reader.hasError());
+}
+
+TEST_F(ObjectReaderTest, WindowTest)
+{
+    LocalOssServer::Options options;
+    options.latencyMs = 20;
+    if (!StartServer(options)) {
+        return;
+    }
+    std::string data = PutData("object", 256 * 1024);
+    ObjectReader reader(*Client, "bucket", "object", 16 * 1024, 4);
+    EXPECT_EQ(reader.Window(), 2);
+    //the reader waits for the first block, the window grows to parallel
+    EXPECT_EQ(ReadAt(reader, 0, 100), data.substr(0, 100));
+    EXPECT_EQ(reader.Window(), 4);
+    //a seek away from the read-ahead starts over
+    EXPECT_TRUE(reader.seek(200 * 1024));
+    EXPECT_EQ(reader.Window(), 2);
+    EXPECT_EQ(ReadAt(reader, 200 * 1024, 100), data.substr(200 * 1024, 100));
+    EXPECT_TRUE(reader.seek(0));
+    EXPECT_EQ(ReadAll(reader), data);
+}
+
+TEST_F(ObjectReaderTest, CancelReadAheadTest)
+{
+    //the put and the head go at once, the range request of the only block stalls for 4s
+    LocalOssServer::Options options;
+    options.slowEvery = 3;
+    options.slowLatencyMs = 4000;
+    if (!StartServer(options)) {
+        return;
+    }
+    std::string data = PutData("object", 64 * 1024);
+    auto start = std::chrono::steady_clock::now();
+    {
+        ObjectReader reader(*Client, "bucket", "object", 64 * 1024, 1);
+        EXPECT_TRUE(reader.seek(0));
+        for (int i = 0; i < 100 && Server->requestCount() < 3; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT_EQ(Server->requestCount(), 3);
+        //past the block, its request is aborted instead of waited for on close
+        EXPECT_TRUE(reader.seek(static_cast<int64_t>(data.size())));
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_LT(elapsed, 3000);
+}
+
+TEST_F(ObjectReaderTest, ErrorTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    char buffer[100];
+    ObjectReader missing(*Client, "bucket", "missing");
+    EXPECT_EQ(missing.read(buffer, sizeof(buffer)), -1);
+    EXPECT_TRUE(missing.hasError());
+    EXPECT_EQ(missing.Size(), -1);
+    EXPECT_FALSE(missing.seek(0));
+
+    //the ranges are bound to the version seen on open
+    std::string data = PutData("object", 200 * 1024);
+    ObjectReader reader(*Client, "bucket", "object", 16 * 1024, 2);
+    EXPECT_EQ(ReadAt(reader, 0, 100), data.substr(0, 100));
+    PutData("object", 200 * 1024, 1);
+    EXPECT_TRUE(reader.seek(150 * 1024));
+    EXPECT_EQ(reader.read(buffer, sizeof(buffer)), -1);
+    EXPECT_TRUE(reader.hasError());
+    EXPECT_EQ(reader.error().Code(), "PreconditionFailed");
+    EXPECT_FALSE(reader.seek(0));
+}
+
+}
+}
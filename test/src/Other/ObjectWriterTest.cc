@@ -0,0 +1,162 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <alibabacloud/oss/utils/ObjectWriter.h>
+#include <src/utils/Crc64.h>
+#include "../LocalOssServer.h"
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class ObjectWriterTest : public LocalOssServerFixture {
+protected:
+    static std::string MakeData(size_t size)
+    {
+        std::string data(size, '\0');
+        for (size_t i = 0; i < size; i++) {
+            data[i] = static_cast<char>(i * 131 + i / 7);
+        }
+        return data;
+    }
+
+    //the data in chunks of 1 byte to 40KB
+    static bool WriteChunks(ObjectWriter &writer, const std::string &data)
+    {
+        size_t pos = 0;
+        for (size_t i = 0; pos < data.size(); i++) {
+            size_t n = std::min(data.size() - pos, (i * 7919) % (40 * 1024) + 1);
+            if (!writer.write(data.data() + pos, n)) {
+                return false;
+            }
+            pos += n;
+        }
+        return true;
+    }
+
+    std::string GetContent(const std::string &key)
+    {
+        auto outcome = Client->GetObject("bucket", key);
+        if (!outcome.isSuccess()) {
+            return "<" + outcome.error().Code() + ">";
+        }
+        std::stringstream ss;
+        ss << outcome.result().Content()->rdbuf();
+        return ss.str();
+    }
+};
+
+TEST_F(ObjectWriterTest, SmallObjectTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    std::string data = MakeData(50 * 1024);
+    ObjectWriter writer(*Client, "bucket", "small", ObjectMetaData(), 100 * 1024);
+    EXPECT_TRUE(WriteChunks(writer, data));
+    EXPECT_TRUE(writer.close());
+    EXPECT_TRUE(writer.close());
+    EXPECT_EQ(writer.PartCount(), 0);
+    EXPECT_EQ(writer.Size(), static_cast<int64_t>(data.size()));
+    EXPECT_FALSE(writer.ETag().empty());
+    EXPECT_EQ(writer.CRC64(), CRC64::CalcCRC(0, const_cast<char *>(data.data()), data.size()));
+    EXPECT_EQ(GetContent("small"), data);
+
+    ObjectWriter empty(*Client, "bucket", "empty");
+    EXPECT_TRUE(empty.close());
+    EXPECT_EQ(GetContent("empty"), "");
+}
+
+TEST_F(ObjectWriterTest, MultipartTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    for (int parallel : { 1, 3 }) {
+        std::string data = MakeData(1100 * 1024 + 333);
+        ObjectMetaData meta;
+        meta.setContentType("application/x-test");
+        std::string key = "multipart-" + std::to_string(parallel);
+        ObjectWriter writer(*Client, "bucket", key, meta, 100 * 1024, parallel);
+        EXPECT_TRUE(WriteChunks(writer, data));
+        EXPECT_TRUE(writer.close());
+        EXPECT_FALSE(writer.hasError());
+        EXPECT_EQ(writer.PartCount(), 12);
+        EXPECT_EQ(writer.Size(), static_cast<int64_t>(data.size()));
+        EXPECT_EQ(writer.CRC64(), CRC64::CalcCRC(0, const_cast<char *>(data.data()), data.size()));
+        EXPECT_EQ(GetContent(key), data);
+        auto head = Client->HeadObject("bucket", key);
+        ASSERT_TRUE(head.isSuccess());
+        EXPECT_EQ(head.result().ContentType(), "application/x-test");
+    }
+
+    //exactly two parts, the last write fills the last part
+    std::string data = MakeData(200 * 1024);
+    ObjectWriter writer(*Client, "bucket", "exact", ObjectMetaData(), 100 * 1024, 2);
+    EXPECT_TRUE(writer.write(data));
+    EXPECT_TRUE(writer.close());
+    EXPECT_EQ(writer.PartCount(), 2);
+    EXPECT_EQ(GetContent("exact"), data);
+}
+
+TEST_F(ObjectWriterTest, AbortTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    std::string data = MakeData(250 * 1024);
+    {
+        ObjectWriter writer(*Client, "bucket", "aborted", ObjectMetaData(), 100 * 1024, 2);
+        EXPECT_TRUE(writer.write(data));
+        writer.abort();
+        EXPECT_FALSE(writer.write(data));
+        EXPECT_FALSE(writer.close());
+        EXPECT_EQ(writer.error().Code(), "ObjectWriterError");
+    }
+    {
+        //not closed, destroyed
+        ObjectWriter writer(*Client, "bucket", "dropped", ObjectMetaData(), 100 * 1024, 2);
+        EXPECT_TRUE(writer.write(data));
+    }
+    EXPECT_FALSE(Client->DoesObjectExist("bucket", "aborted"));
+    EXPECT_FALSE(Client->DoesObjectExist("bucket", "dropped"));
+}
+
+TEST_F(ObjectWriterTest, ErrorTest)
+{
+    LocalOssServer::Options options;
+    options.errorRate = 1.0;
+    if (!StartServer(options)) {
+        return;
+    }
+    std::string data = MakeData(250 * 1024);
+    ObjectWriter writer(*Client, "bucket", "failed", ObjectMetaData(), 100 * 1024, 2);
+    EXPECT_FALSE(writer.write(data));
+    EXPECT_FALSE(writer.close());
+    EXPECT_TRUE(writer.hasError());
+    EXPECT_EQ(writer.error().Code(), "ServiceUnavailable");
+
+    ObjectWriter small(*Client, "bucket", "failed-small");
+    EXPECT_TRUE(small.write(data));
+    EXPECT_FALSE(small.close());
+    EXPECT_EQ(small.error().Code(), "ServiceUnavailable");
+}
+
+}
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/Const.h>
+#include <src/utils/PositionalFile.h>
+#include <src/utils/FileSystemUtils.h>
+#include "../Utils.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+class PositionalFileTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        FilePath = TestUtils::GetExecutableDirectory();
+        FilePath.push_back(PATH_DELIMITER);
+        FilePath.append(TestUtils::GetTargetFileName("PositionalFileTest"));
+        RemoveFile(FilePath);
+    }
+
+    void TearDown() override
+    {
+        RemoveFile(FilePath);
+    }
+
+    static std::string Pattern(size_t size, int seed)
+    {
+        std::string data(size, '\0');
+        for (size_t i = 0; i < size; i++) {
+            data[i] = static_cast<char>(i * 31 + seed);
+        }
+        return data;
+    }
+
+    std::string ReadFile()
+    {
+        std::ifstream in(FilePath, std::ios::in | std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    //writes the parts in parallel, in uneven pieces like the http write callback
+    void WriteParts(bool directIO, const std::vector<std::string> &parts, size_t partSize)
+    {
+        auto file = std::make_shared<PositionalFile>(FilePath, directIO);
+        ASSERT_TRUE(file->isOpen());
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < parts.size(); i++) {
+            workers.emplace_back([&, i]() {
+                PositionalWriteStream stream(file, static_cast<int64_t>(i * partSize));
+                const std::string &data = parts[i];
+                size_t written = 0;
+                size_t piece = 1000 + i;
+                while (written < data.size()) {
+                    size_t n = std::min(piece, data.size() - written);
+                    stream.write(data.data() + written, n);
+                    written += n;
+                }
+                stream.flush();
+                EXPECT_TRUE(stream.good());
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    int64_t FileSize()
+    {
+        std::ifstream in(FilePath, std::ios::in | std::ios::binary | std::ios::ate);
+        return static_cast<int64_t>(in.tellg());
+    }
+
+    std::string FilePath;
+};
+
+TEST_F(PositionalFileTest, ParallelPartsTest)
+{
+    const size_t partSize = 100 * 1024;
+    std::vector<std::string> parts;
+    std::string expected;
+    for (int i = 0; i < 8; i++) {
+        parts.push_back(Pattern(i == 7 ? 12345 : partSize, i));
+        expected.append(parts.back());
+    }
+
+    WriteParts(false, parts, partSize);
+    EXPECT_EQ(ReadFile(), expected);
+}
+
+TEST_F(PositionalFileTest, DirectIOTest)
+{
+    //falls back to the buffered writes where O_DIRECT is not supported
+    const size_t partSize = 1024 * 1024 + 4096;
+    std::vector<std::string> parts;
+    std::string expected;
+    for (int i = 0; i < 4; i++) {
+        parts.push_back(Pattern(i == 3 ? 4096 * 3 + 17 : partSize, i));
+        expected.append(parts.back());
+    }
+
+    WriteParts(true, parts, partSize);
+    EXPECT_EQ(ReadFile(), expected);
+}
+
+TEST_F(PositionalFileTest, RewindTest)
+{
+    auto file = std::make_shared<PositionalFile>(FilePath, true);
+    {
+        //a failed transfer is rewound to the start of the part and written again
+        PositionalWriteStream stream(file, 4096);
+        EXPECT_EQ(stream.tellp(), std::streampos(0));
+        std::string stale = Pattern(10000, 1);
+        stream.write(stale.data(), stale.size());
+        stream.flush();
+        EXPECT_EQ(stream.tellp(), std::streampos(10000));
+
+        stream.seekp(0);
+        std::string data = Pattern(12000, 2);
+        stream.write(data.data(), data.size());
+        stream.put('x');
+    }
+    std::string content = ReadFile();
+    ASSERT_EQ(content.size(), 4096U + 12001U);
+    EXPECT_EQ(content.substr(0, 4096), std::string(4096, '\0'));
+    EXPECT_EQ(content.substr(4096, 12000), Pattern(12000, 2));
+    EXPECT_EQ(content.back(), 'x');
+}
+
+TEST_F(PositionalFileTest, PreallocateTest)
+{
+    auto file = std::make_shared<PositionalFile>(FilePath);
+    ASSERT_TRUE(file->isOpen());
+    if (file->preallocate(1024 * 1024)) {
+        EXPECT_EQ(FileSize(), 1024 * 1024);
+    }
+    EXPECT_TRUE(file->write("abc", 3, 1024 * 1024 - 3));
+    file = nullptr;
+    EXPECT_EQ(FileSize(), 1024 * 1024);
+}
+
+TEST_F(PositionalFileTest, OpenFailedTest)
+{
+    auto file = std::make_shared<PositionalFile>(FilePath + ".not-exist" + PATH_DELIMITER + "file");
+    EXPECT_FALSE(file->isOpen());
+    EXPECT_FALSE(file->write("abc", 3, 0));
+    PositionalWriteStream stream(file, 0);
+    EXPECT_TRUE(stream.bad());
+}
+
+}
+}
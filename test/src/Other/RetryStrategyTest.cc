@@ -0,0 +1,175 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <src/client/LatencyWindow.h>
+#include "../LocalOssServer.h"
+#include <set>
+#include <thread>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+static Error ServerError(long status)
+{
+    Error error("ServerError", "");
+    error.setStatus(status);
+    return error;
+}
+
+namespace
+{
+    //counts how often the xml body is serialized
+    class CountingDeleteObjectsRequest : public DeleteObjectsRequest
+    {
+    public:
+        CountingDeleteObjectsRequest(const std::string &bucket, int &payloads) :
+            DeleteObjectsRequest(bucket), payloads_(payloads) {}
+    protected:
+        std::string payload() const override
+        {
+            payloads_++;
+            return DeleteObjectsRequest::payload();
+        }
+    private:
+        int &payloads_;
+    };
+}
+
+class RetryStrategyTest : public LocalOssServerFixture {
+};
+
+TEST_F(RetryStrategyTest, RetryableErrorTest)
+{
+    EXPECT_TRUE(RetryStrategy::isRetryableError(ServerError(500)));
+    EXPECT_TRUE(RetryStrategy::isRetryableError(ServerError(503)));
+    EXPECT_TRUE(RetryStrategy::isRetryableError(ServerError(ERROR_CURL_BASE + 28)));
+    EXPECT_FALSE(RetryStrategy::isRetryableError(ServerError(404)));
+    EXPECT_FALSE(RetryStrategy::isRetryableError(ServerError(ERROR_CURL_BASE + 6)));
+}
+
+TEST_F(RetryStrategyTest, JitterDelayTest)
+{
+    JitterRetryStrategy strategy(4, 100, 1000);
+    auto error = ServerError(503);
+    EXPECT_TRUE(strategy.shouldRetry(error, 3));
+    EXPECT_FALSE(strategy.shouldRetry(error, 4));
+    EXPECT_FALSE(strategy.shouldRetry(ServerError(404), 0));
+
+    std::set<long> firstDelays;
+    for (int i = 0; i < 1000; i++) {
+        long delay = strategy.calcDelayTimeMs(error, 0);
+        EXPECT_GE(delay, 100);
+        EXPECT_LE(delay, 300);
+        firstDelays.insert(delay);
+        for (long retry = 1; retry < 8; retry++) {
+            delay = strategy.calcDelayTimeMs(error, retry);
+            EXPECT_GE(delay, 100);
+            EXPECT_LE(delay, 1000);
+        }
+    }
+    //clients failing together do not retry together
+    EXPECT_GT(firstDelays.size(), 100U);
+}
+
+TEST_F(RetryStrategyTest, RetryBudgetTest)
+{
+    auto inner = std::make_shared<JitterRetryStrategy>(3, 10, 100);
+    RetryBudgetStrategy strategy(inner, 5, 100);
+    auto error = ServerError(503);
+
+    EXPECT_FALSE(strategy.shouldRetry(error, 3));
+    EXPECT_FALSE(strategy.shouldRetry(ServerError(404), 0));
+    //only the retries the inner strategy takes cost tokens
+    EXPECT_GT(strategy.AvailableTokens(), 4.9);
+
+    int retries = 0;
+    for (int i = 0; i < 20; i++) {
+        if (strategy.shouldRetry(error, 0)) {
+            retries++;
+        }
+    }
+    EXPECT_GE(retries, 5);
+    EXPECT_LT(retries, 8);
+    EXPECT_LT(strategy.AvailableTokens(), 1.0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(strategy.shouldRetry(error, 0));
+    long delay = strategy.calcDelayTimeMs(error, 1);
+    EXPECT_GE(delay, 10);
+    EXPECT_LE(delay, 100);
+}
+
+TEST_F(RetryStrategyTest, RetryReusesRequestTest)
+{
+    LocalOssServer::Options options;
+    options.errorRate = 1.0;
+    ClientConfiguration conf;
+    conf.retryStrategy = std::make_shared<JitterRetryStrategy>(3, 1, 1);
+    if (!StartServer(options, conf)) {
+        return;
+    }
+
+    int payloads = 0;
+    CountingDeleteObjectsRequest request("bucket", payloads);
+    for (int i = 0; i < 100; i++) {
+        request.addKey("object-" + std::to_string(i));
+    }
+    auto outcome = Client->DeleteObjects(request);
+    EXPECT_FALSE(outcome.isSuccess());
+    EXPECT_EQ(outcome.error().Code(), "ServiceUnavailable");
+    //four attempts, one body
+    EXPECT_EQ(Server->requestCount(), 4);
+    EXPECT_EQ(payloads, 1);
+
+    //a retry sends the whole body again
+    options.errorRate = 0.5;
+    LocalOssServer flaky(options);
+    ASSERT_TRUE(flaky.start());
+    conf.retryStrategy = std::make_shared<JitterRetryStrategy>(30, 1, 1);
+    OssClient flakyClient(flaky.endpoint(), "ak", "sk", conf);
+    payloads = 0;
+    outcome = flakyClient.DeleteObjects(request);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(outcome.result().keyList().size(), 100U);
+    EXPECT_EQ(payloads, 1);
+    flaky.stop();
+}
+
+TEST_F(RetryStrategyTest, LatencyWindowTest)
+{
+    LatencyWindow window;
+    for (long i = 1; i < static_cast<long>(LatencyWindow::MinSamples); i++) {
+        window.add(i);
+    }
+    EXPECT_EQ(window.percentile(95), -1);
+
+    for (long i = 1; i <= 100; i++) {
+        window.add(i);
+    }
+    //the oldest samples are dropped once the window is full
+    for (size_t i = 0; i < LatencyWindow::Capacity; i++) {
+        window.add(static_cast<long>(i % 100) + 1);
+    }
+    EXPECT_GE(window.percentile(95), 94);
+    EXPECT_LE(window.percentile(95), 96);
+    EXPECT_EQ(window.percentile(100), 100);
+}
+
+}
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/http/HttpType.h>
+#include <src/auth/HmacSha1Signer.h>
+#include <src/utils/SignUtils.h>
+#include <openssl/hmac.h>
+#include <openssl/evp.h>
+#include <thread>
+#include <vector>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+static std::string HmacSha1Base64(const std::string &src, const std::string &secret)
+{
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int mdLen = 0;
+    HMAC(EVP_sha1(), secret.c_str(), static_cast<int>(secret.size()),
+        reinterpret_cast<const unsigned char*>(src.c_str()), src.size(), md, &mdLen);
+    char encodedData[100];
+    EVP_EncodeBlock(reinterpret_cast<unsigned char*>(encodedData), md, mdLen);
+    return encodedData;
+}
+
+TEST(SignerTest, HmacSha1MatchTest)
+{
+    HmacSha1Signer signer;
+    //empty, shorter, equal to and longer than the sha1 block, the cached key changes each time
+    std::vector<std::string> secrets = { "", "sk", std::string(64, 'k'), std::string(65, 'k'), std::string(200, 's') };
+    std::string src = "PUT\n\ntext/plain\nThu, 17 Oct 2026 00:00:00 GMT\n/bucket/key";
+    for (int round = 0; round < 2; round++) {
+        for (const auto &secret : secrets) {
+            EXPECT_EQ(signer.generate(src, secret), HmacSha1Base64(src, secret));
+            EXPECT_EQ(signer.generate("", secret), "");
+            EXPECT_EQ(signer.generate("x", secret), HmacSha1Base64("x", secret));
+        }
+    }
+}
+
+TEST(SignerTest, HmacSha1MultiThreadTest)
+{
+    HmacSha1Signer signer;
+    std::vector<std::thread> workers;
+    std::vector<int> failures(4, 0);
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&, t]() {
+            std::string secret = "secret-" + std::to_string(t % 2);
+            for (int i = 0; i < 500; i++) {
+                std::string src = "GET\n\n\n" + std::to_string(i) + "\n/bucket";
+                if (signer.generate(src, secret) != HmacSha1Base64(src, secret)) {
+                    failures[t]++;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (auto failure : failures) {
+        EXPECT_EQ(failure, 0);
+    }
+}
+
+TEST(SignerTest, PreparedKeyTest)
+{
+    HmacSha1Signer signer;
+    auto key = signer.prepare("sk");
+    std::string signature = "reused";
+    key->sign("GET\n\n\n1\n/bucket/key", signature);
+    EXPECT_EQ(signature, HmacSha1Base64("GET\n\n\n1\n/bucket/key", "sk"));
+    //a key keeps its secret when the signer moves on to another
+    EXPECT_EQ(signer.generate("x", "other"), HmacSha1Base64("x", "other"));
+    key->sign("x", signature);
+    EXPECT_EQ(signature, HmacSha1Base64("x", "sk"));
+}
+
+TEST(SignerTest, PresignedUrlsTest)
+{
+    std::vector<std::string> keys = { "a", "dir/b c.txt", "%+=&?#", "\xE4\xB8\xAD\xE6\x96\x87/key" };
+    for (int i = 0; i < 2000; i++) {
+        keys.push_back("batch/" + std::to_string(i));
+    }
+    std::vector<std::string> endpoints = { "http://oss-cn-hangzhou.aliyuncs.com", "oss-cn-hangzhou.aliyuncs.com", "http://127.0.0.1:8080" };
+    for (const auto &endpoint : endpoints) {
+        for (int sts = 0; sts < 2; sts++) {
+            ClientConfiguration conf;
+            auto client = sts ? OssClient(endpoint, "ak", "sk+/", "token=+/", conf) : OssClient(endpoint, "ak", "sk", conf);
+            std::vector<std::string> urls(3, "stale");
+            for (auto method : { Http::Get, Http::Put }) {
+                auto outcome = client.GeneratePresignedUrls("bucket", keys, 1700000000, method, urls);
+                ASSERT_TRUE(outcome.isSuccess());
+                ASSERT_EQ(urls.size(), keys.size());
+                for (size_t i = 0; i < keys.size(); i++) {
+                    auto single = client.GeneratePresignedUrl("bucket", keys[i], 1700000000, method);
+                    ASSERT_TRUE(single.isSuccess());
+                    EXPECT_EQ(urls[i], single.result()) << endpoint << " " << keys[i];
+                }
+            }
+        }
+    }
+
+    OssClient client("oss-cn-hangzhou.aliyuncs.com", "ak", "sk", ClientConfiguration());
+    std::vector<std::string> urls;
+    EXPECT_FALSE(client.GeneratePresignedUrls("Bucket", keys, 1700000000, Http::Get, urls).isSuccess());
+    keys.push_back("");
+    EXPECT_FALSE(client.GeneratePresignedUrls("bucket", keys, 1700000000, Http::Get, urls).isSuccess());
+    EXPECT_TRUE(client.GeneratePresignedUrls("bucket", {}, 1700000000, Http::Get, urls).isSuccess());
+    EXPECT_TRUE(urls.empty());
+}
+
+TEST(SignerTest, CanonicalStringTest)
+{
+    HeaderCollection headers;
+    headers[Http::CONTENT_TYPE] = "text/plain";
+    headers[Http::CONTENT_MD5] = "md5";
+    headers["  X-OSS-Meta-Owner "] = "  bench ";
+    headers["x-oss-acl"] = "private";
+    headers["x-oss"] = "not-signed";
+    headers["X-Other"] = "not-signed";
+    ParameterCollection parameters;
+    parameters["uploadId"] = "id";
+    parameters["partNumber"] = "1";
+    parameters["max-keys"] = "100";
+    parameters["acl"] = "";
+
+    SignUtils signUtils("1.0");
+    signUtils.build("PUT", "/bucket/key", "date", headers, parameters);
+    EXPECT_EQ(signUtils.CanonicalString(),
+        "PUT\nmd5\ntext/plain\ndate\n"
+        "x-oss-meta-owner:bench\nx-oss-acl:private\n"
+        "/bucket/key?acl&partNumber=1&uploadId=id");
+
+    signUtils.build("PUT", "/bucket/", "date", HeaderCollection(), ParameterCollection());
+    EXPECT_EQ(signUtils.CanonicalString(), "PUT\n\n\ndate\n/bucket/");
+}
+
+}
+}
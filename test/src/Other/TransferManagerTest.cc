@@ -0,0 +1,352 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <src/utils/TransferManager.h>
+#include <src/utils/FileSystemUtils.h>
+#include "../LocalOssServer.h"
+#include "../Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+namespace
+{
+    class Gate
+    {
+    public:
+        Gate() : entered_(false), open_(false) {}
+        void pass()
+        {
+            std::unique_lock<std::mutex> lck(lock_);
+            entered_ = true;
+            cv_.notify_all();
+            cv_.wait(lck, [this] { return open_; });
+        }
+        void waitEntered()
+        {
+            std::unique_lock<std::mutex> lck(lock_);
+            cv_.wait(lck, [this] { return entered_; });
+        }
+        void open()
+        {
+            std::lock_guard<std::mutex> lck(lock_);
+            open_ = true;
+            cv_.notify_all();
+        }
+    private:
+        std::mutex lock_;
+        std::condition_variable cv_;
+        bool entered_;
+        bool open_;
+    };
+
+    //runs a transfer of parts parts on a thread, each part logs its name
+    std::thread StartTransfer(TransferManager &manager, TransferPriority priority, const std::string &name, int parts,
+        std::mutex &lock, std::vector<std::string> &order)
+    {
+        return std::thread([&manager, priority, name, parts, &lock, &order]() {
+            int next = 0;
+            manager.run(priority, [&](TransferManager::Task &task) -> TransferManager::State {
+                if (next == parts) {
+                    return TransferManager::Done;
+                }
+                std::string part = name + std::to_string(next++);
+                task.bytes = 1;
+                task.run = [part, &lock, &order]() {
+                    std::lock_guard<std::mutex> lck(lock);
+                    order.push_back(part);
+                };
+                return TransferManager::Ready;
+            });
+        });
+    }
+
+    //keeps the single worker of the manager busy until the gate opens
+    std::thread StartGate(TransferManager &manager, Gate &gate)
+    {
+        std::thread thread([&manager, &gate]() {
+            bool taken = false;
+            manager.run(TransferPriority::Normal, [&](TransferManager::Task &task) -> TransferManager::State {
+                if (taken) {
+                    return TransferManager::Done;
+                }
+                taken = true;
+                task.bytes = 1;
+                task.run = [&gate]() { gate.pass(); };
+                return TransferManager::Ready;
+            });
+        });
+        gate.waitEntered();
+        return thread;
+    }
+}
+
+TEST(TransferManagerTest, RoundRobinTest)
+{
+    TransferManager manager(1, 0);
+    Gate gate;
+    std::mutex lock;
+    std::vector<std::string> order;
+    auto gateThread = StartGate(manager, gate);
+    auto a = StartTransfer(manager, TransferPriority::Normal, "a", 4, lock, order);
+    auto b = StartTransfer(manager, TransferPriority::Normal, "b", 2, lock, order);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    gate.open();
+    gateThread.join();
+    a.join();
+    b.join();
+
+    //the transfers take turns part by part, then the longer one runs alone
+    ASSERT_EQ(order.size(), 6U);
+    EXPECT_NE(order[0][0], order[1][0]);
+    EXPECT_NE(order[1][0], order[2][0]);
+    EXPECT_NE(order[2][0], order[3][0]);
+    EXPECT_EQ(std::vector<std::string>(order.begin() + 4, order.end()), std::vector<std::string>({ "a2", "a3" }));
+}
+
+TEST(TransferManagerTest, PriorityTest)
+{
+    TransferManager manager(1, 0);
+    Gate gate;
+    std::mutex lock;
+    std::vector<std::string> order;
+    auto gateThread = StartGate(manager, gate);
+    auto low = StartTransfer(manager, TransferPriority::Low, "l", 2, lock, order);
+    auto normal = StartTransfer(manager, TransferPriority::Normal, "n", 2, lock, order);
+    auto high = StartTransfer(manager, TransferPriority::High, "h", 2, lock, order);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    gate.open();
+    gateThread.join();
+    low.join();
+    normal.join();
+    high.join();
+
+    EXPECT_EQ(order, std::vector<std::string>({ "h0", "h1", "n0", "n1", "l0", "l1" }));
+}
+
+TEST(TransferManagerTest, BusyTest)
+{
+    //a transfer keeps to one part in flight on a pool of four
+    TransferManager manager(4, 0);
+    std::mutex lock;
+    int active = 0;
+    int mostActive = 0;
+    int next = 0;
+    manager.run(TransferPriority::Normal, [&](TransferManager::Task &task) -> TransferManager::State {
+        std::lock_guard<std::mutex> lck(lock);
+        if (next == 20) {
+            return TransferManager::Done;
+        }
+        if (active > 0) {
+            return TransferManager::Busy;
+        }
+        next++;
+        active++;
+        task.bytes = 1;
+        task.run = [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard<std::mutex> lck(lock);
+            mostActive = std::max(mostActive, active);
+            active--;
+        };
+        return TransferManager::Ready;
+    });
+    EXPECT_EQ(next, 20);
+    EXPECT_EQ(active, 0);
+    EXPECT_EQ(mostActive, 1);
+}
+
+TEST(TransferManagerTest, StallTest)
+{
+    //busy with no part in flight stops the transfer, it is not reported done
+    TransferManager manager(2, 0);
+    int next = 0;
+    auto take = [&](TransferManager::Task &task) -> TransferManager::State {
+        if (next == 3) {
+            return TransferManager::Busy;
+        }
+        next++;
+        task.bytes = 1;
+        task.run = []() {};
+        return TransferManager::Ready;
+    };
+    EXPECT_EQ(manager.run(TransferPriority::Normal, take), TransferManager::Busy);
+    EXPECT_EQ(next, 3);
+
+    next = 0;
+    auto finish = [&](TransferManager::Task &task) -> TransferManager::State {
+        if (next == 3) {
+            return TransferManager::Done;
+        }
+        return take(task);
+    };
+    EXPECT_EQ(manager.run(TransferPriority::Normal, finish), TransferManager::Done);
+
+    //the same in the caller thread after shutdown
+    manager.shutdown();
+    next = 0;
+    EXPECT_EQ(manager.run(TransferPriority::Normal, take), TransferManager::Busy);
+    EXPECT_EQ(next, 3);
+}
+
+TEST(TransferManagerTest, InflightBytesTest)
+{
+    TransferManager manager(8, 250);
+    std::mutex lock;
+    uint64_t inflight = 0;
+    uint64_t mostInflight = 0;
+    bool bigAlone = false;
+    auto transfer = [&](int parts, uint64_t bytes) {
+        int next = 0;
+        manager.run(TransferPriority::Normal, [&, parts, bytes](TransferManager::Task &task) -> TransferManager::State {
+            if (next == parts) {
+                return TransferManager::Done;
+            }
+            next++;
+            task.bytes = bytes;
+            task.run = [&, bytes]() {
+                {
+                    std::lock_guard<std::mutex> lck(lock);
+                    inflight += bytes;
+                    mostInflight = bytes > 250 ? mostInflight : std::max(mostInflight, inflight);
+                    if (bytes > 250) {
+                        bigAlone = inflight == bytes;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                std::lock_guard<std::mutex> lck(lock);
+                inflight -= bytes;
+            };
+            return TransferManager::Ready;
+        });
+    };
+    std::thread a([&] { transfer(10, 100); });
+    std::thread b([&] { transfer(10, 100); });
+    //a part over the limit runs when nothing else is in flight
+    std::thread c([&] { transfer(1, 1000); });
+    a.join();
+    b.join();
+    c.join();
+    EXPECT_LE(mostInflight, 200U);
+    EXPECT_TRUE(bigAlone);
+    EXPECT_EQ(inflight, 0U);
+}
+
+TEST(TransferManagerTest, ShutdownTest)
+{
+    TransferManager manager(2, 0);
+    manager.shutdown();
+    //the parts run in the caller thread
+    int parts = 0;
+    std::thread::id id;
+    manager.run(TransferPriority::Normal, [&](TransferManager::Task &task) -> TransferManager::State {
+        if (parts == 3) {
+            return TransferManager::Done;
+        }
+        parts++;
+        task.bytes = 1;
+        task.run = [&]() { id = std::this_thread::get_id(); };
+        return TransferManager::Ready;
+    });
+    EXPECT_EQ(parts, 3);
+    EXPECT_EQ(id, std::this_thread::get_id());
+}
+
+class TransferManagerClientTest : public LocalOssServerFixture {
+protected:
+    void SetUp() override
+    {
+        FilePath = TestUtils::GetTargetFileName("manager-upload").append(".tmp");
+        Data.resize(1024 * 1024 + 77);
+        for (size_t i = 0; i < Data.size(); i++) {
+            Data[i] = static_cast<char>(i * 131 + i / 7);
+        }
+        std::ofstream file(FilePath, std::ios::out | std::ios::binary);
+        file.write(Data.data(), Data.size());
+    }
+
+    void TearDown() override
+    {
+        LocalOssServerFixture::TearDown();
+        RemoveFile(FilePath);
+    }
+
+    bool StartServer(unsigned transferThreadNum)
+    {
+        LocalOssServer::Options options;
+        options.latencyMs = 10;
+        ClientConfiguration conf = NoRetryConfiguration();
+        conf.transferThreadNum = transferThreadNum;
+        return LocalOssServerFixture::StartServer(options, conf);
+    }
+
+    std::string GetContent(const std::string &key)
+    {
+        auto outcome = Client->GetObject("bucket", key);
+        if (!outcome.isSuccess()) {
+            return "<" + outcome.error().Code() + ">";
+        }
+        std::stringstream ss;
+        ss << outcome.result().Content()->rdbuf();
+        return ss.str();
+    }
+
+    std::string FilePath;
+    std::string Data;
+};
+
+TEST_F(TransferManagerClientTest, SharedThreadsTest)
+{
+    if (!StartServer(3)) {
+        return;
+    }
+    //the parts of one transfer are bound by the transfer threads of the client, not ThreadNum
+    UploadObjectRequest request("bucket", "single", FilePath, "", 100 * 1024, 8);
+    auto outcome = Client->ResumableUploadObject(request);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(GetContent("single"), Data);
+    EXPECT_LE(Server->maxActiveRequests(), 3);
+
+    //concurrent transfers of all the priorities share them
+    std::vector<std::thread> threads;
+    std::vector<int> results(6, 0);
+    for (int i = 0; i < 6; i++) {
+        threads.emplace_back([this, i, &results]() {
+            UploadObjectRequest request("bucket", "object" + std::to_string(i), FilePath, "", 100 * 1024, 4);
+            request.setTransferPriority(static_cast<TransferPriority>(i % 3));
+            results[i] = Client->ResumableUploadObject(request).isSuccess();
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < 6; i++) {
+        EXPECT_TRUE(results[i]);
+        EXPECT_EQ(GetContent("object" + std::to_string(i)), Data);
+    }
+}
+
+}
+}
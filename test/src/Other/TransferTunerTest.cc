@@ -0,0 +1,244 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <src/utils/TransferTuner.h>
+#include <src/utils/FileSystemUtils.h>
+#include "../LocalOssServer.h"
+#include "../Utils.h"
+#include <fstream>
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+namespace
+{
+    class FakeClockTuner : public TransferTuner
+    {
+    public:
+        FakeClockTuner(int concurrency, int maxConcurrency, int maxChunks) :
+            TransferTuner(concurrency, maxConcurrency, maxChunks), now(0) {}
+        int64_t now;
+    protected:
+        int64_t nowUs() const override { return now; }
+    };
+
+    //a round of all the slots at once, each part moves bytes in us
+    void RunRound(FakeClockTuner &tuner, uint64_t bytes, int64_t us, int failures = 0)
+    {
+        int parts = tuner.Concurrency();
+        std::vector<int64_t> starts(parts);
+        for (int i = 0; i < parts; i++) {
+            EXPECT_TRUE(tuner.acquire(starts[i]));
+        }
+        tuner.now += us;
+        for (int i = 0; i < parts; i++) {
+            tuner.release(starts[i], i < failures ? 0 : bytes, i >= failures);
+        }
+    }
+}
+
+TEST(TransferTunerTest, FixedTest)
+{
+    TransferTuner tuner(3);
+    EXPECT_FALSE(tuner.adaptive());
+    EXPECT_EQ(tuner.MaxConcurrency(), 3);
+    for (int i = 0; i < 10; i++) {
+        int64_t start;
+        EXPECT_TRUE(tuner.acquire(start));
+        tuner.release(start, 1024, true);
+    }
+    EXPECT_EQ(tuner.Concurrency(), 3);
+    EXPECT_EQ(tuner.chunks(100), 1);
+}
+
+TEST(TransferTunerTest, SlowStartTest)
+{
+    //every part takes 100ms, the throughput grows with the concurrency
+    FakeClockTuner tuner(2, 12, 8);
+    EXPECT_TRUE(tuner.adaptive());
+    std::vector<int> concurrency;
+    std::vector<int> chunks;
+    for (int round = 0; round < 5; round++) {
+        RunRound(tuner, 1024 * 1024, 100 * 1000);
+        concurrency.push_back(tuner.Concurrency());
+        chunks.push_back(tuner.Chunks());
+    }
+    EXPECT_EQ(concurrency, std::vector<int>({ 4, 8, 12, 12, 12 }));
+    //short parts are merged up to the limit
+    EXPECT_EQ(chunks, std::vector<int>({ 2, 4, 8, 8, 8 }));
+    //the tail keeps every slot busy
+    EXPECT_EQ(tuner.chunks(1000), 8);
+    EXPECT_EQ(tuner.chunks(36), 3);
+    EXPECT_EQ(tuner.chunks(5), 1);
+}
+
+TEST(TransferTunerTest, PlateauTest)
+{
+    //the link moves 16MB a second at any concurrency, parts of 1s keep their size
+    FakeClockTuner tuner(2, 32, 8);
+    const uint64_t perSecond = 16 * 1024 * 1024;
+    RunRound(tuner, perSecond / 2, 1000 * 1000);
+    EXPECT_EQ(tuner.Concurrency(), 4);
+    //no gain, then a probe one step higher after four rounds, and back
+    std::vector<int> concurrency;
+    for (int round = 0; round < 6; round++) {
+        RunRound(tuner, perSecond / tuner.Concurrency(), 1000 * 1000);
+        concurrency.push_back(tuner.Concurrency());
+    }
+    EXPECT_EQ(concurrency, std::vector<int>({ 4, 4, 4, 5, 4, 4 }));
+    EXPECT_EQ(tuner.Chunks(), 1);
+
+    //long parts are split again
+    FakeClockTuner slow(4, 4, 8);
+    RunRound(slow, 1024 * 1024, 100 * 1000);
+    RunRound(slow, 1024 * 1024, 100 * 1000);
+    EXPECT_EQ(slow.Chunks(), 4);
+    RunRound(slow, 1024 * 1024, 3000 * 1000);
+    EXPECT_EQ(slow.Chunks(), 2);
+}
+
+TEST(TransferTunerTest, BackOffTest)
+{
+    FakeClockTuner tuner(8, 32, 8);
+    RunRound(tuner, 1024 * 1024, 1000 * 1000);
+    EXPECT_EQ(tuner.Concurrency(), 16);
+    //a failed part halves the concurrency
+    RunRound(tuner, 1024 * 1024, 1000 * 1000, 1);
+    EXPECT_EQ(tuner.Concurrency(), 8);
+    //then one step at a time
+    RunRound(tuner, 1024 * 1024, 1000 * 1000);
+    EXPECT_EQ(tuner.Concurrency(), 9);
+    //a throughput drop takes a quarter back
+    RunRound(tuner, 256 * 1024, 1000 * 1000);
+    EXPECT_EQ(tuner.Concurrency(), 7);
+}
+
+TEST(TransferTunerTest, SlotTest)
+{
+    FakeClockTuner tuner(1, 4, 1);
+    int64_t start, other;
+    EXPECT_TRUE(tuner.acquire(start));
+    EXPECT_FALSE(tuner.acquire(other));
+    tuner.release(start, 0, true);
+    EXPECT_TRUE(tuner.acquire(other));
+    tuner.release(other, 0, true);
+    //slots that sent nothing are no samples
+    EXPECT_EQ(tuner.Concurrency(), 1);
+}
+
+class TransferTunerResumableTest : public LocalOssServerFixture {
+protected:
+    void SetUp() override
+    {
+        CheckpointDir = TestUtils::GetTargetFileName("tuner-checkpoint");
+        CreateDirectory(CheckpointDir);
+        FilePath = TestUtils::GetTargetFileName("tuner-upload").append(".tmp");
+        Data.resize(3 * 1024 * 1024 + 123);
+        for (size_t i = 0; i < Data.size(); i++) {
+            Data[i] = static_cast<char>(i * 131 + i / 7);
+        }
+        std::ofstream file(FilePath, std::ios::out | std::ios::binary);
+        file.write(Data.data(), Data.size());
+    }
+
+    void TearDown() override
+    {
+        LocalOssServerFixture::TearDown();
+        RemoveFile(FilePath);
+        RemoveDirectory(CheckpointDir);
+    }
+
+    std::string GetContent(const std::string &key)
+    {
+        auto outcome = Client->GetObject("bucket", key);
+        if (!outcome.isSuccess()) {
+            return "<" + outcome.error().Code() + ">";
+        }
+        std::stringstream ss;
+        ss << outcome.result().Content()->rdbuf();
+        return ss.str();
+    }
+
+    static std::string ReadFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    std::string CheckpointDir;
+    std::string FilePath;
+    std::string Data;
+};
+
+TEST_F(TransferTunerResumableTest, UploadTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    UploadObjectRequest request("bucket", "tuned", FilePath, "", 100 * 1024, 2);
+    request.setAutoTune(true);
+    auto outcome = Client->ResumableUploadObject(request);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(GetContent("tuned"), Data);
+
+    //part 2 fails, the parts merged by the tuner must not be sent again on resume
+    UploadObjectRequest failed("bucket", "resumed", FilePath, CheckpointDir, 100 * 1024, 2);
+    failed.setAutoTune(true);
+    failed.setFlags(failed.Flags() | (1 << 30));
+    EXPECT_FALSE(Client->ResumableUploadObject(failed).isSuccess());
+    UploadObjectRequest retry("bucket", "resumed", FilePath, CheckpointDir, 100 * 1024, 2);
+    retry.setAutoTune(true);
+    outcome = Client->ResumableUploadObject(retry);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(GetContent("resumed"), Data);
+}
+
+TEST_F(TransferTunerResumableTest, DownloadTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+    auto content = std::make_shared<std::stringstream>(Data);
+    ASSERT_TRUE(Client->PutObject("bucket", "object", content).isSuccess());
+    std::string target = FilePath + ".download";
+
+    DownloadObjectRequest request("bucket", "object", target, "", 100 * 1024, 2);
+    request.setAutoTune(true);
+    auto outcome = Client->ResumableDownloadObject(request);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(ReadFile(target), Data);
+    RemoveFile(target);
+
+    DownloadObjectRequest failed("bucket", "object", target, CheckpointDir, 100 * 1024, 2);
+    failed.setAutoTune(true);
+    failed.setFlags(failed.Flags() | (1 << 30));
+    EXPECT_FALSE(Client->ResumableDownloadObject(failed).isSuccess());
+    DownloadObjectRequest retry("bucket", "object", target, CheckpointDir, 100 * 1024, 2);
+    retry.setAutoTune(true);
+    outcome = Client->ResumableDownloadObject(retry);
+    ASSERT_TRUE(outcome.isSuccess()) << outcome.error().Message();
+    EXPECT_EQ(ReadFile(target), Data);
+    RemoveFile(target);
+}
+
+}
+}
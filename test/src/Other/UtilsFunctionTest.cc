@@ -20,6 +20,7 @@
 #include "../Config.h"
 #include "../Utils.h"
 #include <fstream>
+#include <sstream>
 #include "src/utils/FileSystemUtils.h"
 
 namespace AlibabaCloud {
@@ -698,5 +699,53 @@ TEST_F(UtilsFunctionTest, TwoHeaderCollectionInsertTest)
     EXPECT_EQ(headers1["key3"], "value3");
 }
 
+TEST_F(UtilsFunctionTest, ComputeContentMD5StreamTest)
+{
+    std::string data = TestUtils::GetRandomString(200 * 1024 + 17);
+    auto content = std::make_shared<std::stringstream>(data);
+    content->seekg(100);
+
+    //the whole stream from its start, the position is kept
+    EXPECT_EQ(ComputeContentMD5(*content), ComputeContentMD5(data.c_str(), data.size()));
+    EXPECT_EQ(content->tellg(), std::streampos(100));
+    EXPECT_EQ(ComputeContentETag(*content), ComputeContentETag(data.c_str(), data.size()));
+
+    //the bytes a request sends from the read position
+    uint64_t crc64 = 0;
+    const size_t size = 150 * 1024;
+    EXPECT_EQ(ComputeContentMD5(*content, size, &crc64), ComputeContentMD5(data.c_str() + 100, size));
+    EXPECT_EQ(crc64, ComputeCRC64(0, (void *)(data.c_str() + 100), size));
+    EXPECT_EQ(content->tellg(), std::streampos(100));
+    EXPECT_EQ(ComputeContentMD5(*content, data.size() - 100, nullptr), ComputeContentMD5(data.c_str() + 100, data.size() - 100));
+    EXPECT_EQ(content->tellg(), std::streampos(100));
+}
+
+TEST_F(UtilsFunctionTest, ComputeContentMD5BatchTest)
+{
+    //every padding case, lanes finishing at different blocks, and a body over the in memory limit
+    std::vector<std::string> datas;
+    for (size_t size = 0; size < 200; size++) {
+        datas.push_back(TestUtils::GetRandomString(static_cast<int>(size)));
+    }
+    datas.push_back(TestUtils::GetRandomString(100 * 1024 + 3));
+    datas.push_back(TestUtils::GetRandomString(5 * 1024 * 1024));
+
+    std::vector<std::shared_ptr<std::iostream>> contents;
+    for (const auto &data : datas) {
+        contents.push_back(std::make_shared<std::stringstream>(data));
+    }
+    contents.push_back(nullptr);
+    contents[3]->seekg(2);
+
+    auto md5s = ComputeContentMD5(contents);
+    ASSERT_EQ(md5s.size(), contents.size());
+    for (size_t i = 0; i < datas.size(); i++) {
+        EXPECT_EQ(md5s[i], ComputeContentMD5(datas[i].c_str(), datas[i].size())) << "size:" << datas[i].size();
+    }
+    EXPECT_EQ(md5s.back(), "");
+    EXPECT_EQ(contents[3]->tellg(), std::streampos(2));
+    EXPECT_EQ(ComputeContentMD5(std::vector<std::shared_ptr<std::iostream>>()).size(), 0U);
+}
+
 }
 }
@@ -0,0 +1,345 @@
+/*
+ * Copyright 2009-2017 Alibaba Cloud All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <alibabacloud/oss/OssClient.h>
+#include <alibabacloud/oss/client/RetryStrategy.h>
+#include <src/utils/XmlStreamParser.h>
+#include "../LocalOssServer.h"
+#include <sstream>
+
+namespace AlibabaCloud {
+namespace OSS {
+
+/*records the events as "<name@depth" and ">name@depth=text"*/
+class RecordingHandler : public XmlStreamParser::Handler
+{
+public:
+    void onStartElement(const std::string &name, int depth) override
+    {
+        events.push_back("<" + name + "@" + std::to_string(depth));
+    }
+    void onEndElement(const std::string &name, int depth, std::string &text) override
+    {
+        events.push_back(">" + name + "@" + std::to_string(depth) + "=" + text);
+    }
+    std::vector<std::string> events;
+};
+
+/*exposes the parse flag of a result*/
+template <class T>
+class Parsed : public T
+{
+public:
+    using T::T;
+    using T::ParseDone;
+};
+
+static bool Parse(const std::string &xml, std::vector<std::string> &events, size_t chunk = 0)
+{
+    RecordingHandler handler;
+    XmlStreamParser parser(handler);
+    if (chunk == 0) {
+        parser.feed(xml.c_str(), xml.size());
+    }
+    else {
+        for (size_t pos = 0; pos < xml.size(); pos += chunk) {
+            parser.feed(xml.c_str() + pos, std::min(chunk, xml.size() - pos));
+        }
+    }
+    events = handler.events;
+    return parser.finish();
+}
+
+static const char *ListBucketXml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<ListBucketResult>\n"
+    "  <Name>bucket</Name>\n"
+    "  <Prefix>dir%2F</Prefix>\n"
+    "  <Marker></Marker>\n"
+    "  <MaxKeys>100</MaxKeys>\n"
+    "  <Delimiter>%2F</Delimiter>\n"
+    "  <IsTruncated>true</IsTruncated>\n"
+    "  <NextMarker>dir%2Fb%26c</NextMarker>\n"
+    "  <EncodingType>url</EncodingType>\n"
+    "  <!-- a comment with <tags> -->\n"
+    "  <Contents>\n"
+    "    <Key>dir%2Fa</Key>\n"
+    "    <LastModified>2019-04-26T05:39:32.000Z</LastModified>\n"
+    "    <ETag>&quot;5B3C1A2E053D763E1B002CC607C5A0FE&quot;</ETag>\n"
+    "    <Type>Normal</Type>\n"
+    "    <Size>344606</Size>\n"
+    "    <StorageClass>IA</StorageClass>\n"
+    "    <Owner>\n"
+    "      <ID>0022012</ID>\n"
+    "      <DisplayName>user-&#x41;&#66;</DisplayName>\n"
+    "    </Owner>\n"
+    "  </Contents>\n"
+    "  <Contents>\n"
+    "    <Key>dir%2Fb%26c</Key>\n"
+    "    <LastModified>2019-04-26T05:39:33.000Z</LastModified>\n"
+    "    <ETag><![CDATA[\"etag>]]\"]]></ETag>\n"
+    "    <Type>Appendable</Type>\n"
+    "    <Size>0</Size>\n"
+    "    <StorageClass>Standard</StorageClass>\n"
+    "  </Contents>\n"
+    "  <CommonPrefixes>\n"
+    "    <Prefix>dir%2Fsub%2F</Prefix>\n"
+    "  </CommonPrefixes>\n"
+    "</ListBucketResult>\n";
+
+class XmlStreamParserTest : public LocalOssServerFixture {
+};
+
+TEST_F(XmlStreamParserTest, ChunkedFeedTest)
+{
+    std::vector<std::string> whole;
+    ASSERT_TRUE(Parse(ListBucketXml, whole));
+    EXPECT_EQ(whole.front(), "<ListBucketResult@1");
+    EXPECT_EQ(whole.back(), ">ListBucketResult@1=");
+
+    //every split point and small chunks give the same events
+    std::string xml = ListBucketXml;
+    for (size_t split = 1; split < xml.size(); split++) {
+        RecordingHandler handler;
+        XmlStreamParser parser(handler);
+        parser.feed(xml.c_str(), split);
+        parser.feed(xml.c_str() + split, xml.size() - split);
+        EXPECT_TRUE(parser.finish()) << split;
+        EXPECT_EQ(handler.events, whole) << split;
+    }
+    for (size_t chunk : { 1, 2, 3, 7, 64 }) {
+        std::vector<std::string> events;
+        EXPECT_TRUE(Parse(xml, events, chunk));
+        EXPECT_EQ(events, whole) << chunk;
+    }
+}
+
+TEST_F(XmlStreamParserTest, TextTest)
+{
+    std::vector<std::string> events;
+    ASSERT_TRUE(Parse("<a x=\"1>2\"><b>&lt;&amp;&gt;&apos;&quot;&#20013;&unknown;&amp</b>"
+        "<c><![CDATA[<not/>&amp;]]>tail</c><d/><e>  </e>\n</a>", events));
+    std::vector<std::string> expected = {
+        "<a@1",
+        "<b@2", ">b@2=<&>'\"\xE4\xB8\xAD&unknown;&amp",
+        "<c@2", ">c@2=<not/>&amp;tail",
+        "<d@2", ">d@2=",
+        "<e@2", ">e@2=  ",
+        ">a@1="
+    };
+    EXPECT_EQ(events, expected);
+
+    std::string decoded;
+    XmlDecodeEntities("a&lt;b&#x4e2d;&#0;", 18, decoded);
+    EXPECT_EQ(decoded, "a<b\xE4\xB8\xAD&#0;");
+}
+
+TEST_F(XmlStreamParserTest, MalformedTest)
+{
+    std::vector<std::string> events;
+    EXPECT_FALSE(Parse("", events));
+    EXPECT_FALSE(Parse("<a><b></a>", events));
+    EXPECT_FALSE(Parse("<a></b>", events));
+    EXPECT_FALSE(Parse("<a><b></b>", events));
+    EXPECT_FALSE(Parse("<a></a><b></b>", events));
+    EXPECT_FALSE(Parse("<a><></a>", events));
+    EXPECT_FALSE(Parse("<a><b", events));
+    EXPECT_FALSE(Parse("not xml", events));
+    EXPECT_TRUE(Parse("<a/>", events));
+}
+
+TEST_F(XmlStreamParserTest, ListObjectsResultTest)
+{
+    auto content = std::make_shared<std::stringstream>(ListBucketXml);
+    Parsed<ListObjectsResult> result(content);
+    EXPECT_TRUE(result.ParseDone());
+    EXPECT_EQ(result.Name(), "bucket");
+    EXPECT_EQ(result.Prefix(), "dir/");
+    EXPECT_EQ(result.Marker(), "");
+    EXPECT_EQ(result.MaxKeys(), 100);
+    EXPECT_EQ(result.Delimiter(), "/");
+    EXPECT_TRUE(result.IsTruncated());
+    EXPECT_EQ(result.NextMarker(), "dir/b&c");
+    EXPECT_EQ(result.EncodingType(), "url");
+    ASSERT_EQ(result.ObjectSummarys().size(), 2U);
+    const auto &first = result.ObjectSummarys()[0];
+    EXPECT_EQ(first.Key(), "dir/a");
+    EXPECT_EQ(first.LastModified(), "2019-04-26T05:39:32.000Z");
+    EXPECT_EQ(first.ETag(), "5B3C1A2E053D763E1B002CC607C5A0FE");
+    EXPECT_EQ(first.Type(), "Normal");
+    EXPECT_EQ(first.Size(), 344606);
+    EXPECT_EQ(first.Owner().Id(), "0022012");
+    EXPECT_EQ(first.Owner().DisplayName(), "user-AB");
+    const auto &second = result.ObjectSummarys()[1];
+    EXPECT_EQ(second.Key(), "dir/b&c");
+    EXPECT_EQ(second.ETag(), "etag>]]");
+    EXPECT_EQ(second.Size(), 0);
+    EXPECT_EQ(second.Owner().Id(), "");
+    ASSERT_EQ(result.CommonPrefixes().size(), 1U);
+    EXPECT_EQ(result.CommonPrefixes().front(), "dir/sub/");
+
+    Parsed<ListObjectsResult> fromString{ std::string(ListBucketXml) };
+    EXPECT_TRUE(fromString.ParseDone());
+    EXPECT_EQ(fromString.ObjectSummarys().size(), 2U);
+    EXPECT_EQ(fromString.NextMarker(), "dir/b&c");
+
+    Parsed<ListObjectsResult> other{ std::string("<Error><Code>NoSuchBucket</Code></Error>") };
+    EXPECT_TRUE(other.ObjectSummarys().empty());
+    EXPECT_TRUE(other.Name().empty());
+    EXPECT_FALSE(Parsed<ListObjectsResult>(std::string("<ListBucketResult><Name>b</Name>")).ParseDone());
+}
+
+TEST_F(XmlStreamParserTest, ListPartsResultTest)
+{
+    std::string xml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<ListPartsResult>\n"
+        "  <Bucket>bucket</Bucket>\n"
+        "  <EncodingType>url</EncodingType>\n"
+        "  <Key>dir%2Fkey</Key>\n"
+        "  <UploadId>0004B999EF5A239BB9138C6227D69F95</UploadId>\n"
+        "  <PartNumberMarker>1</PartNumberMarker>\n"
+        "  <NextPartNumberMarker>3</NextPartNumberMarker>\n"
+        "  <MaxParts>2</MaxParts>\n"
+        "  <IsTruncated>true</IsTruncated>\n"
+        "  <Part>\n"
+        "    <PartNumber>2</PartNumber>\n"
+        "    <LastModified>2012-02-23T07:01:34.000Z</LastModified>\n"
+        "    <ETag>\"3349DC700140D7F86A0784842780****\"</ETag>\n"
+        "    <HashCrc64ecma>1234</HashCrc64ecma>\n"
+        "    <Size>6291456</Size>\n"
+        "  </Part>\n"
+        "  <Part>\n"
+        "    <PartNumber>3</PartNumber>\n"
+        "    <Size>1024</Size>\n"
+        "  </Part>\n"
+        "</ListPartsResult>\n";
+    Parsed<ListPartsResult> result(std::make_shared<std::stringstream>(xml));
+    EXPECT_TRUE(result.ParseDone());
+    EXPECT_EQ(result.Bucket(), "bucket");
+    EXPECT_EQ(result.Key(), "dir/key");
+    EXPECT_EQ(result.UploadId(), "0004B999EF5A239BB9138C6227D69F95");
+    EXPECT_EQ(result.PartNumberMarker(), 1U);
+    EXPECT_EQ(result.NextPartNumberMarker(), 3U);
+    EXPECT_EQ(result.MaxParts(), 2U);
+    EXPECT_TRUE(result.IsTruncated());
+    ASSERT_EQ(result.PartList().size(), 2U);
+    EXPECT_EQ(result.PartList()[0].PartNumber(), 2);
+    EXPECT_EQ(result.PartList()[0].ETag(), "3349DC700140D7F86A0784842780****");
+    EXPECT_EQ(result.PartList()[0].CRC64(), 1234ULL);
+    EXPECT_EQ(result.PartList()[0].Size(), 6291456);
+    EXPECT_EQ(result.PartList()[1].PartNumber(), 3);
+    EXPECT_EQ(result.PartList()[1].Size(), 1024);
+}
+
+TEST_F(XmlStreamParserTest, ListMultipartUploadsResultTest)
+{
+    std::string xml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<ListMultipartUploadsResult>\n"
+        "  <Bucket>bucket</Bucket>\n"
+        "  <EncodingType>url</EncodingType>\n"
+        "  <KeyMarker>a%2F</KeyMarker>\n"
+        "  <UploadIdMarker></UploadIdMarker>\n"
+        "  <NextKeyMarker>b%2Fx</NextKeyMarker>\n"
+        "  <NextUploadIdMarker>0004B99B8E707874FC2D692FA5D77D3F</NextUploadIdMarker>\n"
+        "  <MaxUploads>2</MaxUploads>\n"
+        "  <IsTruncated>false</IsTruncated>\n"
+        "  <Upload>\n"
+        "    <Key>a%2Fy</Key>\n"
+        "    <UploadId>0004B999EF518A1FE585B0C9360DC4C8</UploadId>\n"
+        "    <Initiated>2012-02-23T04:18:23.000Z</Initiated>\n"
+        "  </Upload>\n"
+        "  <Upload>\n"
+        "    <Key>b%2Fx</Key>\n"
+        "    <UploadId>0004B99B8E707874FC2D692FA5D77D3F</UploadId>\n"
+        "    <Initiated>2012-02-23T06:14:27.000Z</Initiated>\n"
+        "  </Upload>\n"
+        "  <CommonPrefixes>\n"
+        "    <Prefix>c%2F</Prefix>\n"
+        "  </CommonPrefixes>\n"
+        "</ListMultipartUploadsResult>\n";
+    Parsed<ListMultipartUploadsResult> result(std::make_shared<std::stringstream>(xml));
+    EXPECT_TRUE(result.ParseDone());
+    EXPECT_EQ(result.Bucket(), "bucket");
+    EXPECT_EQ(result.KeyMarker(), "a/");
+    EXPECT_EQ(result.NextKeyMarker(), "b/x");
+    EXPECT_EQ(result.NextUploadIdMarker(), "0004B99B8E707874FC2D692FA5D77D3F");
+    EXPECT_EQ(result.MaxUploads(), 2U);
+    EXPECT_FALSE(result.IsTruncated());
+    ASSERT_EQ(result.MultipartUploadList().size(), 2U);
+    EXPECT_EQ(result.MultipartUploadList()[0].Key, "a/y");
+    EXPECT_EQ(result.MultipartUploadList()[0].UploadId, "0004B999EF518A1FE585B0C9360DC4C8");
+    EXPECT_EQ(result.MultipartUploadList()[1].Key, "b/x");
+    EXPECT_EQ(result.MultipartUploadList()[1].Initiated, "2012-02-23T06:14:27.000Z");
+    ASSERT_EQ(result.CommonPrefixes().size(), 1U);
+    EXPECT_EQ(result.CommonPrefixes().front(), "c/");
+
+    EXPECT_FALSE(Parsed<ListMultipartUploadsResult>(std::string("<Error><Code>NoSuchBucket</Code></Error>")).ParseDone());
+}
+
+TEST_F(XmlStreamParserTest, ListObjectsOnReceiveTest)
+{
+    if (!StartServer()) {
+        return;
+    }
+
+    std::vector<std::string> keys = { "dir/a b", "dir/b&c", "dir/<x>", "dir/\xE4\xB8\xAD", "top" };
+    for (const auto &key : keys) {
+        ASSERT_TRUE(Client->PutObject("bucket", key, std::make_shared<std::stringstream>(key)).isSuccess());
+    }
+    std::sort(keys.begin(), keys.end());
+
+    ListObjectsRequest request("bucket");
+    request.setEncodingType("url");
+    request.setMaxKeys(3);
+    std::vector<std::string> listed;
+    do {
+        auto outcome = Client->ListObjects(request);
+        ASSERT_TRUE(outcome.isSuccess());
+        for (const auto &summary : outcome.result().ObjectSummarys()) {
+            listed.push_back(summary.Key());
+        }
+        request.setMarker(outcome.result().NextMarker());
+        if (!outcome.result().IsTruncated()) {
+            break;
+        }
+    } while (true);
+    EXPECT_EQ(listed, keys);
+
+    auto delimited = ListObjectsRequest("bucket");
+    delimited.setDelimiter("/");
+    auto outcome = Client->ListObjectsCallable(delimited).get();
+    ASSERT_TRUE(outcome.isSuccess());
+    EXPECT_EQ(outcome.result().ObjectSummarys().size(), 1U);
+    EXPECT_EQ(outcome.result().CommonPrefixes().front(), "dir/");
+    EXPECT_FALSE(outcome.result().RequestId().empty());
+
+    //the error document is still read by the error path
+    LocalOssServer::Options options;
+    options.errorRate = 1.0;
+    auto failing = std::make_shared<LocalOssServer>(options);
+    ASSERT_TRUE(failing->start());
+    OssClient failingClient(failing->endpoint(), "ak", "sk", NoRetryConfiguration());
+    auto failed = failingClient.ListObjects("bucket");
+    EXPECT_FALSE(failed.isSuccess());
+    EXPECT_EQ(failed.error().Code(), "ServiceUnavailable");
+    failing->stop();
+}
+
+}
+}